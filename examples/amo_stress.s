@@ -0,0 +1,81 @@
+# Stress test for the A extension, run with: rvsim amo_stress.elf --harts 4 --maxitr 100000000
+#
+# Every hart increments three shared counters ITERS times:
+#   add_count   with amoadd.w
+#   lrsc_count  with an lr.w/sc.w retry loop
+#   lock_count  with plain lw/sw inside a spinlock taken with amoswap.w.aq
+# and records the highest hart id with amomax.w. Hart 0 waits for all harts,
+# then checks the totals. It halts with ecall if they are right and spins
+# forever if not (reported as "Maximum iterations reached").
+
+.equ NHARTS, 4
+.equ ITERS, 100000
+
+.text
+.global _start
+
+_start:
+    csrr    s0, mhartid
+    li      s1, ITERS
+    la      s2, add_count
+    la      s3, lrsc_count
+    la      s4, lock
+    la      s5, lock_count
+
+loop:
+    li      t0, 1
+    amoadd.w zero, t0, (s2)
+
+1:  lr.w    t1, (s3)
+    addi    t1, t1, 1
+    sc.w    t2, t1, (s3)
+    bnez    t2, 1b
+
+2:  amoswap.w.aq t1, t0, (s4)
+    bnez    t1, 2b
+    lw      t1, 0(s5)
+    addi    t1, t1, 1
+    sw      t1, 0(s5)
+    amoswap.w.rl zero, zero, (s4)
+
+    addi    s1, s1, -1
+    bnez    s1, loop
+
+    la      t1, max_hart
+    amomax.w zero, s0, (t1)
+    la      t1, done
+    amoadd.w zero, t0, (t1)
+    bnez    s0, park
+
+    # Hart 0: wait for all harts
+    li      t2, NHARTS
+3:  lw      t3, 0(t1)
+    bne     t3, t2, 3b
+
+    li      t2, NHARTS * ITERS
+    lw      t3, 0(s2)
+    bne     t3, t2, fail
+    lw      t3, 0(s3)
+    bne     t3, t2, fail
+    lw      t3, 0(s5)
+    bne     t3, t2, fail
+    la      t1, max_hart
+    lw      t3, 0(t1)
+    li      t2, NHARTS - 1
+    bne     t3, t2, fail
+    li      a0, 0
+    ecall
+
+fail:
+    j       fail
+
+park:
+    ecall
+
+.data
+add_count:  .word 0
+lrsc_count: .word 0
+lock:       .word 0
+lock_count: .word 0
+max_hart:   .word 0
+done:       .word 0
@@ -0,0 +1,53 @@
+# Reserved & illegal encodings of the C extension (RV32), run with:
+#   rvsim c_illegal.elf --signature c_illegal.signature
+# and compare with c_illegal.reference_output (or run --compliance on the
+# directory holding both).
+#
+# Each encoding raises an illegal instruction exception. The trap handler
+# records mcause & mtval, which holds the 16-bit encoding (not a 32-bit
+# expansion), then skips the 2-byte instruction. A valid compressed
+# instruction after the last one checks execution carries on in step.
+
+.text
+.global _start
+
+_start:
+    la      s0, begin_signature
+    la      t0, handler
+    csrw    mtvec, t0
+
+    .half   0x0000                  # all zeros
+    .half   0x0004                  # c.addi4spn with nzuimm 0
+    .half   0x6101                  # c.addi16sp with nzimm 0
+    .half   0x6081                  # c.lui with nzimm 0
+    .half   0x4002                  # c.lwsp with rd x0
+    .half   0x8002                  # c.jr with rs1 x0
+    .half   0x8000                  # quadrant 0, funct3 4 (reserved)
+    .half   0x1082                  # c.slli with shamt[5] set (RV64 only)
+    .half   0x9c01                  # c.subw (RV64 only)
+    c.li    a0, 5
+    sw      a0, 0(s0)
+
+    csrw    mtvec, zero
+    li      a0, 0
+    ecall
+
+.align 2
+handler:
+    csrr    t0, mcause
+    sw      t0, 0(s0)
+    csrr    t0, mtval
+    sw      t0, 4(s0)
+    addi    s0, s0, 8
+    csrr    t0, mepc
+    addi    t0, t0, 2
+    csrw    mepc, t0
+    mret
+
+.data
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 19, 4, 0xdeadbeef
+.global end_signature
+end_signature:
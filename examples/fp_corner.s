@@ -0,0 +1,144 @@
+# Corner cases of the F & D extensions (RV32), run with:
+#   rvsim fp_corner.elf --signature fp_corner.signature
+# and compare with fp_corner.reference_output (or run --compliance on the
+# directory holding both).
+#
+# Signed zeros: sums of opposite zeros round to +0 except in RDN, fmin/fmax
+# order -0 below +0, comparisons treat them as equal.
+# NaN boxing: single precision values live in the lower half of a double
+# register with the upper half all ones; an operand that is not boxed reads
+# as the canonical NaN, results (and flw/fmv.w.x) are always boxed.
+# RMM: ties round away from zero, where RNE rounds them to even. Every
+# rounded result is followed by the fflags it raised.
+
+.text
+.global _start
+
+_start:
+    la      s0, begin_signature
+    la      s1, fp_data
+
+    # ---- Signed zeros ----
+    fmv.w.x f0, zero                # +0
+    fneg.s  f1, f0                  # -0
+    fadd.s  f2, f0, f1
+    fmv.x.w t0, f2
+    sw      t0, 0(s0)
+    fadd.s  f2, f0, f1, rdn
+    fmv.x.w t0, f2
+    sw      t0, 4(s0)
+    fsub.s  f2, f0, f0, rdn
+    fmv.x.w t0, f2
+    sw      t0, 8(s0)
+    fmin.s  f2, f0, f1
+    fmv.x.w t0, f2
+    sw      t0, 12(s0)
+    fmax.s  f2, f1, f0
+    fmv.x.w t0, f2
+    sw      t0, 16(s0)
+    feq.s   t0, f0, f1
+    sw      t0, 20(s0)
+    flt.s   t0, f1, f0
+    sw      t0, 24(s0)
+    fclass.s t0, f1
+    sw      t0, 28(s0)
+    fsqrt.s f2, f1
+    fmv.x.w t0, f2
+    sw      t0, 32(s0)
+    flw     f3, 0(s1)               # 3.0
+    fmul.s  f2, f1, f3
+    fmv.x.w t0, f2
+    sw      t0, 36(s0)
+    fcvt.w.s t0, f1
+    sw      t0, 40(s0)
+    fclass.s t0, f0
+    sw      t0, 44(s0)
+    fcvt.d.s f4, f1
+    fsd     f4, 48(s0)
+    fcvt.s.d f2, f4
+    fmv.x.w t0, f2
+    sw      t0, 56(s0)
+
+    # ---- NaN boxing ----
+    fld     f5, 8(s1)               # 1.0 as a double, not a boxed single
+    fclass.s t0, f5
+    sw      t0, 60(s0)
+    fadd.s  f2, f5, f3
+    fmv.x.w t0, f2
+    sw      t0, 64(s0)
+    fsgnj.s f2, f3, f5
+    fmv.x.w t0, f2
+    sw      t0, 68(s0)
+    fmv.x.w t0, f5                  # moves the lower half as is
+    sw      t0, 72(s0)
+    fclass.s t0, f3
+    sw      t0, 76(s0)
+    flw     f6, 0(s1)
+    fsd     f6, 80(s0)
+    li      t1, 0x40490fdb
+    fmv.w.x f6, t1
+    fsd     f6, 88(s0)
+    fcvt.s.d f6, f5
+    fsd     f6, 96(s0)
+
+    # ---- RMM rounding ----
+    csrw    fflags, zero
+    flw     f7, 4(s1)               # 2.5
+    fcvt.w.s t0, f7, rmm
+    sw      t0, 104(s0)
+    fcvt.w.s t0, f7, rne
+    sw      t0, 108(s0)
+    fneg.s  f8, f7
+    fcvt.w.s t0, f8, rmm
+    sw      t0, 112(s0)
+    fcvt.w.s t0, f8, rne
+    sw      t0, 116(s0)
+    frflags t0
+    sw      t0, 120(s0)
+
+    csrw    fflags, zero
+    li      t1, 0x3f800000          # 1.0
+    fmv.w.x f9, t1
+    li      t1, 0x33800000          # 2^-24, half an ulp of 1.0
+    fmv.w.x f10, t1
+    fadd.s  f2, f9, f10, rmm
+    fmv.x.w t0, f2
+    sw      t0, 124(s0)
+    fadd.s  f2, f9, f10, rne
+    fmv.x.w t0, f2
+    sw      t0, 128(s0)
+    fneg.s  f9, f9
+    fsub.s  f2, f9, f10, rmm
+    fmv.x.w t0, f2
+    sw      t0, 132(s0)
+    frflags t0
+    sw      t0, 136(s0)
+
+    csrw    fflags, zero
+    fld     f11, 16(s1)             # 1 + 2^-24 as a double
+    fcvt.s.d f2, f11, rmm
+    fmv.x.w t0, f2
+    sw      t0, 140(s0)
+    fcvt.s.d f2, f11, rne
+    fmv.x.w t0, f2
+    sw      t0, 144(s0)
+    frflags t0
+    sw      t0, 148(s0)
+
+    li      a0, 0
+    ecall
+
+.data
+.align 3
+fp_data:
+    .word   0x40400000              # 3.0f
+    .word   0x40200000              # 2.5f
+    .dword  0x3ff0000000000000      # 1.0
+    .dword  0x3ff0000010000000      # 1 + 2^-24
+
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 38, 4, 0xdeadbeef
+.global end_signature
+end_signature:
@@ -0,0 +1,83 @@
+# Corner cases of the M extension (RV32), run with:
+#   rvsim m_corner.elf --signature m_corner.signature
+# and compare with m_corner.reference_output (or run --compliance on the
+# directory holding both).
+#
+# Division overflow (most negative / -1) and division by zero don't trap,
+# they give the results fixed by the spec:
+#   div  MIN, -1 = MIN        rem  MIN, -1 = 0
+#   div  x, 0    = -1         rem  x, 0    = x
+#   divu x, 0    = 2^32-1     remu x, 0    = x
+# followed by the upper halves of products of the extreme operands.
+
+.text
+.global _start
+
+_start:
+    la      s0, begin_signature
+    li      s1, 0x80000000
+    li      s2, -1
+    li      s3, 1234567
+    li      s4, -7
+
+    # Overflow
+    div     t0, s1, s2
+    sw      t0, 0(s0)
+    rem     t0, s1, s2
+    sw      t0, 4(s0)
+    divu    t0, s1, s2
+    sw      t0, 8(s0)
+    remu    t0, s1, s2
+    sw      t0, 12(s0)
+
+    # Division by zero
+    div     t0, s3, zero
+    sw      t0, 16(s0)
+    rem     t0, s3, zero
+    sw      t0, 20(s0)
+    divu    t0, s3, zero
+    sw      t0, 24(s0)
+    remu    t0, s3, zero
+    sw      t0, 28(s0)
+    div     t0, s4, zero
+    sw      t0, 32(s0)
+    rem     t0, s4, zero
+    sw      t0, 36(s0)
+    div     t0, zero, zero
+    sw      t0, 40(s0)
+    rem     t0, zero, zero
+    sw      t0, 44(s0)
+
+    # Signs of the remainder follow the dividend
+    rem     t0, s4, s3
+    sw      t0, 48(s0)
+    li      t1, 2
+    rem     t0, s4, t1
+    sw      t0, 52(s0)
+    div     t0, s4, t1
+    sw      t0, 56(s0)
+
+    # Products of the extreme operands
+    mul     t0, s1, s2
+    sw      t0, 60(s0)
+    mulh    t0, s1, s1
+    sw      t0, 64(s0)
+    mulh    t0, s1, s2
+    sw      t0, 68(s0)
+    mulhsu  t0, s2, s2
+    sw      t0, 72(s0)
+    mulhsu  t0, s1, s2
+    sw      t0, 76(s0)
+    mulhu   t0, s2, s2
+    sw      t0, 80(s0)
+
+    li      a0, 0
+    ecall
+
+.data
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 21, 4, 0xdeadbeef
+.global end_signature
+end_signature:
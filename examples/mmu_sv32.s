@@ -0,0 +1,184 @@
+# Sv32 address translation (RV32), run with:
+#   rvsim mmu_sv32.elf --signature mmu_sv32.signature
+# and compare with mmu_sv32.reference_output (or run --compliance on the
+# directory holding both).
+#
+# M-mode builds the page tables & runs the tests in S-mode. Every trap goes
+# to M-mode, which records mcause & mtval and skips the instruction. Checked:
+#   - 4 KiB pages through a second level table & 4 MiB megapages
+#   - A set by loads, A & D set by stores, both written back to the PTE
+#   - load, store & fetch page faults on invalid PTEs, missing permissions,
+#     W without R, misaligned megapages & pointers to the next level with A, D
+#     or U set (reserved in non-leaf PTEs)
+#   - MXR making execute only pages readable
+
+.equ PTE_V, 0x01
+.equ PTE_R, 0x02
+.equ PTE_W, 0x04
+.equ PTE_X, 0x08
+.equ PTE_U, 0x10
+.equ PTE_A, 0x40
+.equ PTE_D, 0x80
+
+# Store a PTE pointing to sym with flags in entry idx of table
+.macro pte table, idx, sym, flags
+    la      t0, \sym
+    srli    t0, t0, 12
+    slli    t0, t0, 10
+    ori     t0, t0, \flags
+    la      t1, \table
+    sw      t0, \idx * 4(t1)
+.endm
+
+.text
+.global _start
+
+_start:
+    la      s0, begin_signature
+    la      t0, m_handler
+    csrw    mtvec, t0
+
+    # VA 0: megapage identity mapping code & data
+    li      t0, PTE_V | PTE_R | PTE_W | PTE_X | PTE_A | PTE_D
+    la      t1, root
+    sw      t0, 0(t1)
+    # VA 0x400000: 4 KiB pages
+    pte     root, 1, leaf, PTE_V
+    # VA 0x800000: megapage not aligned to 4 MiB
+    pte     root, 2, leaf, PTE_V | PTE_R | PTE_W | PTE_A | PTE_D
+    # VA 0xc00000, 0x1000000 & 0x1800000: pointers with A, U & D set
+    pte     root, 3, leaf, PTE_V | PTE_A
+    pte     root, 4, leaf, PTE_V | PTE_U
+    pte     root, 6, leaf, PTE_V | PTE_D
+    # VA 0x1400000: read only megapage alias of VA 0
+    li      t0, PTE_V | PTE_R | PTE_A
+    sw      t0, 20(t1)
+
+    pte     leaf, 0, page, PTE_V | PTE_R | PTE_W        # A & D clear
+    pte     leaf, 1, page, PTE_V | PTE_R | PTE_A        # read only
+    pte     leaf, 3, page, PTE_V | PTE_W | PTE_A | PTE_D  # reserved
+    pte     leaf, 4, page, PTE_V | PTE_X | PTE_A        # execute only
+
+    la      t0, root
+    srli    t0, t0, 12
+    li      t1, 1 << 31
+    or      t0, t0, t1
+    csrw    satp, t0
+
+    # mret to S-mode
+    li      t0, 0x1800
+    csrc    mstatus, t0
+    li      t0, 0x800
+    csrs    mstatus, t0
+    la      t0, s_code
+    csrw    mepc, t0
+    mret
+
+s_code:
+    la      a1, leaf
+    li      a2, 0x400000
+
+    # A set by a load, D by a store
+    lw      t0, 0(a2)
+    sw      t0, 0(s0)
+    lbu     t0, 0(a1)
+    sw      t0, 4(s0)
+    li      t0, 0x1234abcd
+    sw      t0, 4(a2)
+    lbu     t0, 0(a1)
+    sw      t0, 8(s0)
+    addi    s0, s0, 12
+
+    # Read only page: loads see the store above, stores fault
+    li      a3, 0x401000
+    lw      t0, 4(a3)
+    sw      t0, 0(s0)
+    addi    s0, s0, 4
+    sw      t0, 8(a3)
+
+    # Invalid PTE, W without R, execute only page
+    li      a3, 0x402000
+    lw      t0, 0(a3)
+    li      a3, 0x403000
+    lw      t0, 0(a3)
+    li      a3, 0x404000
+    lw      t0, 0(a3)
+    li      t1, 1 << 19
+    csrs    sstatus, t1
+    lw      t0, 4(a3)
+    sw      t0, 0(s0)
+    addi    s0, s0, 4
+    csrc    sstatus, t1
+
+    # Megapage alias reads code & data, but can't be written
+    la      t0, page
+    li      t1, 0x1400000
+    add     a3, t0, t1
+    lw      t0, 4(a3)
+    sw      t0, 0(s0)
+    addi    s0, s0, 4
+    sw      t0, 0(a3)
+
+    # Misaligned megapage, pointers with A, U or D set
+    li      a3, 0x800000
+    lw      t0, 0(a3)
+    li      a3, 0xc00000
+    sw      t0, 0(a3)
+    li      a3, 0x1000000
+    lw      t0, 0(a3)
+    li      a3, 0x1800000
+    lw      t0, 0(a3)
+
+    # Fetch from an invalid page (the handler returns to ra)
+    li      a3, 0x402000
+    la      ra, 1f
+    jr      a3
+1:
+    ecall                   # back to M-mode
+
+    .align 2
+m_handler:
+    csrr    t5, mcause
+    li      t6, 9
+    beq     t5, t6, m_done
+    sw      t5, 0(s0)
+    csrr    t5, mtval
+    sw      t5, 4(s0)
+    addi    s0, s0, 8
+    csrr    t5, mcause
+    li      t6, 12
+    bne     t5, t6, 1f
+    csrw    mepc, ra
+    mret
+1:
+    csrr    t5, mepc
+    addi    t5, t5, 4
+    csrw    mepc, t5
+    mret
+
+m_done:
+    # Final PTE of the 4 KiB page: V R W A D
+    la      t0, leaf
+    lw      t0, 0(t0)
+    andi    t0, t0, 0xff
+    sw      t0, 0(s0)
+    csrw    mtvec, zero
+    li      a0, 0
+    ecall
+
+.data
+.align 12
+root:
+    .fill 1024, 4, 0
+leaf:
+    .fill 1024, 4, 0
+page:
+    .word 0x600df00d
+    .fill 1023, 4, 0
+
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 27, 4, 0xdeadbeef
+.global end_signature
+end_signature:
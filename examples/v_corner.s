@@ -0,0 +1,145 @@
+# Corner cases of the V extension (RV32, VLEN 128), run with:
+#   rvsim v_corner.elf --signature v_corner.signature
+# and compare with v_corner.reference_output (or run --compliance on the
+# directory holding both). Kernels use AVX2 or SSE2 when the host has them;
+# --portable runs the same test on the scalar kernels, which must give the
+# same signature.
+#
+# Every operation runs at SEW 8, 16, 32 & 64 with LMUL 4 and vl 3 below VLMAX,
+# so the SIMD kernels get a partial last vector, under a mask with a mix of
+# active & inactive elements. The whole destination group, filled with a
+# pattern beforehand, is stored: inactive & tail elements must be left
+# undisturbed. Operands include 0, -1 & the most negative values, shifts by
+# SEW or more (taken modulo SEW) and reductions over the active elements.
+
+.text
+.global _start
+
+# Fill v8-v11 with the pattern, run the instruction, store v8-v11
+.macro vop insn:vararg
+    la      t1, pattern
+    vl4re8.v v8, (t1)
+    \insn
+    vs4r.v  v8, (s0)
+    addi    s0, s0, 64
+.endm
+
+# All operations at one SEW
+.macro sew_tests sew
+    vsetvli t0, zero, e\sew, m4, tu, mu
+    addi    t0, t0, -3
+    vsetvli t0, t0, e\sew, m4, tu, mu
+    la      t1, src1
+    vle\sew\().v v16, (t1)
+    la      t1, src2
+    vle\sew\().v v20, (t1)
+    li      a1, -1
+    li      a2, \sew + 1
+    li      a3, 0x5a
+
+    vop     vadd.vv v8, v16, v20, v0.t
+    vop     vsub.vx v8, v16, a1, v0.t
+    vop     vrsub.vi v8, v16, -16, v0.t
+    vop     vand.vv v8, v16, v20, v0.t
+    vop     vor.vx v8, v16, a3, v0.t
+    vop     vxor.vi v8, v16, -1, v0.t
+    vop     vsll.vv v8, v16, v20, v0.t
+    vop     vsrl.vx v8, v16, a2, v0.t
+    vop     vsra.vv v8, v16, v20, v0.t
+    vop     vsra.vi v8, v16, 31, v0.t
+    vop     vmul.vv v8, v16, v20, v0.t
+    vop     vmulh.vv v8, v16, v20, v0.t
+    vop     vmulhu.vv v8, v16, v20, v0.t
+    vop     vmulhsu.vv v8, v16, v20, v0.t
+    vop     vmacc.vv v8, v16, v20, v0.t
+    vop     vnmsac.vx v8, a1, v20, v0.t
+    vop     vmin.vv v8, v16, v20, v0.t
+    vop     vminu.vv v8, v16, v20, v0.t
+    vop     vmax.vx v8, v16, a1, v0.t
+    vop     vmaxu.vv v8, v16, v20, v0.t
+    vop     vmerge.vvm v8, v16, v20, v0
+    vop     vmerge.vim v8, v16, -7, v0
+    vop     vmv.v.x v8, a1
+    vop     vmseq.vv v8, v16, v20, v0.t
+    vop     vmslt.vv v8, v16, v20, v0.t
+    vop     vmsltu.vv v8, v16, v20, v0.t
+    vop     vmsgt.vx v8, v16, a1, v0.t
+    vop     vmsleu.vi v8, v16, 15, v0.t
+    vop     vredsum.vs v8, v16, v20, v0.t
+    vop     vredmax.vs v8, v16, v20, v0.t
+    vop     vredminu.vs v8, v16, v20, v0.t
+    vop     vredand.vs v8, v16, v20, v0.t
+    vop     vredor.vs v8, v16, v20
+    vop     vredxor.vs v8, v16, v20, v0.t
+.endm
+
+_start:
+    la      s0, begin_signature
+    li      t0, 0x600
+    csrs    mstatus, t0             # VS on
+
+    vsetvli t0, zero, e8, m8, ta, ma     # vlm.v loads vl / 8 bytes
+    la      t1, mask
+    vlm.v   v0, (t1)
+
+    sew_tests 8
+    sew_tests 16
+    sew_tests 32
+    sew_tests 64
+
+    # Mask operations
+    li      t0, 61
+    vsetvli t0, t0, e8, m4, tu, mu
+    vcpop.m t1, v0
+    sw      t1, 0(s0)
+    vfirst.m t1, v0
+    sw      t1, 4(s0)
+    vmclr.m v8
+    vfirst.m t1, v8
+    sw      t1, 8(s0)
+    addi    s0, s0, 12
+    vop     vid.v v8, v0.t
+    vop     vmand.mm v8, v0, v16
+    vop     vmnor.mm v8, v0, v20
+
+    # Strided load with a negative stride, masked store over the pattern
+    li      t0, 7
+    vsetvli t0, t0, e32, m4, tu, mu
+    la      t3, src1 + 28
+    li      t2, -4
+    vop     vlse32.v v8, (t3), t2, v0.t
+    la      t1, pattern
+    vl2re8.v v8, (t1)
+    vs2r.v  v8, (s0)
+    vse32.v v16, (s0), v0.t
+    addi    s0, s0, 32
+
+    li      a0, 0
+    ecall
+
+.data
+.align 4
+mask:
+    .word 0xa5c3f06d, 0x0ff05aa5, 0x3c96e187, 0x80000001
+src1:
+    .word 0x00000000, 0xffffffff, 0x80000000, 0x7fffffff
+    .word 0x12345678, 0x9abcdef0, 0x00ff00ff, 0x80808080
+    .word 0x00000000, 0x80000000, 0xffffffff, 0xffffffff
+    .word 0x00000080, 0x00008000, 0x7f7f7f7f, 0x0badf00d
+src2:
+    .word 0xffffffff, 0x00000001, 0x7f7f7f7f, 0x80000000
+    .word 0x3f2e1d0c, 0xfedcba98, 0x01020304, 0x00000000
+    .word 0xffffffff, 0xffffffff, 0x00000000, 0x80000000
+    .word 0x41424344, 0x07070707, 0xc0c0c0c0, 0xdeadbeef
+pattern:
+    .word 0xd1d1d1d1, 0xd2d2d2d2, 0xd3d3d3d3, 0xd4d4d4d4
+    .word 0xd5d5d5d5, 0xd6d6d6d6, 0xd7d7d7d7, 0xd8d8d8d8
+    .word 0xd9d9d9d9, 0xdadadada, 0xdbdbdbdb, 0xdcdcdcdc
+    .word 0xdddddddd, 0xdededede, 0xdfdfdfdf, 0xe0e0e0e0
+
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 2251, 4, 0xdeadbeef
+.global end_signature
+end_signature:
@@ -0,0 +1,117 @@
+# Corner cases of the bit manipulation extensions Zba, Zbb, Zbc & Zbs (RV32),
+# run with:
+#   rvsim zb_corner.elf --signature zb_corner.signature
+# and compare with zb_corner.reference_output (or run --compliance on the
+# directory holding both). Counting & carry-less multiply use host
+# instructions when the host has them; --portable runs the same test on the
+# portable code, which must give the same signature.
+#
+# Each operation is applied to 0, 1, -1, the most negative value & two mixed
+# bit patterns: counts of all-zero & all-one words, products with the top
+# bits set, shifts by amounts >= XLEN (taken modulo XLEN) and single bit
+# operations on bit 31.
+
+.text
+.global _start
+
+# Apply a two operand instruction to every pair of a & b, store the results
+.macro op2 insn
+    la      t2, operands
+    li      t3, 6
+1:
+    lw      t0, 0(t2)
+    la      t4, operands
+    li      t5, 6
+2:
+    lw      t1, 0(t4)
+    \insn   t6, t0, t1
+    sw      t6, 0(s0)
+    addi    s0, s0, 4
+    addi    t4, t4, 4
+    addi    t5, t5, -1
+    bnez    t5, 2b
+    addi    t2, t2, 4
+    addi    t3, t3, -1
+    bnez    t3, 1b
+.endm
+
+# Apply a one operand instruction to every operand
+.macro op1 insn
+    la      t2, operands
+    li      t3, 6
+1:
+    lw      t0, 0(t2)
+    \insn   t6, t0
+    sw      t6, 0(s0)
+    addi    s0, s0, 4
+    addi    t2, t2, 4
+    addi    t3, t3, -1
+    bnez    t3, 1b
+.endm
+
+_start:
+    la      s0, begin_signature
+
+    # Zbb counts & byte operations
+    op1     clz
+    op1     ctz
+    op1     cpop
+    op1     orc.b
+    op1     rev8
+    op1     sext.b
+    op1     sext.h
+    op1     zext.h
+
+    # Zbc
+    op2     clmul
+    op2     clmulh
+    op2     clmulr
+
+    # Zbb logic, min/max & rotates
+    op2     andn
+    op2     orn
+    op2     xnor
+    op2     min
+    op2     minu
+    op2     max
+    op2     maxu
+    op2     rol
+    op2     ror
+
+    # Zba
+    op2     sh1add
+    op2     sh2add
+    op2     sh3add
+
+    # Zbs (bit index taken modulo XLEN)
+    op2     bset
+    op2     bclr
+    op2     binv
+    op2     bext
+
+    # Immediate forms
+    li      t0, 0x80000001
+    rori    t1, t0, 31
+    sw      t1, 0(s0)
+    bseti   t1, zero, 31
+    sw      t1, 4(s0)
+    bclri   t1, t0, 31
+    sw      t1, 8(s0)
+    binvi   t1, t0, 0
+    sw      t1, 12(s0)
+    bexti   t1, t0, 31
+    sw      t1, 16(s0)
+
+    li      a0, 0
+    ecall
+
+.data
+operands:
+    .word 0, 1, 0xffffffff, 0x80000000, 0x12345678, 0xf0e1d2c3
+
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 737, 4, 0xdeadbeef
+.global end_signature
+end_signature:
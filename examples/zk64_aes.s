@@ -0,0 +1,146 @@
+# AES-128 with the RV64 scalar crypto instructions (needs a simulator built
+# without RV_XLEN_32), run with:
+#   rvsim zk64_aes.elf --signature zk64_aes.signature
+# and compare with zk64_aes.reference_output. aes64* run on AES-NI when the
+# host has it; --portable runs the same test on the lookup tables, which must
+# give the same signature.
+#
+# Expands the FIPS-197 appendix B key with aes64ks1i/aes64ks2, encrypts the
+# appendix B block with aes64esm/aes64es (ciphertext 3925841d 02dc09fb
+# dc118597 196a0b32), decrypts it back with aes64dsm/aes64ds & aes64im, then
+# applies each instruction to corner operands.
+
+.text
+.global _start
+
+_start:
+    la      s0, begin_signature
+
+    # Key schedule: rk[0..10] at round_keys
+    la      a0, round_keys
+    la      t0, key
+    ld      t1, 0(t0)
+    ld      t2, 8(t0)
+    sd      t1, 0(a0)
+    sd      t2, 8(a0)
+    .irp r, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9
+    aes64ks1i t3, t2, \r
+    aes64ks2 t1, t3, t1
+    aes64ks2 t2, t1, t2
+    sd      t1, 16 * (\r + 1)(a0)
+    sd      t2, 16 * (\r + 1) + 8(a0)
+    .endr
+    # Last round key
+    sd      t1, 0(s0)
+    sd      t2, 8(s0)
+    addi    s0, s0, 16
+
+    # Encrypt
+    la      t0, plaintext
+    ld      t1, 0(t0)
+    ld      t2, 8(t0)
+    ld      t3, 0(a0)
+    ld      t4, 8(a0)
+    xor     t1, t1, t3
+    xor     t2, t2, t4
+    .irp r, 1, 2, 3, 4, 5, 6, 7, 8, 9
+    aes64esm t3, t1, t2
+    aes64esm t4, t2, t1
+    ld      t1, 16 * \r(a0)
+    ld      t2, 16 * \r + 8(a0)
+    xor     t1, t1, t3
+    xor     t2, t2, t4
+    .endr
+    aes64es t3, t1, t2
+    aes64es t4, t2, t1
+    ld      t1, 160(a0)
+    ld      t2, 168(a0)
+    xor     t1, t1, t3
+    xor     t2, t2, t4
+    sd      t1, 0(s0)
+    sd      t2, 8(s0)
+    addi    s0, s0, 16
+
+    # Decrypt, middle round keys go through InvMixColumns
+    ld      t3, 160(a0)
+    ld      t4, 168(a0)
+    xor     t1, t1, t3
+    xor     t2, t2, t4
+    .irp r, 9, 8, 7, 6, 5, 4, 3, 2, 1
+    aes64dsm t3, t1, t2
+    aes64dsm t4, t2, t1
+    ld      t1, 16 * \r(a0)
+    ld      t2, 16 * \r + 8(a0)
+    aes64im t1, t1
+    aes64im t2, t2
+    xor     t1, t1, t3
+    xor     t2, t2, t4
+    .endr
+    aes64ds t3, t1, t2
+    aes64ds t4, t2, t1
+    ld      t1, 0(a0)
+    ld      t2, 8(a0)
+    xor     t1, t1, t3
+    xor     t2, t2, t4
+    sd      t1, 0(s0)
+    sd      t2, 8(s0)
+    addi    s0, s0, 16
+
+    # Every instruction on every pair of operands
+    la      t5, operands
+    li      t6, 4
+1:
+    ld      t1, 0(t5)
+    la      a1, operands
+    li      a2, 4
+2:
+    ld      t2, 0(a1)
+    aes64es t0, t1, t2
+    sd      t0, 0(s0)
+    aes64esm t0, t1, t2
+    sd      t0, 8(s0)
+    aes64ds t0, t1, t2
+    sd      t0, 16(s0)
+    aes64dsm t0, t1, t2
+    sd      t0, 24(s0)
+    aes64ks2 t0, t1, t2
+    sd      t0, 32(s0)
+    addi    s0, s0, 40
+    addi    a1, a1, 8
+    addi    a2, a2, -1
+    bnez    a2, 2b
+    aes64im t0, t1
+    sd      t0, 0(s0)
+    aes64ks1i t0, t1, 0
+    sd      t0, 8(s0)
+    aes64ks1i t0, t1, 9
+    sd      t0, 16(s0)
+    aes64ks1i t0, t1, 10
+    sd      t0, 24(s0)
+    addi    s0, s0, 32
+    addi    t5, t5, 8
+    addi    t6, t6, -1
+    bnez    t6, 1b
+
+    li      a0, 0
+    ecall
+
+.data
+.align 3
+key:
+    .byte 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6
+    .byte 0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+plaintext:
+    .byte 0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d
+    .byte 0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34
+operands:
+    .dword 0, -1, 0x8000000000000001, 0x0123456789abcdef
+round_keys:
+    .fill 22, 8, 0
+
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 204, 4, 0xdeadbeef
+.global end_signature
+end_signature:
@@ -0,0 +1,118 @@
+# Scalar crypto instructions of Zknd, Zkne, Zknh, Zksed & Zksh (RV32), run
+# with:
+#   rvsim zk_corner.elf --signature zk_corner.signature
+# and compare with zk_corner.reference_output (or run --compliance on the
+# directory holding both). The RV64 AES instructions, which use AES-NI when
+# the host has it, are covered by zk64_aes.s.
+#
+# The byte wide AES & SM4 instructions run with every byte select on every
+# pair of operands, then the SHA-2 & SM3 functions on every operand (RV32
+# SHA-512 forms on every pair, as the two halves of a 64-bit value).
+
+.text
+.global _start
+
+# Apply a byte select instruction with bs 0-3 to every pair of operands
+.macro bsop insn
+    la      t2, operands
+    li      t3, 4
+1:
+    lw      t0, 0(t2)
+    la      t4, operands
+    li      t5, 4
+2:
+    lw      t1, 0(t4)
+    \insn   t6, t0, t1, 0
+    sw      t6, 0(s0)
+    \insn   t6, t0, t1, 1
+    sw      t6, 4(s0)
+    \insn   t6, t0, t1, 2
+    sw      t6, 8(s0)
+    \insn   t6, t0, t1, 3
+    sw      t6, 12(s0)
+    addi    s0, s0, 16
+    addi    t4, t4, 4
+    addi    t5, t5, -1
+    bnez    t5, 2b
+    addi    t2, t2, 4
+    addi    t3, t3, -1
+    bnez    t3, 1b
+.endm
+
+# Apply a two operand instruction to every pair of operands
+.macro op2 insn
+    la      t2, operands
+    li      t3, 4
+1:
+    lw      t0, 0(t2)
+    la      t4, operands
+    li      t5, 4
+2:
+    lw      t1, 0(t4)
+    \insn   t6, t0, t1
+    sw      t6, 0(s0)
+    addi    s0, s0, 4
+    addi    t4, t4, 4
+    addi    t5, t5, -1
+    bnez    t5, 2b
+    addi    t2, t2, 4
+    addi    t3, t3, -1
+    bnez    t3, 1b
+.endm
+
+# Apply a one operand instruction to every operand
+.macro op1 insn
+    la      t2, operands
+    li      t3, 4
+1:
+    lw      t0, 0(t2)
+    \insn   t6, t0
+    sw      t6, 0(s0)
+    addi    s0, s0, 4
+    addi    t2, t2, 4
+    addi    t3, t3, -1
+    bnez    t3, 1b
+.endm
+
+_start:
+    la      s0, begin_signature
+
+    # Zkne, Zknd
+    bsop    aes32esi
+    bsop    aes32esmi
+    bsop    aes32dsi
+    bsop    aes32dsmi
+
+    # Zksed
+    bsop    sm4ed
+    bsop    sm4ks
+
+    # Zknh
+    op1     sha256sig0
+    op1     sha256sig1
+    op1     sha256sum0
+    op1     sha256sum1
+    op2     sha512sig0h
+    op2     sha512sig0l
+    op2     sha512sig1h
+    op2     sha512sig1l
+    op2     sha512sum0r
+    op2     sha512sum1r
+
+    # Zksh
+    op1     sm3p0
+    op1     sm3p1
+
+    li      a0, 0
+    ecall
+
+.data
+operands:
+    .word 0, 0xffffffff, 0x80000001, 0x01234567
+
+.align 4
+.global begin_signature
+begin_signature:
+    .fill 504, 4, 0xdeadbeef
+.global end_signature
+end_signature:
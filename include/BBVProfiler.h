@@ -0,0 +1,85 @@
+#ifndef __BBVPROFILER_H__
+#define __BBVPROFILER_H__
+
+#include <string>
+#include <fstream>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "RVdefs.h"
+#include "RVCPU.h"
+
+/**
+ * @brief Collects basic block vectors for SimPoint
+ * One vector is written per interval of instructions in the SimPoint .bb
+ * format. Vectors are built from the execution counts of decoded blocks, so
+ * collecting them costs nothing while the CPU runs.
+ * 
+ */
+class BBVProfiler
+{
+    private:
+    /**
+     * @brief Per block state, by block start address
+     */
+    struct BlockInfo
+    {
+        unsigned int id;        // SimPoint block id (from 1)
+        uint64_t lastCount;     // block execution count at the last sample
+    };
+
+    RVCPU * cpu;
+    std::ofstream out;
+
+    /**
+     * @brief Instructions per interval
+     */
+    uint64_t interval;
+
+    /**
+     * @brief Instruction count of the end of the current interval
+     */
+    uint64_t nextSample;
+    uint64_t lastInstret;
+    uint64_t intervals;
+
+    std::unordered_map<REG, BlockInfo> blockInfo;
+    unsigned int nextId;
+
+    /**
+     * @brief Write the vector of the current interval
+     */
+    void sample();
+
+    public:
+    /**
+     * @brief Construct a new BBVProfiler object
+     * 
+     * @param cpu CPU to profile
+     * @param filename .bb file to write
+     * @param interval instructions per interval
+     */
+    BBVProfiler(RVCPU * cpu, std::string filename, uint64_t interval);
+
+    /**
+     * @brief Get number of instructions left in the current interval
+     */
+    uint64_t untilSample();
+
+    /**
+     * @brief Write a vector if the current interval is complete
+     */
+    void update();
+
+    /**
+     * @brief Write the vector of the last (partial) interval
+     */
+    void finish();
+
+    /**
+     * @brief Get number of intervals written
+     */
+    uint64_t getIntervalCount();
+};
+
+#endif // __BBVPROFILER_H__
@@ -0,0 +1,99 @@
+#ifndef __BATCHRUNNER_H__
+#define __BATCHRUNNER_H__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "RVdefs.h"
+
+/**
+ * @brief Runs many ELF files in parallel within one process
+ * Every file gets its own Simulator, so simulations share nothing.
+ * Files are run on a work stealing thread pool & the results are printed as
+ * one summary.
+ * 
+ */
+class BatchRunner
+{
+    private:
+    /**
+     * @brief Result of one simulation
+     */
+    struct Result
+    {
+        std::string error;      // empty if the simulation ran
+        bool halted;
+        int64_t exit_status;    // a0 at ecall
+        uint64_t instret;
+        double wall_time;
+        long mismatch;          // first mismatching signature line, -1 if none
+    };
+
+    ISAdef isa;
+
+    /**
+     * @brief Memory size & instruction budget of each simulation
+     */
+    uint64_t memSize;
+    unsigned long int maxitr;
+
+    /**
+     * @brief Number of worker threads (0: number of CPUs)
+     */
+    unsigned int jobs;
+
+    /**
+     * @brief Directory signatures are written to (empty: not written)
+     */
+    std::string signatureDir;
+
+    /**
+     * @brief Simulate one ELF file (on a worker thread)
+     * 
+     * @param elf ELF file
+     * @param reference reference signature file (empty: pass/fail by exit
+     * status)
+     */
+    Result runOne(const std::string &elf, const std::string &reference);
+
+    public:
+    /**
+     * @brief Construct a new BatchRunner object
+     * 
+     * @param isa ISA of the simulated CPUs
+     * @param mem_size memory size of each simulation
+     * @param maxitr instruction budget of each simulation
+     * @param jobs number of worker threads (0: number of CPUs)
+     */
+    BatchRunner(ISAdef isa, uint64_t mem_size, unsigned long int maxitr, unsigned int jobs);
+
+    /**
+     * @brief Write the signature of every simulation to a directory
+     */
+    void setSignatureDir(const std::string &dir);
+
+    /**
+     * @brief Run all files & print a summary
+     * Simulations with a reference signature pass if they halt & their
+     * signature matches, others if they end with ecall & a0 == 0.
+     * 
+     * @param elfs ELF files
+     * @param references reference signature file of each ELF file (optional)
+     * @return unsigned int number of failed simulations
+     */
+    unsigned int run(const std::vector<std::string> &elfs, const std::vector<std::string> &references = std::vector<std::string>());
+
+    /**
+     * @brief Find compliance tests: ELF files under a directory that have a
+     * reference signature (<name>.reference_output next to the ELF file or in
+     * a references directory beside or above it)
+     * 
+     * @param dir directory searched recursively
+     * @param elfs ELF files found
+     * @param references reference signature of each ELF file
+     */
+    static void findTests(const std::string &dir, std::vector<std::string> &elfs, std::vector<std::string> &references);
+};
+
+#endif // __BATCHRUNNER_H__
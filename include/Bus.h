@@ -1,5 +1,8 @@
 #ifndef __BUS_H__
 #define __BUS_H__
+#include <stdint.h>
+
+class Memory;
 
 /**
  * @brief Struct that models a system bus
@@ -9,7 +12,29 @@
 template <class T>
 struct Bus
 {
+    /**
+     * @brief Memory attached to the bus
+     */
+    Memory * mem;
+
+    /**
+     * @brief Construct a new Bus object
+     * 
+     * @param memory memory attached to the bus
+     */
+    Bus(Memory * memory);
+
     T request(T address, T data, int sel, bool write);
+
+    /**
+     * @brief Get host memory backing a page
+     * 
+     * @param page page address
+     * @param page_size page size in bytes
+     * @return uint8_t* host pointer to the page, NULL if the page is not
+     * entirely plain memory
+     */
+    uint8_t * hostPage(T page, unsigned int page_size);
 };
 
-#endif // __BUS_H__
\ No newline at end of file
+#endif // __BUS_H__
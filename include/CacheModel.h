@@ -0,0 +1,64 @@
+#ifndef __CACHEMODEL_H__
+#define __CACHEMODEL_H__
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @brief Tag-only set associative cache model
+ * Models hits & misses of a cache with LRU replacement, no data is stored.
+ * 
+ */
+class CacheModel
+{
+    private:
+    /**
+     * @brief Cache geometry
+     */
+    unsigned int nSets;
+    unsigned int nWays;
+    unsigned int lineShift;
+
+    /**
+     * @brief Tags & LRU stamps for each line (nSets * nWays entries)
+     */
+    std::vector<uint64_t> tags;
+    std::vector<uint64_t> stamps;
+
+    /**
+     * @brief Monotonic counter used to generate LRU stamps
+     */
+    uint64_t clock;
+
+    public:
+    /**
+     * @brief Access statistics
+     */
+    uint64_t accesses;
+    uint64_t misses;
+
+    /**
+     * @brief Construct a new CacheModel object
+     * 
+     * @param size_bytes cache capacity in bytes
+     * @param ways associativity
+     * @param line_bytes line size in bytes (power of 2)
+     */
+    CacheModel(unsigned int size_bytes = 32*1024, unsigned int ways = 4, unsigned int line_bytes = 64);
+
+    /**
+     * @brief Access an address
+     * 
+     * @param addr address
+     * @return true if access hits
+     * @return false if access misses (the line is allocated)
+     */
+    bool access(uint64_t addr);
+
+    /**
+     * @brief Invalidate all lines & clear statistics
+     */
+    void reset();
+};
+
+#endif // __CACHEMODEL_H__
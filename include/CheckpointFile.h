@@ -0,0 +1,122 @@
+#ifndef __CHECKPOINTFILE_H__
+#define __CHECKPOINTFILE_H__
+
+#include <string>
+#include <vector>
+
+#include "RVdefs.h"
+#include "RVCPU.h"
+#include "Memory.h"
+
+/**
+ * @brief Simulator checkpoint file
+ * Layout: header with the CPU state, memory segments, index of stored page
+ * numbers, then page aligned page contents in index order. Sparse files
+ * only store non-zero pages. Restore maps runs of stored pages copy-on-write
+ * over memory, so it takes time proportional to the number of runs rather
+ * than the size of memory.
+ * 
+ */
+class CheckpointFile
+{
+    private:
+    /**
+     * @brief File header
+     */
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t xlen;
+        uint32_t page_size;
+        uint32_t nsegments;
+        uint64_t mem_size;
+        uint64_t npages;                    // pages stored
+        uint64_t index_offset;              // stored page numbers (uint64_t each)
+        uint64_t data_offset;               // page contents (page aligned)
+
+        // CPU state
+        uint64_t pc;
+        uint64_t x[32];
+        uint64_t f[32];
+        uint64_t fcsr;
+        uint64_t halted;
+        uint64_t instret;
+        uint64_t events[HPM_EV_COUNT];
+        uint64_t counter_base[32];
+        uint64_t counter_snap[32];
+        uint64_t mhpmevent[32];
+        uint64_t mcountinhibit;
+        uint64_t dcache_model_enabled;
+
+        // Vector state (vlen is 0 without the V extension)
+        uint64_t vlen;
+        uint64_t vl;
+        uint64_t vtype;
+        uint64_t vstart;
+        uint64_t vcsr;
+        uint8_t v[32 * RVVector::MAX_VLENB];
+
+        // Trap CSRs (TrapCSR) & privilege level
+        uint64_t tcsr[TCSR_COUNT];
+        uint64_t priv;
+    };
+
+    /**
+     * @brief Memory segment record
+     */
+    struct SegmentRecord
+    {
+        uint64_t addr;
+        uint64_t size;
+        uint64_t flags;
+    };
+
+    static const uint32_t VERSION = 5;
+    static const unsigned int PAGE_SIZE = 1 << RVCPU::PAGE_SHIFT;
+
+    std::string filename;
+    int fd;
+    Header header;
+    std::vector<SegmentRecord> segments;
+    std::vector<uint64_t> index;
+
+    public:
+    /**
+     * @brief Save a checkpoint
+     * 
+     * @param filename file name
+     * @param cpu CPU
+     * @param mem memory
+     * @param sparse only store non-zero pages
+     */
+    static void save(std::string filename, RVCPU * cpu, Memory * mem, bool sparse = true);
+
+    /**
+     * @brief Open a checkpoint & read its header
+     * 
+     * @param filename file name
+     */
+    CheckpointFile(std::string filename);
+
+    /**
+     * @brief Destroy the CheckpointFile object
+     * 
+     */
+    ~CheckpointFile();
+
+    /**
+     * @brief Get size of memory the checkpoint was taken with
+     */
+    uint64_t getMemSize();
+
+    /**
+     * @brief Restore memory & CPU state
+     * 
+     * @param cpu CPU
+     * @param mem memory (of getMemSize bytes)
+     */
+    void restore(RVCPU * cpu, Memory * mem);
+};
+
+#endif // __CHECKPOINTFILE_H__
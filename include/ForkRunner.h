@@ -0,0 +1,77 @@
+#ifndef __FORKRUNNER_H__
+#define __FORKRUNNER_H__
+
+#include <string>
+#include <vector>
+
+#include "RVdefs.h"
+#include "RVCPU.h"
+#include "Memory.h"
+
+/**
+ * @brief Runs many tests from one warmed up simulator state
+ * One child process is forked per test input. Children share guest memory
+ * & the decode cache with the parent copy-on-write, load their input and run
+ * to completion, then report results over a pipe.
+ * 
+ */
+class ForkRunner
+{
+    private:
+    /**
+     * @brief Result reported by a child
+     */
+    struct Result
+    {
+        int64_t exit_status;    // a0 at ecall
+        uint64_t halted;
+        uint64_t instret;       // instructions executed by the test
+        double wall_time;
+        char error[64];         // empty if the test ran
+    };
+
+    RVCPU * cpu;
+    Memory * mem;
+
+    /**
+     * @brief Address test inputs are loaded at
+     */
+    REG inputAddr;
+
+    /**
+     * @brief Instruction budget of each test
+     */
+    unsigned long int maxitr;
+
+    /**
+     * @brief Maximum number of children running at once
+     */
+    unsigned int jobs;
+
+    /**
+     * @brief Load an input & run the test (in the child)
+     */
+    Result runTest(const std::string &input);
+
+    public:
+    /**
+     * @brief Construct a new ForkRunner object
+     * 
+     * @param cpu CPU stopped at the fork point
+     * @param mem memory
+     * @param input_addr address test inputs are loaded at
+     * @param maxitr instruction budget of each test
+     * @param jobs maximum number of children running at once (0: number of CPUs)
+     */
+    ForkRunner(RVCPU * cpu, Memory * mem, REG input_addr, unsigned long int maxitr, unsigned int jobs);
+
+    /**
+     * @brief Run all tests & print a summary
+     * 
+     * @param inputs test input files
+     * @return unsigned int number of failed tests
+     */
+    unsigned int run(const std::vector<std::string> &inputs);
+};
+
+#endif // __FORKRUNNER_H__
@@ -0,0 +1,176 @@
+#ifndef __GDBSTUB_H__
+#define __GDBSTUB_H__
+
+#include <string>
+#include <unordered_set>
+
+#include "RVdefs.h"
+#include "RVCPU.h"
+#include "Memory.h"
+#include "History.h"
+
+/**
+ * @brief GDB remote serial protocol server
+ * Serves a single debugger connection over a TCP or unix domain socket.
+ * 
+ */
+class GDBStub
+{
+    private:
+    /**
+     * @brief Maximum packet size advertised to the debugger
+     */
+    static const unsigned int PACKET_SIZE = 0x20000;
+
+    /**
+     * @brief Instructions executed between checks for a debugger interrupt
+     * while continuing
+     */
+    static const unsigned long int CONTINUE_CHUNK = 1 << 20;
+
+    /**
+     * @brief Simulated system
+     */
+    RVCPU * cpu;
+    Memory * mem;
+    History * history;
+
+    /**
+     * @brief Sockets
+     */
+    int listenFd;
+    int connFd;
+    std::string unixPath;
+
+    /**
+     * @brief Buffered input from the debugger
+     */
+    std::string rxBuf;
+    size_t rxPos;
+
+    /**
+     * @brief Protocol state
+     */
+    bool noAck;
+    bool interrupted;
+    bool memDirty;
+    bool done;
+
+    /**
+     * @brief Breakpoints inserted by the debugger
+     */
+    std::unordered_set<REG> swBreakpoints;
+    std::unordered_set<REG> hwBreakpoints;
+
+    /**
+     * @brief Receive more data from the debugger
+     * 
+     * @param block wait for data
+     * @return false if connection was closed (or no data when not blocking)
+     */
+    bool receive(bool block);
+
+    /**
+     * @brief Read a byte from the debugger
+     */
+    bool readByte(char &c);
+
+    /**
+     * @brief Receive a packet
+     * 
+     * @param pkt packet contents
+     * @return false if connection was closed
+     */
+    bool getPacket(std::string &pkt);
+
+    /**
+     * @brief Send a packet
+     * 
+     * @param pkt packet contents
+     */
+    void putPacket(const std::string &pkt);
+
+    /**
+     * @brief Handle a packet
+     * 
+     * @param pkt packet contents
+     * @return std::string reply
+     */
+    std::string handle(const std::string &pkt);
+
+    /**
+     * @brief Resume execution & wait for the CPU to stop
+     * 
+     * @param step execute a single instruction
+     * @return std::string stop reply
+     */
+    std::string resume(bool step);
+
+    /**
+     * @brief Execute backwards (bs/bc packets)
+     * 
+     * @param step go back a single instruction
+     * @return std::string stop reply
+     */
+    std::string reverse(bool step);
+
+    /**
+     * @brief Check if the debugger sent an interrupt (^C)
+     */
+    bool pollInterrupt();
+
+    /**
+     * @brief Build the stop reply for the current CPU state
+     */
+    std::string stopReply();
+
+    /**
+     * @brief Register & memory access packets
+     */
+    std::string readRegisters();
+    std::string writeRegisters(const std::string &hex);
+    std::string readMemory(uint64_t addr, uint64_t len);
+    std::string writeMemory(uint64_t addr, const std::string &data, uint64_t len, bool binary);
+
+    /**
+     * @brief Insert/Remove breakpoints & watchpoints (Z/z packets)
+     */
+    std::string breakpoint(const std::string &pkt, bool insert);
+
+    /**
+     * @brief Target description for qXfer:features:read
+     */
+    std::string targetXML();
+
+    public:
+    /**
+     * @brief Construct a new GDBStub object
+     * 
+     * @param cpu CPU to debug
+     * @param mem memory of the simulated system
+     * @param history execution history for reverse execution (optional)
+     */
+    GDBStub(RVCPU * cpu, Memory * mem, History * history = NULL);
+
+    /**
+     * @brief Destroy the GDBStub object
+     * 
+     */
+    ~GDBStub();
+
+    /**
+     * @brief Listen for a debugger connection
+     * 
+     * @param endpoint TCP port number (loopback), or "unix:<path>"
+     * @return true if listening
+     */
+    bool listen(std::string endpoint);
+
+    /**
+     * @brief Accept a connection & serve it until the debugger detaches or
+     * kills the target
+     */
+    void serve();
+};
+
+#endif // __GDBSTUB_H__
@@ -0,0 +1,98 @@
+#ifndef __HARTGROUP_H__
+#define __HARTGROUP_H__
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <stdint.h>
+
+#include "RVdefs.h"
+#include "RVCPU.h"
+
+/**
+ * @brief Runs harts sharing one memory, each on its own host thread
+ * Harts run independently for a quantum of instructions, then wait for each
+ * other at a barrier. In deterministic mode the harts instead run their
+ * quanta one after another in hart order on the calling thread, so runs are
+ * reproducible.
+ * 
+ */
+class HartGroup
+{
+    private:
+    /**
+     * @brief Barrier polls before yielding the host CPU (no polling if there
+     * are more harts than host CPUs)
+     */
+    static const unsigned int SPIN_LIMIT = 1024;
+    unsigned int spinLimit;
+
+    std::vector<RVCPU *> harts;
+
+    /**
+     * @brief Instructions each hart runs between synchronizations
+     */
+    uint64_t quantum;
+    bool deterministic;
+
+    /**
+     * @brief Barrier state: harts arrived in the current epoch & the epoch
+     * number, advanced by the last hart to arrive
+     */
+    std::atomic<unsigned int> arrived;
+    std::atomic<uint64_t> epoch;
+
+    /**
+     * @brief Instruction budget of each hart & instructions run so far
+     * (equal for all harts at a barrier)
+     */
+    uint64_t budget;
+    uint64_t done;
+
+    /**
+     * @brief Set at a barrier when the run ends
+     */
+    bool finished;
+
+    /**
+     * @brief Harts stopped by a fatal error & its message, reported on the
+     * calling thread once all harts stopped
+     */
+    std::vector<uint8_t> failed;
+    std::vector<std::string> errors;
+
+    /**
+     * @brief Wait until all harts have finished the current quantum
+     */
+    void barrier();
+
+    /**
+     * @brief Decide whether the run ends after the current quantum
+     */
+    bool isFinished();
+
+    /**
+     * @brief Thread body of a hart
+     */
+    void worker(unsigned int idx);
+
+    public:
+    /**
+     * @brief Construct a new HartGroup object
+     * 
+     * @param harts harts sharing memory, hart 0 first
+     * @param quantum instructions each hart runs between synchronizations
+     * @param deterministic run harts in turn on the calling thread
+     */
+    HartGroup(const std::vector<RVCPU *> &harts, uint64_t quantum, bool deterministic);
+
+    /**
+     * @brief Run until hart 0 halts, all harts halt, or every hart ran
+     * ticks instructions
+     * 
+     * @param ticks instruction budget of each hart
+     */
+    void run(uint64_t ticks);
+};
+
+#endif // __HARTGROUP_H__
@@ -0,0 +1,168 @@
+#ifndef __HISTORY_H__
+#define __HISTORY_H__
+
+#include <deque>
+#include <vector>
+#include <unordered_set>
+
+#include "RVdefs.h"
+#include "Bus.h"
+#include "RVCPU.h"
+
+/**
+ * @brief Execution history for reverse debugging
+ * A checkpoint of the CPU state is taken every interval instructions. Pages
+ * are copied before their first write after a checkpoint, so rewinding to a
+ * checkpoint undoes the writes of it & all newer checkpoints. Earlier points
+ * in time are reached by replaying forward from the nearest checkpoint.
+ * Oldest checkpoints are evicted to keep memory use within a budget.
+ * 
+ */
+class History
+{
+    private:
+    /**
+     * @brief Contents of a page before it was first written
+     */
+    struct PageImage
+    {
+        REG page;
+        std::vector<uint8_t> data;
+    };
+
+    /**
+     * @brief Checkpoint & pages written until the next checkpoint
+     */
+    struct Checkpoint
+    {
+        CPUSnapshot cpu;
+        std::vector<PageImage> pages;
+    };
+
+    RVCPU * cpu;
+    Bus<REG> * bus;
+
+    /**
+     * @brief Instructions between checkpoints
+     */
+    uint64_t interval;
+
+    /**
+     * @brief Memory budget & current usage in bytes
+     */
+    uint64_t budget;
+    uint64_t bytes;
+
+    /**
+     * @brief Checkpoints, oldest first
+     */
+    std::deque<Checkpoint> checkpoints;
+
+    /**
+     * @brief Pages copied since the newest checkpoint
+     */
+    std::unordered_set<REG> saved;
+
+    /**
+     * @brief Instruction count at which the next checkpoint is due
+     */
+    uint64_t nextAt;
+
+    /**
+     * @brief Last stop found by replay
+     */
+    StopReason stopReason;
+    Watchpoint stopWatch;
+
+    /**
+     * @brief Rewind to a checkpoint, discarding newer ones
+     */
+    void restore(size_t idx);
+
+    /**
+     * @brief Execute until target instructions have retired
+     * 
+     * @param target instruction count
+     * @param last_stop set to the instruction count of the last breakpoint or
+     * watchpoint stop before target (unchanged if none)
+     * @return true if a stop was found
+     */
+    bool replay(uint64_t target, uint64_t * last_stop = NULL);
+
+    /**
+     * @brief Find newest checkpoint taken before an instruction count
+     * 
+     * @return int index, -1 if none
+     */
+    int findCheckpoint(uint64_t instret, bool inclusive);
+
+    /**
+     * @brief Drop oldest checkpoints until within budget
+     */
+    void evict();
+
+    public:
+    /**
+     * @brief Construct a new History object & attach it to the CPU
+     * 
+     * @param cpu CPU
+     * @param bus bus giving access to memory pages
+     * @param interval instructions between checkpoints
+     * @param budget memory budget in bytes
+     */
+    History(RVCPU * cpu, Bus<REG> * bus, uint64_t interval, uint64_t budget);
+
+    /**
+     * @brief Destroy the History object & detach it from the CPU
+     * 
+     */
+    ~History();
+
+    /**
+     * @brief Check if a checkpoint is due
+     */
+    inline bool due(uint64_t instret) { return instret >= nextAt; }
+
+    /**
+     * @brief Take a checkpoint
+     */
+    void checkpoint();
+
+    /**
+     * @brief Check if a page has been copied since the newest checkpoint
+     */
+    inline bool isSaved(REG page) { return saved.count(page) != 0; }
+
+    /**
+     * @brief Copy a page before it is written (once per checkpoint)
+     */
+    void saveBeforeWrite(REG page);
+
+    /**
+     * @brief Discard all history & start over from the current state
+     * (call after state is modified outside of execution)
+     */
+    void rebase();
+
+    /**
+     * @brief Go back one instruction
+     * 
+     * @return false if already at the oldest checkpoint
+     */
+    bool reverseStep();
+
+    /**
+     * @brief Go back to the most recent breakpoint or watchpoint stop
+     * 
+     * @return false if none was found, the CPU is left at the oldest checkpoint
+     */
+    bool reverseContinue();
+
+    /**
+     * @brief Get number of checkpoints & memory used
+     */
+    size_t getCheckpointCount();
+    uint64_t getBytes();
+};
+
+#endif // __HISTORY_H__
@@ -2,6 +2,7 @@
 #define __MEMORY_H__
 #include <stdint.h>
 #include <string>
+#include <istream>
 #include <vector>
 
 /**
@@ -24,6 +25,23 @@ class Memory
 	 */
 	uint64_t size;
 
+	/**
+	 * @brief Segment loaded from an elf file
+	 * 
+	 */
+	struct Segment
+	{
+		uint64_t addr;
+		uint64_t size;
+		int flags;
+	};
+
+	/**
+	 * @brief Segments loaded by initFromElf
+	 * 
+	 */
+	std::vector<Segment> segments;
+
 
 	/**
 	 * @brief Construct a new Memory object
@@ -47,6 +65,25 @@ class Memory
 	 */
 	bool isValidAddress(uint64_t addr);
 
+	/**
+	 * @brief Count host pages of the memory array that have been touched
+	 * 
+	 * @return uint64_t number of resident pages
+	 */
+	uint64_t pagesTouched();
+
+	/**
+	 * @brief Map part of a file copy-on-write over memory
+	 * Falls back to reading the file if the range is not host page aligned.
+	 * 
+	 * @param fd file descriptor
+	 * @param offset file offset
+	 * @param addr memory address
+	 * @param len length in bytes
+	 * @return true if successful
+	 */
+	bool mapFile(int fd, uint64_t offset, uint64_t addr, uint64_t len);
+
 	/**
 	 * @brief Fetch an 8-bit byte from memory
 	 * 
@@ -71,6 +108,16 @@ class Memory
 	 * @param flags_signatures allowed flag signatures
 	 */
 	unsigned int initFromElf(std::string ifile, std::vector<int> flags_signatures);
+
+	/**
+	 * @brief Initialize memory from an elf image read from a stream
+	 * only sections that match flag signatures are loaded
+	 * 
+	 * @param stream elf image
+	 * @param flags_signatures allowed flag signatures
+	 * @param name name of the image used in error messages
+	 */
+	unsigned int initFromElf(std::istream &stream, std::vector<int> flags_signatures, std::string name);
 };
 
 #endif // __MEMORY_H__
\ No newline at end of file
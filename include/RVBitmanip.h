@@ -0,0 +1,55 @@
+#ifndef __RVBITMANIP_H__
+#define __RVBITMANIP_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Host support for the bit manipulation extensions (Zbb & Zbc)
+ * Counting & carry-less multiply go through function pointers selected once
+ * at startup from the host CPU features: lzcnt/tzcnt/popcnt & PCLMULQDQ on
+ * x86-64, portable code otherwise. Byte swaps use __builtin_bswap, which is
+ * a single instruction on every host.
+ * 
+ */
+namespace RVBitmanip
+{
+    /**
+     * @brief Host CPU features used
+     */
+    struct HostFeatures
+    {
+        bool lzcnt;
+        bool tzcnt;     // BMI1
+        bool popcnt;
+        bool pclmul;
+    };
+
+    /**
+     * @brief Get features of the host CPU (detected at startup)
+     */
+    const HostFeatures & hostFeatures();
+
+    /**
+     * @brief Count leading/trailing zeros (64 for 0) & set bits
+     */
+    extern unsigned int (*clz64)(uint64_t x);
+    extern unsigned int (*ctz64)(uint64_t x);
+    extern unsigned int (*cpop64)(uint64_t x);
+
+    /**
+     * @brief Carry-less multiply
+     * 
+     * @param a, b operands
+     * @param hi high half of the 128-bit product
+     * @return uint64_t low half of the product
+     */
+    extern uint64_t (*clmul64)(uint64_t a, uint64_t b, uint64_t &hi);
+
+    /**
+     * @brief Use the portable implementations whatever the host supports, to
+     * check them against the host ones
+     */
+    void usePortable();
+};
+
+#endif // __RVBITMANIP_H__
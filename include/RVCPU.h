@@ -1,11 +1,142 @@
 #ifndef __RVCPU_H__
 #define __RVCPU_H__
 
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "RVdefs.h"
 #include "Bus.h"
+#include "CacheModel.h"
+#include "TLB.h"
+#include "RVVector.h"
+
+class RVCPU;
+class History;
+class BBVProfiler;
+
+/**
+ * @brief Predecoded instruction
+ * Instructions are decoded once into this form, execution only calls the
+ * handler with the pre-extracted operands.
+ */
+struct DecodedInstr
+{
+    void (*exec)(RVCPU &cpu, const DecodedInstr &instr);    // execution handler
+    REG pc;             // instruction address
+    REGS imm;           // immediate (csr address for csr instructions)
+    uint32_t raw;       // raw instruction
+    uint8_t rd;         // destination register (write sink if x0)
+    uint8_t rs1;
+    uint8_t rs2;
+    uint8_t evclass;    // HPM event class
+    uint8_t len;        // instruction length in bytes (2 if compressed)
+    uint16_t parcel;    // compressed encoding raw was expanded from
+};
+
+/**
+ * @brief Block of predecoded instructions
+ * A straight line sequence of instructions that ends in a control transfer
+ * or system instruction. Events are counted once per block execution & only
+ * expanded into per event totals when a counter is read. Blocks are looked
+ * up by physical address & only reused while their virtual address maps to
+ * the same physical pages.
+ */
+struct DecodedBlock
+{
+    static const uint64_t NO_TAIL = ~(uint64_t)0;
+    static const uint64_t TAIL_FAULT = ~(uint64_t)1;
+
+    REG start_pc;
+    REG end_pc;
+    uint64_t start_pa;                      // physical address of start_pc
+    uint64_t tail_pa;                       // physical page the last instruction straddles into
+    std::vector<DecodedInstr> instrs;
+    uint64_t exec_count;                    // complete executions of the block
+    uint64_t taken_count;                   // taken branches terminating the block
+    uint32_t static_events[HPM_EV_COUNT];   // instructions of each event class
+};
+
+/**
+ * @brief Reason the CPU stopped at the end of RVCPU::run
+ */
+enum StopReason
+{
+    STOP_NONE = 0,      // instruction budget exhausted
+    STOP_ECALL,         // halted by ecall
+    STOP_EBREAK,        // halted by ebreak
+    STOP_BREAKPOINT,    // reached a debugger breakpoint
+    STOP_WATCHPOINT,    // instruction accesses a watched address
+    STOP_MARKER         // program wrote the marker CSR
+};
+
+/**
+ * @brief Accesses matched by a watchpoint
+ */
+enum WatchType
+{
+    WATCH_READ = 1,
+    WATCH_WRITE = 2,
+    WATCH_ACCESS = WATCH_READ | WATCH_WRITE
+};
+
+/**
+ * @brief Data watchpoint
+ */
+struct Watchpoint
+{
+    REG addr;
+    REG len;
+    int type;           // WatchType
+};
+
+/**
+ * @brief Architectural & counter state of the CPU
+ * Restoring a snapshot makes execution continue exactly as it did after the
+ * snapshot was taken.
+ */
+struct CPUSnapshot
+{
+    REG PC;
+    REG X[32];
+    uint64_t F[32];
+    uint32_t fcsr;
+    uint8_t V[32 * RVVector::MAX_VLENB];
+    REG vl;
+    REG vtype;
+    REG vstart;
+    uint32_t vcsr;
+    bool halted;
+    uint64_t instret;
+    uint64_t events[HPM_EV_COUNT];      // event totals
+    uint64_t counterBase[32];
+    uint64_t counterSnap[32];
+    REG mhpmevent[32];
+    REG mcountinhibit;
+    REG tcsr[TCSR_COUNT];
+    unsigned int priv;
+    bool dcacheModelEnabled;
+    CacheModel dcache;
+};
+
+/**
+ * @brief Simulation statistics collected by the CPU
+ */
+struct CPUStats
+{
+    uint64_t blockHits;                 // block lookups served from the decode cache
+    uint64_t blockMisses;               // blocks decoded
+    uint64_t cacheFlushes;              // decode cache flushes
+    uint64_t pageWalks;                 // page table walks (TLB misses)
+    uint64_t traps[CAUSE_COUNT];        // exceptions raised, by cause
+};
 
 class RVCPU
 {
+    friend struct RVExec;
+    friend class History;
+    friend class BBVProfiler;
+
     private:
     /**
      * @brief ISA definition for the CPU
@@ -17,18 +148,39 @@ class RVCPU
      */
     unsigned int nRegs;
 
+    /**
+     * @brief Hart id (mhartid)
+     */
+    unsigned int hartId;
+
     /**
      * @brief Reset address for the program counter
      */
     REG PC_RESET_ADDR = 0x00000000;
 
+    /**
+     * @brief Register index that absorbs writes to x0
+     */
+    static const unsigned int REG_SINK = 32;
+
     /**
      * @brief Struct defining architectural state of the processor
      */
     struct RVState
     {
         REG PC;
-        REG X[XLEN];
+        REG X[32 + 1];  // x0-x31 & write sink
+        uint64_t F[32]; // f0-f31, single precision values NaN-boxed
+        uint32_t fflags;
+        uint32_t frm;
+        uint8_t V[32 * RVVector::MAX_VLENB];   // v0-v31, register n at n * vlenb
+        REG vl;
+        REG vtype;
+        REG vstart;
+        uint32_t vxrm;
+        uint32_t vxsat;
+        REG tcsr[TCSR_COUNT];   // trap CSRs (TrapCSR)
+        unsigned int priv;      // privilege level (PrivLevel)
     } state;
 
     /**
@@ -37,16 +189,575 @@ class RVCPU
      */
     Bus<REG> * bus;
 
+    /**
+     * @brief Set when the CPU executes ecall/ebreak without a trap handler
+     */
+    bool halted;
+
+    /**
+     * @brief Reason the last call to run returned
+     */
+    StopReason stopReason;
+
+    /**
+     * @brief Breakpoint addresses, the handler of a decoded instruction at a
+     * breakpoint is swapped for one that stops the CPU
+     */
+    std::unordered_set<REG> breakpoints;
+
+    /**
+     * @brief Data watchpoints & the kinds of access watched in each page
+     */
+    std::vector<Watchpoint> watchpoints;
+    std::unordered_map<REG, int> watchPages;
+
+    /**
+     * @brief Watchpoint that stopped the CPU
+     */
+    Watchpoint watchHit;
+
+    /**
+     * @brief Set while stepping over the instruction the CPU stopped at
+     */
+    bool stopsSuppressed;
+
+    /**
+     * @brief Execution history for reverse debugging (NULL if disabled)
+     */
+    History * history;
+
+    /**
+     * @brief Marker CSR value & whether writing it stops the CPU
+     */
+    REG simMarker;
+    bool markerStop;
+
+    /**
+     * @brief Load reservation (lr/sc)
+     * A store conditional succeeds if memory still holds the value loaded by
+     * the lr, checked with a host compare & swap. Reservations are per hart,
+     * no state is shared between harts.
+     */
+    REG resAddr;
+    uint64_t resValue;
+    unsigned int resSize;
+    bool resValid;
+
+    /**
+     * @brief Simulation statistics
+     */
+    CPUStats stats;
+
+    // ================================ Floating point ===============================
+    /**
+     * @brief Host FPU state while running
+     * The host rounding mode is only switched when an instruction needs a
+     * different one than the last. Exception flags accumulate in the host FPU
+     * & are folded into fflags when fflags/fcsr is accessed or run returns.
+     */
+    unsigned int hostRM;
+    bool fpActive;
+
+    /**
+     * @brief Take over/Give back the host FPU (run entry & exit)
+     */
+    void fpEnter();
+    void fpLeave();
+
+    /**
+     * @brief Fold exceptions raised in the host FPU into fflags
+     */
+    void fpSyncFlags();
+
+    // ==================================== Vector ===================================
+    /**
+     * @brief Vector register length in bytes & configuration decoded from vtype
+     * Registers are vlenb bytes apart, so a register group is one contiguous
+     * array of elements for the kernels.
+     */
+    unsigned int vlenb;
+    unsigned int vsew;      // log2(SEW / 8)
+    int vlmul;              // log2(LMUL), -3 to 3
+    REG vlmax;
+
+    /**
+     * @brief Set vtype (vill if the type is not supported)
+     */
+    void vecSetType(REG vtype);
+
+    /**
+     * @brief Load/Store elements start to end-1 of a register group
+     * Unmasked unit-stride accesses to plain memory are copied a page at a
+     * time, others go element by element through load/store.
+     * 
+     * @param v register group
+     * @param addr address of element 0
+     * @param stride byte stride
+     * @param eew element width in bytes
+     * @param mask mask (NULL if unmasked)
+     */
+    void vecLoad(const DecodedInstr &instr, uint8_t * v, REG addr, REG stride, unsigned int eew,
+        const uint8_t * mask, unsigned int start, unsigned int end);
+    void vecStore(const DecodedInstr &instr, const uint8_t * v, REG addr, REG stride, unsigned int eew,
+        const uint8_t * mask, unsigned int start, unsigned int end);
+
+    // ================================ Decode cache =================================
+    /**
+     * @brief Maximum number of instructions in a block
+     */
+    static const unsigned int MAX_BLOCK_INSTRS = 64;
+
+    /**
+     * @brief Size of the direct mapped block lookup table (power of 2)
+     */
+    static const unsigned int JUMP_CACHE_SIZE = 4096;
+
+    /**
+     * @brief Decoded blocks indexed by start address
+     */
+    std::unordered_map<REG, DecodedBlock> blocks;
+
+    /**
+     * @brief Direct mapped lookup table in front of blocks
+     */
+    DecodedBlock * jumpCache[JUMP_CACHE_SIZE];
+
+    /**
+     * @brief Block being executed
+     */
+    DecodedBlock * curBlock;
+
+    /**
+     * @brief Instruction whose unhandled exception is being reported as a
+     * fatal error, the block is aborted at it before the error leaves run
+     */
+    const DecodedInstr * fatalInstr;
+
+    /**
+     * @brief Set by fence.i, decode cache is flushed after the current block
+     */
+    bool flushPending;
+
+    // ===================================== MMU =====================================
+    /**
+     * @brief Translation contexts: no translation (M-mode or satp bare),
+     * translated S-mode & U-mode accesses
+     * Each context has its own direct mapped TLBs in front of the set
+     * associative translation TLBs, so privilege changes only switch tables.
+     */
+    enum TransContext
+    {
+        CTX_BARE = 0,
+        CTX_S,
+        CTX_U,
+        CTX_COUNT
+    };
+
+    /**
+     * @brief Kinds of access translated
+     */
+    enum AccessType
+    {
+        ACCESS_FETCH,
+        ACCESS_LOAD,
+        ACCESS_STORE        // stores & AMOs
+    };
+
+    /**
+     * @brief Number of entries in the direct mapped data & instruction TLBs
+     * (power of 2)
+     */
+    static const unsigned int DTLB_SIZE = 256;
+    static const unsigned int ITLB_SIZE = 256;
+
+    /**
+     * @brief Tag that never matches an access
+     */
+    static const REG TLB_INVALID = ~(REG)0;
+
+    /**
+     * @brief Data TLB entry mapping a virtual page to host memory
+     * A tag holds the page address if accesses of its kind may take the fast
+     * path, pages that are not plain memory, lack permission or are watched
+     * never match.
+     */
+    struct TLBEntry
+    {
+        REG readTag;
+        REG writeTag;
+        uint8_t * host;
+    };
+    TLBEntry dtlb[CTX_COUNT][DTLB_SIZE];
+
+    /**
+     * @brief Instruction TLB entry mapping an executable virtual page to its
+     * physical page
+     */
+    struct ITLBEntry
+    {
+        REG tag;
+        uint64_t ppage;
+    };
+    ITLBEntry itlb[CTX_COUNT][ITLB_SIZE];
+
+    /**
+     * @brief Contexts of instruction fetches & of loads/stores (differ with
+     * mstatus.MPRV), and their direct mapped TLBs
+     */
+    unsigned int fetchCtx;
+    unsigned int dataCtx;
+    TLBEntry * dtlbCur;
+    ITLBEntry * itlbCur;
+
+    /**
+     * @brief Translations cached across address spaces, tagged with the ASID
+     */
+    TLB itlbPages;
+    TLB dtlbPages;
+
+    /**
+     * @brief Single instruction block raising a fetch fault, for a PC that
+     * has no translation
+     */
+    DecodedBlock faultBlock;
+
+    /**
+     * @brief Select translation contexts after a change of privilege, satp
+     * or mstatus
+     */
+    void updateTranslation();
+
+    /**
+     * @brief Translate a virtual address in a context
+     * Looks up the translation TLBs, walking the page table on a miss.
+     * 
+     * @param va virtual address
+     * @param access access type (AccessType)
+     * @param ctx translation context (not CTX_BARE)
+     * @param pa physical address
+     * @param cause exception cause if the translation fails
+     * @return TLB::Entry* translation, NULL on a fault
+     */
+    TLB::Entry * translate(REG va, int access, unsigned int ctx, uint64_t &pa, unsigned int &cause);
+
+    /**
+     * @brief Walk the page table (Sv32/Sv39) & cache the translation
+     * Page table entries are read & their A/D bits set through host pointers
+     * into memory.
+     * 
+     * @return TLB::Entry* translation, NULL on a fault
+     */
+    TLB::Entry * walk(REG va, int access, unsigned int ctx, unsigned int &cause);
+
+    /**
+     * @brief Check the permissions of a page for an access
+     */
+    bool pagePermitted(uint8_t flags, int access, unsigned int ctx);
+
+    /**
+     * @brief Translate an instruction address & refill its instruction TLB entry
+     * 
+     * @return false if the fetch faults (cause set)
+     */
+    bool translateFetch(REG va, uint64_t &pa, unsigned int &cause);
+
+    /**
+     * @brief Get the physical address of an instruction that can be fetched
+     * 
+     * @return false if the fetch faults (cause set)
+     */
+    bool fetchAddress(REG pc, uint64_t &pa, unsigned int &cause);
+
+    /**
+     * @brief Translate a data address & refill its data TLB entry, raises
+     * page faults & access faults
+     * 
+     * @param type accesses made (WatchType)
+     * @return REG physical address
+     */
+    REG translateData(const DecodedInstr &instr, REG va, unsigned int nbytes, int type);
+
+    /**
+     * @brief Execute sfence.vma
+     */
+    void sfenceVMA(const DecodedInstr &instr);
+
+    /**
+     * @brief Write mstatus fields & legalize them
+     * 
+     * @param mask bits written
+     */
+    void writeStatus(REG value, REG mask);
+
+    // ============================= Performance counters ============================
+    /**
+     * @brief Counter state, value = base + (source - snap) unless inhibited
+     */
+    struct Counter
+    {
+        uint64_t base;
+        uint64_t snap;
+    };
+
+    /**
+     * @brief Instructions retired
+     */
+    uint64_t instret;
+
+    /**
+     * @brief Event totals folded in from flushed blocks & partial executions
+     */
+    uint64_t evFolded[HPM_EV_COUNT];
+
+    /**
+     * @brief Counters indexed by CSR address offset (0: cycle, 2: instret, 3-31: hpm)
+     */
+    Counter counters[32];
+    REG mhpmevent[32];
+    REG mcountinhibit;
+
+    /**
+     * @brief Data cache model (only simulated when an event selects it or
+     * it is forced on)
+     */
+    CacheModel dcache;
+    bool dcacheModelEnabled;
+    bool dcacheModelForced;
+
+    /**
+     * @brief Enable the cache model if forced or selected by an event
+     */
+    void updateCacheModel();
+
+    /**
+     * @brief Get or build the decoded block starting at pc
+     */
+    DecodedBlock * lookupBlock(REG pc);
+
+    /**
+     * @brief Check that the page a block's last instruction straddles into
+     * still maps to the same physical page
+     */
+    bool blockTailValid(const DecodedBlock &blk);
+
+    /**
+     * @brief Decode instructions starting at pc into blk
+     * 
+     * @param blk block
+     * @param pc start address
+     * @param pa physical start address
+     * @param max_instrs maximum number of instructions
+     * @param tag_breakpoints swap handlers of instructions at breakpoints
+     */
+    void buildBlock(DecodedBlock &blk, REG pc, uint64_t pa, unsigned int max_instrs = MAX_BLOCK_INSTRS, bool tag_breakpoints = true);
+
+    /**
+     * @brief Make blk a single instruction raising a fetch fault at pc
+     */
+    void buildFaultBlock(DecodedBlock &blk, REG pc, unsigned int cause, bool tag_breakpoints = true);
+
+    /**
+     * @brief Fold block level event counts into totals
+     */
+    void foldBlockEvents(const DecodedBlock &blk);
+
+    /**
+     * @brief Execute the instruction the CPU is stopped at, ignoring
+     * breakpoints & watchpoints
+     */
+    void stepOverStop();
+
+    /**
+     * @brief Find the decoded instruction at pc in a block
+     */
+    DecodedInstr * findDecoded(DecodedBlock &blk, REG pc);
+
+    /**
+     * @brief Check if the ISA includes an extension (InstrExt)
+     */
+    bool hasExtension(uint8_t ext);
+
+    /**
+     * @brief Decode an instruction
+     * 
+     * @return true if instruction terminates a block
+     */
+    bool decode(REG pc, uint32_t raw, DecodedInstr &instr);
+
+    /**
+     * @brief Execute at most limit instructions of a block
+     */
+    void execBlock(DecodedBlock * blk, unsigned long int limit);
+
+    /**
+     * @brief Stop the current block before an instruction
+     * 
+     * @param at instruction to stop at
+     * @param reason stop reason
+     */
+    void abortBlock(const DecodedInstr &at, StopReason reason);
+
+    /**
+     * @brief Abort the executing block at the instruction whose unhandled
+     * exception is being reported as a fatal error
+     */
+    void abortFatal();
+
+    /**
+     * @brief Memory access helpers used by instruction handlers
+     * Accesses within a page mapped by the data TLB go straight to host
+     * memory, others take the slow path through the bus.
+     */
+    REG load(const DecodedInstr &instr, REG addr, unsigned int nbytes);
+    void store(const DecodedInstr &instr, REG addr, REG data, unsigned int nbytes);
+    REG loadSlow(const DecodedInstr &instr, REG addr, unsigned int nbytes);
+    void storeSlow(const DecodedInstr &instr, REG addr, REG data, unsigned int nbytes);
+
+    /**
+     * @brief 64-bit element accesses of vector loads/stores on RV32
+     * Watchpoints & translation are checked for all 8 bytes before any is
+     * accessed, so a fault never leaves half an element transferred.
+     */
+    uint64_t loadElement64(const DecodedInstr &instr, REG addr);
+    void storeElement64(const DecodedInstr &instr, REG addr, uint64_t data);
+    unsigned int translateElement64(const DecodedInstr &instr, REG addr, int type, REG pa[2]);
+
+    /**
+     * @brief Get host memory for an atomic access
+     * Checks alignment & watchpoints, translates the address, and saves the
+     * page for reverse debugging before a write.
+     * 
+     * @param type accesses made (WatchType)
+     * @param pa physical address (set if NULL is returned)
+     * @return uint8_t* host address, NULL if addr is not plain memory
+     */
+    uint8_t * atomicAddress(const DecodedInstr &instr, REG addr, unsigned int nbytes, int type, REG &pa);
+
+    /**
+     * @brief Refill the data TLB entry for the virtual page containing va
+     * 
+     * @param pa physical address va translates to
+     * @param readable/writable accesses permitted by the translation
+     */
+    void fillDTLB(REG va, uint64_t pa, bool readable, bool writable);
+
+    /**
+     * @brief Invalidate all data TLB entries (of every context)
+     */
+    void flushDTLB();
+
+    /**
+     * @brief Invalidate the direct mapped TLBs of the translated contexts
+     */
+    void flushTranslatedTLBs();
+
+    /**
+     * @brief Stop before instr if an access hits a watchpoint
+     */
+    void checkWatchpoints(const DecodedInstr &instr, REG addr, unsigned int nbytes, int type);
+
+    /**
+     * @brief Report an illegal instruction
+     */
+    void illegalInstruction(const DecodedInstr &instr);
+
+    /**
+     * @brief Raise an exception on an instruction
+     * Unwinds out of the executing block to the trap handler, so it never
+     * returns. Without a handler (mtvec is 0) the exception is a fatal error.
+     * 
+     * @param instr instruction raising the exception
+     * @param cause exception cause (TrapCause)
+     * @param tval value for mtval
+     */
+    void raiseException(const DecodedInstr &instr, unsigned int cause, REG tval);
+
+    /**
+     * @brief Take an exception raised by the last instruction of the
+     * executing block (ecall/ebreak), without unwinding
+     * Without a handler (mtvec is 0) the CPU halts.
+     */
+    void takeException(const DecodedInstr &instr, unsigned int cause, REG tval);
+
+    /**
+     * @brief Report an exception raised without a trap handler
+     */
+    void unhandledException(const DecodedInstr &instr, unsigned int cause, REG tval);
+
+    /**
+     * @brief Enter the trap handler for an exception raised at the PC
+     */
+    void enterTrap(unsigned int cause, REG tval);
+
+    /**
+     * @brief Check if an exception is handled by a trap handler (delegated
+     * to S-mode or mtvec set)
+     */
+    bool hasTrapHandler(unsigned int cause);
+
+    /**
+     * @brief Return from a trap handler (mret/sret)
+     * 
+     * @param instr return instruction
+     * @param from privilege level of the handler
+     */
+    void trapReturn(const DecodedInstr &instr, unsigned int from);
+
+    /**
+     * @brief Misaligned bits of instruction addresses (2 byte alignment with C)
+     */
+    REG fetchAlignMask;
+
+    /**
+     * @brief Execute a csr instruction
+     * 
+     * @param instr decoded instruction
+     * @param operand rs1 value or zero extended immediate
+     * @param op 0: write, 1: set bits, 2: clear bits
+     */
+    void csrOp(const DecodedInstr &instr, REG operand, int op);
+
+    /**
+     * @brief Read/Write a CSR
+     * 
+     * @return false if the CSR does not exist
+     */
+    bool csrRead(uint16_t addr, REG &value);
+    bool csrWrite(uint16_t addr, REG value);
+
+    /**
+     * @brief Compute total count of an event
+     */
+    uint64_t eventTotal(unsigned int event);
+
+    /**
+     * @brief Get/Set counter value
+     */
+    uint64_t counterSource(unsigned int idx);
+    uint64_t counterValue(unsigned int idx);
+    void counterSet(unsigned int idx, uint64_t value);
+
+    /**
+     * @brief Remove decoded blocks of modified pages
+     */
+    void invalidateDecodedPages(const std::vector<REG> &pages);
+
     public:
+    /**
+     * @brief Page size used by the data TLB & checkpoints
+     */
+    static const unsigned int PAGE_SHIFT = 12;
+
     /**
      * @brief Construct a new RVCPU object
      * 
      * @param pc_init_address program counter reset address
      * @param ISA_def RISC-V ISA definition
      * @param system_bus bus object pointer
+     * @param hart_id hart id
      */
-    RVCPU(REG pc_init_address, ISAdef ISA_def, Bus<REG> * system_bus);
-    
+    RVCPU(REG pc_init_address, ISAdef ISA_def, Bus<REG> * system_bus, unsigned int hart_id = 0);
+
     /**
      * @brief Get the value of the specified register
      * 
@@ -58,15 +769,145 @@ class RVCPU
     /**
      * @brief Get value of program counter
      * 
-     * @return REG 
+     * @return REG
      */
     REG getPCValue();
 
+    /**
+     * @brief Set the value of the specified register
+     * 
+     * @param reg_no register number
+     * @param value value
+     */
+    void setRegValue(unsigned int reg_no, REG value);
+
+    /**
+     * @brief Set value of program counter
+     * 
+     * @param value address
+     */
+    void setPCValue(REG value);
+
+    /**
+     * @brief Get/Set raw value of a floating point register
+     * 
+     * @param reg_no register number
+     */
+    uint64_t getFRegValue(unsigned int reg_no);
+    void setFRegValue(unsigned int reg_no, uint64_t value);
+
+    /**
+     * @brief Get vector register length in bits (0 without the V extension)
+     */
+    unsigned int getVLEN();
+
+    /**
+     * @brief Check if CPU has halted (ecall/ebreak without a trap handler)
+     */
+    bool isHalted();
+
+    /**
+     * @brief Get reason the last call to run returned
+     */
+    StopReason getStopReason();
+
+    /**
+     * @brief Add/Remove a breakpoint
+     * Execution stops before the instruction at a breakpoint is executed.
+     * 
+     * @param addr address
+     */
+    void setBreakpoint(REG addr);
+    void clearBreakpoint(REG addr);
+
+    /**
+     * @brief Check for a breakpoint at an address
+     */
+    bool hasBreakpoint(REG addr);
+
+    /**
+     * @brief Get breakpoint addresses
+     */
+    const std::unordered_set<REG> & getBreakpoints();
+
+    /**
+     * @brief Add/Remove a data watchpoint
+     * Execution stops before an instruction accessing [addr, addr+len).
+     * 
+     * @param addr start address
+     * @param len length in bytes
+     * @param type accesses to watch (WatchType)
+     */
+    void setWatchpoint(REG addr, REG len, int type);
+    bool clearWatchpoint(REG addr, REG len, int type);
+
+    /**
+     * @brief Get watchpoints
+     */
+    const std::vector<Watchpoint> & getWatchpoints();
+
+    /**
+     * @brief Get the watchpoint that stopped the CPU (STOP_WATCHPOINT)
+     */
+    const Watchpoint & getWatchHit();
+
+    /**
+     * @brief Enable/Disable stopping when the program writes the marker CSR
+     */
+    void setMarkerStop(bool enable);
+
+    /**
+     * @brief Get value last written to the marker CSR
+     */
+    REG getMarker();
+
+    /**
+     * @brief Save/Restore architectural & counter state
+     * Both restart tracking of pages written since the snapshot.
+     */
+    void saveSnapshot(CPUSnapshot &snap);
+    void restoreSnapshot(const CPUSnapshot &snap);
+
+    /**
+     * @brief Attach execution history for reverse debugging (NULL to detach)
+     */
+    void setHistory(History * hist);
+
+    /**
+     * @brief Simulate the data cache model even if no event selects it
+     */
+    void setCacheModelForced(bool enable);
+
+    /**
+     * @brief Get the data cache model
+     */
+    const CacheModel & getDCache();
+
+    /**
+     * @brief Get number of instructions retired since reset
+     */
+    uint64_t getInstret();
+
+    /**
+     * @brief Get simulation statistics
+     */
+    const CPUStats & getStats();
+
+    /**
+     * @brief Get hart id
+     */
+    unsigned int getHartId();
+
     /**
      * @brief Reset CPU
      */
     void reset();
 
+    /**
+     * @brief Discard all decoded blocks (call after modifying code in memory)
+     */
+    void flushDecodeCache();
+
     /**
      * @brief Step CPU by a cycles
      */
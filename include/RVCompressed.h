@@ -0,0 +1,35 @@
+#ifndef __RVCOMPRESSED_H__
+#define __RVCOMPRESSED_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Compressed (C extension) instructions
+ * Every 16-bit instruction is expanded to the 32-bit instruction it stands
+ * for when a block is decoded, so compressed & full instructions share the
+ * decoder & execution handlers and only differ in length.
+ * 
+ */
+namespace RVCompressed
+{
+    /**
+     * @brief Check if an instruction parcel starts a compressed instruction
+     * 
+     * @param parcel first 16 bits of the instruction
+     */
+    inline bool isCompressed(uint32_t parcel)
+    {
+        return (parcel & 0x3) != 0x3;
+    }
+
+    /**
+     * @brief Expand a compressed instruction
+     * 
+     * @param c compressed instruction
+     * @return uint32_t equivalent 32-bit instruction, 0 (illegal) for
+     * reserved encodings
+     */
+    uint32_t expand(uint16_t c);
+};
+
+#endif // __RVCOMPRESSED_H__
@@ -0,0 +1,85 @@
+#ifndef __RVCRYPTO_H__
+#define __RVCRYPTO_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Host support for the scalar cryptography extensions (Zkn & Zks)
+ * RV64 AES instructions go through function pointers selected once at
+ * startup: AES-NI on x86-64 hosts that have it, lookup tables otherwise.
+ * The byte wide RV32 AES & SM4 instructions always use lookup tables, which
+ * combine the S-box with the linear layer that follows it.
+ * 
+ */
+namespace RVCrypto
+{
+    /**
+     * @brief Host CPU features used
+     */
+    struct HostFeatures
+    {
+        bool aesni;
+    };
+
+    /**
+     * @brief Get features of the host CPU (detected at startup)
+     */
+    const HostFeatures & hostFeatures();
+
+    /**
+     * @brief Byte operations, S-box & linear layer
+     */
+    enum ByteOp
+    {
+        AES_ENC,        // forward S-box
+        AES_ENC_MIX,    // forward S-box, MixColumns
+        AES_DEC,        // inverse S-box
+        AES_DEC_MIX,    // inverse S-box, InvMixColumns
+        AES_IMC,        // InvMixColumns only
+        SM4_ED,         // SM4 S-box, round function linear layer L
+        SM4_KS,         // SM4 S-box, key schedule linear layer L'
+        BYTE_OP_COUNT
+    };
+
+    /**
+     * @brief Result of each byte operation for each input byte, as the
+     * column word for an input in byte 0 (rotate by 8*i for byte i)
+     */
+    struct ByteTables
+    {
+        uint32_t t[BYTE_OP_COUNT][256];
+    };
+
+    extern const ByteTables byteTables;
+
+    /**
+     * @brief AES middle/final round without AddRoundKey on the 128-bit state
+     * {hi, lo}, returns the low half of the new state
+     */
+    extern uint64_t (*aes64es)(uint64_t lo, uint64_t hi);   // ShiftRows, SubBytes
+    extern uint64_t (*aes64esm)(uint64_t lo, uint64_t hi);  // ShiftRows, SubBytes, MixColumns
+    extern uint64_t (*aes64ds)(uint64_t lo, uint64_t hi);   // InvShiftRows, InvSubBytes
+    extern uint64_t (*aes64dsm)(uint64_t lo, uint64_t hi);  // InvShiftRows, InvSubBytes, InvMixColumns
+
+    /**
+     * @brief InvMixColumns of two columns
+     */
+    extern uint64_t (*aes64im)(uint64_t x);
+
+    /**
+     * @brief Key schedule step: SubWord of the high word of x, rotated for
+     * rnum 0-9, xor the round constant, returned in both halves
+     * 
+     * @param x previous round key half
+     * @param rnum round number (0-10)
+     */
+    extern uint64_t (*aes64ks1i)(uint64_t x, unsigned int rnum);
+
+    /**
+     * @brief Use the lookup tables whatever the host supports, to check them
+     * against AES-NI
+     */
+    void usePortable();
+};
+
+#endif // __RVCRYPTO_H__
@@ -0,0 +1,64 @@
+#ifndef __RVDISASM_H__
+#define __RVDISASM_H__
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief RISC-V disassembler
+ * Uses the same instruction table as the decoder, so every instruction the
+ * simulator executes can be disassembled.
+ */
+namespace RVDisasm
+{
+    /**
+     * @brief Get ABI name of an integer register
+     * 
+     * @param reg register number
+     * @return const char* ABI name
+     */
+    const char * regName(unsigned int reg);
+
+    /**
+     * @brief Get ABI name of a floating point register
+     * 
+     * @param reg register number
+     * @return const char* ABI name
+     */
+    const char * fregName(unsigned int reg);
+
+    /**
+     * @brief Get name of a vector register
+     * 
+     * @param reg register number
+     * @return const char* name (v0-v31)
+     */
+    const char * vregName(unsigned int reg);
+
+    /**
+     * @brief Format a vtype value as in vsetvli (e.g. "e32, m1, ta, ma")
+     * 
+     * @param vtype vtype value
+     * @return std::string formatted type
+     */
+    std::string vtypeName(uint64_t vtype);
+
+    /**
+     * @brief Get name of a CSR
+     * 
+     * @param addr csr address
+     * @return std::string name, or hex address if unknown
+     */
+    std::string csrName(uint16_t addr);
+
+    /**
+     * @brief Disassemble an instruction
+     * 
+     * @param raw raw instruction (16-bit if compressed)
+     * @param pc instruction address (used to resolve branch & jump targets)
+     * @return std::string disassembly
+     */
+    std::string disassemble(uint32_t raw, uint64_t pc);
+}
+
+#endif // __RVDISASM_H__
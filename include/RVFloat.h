@@ -0,0 +1,120 @@
+#ifndef __RVFLOAT_H__
+#define __RVFLOAT_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <cmath>
+#include <limits>
+
+#include "RVdefs.h"
+
+/**
+ * @brief Host floating point support for the F & D extensions
+ * Instructions run on the host FPU in the guest rounding mode. Exception
+ * flags accumulate in the host FPU & are only read when the guest accesses
+ * fflags. Rounding to nearest with ties to max magnitude (RMM), which the
+ * host does not have, is done in software: the operation is computed in a
+ * wider format with round to odd & then rounded to the target precision,
+ * which gives the exactly rounded result.
+ * 
+ */
+namespace RVFloat
+{
+    /**
+     * @brief Wider host type for the software rounding path (at least 2 more
+     * significand bits than T)
+     */
+    template <typename T> struct Wide;
+    template <> struct Wide<float>  { typedef double type; };
+    template <> struct Wide<double> { typedef long double type; };
+
+    /**
+     * @brief Get exception flags raised in the host FPU (as fflags bits)
+     */
+    uint32_t hostFlags();
+
+    /**
+     * @brief Clear host FPU exception flags
+     */
+    void clearHostFlags();
+
+    /**
+     * @brief Set host FPU rounding mode
+     * 
+     * @param rm RoundingMode (RM_RNE - RM_RUP)
+     */
+    void setHostRounding(unsigned int rm);
+
+    /**
+     * @brief Keep the compiler from moving floating point operations on v
+     * across changes of the host rounding mode or flags
+     */
+    template <typename V>
+    inline void barrier(V &v)
+    {
+        __asm__ __volatile__("" : "+m"(v));
+    }
+
+    /**
+     * @brief Set the lowest significand bit of an inexact result computed
+     * with round towards zero, giving the round to odd result
+     */
+    template <typename W>
+    inline W makeOdd(W w)
+    {
+        uint64_t low;
+        memcpy(&low, &w, sizeof(low));      // little endian: low significand bits first
+        low |= 1;
+        memcpy(&w, &low, sizeof(low));
+        return w;
+    }
+
+    /**
+     * @brief Round a wide value to T, to nearest with ties to max magnitude
+     * The wide value must be exact or rounded to odd with at least 2 more
+     * significand bits than T.
+     * 
+     * @param w value
+     * @param flags fflags raised are or-ed in
+     * @return T rounded value
+     */
+    template <typename T, typename W>
+    T roundMaxMagnitude(W w, uint32_t &flags)
+    {
+        const int digits = std::numeric_limits<T>::digits;
+        const int min_exp = std::numeric_limits<T>::min_exponent;
+
+        if(std::isnan(w) || std::isinf(w) || w == 0)
+            return (T)w;
+
+        bool negative = w < 0;
+        W mag = std::fabs(w);
+        int e;
+        std::frexp(mag, &e);
+
+        // Tininess is detected after rounding, as if the exponent range was
+        // unbounded
+        W scaled = std::ldexp(mag, digits - e);
+        W whole = std::floor(scaled);
+        W unbounded = std::ldexp(whole + (scaled - whole >= 0.5 ? 1 : 0), e - digits);
+        bool tiny = unbounded < (W)std::numeric_limits<T>::min();
+
+        // Subnormal results have fewer significand bits
+        int ulp_exp = e - digits > min_exp - digits ? e - digits : min_exp - digits;
+        scaled = std::ldexp(mag, -ulp_exp);
+        whole = std::floor(scaled);
+        W frac = scaled - whole;
+        W rounded = std::ldexp(whole + (frac >= 0.5 ? 1 : 0), ulp_exp);
+
+        if(rounded > (W)std::numeric_limits<T>::max())
+        {
+            flags |= FFLAG_OF | FFLAG_NX;
+            return negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+        }
+        if(frac != 0)
+            flags |= FFLAG_NX | (tiny ? FFLAG_UF : 0);
+        return (T)(negative ? -rounded : rounded);
+    }
+};
+
+#endif // __RVFLOAT_H__
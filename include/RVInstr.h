@@ -0,0 +1,104 @@
+#ifndef __RVINSTR_H__
+#define __RVINSTR_H__
+
+#include <stdint.h>
+
+class RVCPU;
+struct DecodedInstr;
+
+/**
+ * @brief Instruction formats (determine operand & immediate extraction)
+ */
+enum InstrFormat
+{
+    FMT_R,
+    FMT_I,
+    FMT_IM,     // I-type with memory style operand: imm(rs1)
+    FMT_S,
+    FMT_B,
+    FMT_U,
+    FMT_J,
+    FMT_SHAMT,
+    FMT_CSR,
+    FMT_CSRI,
+    FMT_FENCE,
+    FMT_AMO,    // R-type with address in rs1: rd, rs2, (rs1)
+    FMT_R1,     // R-type with a single source: rd, rs1
+    FMT_RR,     // R-type without a destination: rs1, rs2
+    FMT_R4,     // R-type with a third source (rs3 in bits 31:27)
+    FMT_RBS,    // R-type with a byte select (bits 31:30): rd, rs1, rs2, bs
+    FMT_RNUM,   // round number (bits 23:20): rd, rs1, rnum
+    FMT_VV,     // vector-vector/scalar: vd, vs2, vs1/rs1
+    FMT_VI,     // vector-immediate: vd, vs2, simm5
+    FMT_VIU,    // vector-immediate: vd, vs2, uimm5
+    FMT_VR2,    // single vector source: rd, vs2
+    FMT_VI1,    // immediate only: vd, simm5
+    FMT_VD,     // destination only: vd
+    FMT_VL,     // vector unit-stride access: vd, (rs1)
+    FMT_VLS,    // vector strided access: vd, (rs1), rs2
+    FMT_VSETVLI,    // rd, rs1, vtypei
+    FMT_VSETIVLI,   // rd, uimm5, vtypei
+    FMT_NONE
+};
+
+/**
+ * @brief ISA extension an instruction belongs to
+ */
+enum InstrExt
+{
+    EXT_I = 0,  // base integer ISA
+    EXT_M,
+    EXT_A,
+    EXT_F,
+    EXT_D,
+    EXT_ZBA,    // address generation
+    EXT_ZBB,    // basic bit manipulation
+    EXT_ZBC,    // carry-less multiply
+    EXT_ZBS,    // single bit instructions
+    EXT_V,      // vector
+    EXT_ZKND,   // AES decryption
+    EXT_ZKNE,   // AES encryption
+    EXT_ZKND_ZKNE,  // AES key schedule (either of the two)
+    EXT_ZKNH,   // SHA-2
+    EXT_ZKSED,  // SM4
+    EXT_ZKSH    // SM3
+};
+
+// Instruction flags
+const uint8_t F_TERM    = 0x01;     // Terminates a block
+const uint8_t F_WRD     = 0x02;     // Writes rd
+const uint8_t F_FRD     = 0x04;     // rd is a floating point register
+const uint8_t F_FRS1    = 0x08;     // rs1 is a floating point register
+const uint8_t F_FRS2    = 0x10;     // rs2 (& rs3) are floating point registers
+const uint8_t F_FRS     = F_FRS1 | F_FRS2;
+const uint8_t F_FP      = F_FRD | F_FRS;
+const uint8_t F_VRD     = 0x20;     // rd is a vector register
+const uint8_t F_VRS1    = 0x40;     // rs1 is a vector register
+const uint8_t F_VRS2    = 0x80;     // rs2 is a vector register
+const uint8_t F_VEC     = F_VRD | F_VRS1 | F_VRS2;
+
+/**
+ * @brief Instruction description
+ */
+struct InstrDesc
+{
+    const char * name;
+    uint32_t mask;
+    uint32_t match;
+    InstrFormat fmt;
+    void (*exec)(RVCPU &cpu, const DecodedInstr &instr);
+    uint8_t evclass;
+    uint8_t flags;
+    int xlen;           // 0 if valid for all XLEN
+    uint8_t ext;        // InstrExt
+};
+
+/**
+ * @brief Find description of an instruction
+ * 
+ * @param raw raw instruction
+ * @return const InstrDesc* description, NULL if instruction is unknown
+ */
+const InstrDesc * findInstr(uint32_t raw);
+
+#endif // __RVINSTR_H__
@@ -0,0 +1,147 @@
+#ifndef __RVSIMAPI_H__
+#define __RVSIMAPI_H__
+
+/**
+ * @brief C interface of librvsim
+ * Every simulator owns its memory, bus & CPU. Functions never exit the
+ * process; failures return RVSIM_ERROR & the message is available from
+ * rvsim_error. Different simulators can be used concurrently from different
+ * threads, a single simulator must not. Register & address values are
+ * 64-bit regardless of XLEN.
+ * 
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opaque simulator handle
+ */
+typedef struct rvsim rvsim_t;
+
+/**
+ * @brief Status codes
+ */
+#define RVSIM_OK        0   /* budget used up or stopped */
+#define RVSIM_HALTED    1   /* program ended with ecall/ebreak */
+#define RVSIM_ERROR     -1  /* fatal error, see rvsim_error */
+
+/**
+ * @brief ISA extension flags for rvsim_create
+ */
+#define RVSIM_ISA_E     (1u << 0)
+#define RVSIM_ISA_M     (1u << 1)
+#define RVSIM_ISA_A     (1u << 2)
+#define RVSIM_ISA_F     (1u << 3)
+#define RVSIM_ISA_D     (1u << 4)
+#define RVSIM_ISA_C     (1u << 5)
+#define RVSIM_ISA_ZBA   (1u << 6)
+#define RVSIM_ISA_ZBB   (1u << 7)
+#define RVSIM_ISA_ZBC   (1u << 8)
+#define RVSIM_ISA_ZBS   (1u << 9)
+#define RVSIM_ISA_V     (1u << 10)
+#define RVSIM_VLEN_256  (1u << 11)  /* VLEN of the V extension, 128 bits by default */
+#define RVSIM_VLEN_512  (1u << 12)
+#define RVSIM_ISA_ZKND  (1u << 13)
+#define RVSIM_ISA_ZKNE  (1u << 14)
+#define RVSIM_ISA_ZKNH  (1u << 15)
+#define RVSIM_ISA_ZKSED (1u << 16)
+#define RVSIM_ISA_ZKSH  (1u << 17)
+
+/**
+ * @brief Get XLEN of the library (32 or 64)
+ */
+unsigned int rvsim_xlen(void);
+
+/**
+ * @brief Create a simulator
+ * 
+ * @param isa ISA extensions (RVSIM_ISA_* flags)
+ * @param mem_size memory size in bytes
+ * @return rvsim_t* simulator, NULL if memory can't be allocated
+ */
+rvsim_t * rvsim_create(unsigned int isa, uint64_t mem_size);
+
+/**
+ * @brief Destroy a simulator
+ */
+void rvsim_destroy(rvsim_t * sim);
+
+/**
+ * @brief Load an ELF file & reset the CPU to its entry point
+ * 
+ * @return int RVSIM_OK or RVSIM_ERROR
+ */
+int rvsim_load_elf(rvsim_t * sim, const char * filename);
+
+/**
+ * @brief Load an ELF image from host memory & reset the CPU to its entry point
+ * 
+ * @return int RVSIM_OK or RVSIM_ERROR
+ */
+int rvsim_load_elf_buffer(rvsim_t * sim, const void * data, size_t size);
+
+/**
+ * @brief Run the CPU
+ * After a fatal error the PC & instruction count are left at the faulting
+ * instruction & every run returns RVSIM_ERROR until a program is loaded again.
+ * 
+ * @param budget maximum number of instructions
+ * @return int RVSIM_OK, RVSIM_HALTED or RVSIM_ERROR
+ */
+int rvsim_run(rvsim_t * sim, uint64_t budget);
+
+/**
+ * @brief Get message of the last fatal error ("" if none)
+ */
+const char * rvsim_error(rvsim_t * sim);
+
+/**
+ * @brief Read/Write integer registers (x0-x31) & PC
+ */
+uint64_t rvsim_get_reg(rvsim_t * sim, unsigned int reg);
+void rvsim_set_reg(rvsim_t * sim, unsigned int reg, uint64_t value);
+uint64_t rvsim_get_pc(rvsim_t * sim);
+void rvsim_set_pc(rvsim_t * sim, uint64_t value);
+
+/**
+ * @brief Get number of instructions retired since the program was loaded
+ */
+uint64_t rvsim_instret(rvsim_t * sim);
+
+/**
+ * @brief Get a direct view of guest RAM
+ * The pointer stays valid until the simulator is destroyed; host reads &
+ * writes through it are guest memory accesses without any copy.
+ * 
+ * @param addr guest address
+ * @param len bytes of RAM from addr to the end of memory (optional)
+ * @return uint8_t* host pointer to addr, NULL if addr is outside memory
+ */
+uint8_t * rvsim_memory(rvsim_t * sim, uint64_t addr, uint64_t * len);
+
+/**
+ * @brief Get a region loaded from the ELF file
+ * 
+ * @param index region index
+ * @param addr guest address of the region
+ * @param len size of the region in bytes
+ * @return uint8_t* host pointer to the region, NULL if index is out of range
+ */
+uint8_t * rvsim_region(rvsim_t * sim, unsigned int index, uint64_t * addr, uint64_t * len);
+
+/**
+ * @brief Discard decoded instructions after the host wrote code through a
+ * memory view
+ */
+void rvsim_code_modified(rvsim_t * sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __RVSIMAPI_H__
@@ -0,0 +1,115 @@
+#ifndef __RVVECTOR_H__
+#define __RVVECTOR_H__
+
+#include <stdint.h>
+
+/**
+ * @brief Host kernels of the vector (V) extension
+ * Register groups are contiguous in the vector register file, so kernels see
+ * every operand as an array of SEW-bit elements & process elements start to
+ * end-1. Kernels are instantiated for each operation & SEW; the set matching
+ * the host CPU (AVX2, SSE2 or scalar code) is selected once at startup.
+ * 
+ */
+namespace RVVector
+{
+    /**
+     * @brief Supported VLEN range (bits)
+     */
+    const unsigned int MIN_VLEN = 128;
+    const unsigned int MAX_VLEN = 512;
+    const unsigned int MAX_VLENB = MAX_VLEN / 8;
+
+    /**
+     * @brief Element wise operations: vd = vs2 op (vs1 or scalar)
+     */
+    enum BinaryOp
+    {
+        OP_ADD,
+        OP_SUB,
+        OP_RSUB,        // (vs1 or scalar) - vs2
+        OP_AND,
+        OP_OR,
+        OP_XOR,
+        OP_SLL,
+        OP_SRL,
+        OP_SRA,
+        OP_MINU,
+        OP_MIN,
+        OP_MAXU,
+        OP_MAX,
+        OP_MUL,
+        OP_MULH,
+        OP_MULHU,
+        OP_MULHSU,      // signed vs2, unsigned vs1/scalar
+        BINARY_OP_COUNT
+    };
+
+    /**
+     * @brief Comparisons setting mask bits: vd.mask = vs2 op (vs1 or scalar)
+     */
+    enum CompareOp
+    {
+        CMP_EQ,
+        CMP_NE,
+        CMP_LTU,
+        CMP_LT,
+        CMP_LEU,
+        CMP_LE,
+        CMP_GTU,
+        CMP_GT,
+        COMPARE_OP_COUNT
+    };
+
+    /**
+     * @brief Multiply-add operations (b is vs1 or the scalar)
+     */
+    enum TernaryOp
+    {
+        OP_MACC,        // vd = b * vs2 + vd
+        OP_NMSAC,       // vd = -(b * vs2) + vd
+        OP_MADD,        // vd = b * vd + vs2
+        OP_NMSUB,       // vd = -(b * vd) + vs2
+        TERNARY_OP_COUNT
+    };
+
+    /**
+     * @brief Kernel taking vs1, or x truncated to SEW if vs1 is NULL
+     * Inactive elements (mask bit clear) are left unchanged, mask is NULL
+     * for unmasked instructions.
+     */
+    typedef void (*ElementKernel)(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x,
+        const uint8_t * mask, unsigned int start, unsigned int end);
+
+    /**
+     * @brief Reduction of the active elements of vs2 & init
+     */
+    typedef uint64_t (*ReduceKernel)(const uint8_t * vs2, uint64_t init, const uint8_t * mask, unsigned int start, unsigned int end);
+
+    /**
+     * @brief Kernels for one kind of host, indexed by operation & SEW
+     * (0: 8-bit, 1: 16-bit, 2: 32-bit, 3: 64-bit)
+     */
+    struct Kernels
+    {
+        const char * name;
+        ElementKernel binary[BINARY_OP_COUNT][4];
+        ElementKernel compare[COMPARE_OP_COUNT][4];
+        ElementKernel ternary[TERNARY_OP_COUNT][4];
+        ReduceKernel reduce[BINARY_OP_COUNT][4];    // add, and, or, xor, min & max only
+        ElementKernel merge[4];                     // vd = mask ? (vs1 or x) : vs2, vd = (vs1 or x) if unmasked
+    };
+
+    /**
+     * @brief Kernels selected for the host CPU
+     */
+    extern const Kernels * kernels;
+
+    /**
+     * @brief Use the scalar kernels whatever the host supports, to check them
+     * against the SIMD ones
+     */
+    void usePortable();
+};
+
+#endif // __RVVECTOR_H__
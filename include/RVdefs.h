@@ -1,15 +1,21 @@
 #ifndef __RVDEFS_H__
 #define __RVDEFS_H__
 
+#include <stdint.h>
+
 // Datatype for a register
 #ifdef RV_XLEN_32
     const int XLEN = 32;
     using REG = uint32_t;
     using REGS = int32_t;
+    using DREG = uint64_t;              // Double width (full products)
+    using DREGS = int64_t;
 #else
     const int XLEN = 64;
     using REG = uint64_t;
     using REGS = int64_t;
+    using DREG = unsigned __int128;     // Double width (full products)
+    using DREGS = __int128;
 #endif
 
 // Other data types
@@ -31,6 +37,237 @@ struct ISAdef
     bool ISA_F; // Single Precision Floating point
     bool ISA_D; // Double Precision Floating point
     bool ISA_C; // Compressed
+
+    bool ISA_ZBA;   // Address generation
+    bool ISA_ZBB;   // Basic bit manipulation
+    bool ISA_ZBC;   // Carry-less multiply
+    bool ISA_ZBS;   // Single bit instructions
+
+    bool ISA_ZKND;  // AES decryption
+    bool ISA_ZKNE;  // AES encryption
+    bool ISA_ZKNH;  // SHA-2 hash functions
+    bool ISA_ZKSED; // SM4 block cipher
+    bool ISA_ZKSH;  // SM3 hash function
+
+    bool ISA_V;             // Vector
+    unsigned int VLEN;      // Vector register length in bits (128, 256 or 512)
+};
+
+/**
+ * @brief CSR addresses
+ * 
+ */
+namespace CSR
+{
+    // Floating point control & status
+    const uint16_t FFLAGS           = 0x001;
+    const uint16_t FRM              = 0x002;
+    const uint16_t FCSR             = 0x003;
+
+    // Vector control & status
+    const uint16_t VSTART           = 0x008;
+    const uint16_t VXSAT            = 0x009;
+    const uint16_t VXRM             = 0x00a;
+    const uint16_t VCSR             = 0x00f;
+    const uint16_t VL               = 0xc20;
+    const uint16_t VTYPE            = 0xc21;
+    const uint16_t VLENB            = 0xc22;
+
+    // Supervisor trap setup, handling & protection
+    const uint16_t SSTATUS          = 0x100;    // view of mstatus
+    const uint16_t SIE              = 0x104;    // view of mie
+    const uint16_t STVEC            = 0x105;
+    const uint16_t SCOUNTEREN       = 0x106;
+    const uint16_t SSCRATCH         = 0x140;
+    const uint16_t SEPC             = 0x141;
+    const uint16_t SCAUSE           = 0x142;
+    const uint16_t STVAL            = 0x143;
+    const uint16_t SIP              = 0x144;    // view of mip
+    const uint16_t SATP             = 0x180;
+
+    // Machine information
+    const uint16_t MVENDORID        = 0xf11;
+    const uint16_t MARCHID          = 0xf12;
+    const uint16_t MIMPID           = 0xf13;
+    const uint16_t MHARTID          = 0xf14;
+
+    // Machine trap setup & handling
+    const uint16_t MSTATUS          = 0x300;
+    const uint16_t MISA             = 0x301;
+    const uint16_t MEDELEG          = 0x302;
+    const uint16_t MIDELEG          = 0x303;
+    const uint16_t MIE              = 0x304;
+    const uint16_t MTVEC            = 0x305;
+    const uint16_t MCOUNTEREN       = 0x306;
+    const uint16_t MSTATUSH         = 0x310;    // RV32 only
+    const uint16_t MSCRATCH         = 0x340;
+    const uint16_t MEPC             = 0x341;
+    const uint16_t MCAUSE           = 0x342;
+    const uint16_t MTVAL            = 0x343;
+    const uint16_t MIP              = 0x344;
+
+    // Machine counter setup
+    const uint16_t MCOUNTINHIBIT    = 0x320;
+    const uint16_t MHPMEVENT3       = 0x323;    // mhpmevent3 - mhpmevent31
+    const uint16_t MHPMEVENT31      = 0x33f;
+
+    // Machine counters
+    const uint16_t MCYCLE           = 0xb00;
+    const uint16_t MINSTRET         = 0xb02;
+    const uint16_t MHPMCOUNTER3     = 0xb03;    // mhpmcounter3 - mhpmcounter31
+    const uint16_t MHPMCOUNTER31    = 0xb1f;
+    const uint16_t MCYCLEH          = 0xb80;    // upper halves (RV32 only)
+    const uint16_t MINSTRETH        = 0xb82;
+    const uint16_t MHPMCOUNTER3H    = 0xb83;
+    const uint16_t MHPMCOUNTER31H   = 0xb9f;
+
+    // Unprivileged counters (read-only shadows)
+    const uint16_t CYCLE            = 0xc00;
+    const uint16_t TIME             = 0xc01;
+    const uint16_t INSTRET          = 0xc02;
+    const uint16_t HPMCOUNTER31     = 0xc1f;
+    const uint16_t CYCLEH           = 0xc80;
+    const uint16_t HPMCOUNTER31H    = 0xc9f;
+
+    // Simulator control (custom read/write range)
+    const uint16_t SIMMARKER        = 0x8c0;    // writes can stop the simulation at a marker
+}
+
+/**
+ * @brief Trap CSRs held in the CSR array of the CPU state
+ * 
+ */
+enum TrapCSR
+{
+    TCSR_MSTATUS = 0,
+    TCSR_MIE,
+    TCSR_MTVEC,
+    TCSR_MSCRATCH,
+    TCSR_MEPC,
+    TCSR_MCAUSE,
+    TCSR_MTVAL,
+    TCSR_MIP,
+    TCSR_MEDELEG,
+    TCSR_MIDELEG,
+    TCSR_MCOUNTEREN,
+    TCSR_STVEC,
+    TCSR_SCOUNTEREN,
+    TCSR_SSCRATCH,
+    TCSR_SEPC,
+    TCSR_SCAUSE,
+    TCSR_STVAL,
+    TCSR_SATP,
+    TCSR_COUNT
+};
+
+/**
+ * @brief Privilege levels
+ * 
+ */
+enum PrivLevel
+{
+    PRIV_U = 0,
+    PRIV_S = 1,
+    PRIV_M = 3
+};
+
+/**
+ * @brief mstatus fields (sstatus is a view of the supervisor fields)
+ * 
+ */
+const uint64_t MSTATUS_SIE  = 0x00000002;   // S interrupt enable
+const uint64_t MSTATUS_MIE  = 0x00000008;   // M interrupt enable
+const uint64_t MSTATUS_SPIE = 0x00000020;   // SIE before the trap
+const uint64_t MSTATUS_MPIE = 0x00000080;   // MIE before the trap
+const uint64_t MSTATUS_SPP  = 0x00000100;   // privilege before a trap to S
+const uint64_t MSTATUS_VS   = 0x00000600;   // vector state (off or dirty)
+const uint64_t MSTATUS_MPP  = 0x00001800;   // privilege before a trap to M
+const uint64_t MSTATUS_FS   = 0x00006000;   // floating point state (off or dirty)
+const uint64_t MSTATUS_MPRV = 0x00020000;   // loads & stores use the MPP privilege
+const uint64_t MSTATUS_SUM  = 0x00040000;   // S may access U pages
+const uint64_t MSTATUS_MXR  = 0x00080000;   // executable pages are readable
+const uint64_t MSTATUS_TVM  = 0x00100000;   // trap satp & sfence.vma in S
+const uint64_t MSTATUS_TW   = 0x00200000;   // trap wfi below M
+const uint64_t MSTATUS_TSR  = 0x00400000;   // trap sret in S
+const uint64_t MSTATUS_UXL  = 0x300000000ULL;   // U & S XLEN (RV64 only, fixed to 64)
+const uint64_t MSTATUS_SXL  = 0xc00000000ULL;
+const uint64_t MSTATUS_XL_64 = 0xa00000000ULL;  // UXL = SXL = 2
+
+/**
+ * @brief Page table entry flags
+ * 
+ */
+const uint8_t PTE_V = 0x01;     // valid
+const uint8_t PTE_R = 0x02;     // readable
+const uint8_t PTE_W = 0x04;     // writable
+const uint8_t PTE_X = 0x08;     // executable
+const uint8_t PTE_U = 0x10;     // user page
+const uint8_t PTE_G = 0x20;     // global mapping
+const uint8_t PTE_A = 0x40;     // accessed
+const uint8_t PTE_D = 0x80;     // dirty
+
+/**
+ * @brief Floating point rounding modes (frm & the rm instruction field)
+ * 
+ */
+enum RoundingMode
+{
+    RM_RNE = 0,     // to nearest, ties to even
+    RM_RTZ = 1,     // towards zero
+    RM_RDN = 2,     // down
+    RM_RUP = 3,     // up
+    RM_RMM = 4,     // to nearest, ties to max magnitude
+    RM_DYN = 7      // use frm (rm field only)
+};
+
+/**
+ * @brief Floating point exception flags (fflags)
+ * 
+ */
+const uint32_t FFLAG_NX = 0x01;     // inexact
+const uint32_t FFLAG_UF = 0x02;     // underflow
+const uint32_t FFLAG_OF = 0x04;     // overflow
+const uint32_t FFLAG_DZ = 0x08;     // divide by zero
+const uint32_t FFLAG_NV = 0x10;     // invalid operation
+
+/**
+ * @brief Synchronous exception causes (mcause values)
+ * 
+ */
+enum TrapCause
+{
+    CAUSE_MISALIGNED_FETCH      = 0,
+    CAUSE_FETCH_ACCESS          = 1,
+    CAUSE_ILLEGAL_INSTRUCTION   = 2,
+    CAUSE_BREAKPOINT            = 3,
+    CAUSE_MISALIGNED_LOAD       = 4,
+    CAUSE_LOAD_ACCESS           = 5,
+    CAUSE_MISALIGNED_STORE      = 6,
+    CAUSE_STORE_ACCESS          = 7,
+    CAUSE_USER_ECALL            = 8,
+    CAUSE_SUPERVISOR_ECALL      = 9,
+    CAUSE_MACHINE_ECALL         = 11,
+    CAUSE_FETCH_PAGE_FAULT      = 12,
+    CAUSE_LOAD_PAGE_FAULT       = 13,
+    CAUSE_STORE_PAGE_FAULT      = 15,
+    CAUSE_COUNT                 = 16
+};
+
+/**
+ * @brief Events selectable through the mhpmevent CSRs
+ * 
+ */
+enum HPMEvent
+{
+    HPM_EV_NONE = 0,
+    HPM_EV_LOAD,            // Loads retired
+    HPM_EV_STORE,           // Stores retired
+    HPM_EV_BRANCH,          // Conditional branches retired
+    HPM_EV_BRANCH_TAKEN,    // Conditional branches taken
+    HPM_EV_JUMP,            // Unconditional jumps (jal/jalr) retired
+    HPM_EV_DCACHE_ACCESS,   // Data cache accesses (cache model)
+    HPM_EV_DCACHE_MISS,     // Data cache misses (cache model)
+    HPM_EV_COUNT
 };
 
 #endif // __RVDEFS_H__
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef __SAMPLEDSIM_H__
+#define __SAMPLEDSIM_H__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "RVdefs.h"
+#include "RVCPU.h"
+
+/**
+ * @brief Sampled simulation of SimPoint intervals
+ * Fast-forwards functionally to each simpoint, warms the cache model, then
+ * simulates only the simpoint interval with the cache model enabled. Results
+ * are combined using the simpoint weights.
+ * 
+ */
+class SampledSim
+{
+    private:
+    /**
+     * @brief A simpoint & its measurements
+     */
+    struct SimPoint
+    {
+        uint64_t interval;      // interval index
+        unsigned int id;        // simpoint (cluster) id
+        double weight;
+        bool reached;           // interval was simulated
+        uint64_t instret;       // instructions simulated in the interval
+        uint64_t accesses;      // data cache accesses in the interval
+        uint64_t misses;        // data cache misses in the interval
+    };
+
+    RVCPU * cpu;
+    std::vector<SimPoint> points;
+
+    /**
+     * @brief Instructions per interval
+     */
+    uint64_t interval;
+
+    /**
+     * @brief Instructions of cache warm up before each interval
+     */
+    uint64_t warmup;
+
+    /**
+     * @brief Run exactly n instructions (fewer if the CPU halts)
+     */
+    void runFor(uint64_t n);
+
+    public:
+    /**
+     * @brief Construct a new SampledSim object
+     * 
+     * @param cpu CPU at the start of the program
+     * @param simpoints_file simpoints file ("<interval> <id>" per line)
+     * @param weights_file weights file ("<weight> <id>" per line)
+     * @param interval instructions per interval (as used to collect the
+     * basic block vectors)
+     * @param warmup instructions of cache warm up before each interval
+     */
+    SampledSim(RVCPU * cpu, std::string simpoints_file, std::string weights_file, uint64_t interval, uint64_t warmup);
+
+    /**
+     * @brief Simulate all simpoints & print the weighted results
+     * 
+     * @return unsigned int number of simpoints not reached
+     */
+    unsigned int run();
+};
+
+#endif // __SAMPLEDSIM_H__
@@ -0,0 +1,59 @@
+#ifndef __SIGNATURE_H__
+#define __SIGNATURE_H__
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "Memory.h"
+
+/**
+ * @brief Test signature (riscv-arch-test)
+ * The memory between the begin_signature & end_signature symbols, formatted
+ * as one hex word per line, most significant digit first.
+ * 
+ */
+class Signature
+{
+    private:
+    /**
+     * @brief Signature words, one per line
+     */
+    std::vector<std::string> lines;
+
+    public:
+    /**
+     * @brief Read the signature of a finished simulation
+     * 
+     * @param elf ELF file the symbols are looked up in
+     * @param mem memory of the simulation
+     * @param granularity bytes per line (4 or 8)
+     * @return std::string error, empty on success
+     */
+    std::string read(const std::string &elf, Memory * mem, unsigned int granularity = 4);
+
+    /**
+     * @brief Write the signature to a file
+     * 
+     * @return false if the file can't be written
+     */
+    bool write(const std::string &filename) const;
+
+    /**
+     * @brief Compare against a reference signature (case insensitive)
+     * 
+     * @param reference reference lines
+     * @return long index of the first mismatching line, -1 if equal
+     */
+    long compare(const std::vector<std::string> &reference) const;
+
+    /**
+     * @brief Bytes per line of a reference signature file
+     * 
+     * @param reference reference lines
+     * @return unsigned int 4 or 8
+     */
+    static unsigned int granularityOf(const std::vector<std::string> &reference);
+};
+
+#endif // __SIGNATURE_H__
@@ -4,9 +4,39 @@
 
 namespace SimError
 {
-    // Exit function
+    /**
+     * @brief Exit the simulator
+     * Calls the handler set by setExitHandler, if any, before exiting.
+     * 
+     * @param status exit status
+     */
     void Exit(int status);
 
+    /**
+     * @brief Set function called by Exit to clean up before exiting
+     * 
+     * @param handler exit handler (NULL: none)
+     */
+    void setExitHandler(void (*handler)(int status));
+
+    /**
+     * @brief Fatal error, thrown instead of exiting when enabled by
+     * setThrowOnFatal
+     */
+    struct Fatal
+    {
+        std::string message;
+    };
+
+    /**
+     * @brief Throw Fatal on fatal errors instead of exiting (per thread)
+     * Lets one simulation fail without ending the whole process.
+     * 
+     * @param enable throw instead of exiting
+     * @return bool previous setting
+     */
+    bool setThrowOnFatal(bool enable);
+
     // ================== Color codes for output formatting ====================
     const std::string  COLOR_RESET  = "\033[0m";
     const std::string  COLOR_RED    =  "\033[31m";      
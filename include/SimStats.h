@@ -0,0 +1,48 @@
+#ifndef __SIMSTATS_H__
+#define __SIMSTATS_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "RVCPU.h"
+
+/**
+ * @brief Run statistics exported at the end of a simulation
+ * 
+ */
+struct SimStats
+{
+    std::string input;              // simulated ELF file
+    int exit_status;                // simulator exit status
+    bool halted;                    // CPU reached ecall/ebreak
+    uint64_t instret;               // instructions retired
+    double wall_time;               // host time spent simulating (s)
+    double elf_load_time;           // host time spent loading the ELF (s)
+    uint64_t pages_touched;         // host pages of guest memory touched
+    uint64_t page_size;             // host page size
+    CPUStats cpu;                   // decode cache & trap statistics
+
+    /**
+     * @brief Simulation throughput
+     * 
+     * @return double million instructions per second of host time
+     */
+    double mips() const;
+
+    /**
+     * @brief Write statistics to a file, CSV if the filename ends with
+     * ".csv" and JSON otherwise
+     * 
+     * @param filepath output file
+     */
+    void write(std::string filepath) const;
+
+    /**
+     * @brief Format a one line progress report
+     * 
+     * @return std::string heartbeat line
+     */
+    std::string heartbeat() const;
+};
+
+#endif // __SIMSTATS_H__
@@ -0,0 +1,128 @@
+#ifndef __SIMULATOR_H__
+#define __SIMULATOR_H__
+
+#include <string>
+#include <istream>
+#include <stdint.h>
+
+#include "RVdefs.h"
+#include "Memory.h"
+#include "Bus.h"
+#include "RVCPU.h"
+
+/**
+ * @brief Status returned by Simulator calls
+ */
+enum SimStatus
+{
+    SIM_OK = 0,         // instruction budget used up, or stopped (breakpoint...)
+    SIM_HALTED = 1,     // program ended with ecall/ebreak
+    SIM_ERROR = -1      // fatal error, see Simulator::getError
+};
+
+/**
+ * @brief A complete simulated system (Memory, Bus & RVCPU) for embedding
+ * RVSim in other programs
+ * Simulators share no state, so many of them can run concurrently on
+ * different threads. Fatal errors are returned as SIM_ERROR instead of
+ * ending the process.
+ * 
+ */
+class Simulator
+{
+    private:
+    Memory * mem;
+    Bus<REG> * bus;
+    RVCPU * cpu;
+
+    /**
+     * @brief Message of the last fatal error
+     */
+    std::string error;
+
+    /**
+     * @brief Set by a fatal error while running, run keeps failing until a
+     * program is loaded again
+     */
+    bool failed;
+
+    /**
+     * @brief ELF file loaded last
+     */
+    std::string elfFile;
+
+    /**
+     * @brief Load an ELF image & reset the CPU to its entry point
+     * 
+     * @param stream ELF image
+     * @param name name of the image used in error messages
+     */
+    SimStatus loadStream(std::istream &stream, const std::string &name);
+
+    // Not copyable
+    Simulator(const Simulator &);
+    Simulator & operator=(const Simulator &);
+
+    public:
+    /**
+     * @brief Construct a new Simulator object
+     * 
+     * @param isa ISA of the simulated CPU
+     * @param mem_size memory size in bytes
+     */
+    Simulator(ISAdef isa, uint64_t mem_size);
+
+    /**
+     * @brief Destroy the Simulator object
+     * 
+     */
+    ~Simulator();
+
+    /**
+     * @brief Load all loadable segments of an ELF file & set PC to its entry
+     * point
+     * 
+     * @param elf ELF file
+     * @return SimStatus SIM_OK or SIM_ERROR
+     */
+    SimStatus load(const std::string &elf);
+
+    /**
+     * @brief Load all loadable segments of an ELF image in host memory & set
+     * PC to its entry point
+     * 
+     * @param data ELF image
+     * @param size size of the image in bytes
+     * @return SimStatus SIM_OK or SIM_ERROR
+     */
+    SimStatus load(const void * data, size_t size);
+
+    /**
+     * @brief Run the CPU
+     * After a fatal error the PC & instruction count are left at the faulting
+     * instruction & run returns SIM_ERROR until a program is loaded again.
+     * 
+     * @param budget maximum number of instructions
+     * @return SimStatus SIM_OK, SIM_HALTED or SIM_ERROR
+     */
+    SimStatus run(unsigned long int budget);
+
+    /**
+     * @brief Get message of the last fatal error
+     */
+    const std::string & getError();
+
+    /**
+     * @brief Get ELF file loaded last
+     */
+    const std::string & getElfFile();
+
+    /**
+     * @brief Get simulated components
+     */
+    RVCPU * getCPU();
+    Memory * getMemory();
+    Bus<REG> * getBus();
+};
+
+#endif // __SIMULATOR_H__
@@ -0,0 +1,113 @@
+#ifndef __TLB_H__
+#define __TLB_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @brief Set associative cache of page translations with LRU replacement
+ * Entries are tagged with the ASID they were walked under, so switching
+ * address spaces needs no flush. Each entry maps one 4 KiB page: pages of a
+ * superpage are cached one by one as they are used & remember the level of
+ * their leaf, so flushing an address drops every page of its superpage.
+ * 
+ */
+class TLB
+{
+    public:
+    /**
+     * @brief Translation of a page
+     */
+    struct Entry
+    {
+        uint64_t vpn;       // virtual page number (INVALID_VPN if unused)
+        uint64_t ppn;       // physical page number
+        uint64_t stamp;     // LRU stamp
+        uint16_t asid;
+        uint8_t flags;      // PTE flags (PTE_V - PTE_D)
+        uint8_t level;      // level of the leaf PTE, 0 for a 4 KiB page
+    };
+
+    /**
+     * @brief Page number of unused entries
+     */
+    static const uint64_t INVALID_VPN = ~(uint64_t)0;
+
+    private:
+    /**
+     * @brief Geometry & page numbers bits translated by each table level
+     */
+    unsigned int nSets;
+    unsigned int nWays;
+    unsigned int levelBits;
+
+    /**
+     * @brief Entries, nWays per set
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * @brief Monotonic counter used to generate LRU stamps
+     */
+    uint64_t clock;
+
+    /**
+     * @brief Number of entries from superpage leaves, flushing an address
+     * only looks beyond its own set while there are any
+     */
+    unsigned int superpages;
+
+    /**
+     * @brief Invalidate an entry
+     */
+    void invalidate(Entry &e);
+
+    public:
+    /**
+     * @brief Lookup statistics
+     */
+    uint64_t hits;
+    uint64_t misses;
+
+    /**
+     * @brief Construct a new TLB object
+     * 
+     * @param sets number of sets (power of 2)
+     * @param ways associativity
+     * @param level_bits virtual page number bits per page table level
+     */
+    TLB(unsigned int sets = 64, unsigned int ways = 4, unsigned int level_bits = 9);
+
+    /**
+     * @brief Find the translation of a page
+     * 
+     * @param vpn virtual page number
+     * @param asid address space (global entries match any)
+     * @return Entry* entry or NULL on a miss
+     */
+    Entry * lookup(uint64_t vpn, uint16_t asid);
+
+    /**
+     * @brief Add the translation of a page, replacing the least recently
+     * used entry of its set (or an entry for the same page)
+     */
+    Entry * insert(uint64_t vpn, uint64_t ppn, uint16_t asid, uint8_t flags, unsigned int level);
+
+    /**
+     * @brief Invalidate entries (sfence.vma)
+     * 
+     * @param match_vpn only entries translating vpn
+     * @param vpn virtual page number
+     * @param match_asid only non-global entries of asid
+     * @param asid address space
+     */
+    void flush(bool match_vpn, uint64_t vpn, bool match_asid, uint16_t asid);
+
+    /**
+     * @brief Invalidate all entries & clear statistics
+     */
+    void reset();
+};
+
+#endif // __TLB_H__
@@ -0,0 +1,72 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <functional>
+
+/**
+ * @brief Work stealing thread pool for independent tasks
+ * Tasks are spread over per worker queues. A worker takes tasks from the
+ * front of its own queue & steals from the back of the others' once it runs
+ * out, so long tasks don't leave workers idle.
+ * 
+ */
+class ThreadPool
+{
+    private:
+    /**
+     * @brief Task queue of a worker
+     */
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue> > queues;
+
+    /**
+     * @brief Queue the next added task goes to
+     */
+    size_t nextQueue;
+
+    /**
+     * @brief Take a task, from the worker's own queue or stolen from another
+     * 
+     * @return false if all queues are empty
+     */
+    bool take(size_t idx, std::function<void()> &task);
+
+    /**
+     * @brief Worker thread body
+     */
+    void worker(size_t idx);
+
+    public:
+    /**
+     * @brief Construct a new ThreadPool object
+     * 
+     * @param threads number of worker threads (0: number of CPUs)
+     */
+    ThreadPool(unsigned int threads);
+
+    /**
+     * @brief Get number of worker threads
+     */
+    unsigned int getThreadCount();
+
+    /**
+     * @brief Queue a task
+     */
+    void add(std::function<void()> task);
+
+    /**
+     * @brief Run all queued tasks, returns once all have finished
+     */
+    void run();
+};
+
+#endif // __THREADPOOL_H__
@@ -3,7 +3,8 @@
 
 #include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
+#include <stdint.h>
 
 namespace Util 
 {
@@ -84,20 +85,103 @@ namespace Util
      */
     std::string GetStdoutFromCommand(std::string cmd);
 
-    
-    struct DisassembledLine
+
+    /**
+     * @brief Disassembly of executable segments
+     * Each segment is a flat array indexed by (addr - base)/2, entries hold the
+     * raw instruction & an index into a pool of interned strings. Entries are
+     * formatted lazily on first lookup.
+     */
+    class DisassemblyTable
     {
-        uint32_t instr;
-        std::string disassembly;
+        public:
+        struct Entry
+        {
+            uint32_t instr;     // raw instruction (16-bit if compressed)
+            uint32_t text;      // index into string pool, 0 if not formatted yet
+        };
+
+        struct Segment
+        {
+            uint64_t base;
+            std::vector<Entry> entries;
+        };
+
+        /**
+         * @brief Add an executable segment
+         * 
+         * @param base start address
+         * @param size size in bytes
+         * @param data segment contents, may be NULL if instructions are
+         * supplied at lookup
+         */
+        void addSegment(uint64_t base, uint64_t size, const uint8_t * data = NULL);
+
+        /**
+         * @brief Get entry for an address
+         * 
+         * @param addr address
+         * @return Entry* entry, NULL if address is not in any segment
+         */
+        Entry * find(uint64_t addr);
+
+        /**
+         * @brief Get disassembly of the instruction stored in the table
+         * 
+         * @param addr address
+         * @return const std::string& disassembly
+         */
+        const std::string & text(uint64_t addr);
+
+        /**
+         * @brief Get disassembly of an instruction, re-formatting the entry
+         * if the instruction differs from the one stored
+         * 
+         * @param addr address
+         * @param instr raw instruction
+         * @return const std::string& disassembly
+         */
+        const std::string & text(uint64_t addr, uint32_t instr);
+
+        private:
+        std::vector<Segment> segments;
+        unsigned int lastSegment = 0;
+
+        // Interned strings
+        std::vector<std::string> pool = std::vector<std::string>(1);
+        std::unordered_map<std::string, uint32_t> poolIndex;
+
+        /**
+         * @brief Scratch string for addresses outside the table
+         */
+        std::string scratch;
+
+        /**
+         * @brief Intern a string
+         */
+        uint32_t intern(const std::string &s);
     };
 
+    // ==================================== ELF symbols =====================================
+    /**
+     * @brief Look up a symbol in an ELF file
+     * 
+     * @param filename input filename
+     * @param name symbol name
+     * @param addr symbol value
+     * @return true if the symbol was found
+     */
+    bool getSymbolAddress(std::string filename, std::string name, uint64_t &addr);
+
     /**
-     * @brief Get the Disassembly of input file using riscv objdump
+     * @brief Look up several symbols in an ELF file, parsing it once
      * 
      * @param filename input filename
-     * @return std::map<uint32_t, std::string> map of disassembly
+     * @param names symbol names
+     * @param addrs symbol values, in the order of names
+     * @return true if all symbols were found
      */
-    std::map<uint32_t, DisassembledLine> getDisassembly(std::string filename);
+    bool getSymbolAddresses(std::string filename, const std::vector<std::string> &names, std::vector<uint64_t> &addrs);
 }
 
 #endif //__UTIL_H__
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <vector>
+#include <algorithm>
+
+#include "BBVProfiler.h"
+#include "SimError.h"
+
+
+/**
+ * @brief Construct a new BBVProfiler object
+ * 
+ * @param cpu CPU to profile
+ * @param filename .bb file to write
+ * @param interval instructions per interval
+ */
+BBVProfiler::BBVProfiler(RVCPU * cpu, std::string filename, uint64_t interval):
+    out(filename)
+{
+    if(!out)
+        SimError::throwError("Can't open basic block vector file : " + filename, true);
+    if(interval == 0)
+        SimError::throwError("Basic block vector interval must be non-zero", true);
+
+    this->cpu = cpu;
+    this->interval = interval;
+    lastInstret = cpu->getInstret();
+    nextSample = lastInstret + interval;
+    intervals = 0;
+    nextId = 1;
+
+    // Counts of already executed blocks belong to no interval
+    for(std::unordered_map<REG, DecodedBlock>::iterator it = cpu->blocks.begin(); it != cpu->blocks.end(); it++)
+        blockInfo[it->first] = {nextId++, it->second.exec_count};
+}
+
+
+/**
+ * @brief Write the vector of the current interval
+ * Each entry is the number of instructions executed in a block: its
+ * execution count times its size. Counts of blocks discarded from the decode
+ * cache during the interval are lost.
+ */
+void BBVProfiler::sample()
+{
+    std::vector<std::pair<unsigned int, uint64_t> > vec;
+    for(std::unordered_map<REG, DecodedBlock>::iterator it = cpu->blocks.begin(); it != cpu->blocks.end(); it++)
+    {
+        const DecodedBlock &blk = it->second;
+        std::unordered_map<REG, BlockInfo>::iterator info = blockInfo.find(it->first);
+        if(info == blockInfo.end())
+            info = blockInfo.insert({it->first, {nextId++, 0}}).first;
+
+        // Count went backwards if the block was discarded & decoded again
+        uint64_t execs = blk.exec_count >= info->second.lastCount ? blk.exec_count - info->second.lastCount : blk.exec_count;
+        info->second.lastCount = blk.exec_count;
+        if(execs)
+            vec.push_back({info->second.id, execs * blk.instrs.size()});
+    }
+    std::sort(vec.begin(), vec.end());
+
+    out << "T";
+    for(size_t i=0; i<vec.size(); i++)
+        out << ":" << vec[i].first << ":" << vec[i].second << " ";
+    out << "\n";
+
+    intervals++;
+    lastInstret = cpu->getInstret();
+}
+
+
+/**
+ * @brief Get number of instructions left in the current interval
+ */
+uint64_t BBVProfiler::untilSample()
+{
+    uint64_t instret = cpu->getInstret();
+    return instret < nextSample ? nextSample - instret : 0;
+}
+
+
+/**
+ * @brief Write a vector if the current interval is complete
+ */
+void BBVProfiler::update()
+{
+    if(cpu->getInstret() < nextSample)
+        return;
+    sample();
+    nextSample += interval;
+}
+
+
+/**
+ * @brief Write the vector of the last (partial) interval
+ */
+void BBVProfiler::finish()
+{
+    if(cpu->getInstret() > lastInstret)
+        sample();
+    out.flush();
+}
+
+
+/**
+ * @brief Get number of intervals written
+ */
+uint64_t BBVProfiler::getIntervalCount()
+{
+    return intervals;
+}
@@ -0,0 +1,212 @@
+#include <chrono>
+#include <algorithm>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "BatchRunner.h"
+#include "ThreadPool.h"
+#include "Simulator.h"
+#include "SimError.h"
+#include "Signature.h"
+#include "Util.h"
+
+
+/**
+ * @brief Construct a new BatchRunner object
+ * 
+ * @param isa ISA of the simulated CPUs
+ * @param mem_size memory size of each simulation
+ * @param maxitr instruction budget of each simulation
+ * @param jobs number of worker threads (0: number of CPUs)
+ */
+BatchRunner::BatchRunner(ISAdef isa, uint64_t mem_size, unsigned long int maxitr, unsigned int jobs)
+{
+    this->isa = isa;
+    this->memSize = mem_size;
+    this->maxitr = maxitr;
+    this->jobs = jobs;
+}
+
+
+/**
+ * @brief Write the signature of every simulation to a directory
+ */
+void BatchRunner::setSignatureDir(const std::string &dir)
+{
+    signatureDir = dir;
+}
+
+
+/**
+ * @brief Simulate one ELF file (on a worker thread)
+ * Fatal errors end only this simulation.
+ * 
+ * @param elf ELF file
+ * @param reference reference signature file (empty: pass/fail by exit
+ * status)
+ */
+BatchRunner::Result BatchRunner::runOne(const std::string &elf, const std::string &reference)
+{
+    Result res;
+    res.halted = false;
+    res.exit_status = 0;
+    res.instret = 0;
+    res.mismatch = -1;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Simulator sim(isa, memSize);
+    if(sim.load(elf) == SIM_OK && sim.run(maxitr) != SIM_ERROR)
+    {
+        RVCPU * cpu = sim.getCPU();
+        res.halted = cpu->isHalted();
+        res.exit_status = (REGS)cpu->getRegValue(10);
+        res.instret = cpu->getInstret();
+
+        // Signature is compared in memory, without going through a file
+        if(signatureDir != "" || reference != "")
+        {
+            std::vector<std::string> ref_lines;
+            try
+            {
+                if(reference != "")
+                    ref_lines = Util::fRead(reference);
+            }
+            catch(const char * e)
+            {
+                res.error = "can't read reference signature " + reference;
+            }
+
+            Signature sig;
+            if(res.error.empty())
+                res.error = sig.read(elf, sim.getMemory(), Signature::granularityOf(ref_lines));
+            if(res.error.empty() && reference != "")
+                res.mismatch = sig.compare(ref_lines);
+
+            std::string name = elf.substr(elf.find_last_of('/') + 1);
+            name = name.substr(0, name.find_last_of('.'));
+            if(res.error.empty() && signatureDir != "" && !sig.write(signatureDir + "/" + name + ".signature"))
+                res.error = "can't write signature file";
+        }
+    }
+    else
+        res.error = sim.getError();
+    res.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return res;
+}
+
+
+/**
+ * @brief Run all files & print a summary
+ * 
+ * @param elfs ELF files
+ * @return unsigned int number of failed simulations
+ */
+unsigned int BatchRunner::run(const std::vector<std::string> &elfs, const std::vector<std::string> &references)
+{
+    std::vector<Result> results(elfs.size());
+    ThreadPool pool(jobs);
+    for(size_t i=0; i<elfs.size(); i++)
+    {
+        std::string reference = i < references.size() ? references[i] : "";
+        pool.add([this, &elfs, &results, i, reference]() { results[i] = runOne(elfs[i], reference); });
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    pool.run();
+    double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Summary
+    unsigned int failed = 0;
+    uint64_t instret = 0;
+    printf("%-40s %-8s %10s %16s %10s\n", "Test", "Result", "Exit", "Instructions", "Time(s)");
+    for(size_t i=0; i<elfs.size(); i++)
+    {
+        const Result &r = results[i];
+        bool compared = i < references.size() && references[i] != "";
+        bool passed = compared ? r.mismatch < 0 : r.exit_status == 0;
+        const char * verdict = !r.error.empty() ? "ERROR" : (!r.halted ? "TIMEOUT" : (passed ? "PASS" : "FAIL"));
+        if(strcmp(verdict, "PASS") != 0)
+            failed++;
+        instret += r.instret;
+
+        if(!r.error.empty())
+            printf("%-40s %-8s %s\n", elfs[i].c_str(), verdict, r.error.c_str());
+        else if(r.mismatch >= 0)
+            printf("%-40s %-8s %10lld %16llu %10.4f  signature mismatch at line %ld\n", elfs[i].c_str(), verdict, (long long)r.exit_status, (unsigned long long)r.instret, r.wall_time, r.mismatch + 1);
+        else
+            printf("%-40s %-8s %10lld %16llu %10.4f\n", elfs[i].c_str(), verdict, (long long)r.exit_status, (unsigned long long)r.instret, r.wall_time);
+    }
+    printf("%u/%u tests passed in %.4f s on %u threads (%.2f MIPS)\n", (unsigned int)elfs.size() - failed, (unsigned int)elfs.size(),
+        wall_time, pool.getThreadCount(), wall_time > 0 ? instret / wall_time / 1e6 : 0);
+    return failed;
+}
+
+
+/**
+ * @brief Check if a file exists
+ */
+static bool file_exists(const std::string &path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode);
+}
+
+
+/**
+ * @brief Find compliance tests: ELF files under a directory that have a
+ * reference signature (<name>.reference_output next to the ELF file or in a
+ * references directory beside or above it)
+ * 
+ * @param dir directory searched recursively
+ * @param elfs ELF files found
+ * @param references reference signature of each ELF file
+ */
+void BatchRunner::findTests(const std::string &dir, std::vector<std::string> &elfs, std::vector<std::string> &references)
+{
+    DIR * d = opendir(dir.c_str());
+    if(!d)
+        SimError::throwError("Can't open test directory : " + dir, true);
+
+    std::vector<std::string> names;
+    struct dirent * ent;
+    while((ent = readdir(d)) != NULL)
+    {
+        if(ent->d_name[0] != '.')
+            names.push_back(ent->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    for(size_t i=0; i<names.size(); i++)
+    {
+        std::string path = dir + "/" + names[i];
+        struct stat st;
+        if(stat(path.c_str(), &st) != 0)
+            continue;
+        if(S_ISDIR(st.st_mode))
+        {
+            findTests(path, elfs, references);
+            continue;
+        }
+        if(names[i].size() <= 4 || names[i].compare(names[i].size() - 4, 4, ".elf") != 0)
+            continue;
+
+        std::string ref_name = names[i].substr(0, names[i].size() - 4) + ".reference_output";
+        const std::string candidates[] = {dir + "/" + ref_name, dir + "/references/" + ref_name, dir + "/../references/" + ref_name};
+        std::string reference;
+        for(unsigned int c=0; c<3 && reference.empty(); c++)
+        {
+            if(file_exists(candidates[c]))
+                reference = candidates[c];
+        }
+
+        if(reference.empty())
+            SimError::throwWarning("No reference signature for " + path + ", skipped");
+        else
+        {
+            elfs.push_back(path);
+            references.push_back(reference);
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#include "Bus.h"
+#include "Memory.h"
+#include "RVdefs.h"
+
+
+/**
+ * @brief Construct a new Bus object
+ * 
+ * @param memory memory attached to the bus
+ */
+template <class REG>
+Bus<REG>::Bus(Memory * memory)
+{
+    mem = memory;
+}
+
+
+/**
+ * @brief Read or write memory
+ * 
+ * @param address address
+ * @param data write data
+ * @param sel byte lane enables
+ * @param write write if true, read otherwise
+ * @return REG read data
+ */
+template <class REG>
+REG Bus<REG>::request(REG address, REG data, int sel, bool write)
+{
+    // Each bit of sel enables one byte lane starting at address
+    if(write)
+    {
+        for(unsigned int i=0; i<sizeof(REG); i++)
+        {
+            if(sel & (1 << i))
+                mem->store(address+i, (uint8_t)(data >> (8*i)));
+        }
+        return 0;
+    }
+    else
+    {
+        REG rdata = 0;
+
+        for(unsigned int i=0; i<sizeof(REG); i++)
+        {
+            if(sel & (1 << i))
+                rdata |= ((REG) mem->fetch(address+i)) << (8*i);
+        }
+        return rdata;
+    }
+}
+
+
+/**
+ * @brief Get host memory backing a page
+ */
+template <class REG>
+uint8_t * Bus<REG>::hostPage(REG page, unsigned int page_size)
+{
+    if(!mem->isValidAddress(page) || !mem->isValidAddress(page + page_size - 1))
+        return NULL;
+    return mem->mem + page;
+}
+
+
+template struct Bus<REG>;
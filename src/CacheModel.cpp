@@ -0,0 +1,81 @@
+#include "CacheModel.h"
+
+/**
+ * @brief Tag value used to mark invalid lines
+ */
+static const uint64_t INVALID_TAG = ~(uint64_t)0;
+
+
+/**
+ * @brief Construct a new CacheModel object
+ * 
+ * @param size_bytes cache capacity in bytes
+ * @param ways associativity
+ * @param line_bytes line size in bytes (power of 2)
+ */
+CacheModel::CacheModel(unsigned int size_bytes, unsigned int ways, unsigned int line_bytes)
+{
+    nWays = ways;
+    nSets = size_bytes / (ways * line_bytes);
+    if(nSets == 0)
+        nSets = 1;
+
+    lineShift = 0;
+    while((1u << lineShift) < line_bytes)
+        lineShift++;
+
+    tags.resize(nSets * nWays);
+    stamps.resize(nSets * nWays);
+    reset();
+}
+
+
+/**
+ * @brief Access an address
+ * 
+ * @param addr address
+ * @return true if access hits
+ * @return false if access misses (the line is allocated)
+ */
+bool CacheModel::access(uint64_t addr)
+{
+    uint64_t line = addr >> lineShift;
+    unsigned int base = (unsigned int)(line % nSets) * nWays;
+
+    accesses++;
+    clock++;
+
+    unsigned int victim = base;
+    for(unsigned int w = base; w < base + nWays; w++)
+    {
+        if(tags[w] == line)
+        {
+            stamps[w] = clock;
+            return true;
+        }
+        if(stamps[w] < stamps[victim])
+            victim = w;
+    }
+
+    // Miss: replace least recently used way
+    misses++;
+    tags[victim] = line;
+    stamps[victim] = clock;
+    return false;
+}
+
+
+/**
+ * @brief Invalidate all lines & clear statistics
+ */
+void CacheModel::reset()
+{
+    for(unsigned int i = 0; i < tags.size(); i++)
+    {
+        tags[i] = INVALID_TAG;
+        stamps[i] = 0;
+    }
+    clock = 0;
+    accesses = 0;
+    misses = 0;
+}
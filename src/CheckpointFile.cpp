@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "CheckpointFile.h"
+#include "SimError.h"
+
+static const char CHECKPOINT_MAGIC[8] = {'R', 'V', 'S', 'I', 'M', 'C', 'K', 'P'};
+
+
+/**
+ * @brief Check if a page is all zeros
+ */
+static bool isZeroPage(const uint8_t * p, unsigned int len)
+{
+    const uint64_t * w = (const uint64_t *) p;
+    for(unsigned int i=0; i<len/8; i++)
+    {
+        if(w[i])
+            return false;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Save a checkpoint
+ * 
+ * @param filename file name
+ * @param cpu CPU
+ * @param mem memory
+ * @param sparse only store non-zero pages
+ */
+void CheckpointFile::save(std::string filename, RVCPU * cpu, Memory * mem, bool sparse)
+{
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, CHECKPOINT_MAGIC, sizeof(h.magic));
+    h.version = VERSION;
+    h.xlen = XLEN;
+    h.page_size = PAGE_SIZE;
+    h.nsegments = mem->segments.size();
+    h.mem_size = mem->size;
+
+    // CPU state
+    CPUSnapshot snap;
+    cpu->saveSnapshot(snap);
+    h.pc = snap.PC;
+    for(unsigned int i=0; i<32; i++)
+    {
+        h.x[i] = snap.X[i];
+        h.f[i] = snap.F[i];
+        h.counter_base[i] = snap.counterBase[i];
+        h.counter_snap[i] = snap.counterSnap[i];
+        h.mhpmevent[i] = snap.mhpmevent[i];
+    }
+    h.fcsr = snap.fcsr;
+    h.halted = snap.halted;
+    h.instret = snap.instret;
+    for(unsigned int ev=0; ev<HPM_EV_COUNT; ev++)
+        h.events[ev] = snap.events[ev];
+    h.mcountinhibit = snap.mcountinhibit;
+    h.dcache_model_enabled = snap.dcacheModelEnabled;
+    h.vlen = cpu->getVLEN();
+    h.vl = snap.vl;
+    h.vtype = snap.vtype;
+    h.vstart = snap.vstart;
+    h.vcsr = snap.vcsr;
+    memcpy(h.v, snap.V, sizeof(h.v));
+    for(unsigned int i=0; i<TCSR_COUNT; i++)
+        h.tcsr[i] = snap.tcsr[i];
+    h.priv = snap.priv;
+
+    // Pages to store (a partial last page is padded)
+    std::vector<uint64_t> pages;
+    uint64_t npages = (mem->size + PAGE_SIZE - 1) / PAGE_SIZE;
+    for(uint64_t pg=0; pg<npages; pg++)
+    {
+        uint64_t len = (pg + 1) * PAGE_SIZE <= mem->size ? PAGE_SIZE : mem->size - pg * PAGE_SIZE;
+        if(!sparse || len < PAGE_SIZE || !isZeroPage(mem->mem + pg * PAGE_SIZE, PAGE_SIZE))
+            pages.push_back(pg);
+    }
+    h.npages = pages.size();
+    h.index_offset = sizeof(Header) + h.nsegments * sizeof(SegmentRecord);
+    h.data_offset = (h.index_offset + pages.size() * sizeof(uint64_t) + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+
+    FILE * f = fopen(filename.c_str(), "wb");
+    if(!f)
+    {
+        SimError::throwError("Unable to create checkpoint file : " + filename, true);
+        return;
+    }
+
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    for(unsigned int i=0; i<mem->segments.size(); i++)
+    {
+        SegmentRecord rec = {mem->segments[i].addr, mem->segments[i].size, (uint64_t)mem->segments[i].flags};
+        ok = ok && fwrite(&rec, sizeof(rec), 1, f) == 1;
+    }
+    ok = ok && fwrite(pages.data(), sizeof(uint64_t), pages.size(), f) == pages.size();
+
+    // Pad to the page aligned data
+    std::vector<uint8_t> page(PAGE_SIZE, 0);
+    uint64_t pad = h.data_offset - (h.index_offset + pages.size() * sizeof(uint64_t));
+    ok = ok && fwrite(page.data(), 1, pad, f) == pad;
+    for(uint64_t i=0; ok && i<pages.size(); i++)
+    {
+        uint64_t addr = pages[i] * PAGE_SIZE;
+        uint64_t len = addr + PAGE_SIZE <= mem->size ? PAGE_SIZE : mem->size - addr;
+        memset(page.data(), 0, PAGE_SIZE);
+        memcpy(page.data(), mem->mem + addr, len);
+        ok = fwrite(page.data(), 1, PAGE_SIZE, f) == PAGE_SIZE;
+    }
+
+    if(fclose(f) != 0 || !ok)
+        SimError::throwError("Failed to write checkpoint file : " + filename, true);
+}
+
+
+/**
+ * @brief Open a checkpoint & read its header
+ * 
+ * @param filename file name
+ */
+CheckpointFile::CheckpointFile(std::string filename)
+{
+    this->filename = filename;
+    fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        SimError::throwError("Can't open checkpoint file : " + filename, true);
+        return;
+    }
+
+    if(pread(fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0)
+        SimError::throwError("Invalid checkpoint file : " + filename, true);
+    if(header.version != VERSION)
+        SimError::throwError("Unsupported checkpoint version " + std::to_string(header.version) + " : " + filename, true);
+    if(header.xlen != XLEN)
+        SimError::throwError("Checkpoint was taken with a " + std::to_string(header.xlen) + "-bit simulator : " + filename, true);
+    if(header.page_size != PAGE_SIZE)
+        SimError::throwError("Unsupported checkpoint page size : " + filename, true);
+
+    // The file must hold the segments, index & every page it lists; restore
+    // maps the pages, so a short file would fault when a page is touched
+    struct stat st;
+    if(fstat(fd, &st) != 0)
+        SimError::throwError("Can't open checkpoint file : " + filename, true);
+    const uint64_t file_size = st.st_size;
+    const uint64_t index_end = header.index_offset + header.npages * sizeof(uint64_t);
+    if(file_size < sizeof(header) ||
+       header.nsegments > (file_size - sizeof(header)) / sizeof(SegmentRecord) ||
+       header.npages > (header.mem_size + PAGE_SIZE - 1) / PAGE_SIZE ||
+       header.npages > file_size / PAGE_SIZE ||
+       header.index_offset != sizeof(header) + header.nsegments * sizeof(SegmentRecord) ||
+       (header.data_offset & (PAGE_SIZE - 1)) != 0 || header.data_offset < index_end ||
+       header.data_offset > file_size || header.npages > (file_size - header.data_offset) / PAGE_SIZE)
+        SimError::throwError("Truncated checkpoint file : " + filename, true);
+
+    segments.resize(header.nsegments);
+    index.resize(header.npages);
+    ssize_t seg_bytes = segments.size() * sizeof(SegmentRecord);
+    ssize_t index_bytes = index.size() * sizeof(uint64_t);
+    if(pread(fd, segments.data(), seg_bytes, sizeof(header)) != seg_bytes || pread(fd, index.data(), index_bytes, header.index_offset) != index_bytes)
+        SimError::throwError("Truncated checkpoint file : " + filename, true);
+}
+
+
+/**
+ * @brief Destroy the CheckpointFile object
+ * 
+ */
+CheckpointFile::~CheckpointFile()
+{
+    if(fd >= 0)
+        close(fd);
+}
+
+
+/**
+ * @brief Get size of memory the checkpoint was taken with
+ */
+uint64_t CheckpointFile::getMemSize()
+{
+    return header.mem_size;
+}
+
+
+/**
+ * @brief Restore memory & CPU state
+ * 
+ * @param cpu CPU
+ * @param mem memory (of getMemSize bytes)
+ */
+void CheckpointFile::restore(RVCPU * cpu, Memory * mem)
+{
+    if(mem->size != header.mem_size)
+        SimError::throwError("Memory size does not match checkpoint : " + filename, true);
+    if(cpu->getVLEN() != header.vlen)
+        SimError::throwError("VLEN does not match checkpoint (" + std::to_string(header.vlen) + ") : " + filename, true);
+
+    // Stored pages must be in memory & listed once, in order
+    const uint64_t mem_pages = (mem->size + PAGE_SIZE - 1) / PAGE_SIZE;
+    for(uint64_t i=0; i<index.size(); i++)
+    {
+        if(index[i] >= mem_pages || (i > 0 && index[i] <= index[i-1]))
+            SimError::throwError("Invalid checkpoint page index : " + filename, true);
+    }
+
+    // Map runs of consecutive stored pages, a partial last page is read
+    uint64_t i = 0;
+    while(i < index.size())
+    {
+        uint64_t j = i + 1;
+        while(j < index.size() && index[j] == index[j-1] + 1)
+            j++;
+
+        uint64_t addr = index[i] * PAGE_SIZE;
+        uint64_t len = (j - i) * PAGE_SIZE;
+        if(addr + len > mem->size)
+            len = mem->size - addr;
+        if(!mem->mapFile(fd, header.data_offset + i * PAGE_SIZE, addr, len))
+            SimError::throwError("Failed to map checkpoint file : " + filename, true);
+        i = j;
+    }
+
+    mem->segments.clear();
+    for(unsigned int s=0; s<segments.size(); s++)
+    {
+        Memory::Segment seg = {segments[s].addr, segments[s].size, (int)segments[s].flags};
+        mem->segments.push_back(seg);
+    }
+
+    // CPU state, the cache model starts cold but keeps its event counts
+    CPUSnapshot snap;
+    snap.PC = header.pc;
+    for(unsigned int r=0; r<32; r++)
+    {
+        snap.X[r] = header.x[r];
+        snap.F[r] = header.f[r];
+        snap.counterBase[r] = header.counter_base[r];
+        snap.counterSnap[r] = header.counter_snap[r];
+        snap.mhpmevent[r] = header.mhpmevent[r];
+    }
+    snap.fcsr = header.fcsr;
+    snap.halted = header.halted;
+    snap.instret = header.instret;
+    for(unsigned int ev=0; ev<HPM_EV_COUNT; ev++)
+        snap.events[ev] = header.events[ev];
+    snap.mcountinhibit = header.mcountinhibit;
+    snap.dcacheModelEnabled = header.dcache_model_enabled;
+    snap.vl = header.vl;
+    snap.vtype = header.vtype;
+    snap.vstart = header.vstart;
+    snap.vcsr = header.vcsr;
+    memcpy(snap.V, header.v, sizeof(snap.V));
+    for(unsigned int i=0; i<TCSR_COUNT; i++)
+        snap.tcsr[i] = header.tcsr[i];
+    snap.priv = (unsigned int)header.priv;
+    snap.dcache.accesses = header.events[HPM_EV_DCACHE_ACCESS];
+    snap.dcache.misses = header.events[HPM_EV_DCACHE_MISS];
+    cpu->restoreSnapshot(snap);
+}
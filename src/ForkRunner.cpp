@@ -0,0 +1,167 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "ForkRunner.h"
+#include "SimError.h"
+
+
+/**
+ * @brief Construct a new ForkRunner object
+ * 
+ * @param cpu CPU stopped at the fork point
+ * @param mem memory
+ * @param input_addr address test inputs are loaded at
+ * @param maxitr instruction budget of each test
+ * @param jobs maximum number of children running at once (0: number of CPUs)
+ */
+ForkRunner::ForkRunner(RVCPU * cpu, Memory * mem, REG input_addr, unsigned long int maxitr, unsigned int jobs)
+{
+    this->cpu = cpu;
+    this->mem = mem;
+    this->inputAddr = input_addr;
+    this->maxitr = maxitr;
+    this->jobs = jobs ? jobs : (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+    if(this->jobs == 0)
+        this->jobs = 1;
+}
+
+
+/**
+ * @brief Load an input & run the test (in the child)
+ * The program finds the input size in a0 & its address in a1.
+ */
+ForkRunner::Result ForkRunner::runTest(const std::string &input)
+{
+    Result res;
+    memset(&res, 0, sizeof(res));
+
+    std::ifstream f(input, std::ios::binary);
+    if(!f)
+    {
+        snprintf(res.error, sizeof(res.error), "can't open input");
+        return res;
+    }
+    std::vector<char> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    if(data.size() > 0 && (!mem->isValidAddress(inputAddr) || !mem->isValidAddress(inputAddr + data.size() - 1)))
+    {
+        snprintf(res.error, sizeof(res.error), "input does not fit in memory");
+        return res;
+    }
+    memcpy(mem->mem + inputAddr, data.data(), data.size());
+    cpu->setRegValue(10, (REG)data.size());
+    cpu->setRegValue(11, inputAddr);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t instret_start = cpu->getInstret();
+    try
+    {
+        cpu->run(maxitr);
+    }
+    catch(const SimError::Fatal &e)
+    {
+        snprintf(res.error, sizeof(res.error), "%s", e.message.c_str());
+    }
+
+    res.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    res.instret = cpu->getInstret() - instret_start;
+    res.halted = cpu->isHalted();
+    res.exit_status = (REGS)cpu->getRegValue(10);
+    return res;
+}
+
+
+/**
+ * @brief Run all tests & print a summary
+ * 
+ * @param inputs test input files
+ * @return unsigned int number of failed tests
+ */
+unsigned int ForkRunner::run(const std::vector<std::string> &inputs)
+{
+    std::vector<Result> results(inputs.size());
+    std::vector<pid_t> pids(inputs.size(), -1);
+    std::vector<int> fds(inputs.size(), -1);
+    unsigned int running = 0;
+    size_t next = 0;
+
+    // Buffered output would be written again by every child
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(NULL);
+
+    while(next < inputs.size() || running > 0)
+    {
+        // Start children up to the job limit
+        while(next < inputs.size() && running < jobs)
+        {
+            int fd[2];
+            if(pipe(fd) != 0)
+                SimError::throwError("Failed to create pipe", true);
+
+            pid_t pid = fork();
+            if(pid < 0)
+                SimError::throwError("Failed to fork", true);
+            if(pid == 0)
+            {
+                close(fd[0]);
+                // A fatal error ends only this test, the parent's exit
+                // handler (stats & signature files) must not run here
+                SimError::setExitHandler(NULL);
+                SimError::setThrowOnFatal(true);
+                Result res = runTest(inputs[next]);
+                ssize_t n = write(fd[1], &res, sizeof(res));
+                _exit(n == sizeof(res) ? EXIT_SUCCESS : EXIT_FAILURE);
+            }
+
+            close(fd[1]);
+            pids[next] = pid;
+            fds[next] = fd[0];
+            running++;
+            next++;
+        }
+
+        // Collect a finished child, its result is already buffered in the pipe
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if(pid < 0)
+            break;
+        for(size_t i=0; i<inputs.size(); i++)
+        {
+            if(pids[i] != pid)
+                continue;
+
+            if(read(fds[i], &results[i], sizeof(Result)) != sizeof(Result))
+            {
+                memset(&results[i], 0, sizeof(Result));
+                snprintf(results[i].error, sizeof(results[i].error), "simulator exited (status %d)", WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+            }
+            close(fds[i]);
+            pids[i] = -1;
+            running--;
+            break;
+        }
+    }
+
+    // Summary
+    unsigned int failed = 0;
+    printf("%-40s %-8s %10s %16s %10s\n", "Test", "Result", "Exit", "Instructions", "Time(s)");
+    for(size_t i=0; i<inputs.size(); i++)
+    {
+        const Result &r = results[i];
+        const char * verdict = r.error[0] ? "ERROR" : (!r.halted ? "TIMEOUT" : (r.exit_status == 0 ? "PASS" : "FAIL"));
+        if(strcmp(verdict, "PASS") != 0)
+            failed++;
+
+        if(r.error[0])
+            printf("%-40s %-8s %s\n", inputs[i].c_str(), verdict, r.error);
+        else
+            printf("%-40s %-8s %10lld %16llu %10.4f\n", inputs[i].c_str(), verdict, (long long)r.exit_status, (unsigned long long)r.instret, r.wall_time);
+    }
+    printf("%u/%u tests passed\n", (unsigned int)inputs.size() - failed, (unsigned int)inputs.size());
+    return failed;
+}
@@ -0,0 +1,701 @@
+#include <iostream>
+#include <string.h>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "GDBStub.h"
+#include "RVDisasm.h"
+#include "SimError.h"
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/**
+ * @brief Convert a hex digit to its value
+ */
+static int hexValue(char c)
+{
+    if(c >= '0' && c <= '9') return c - '0';
+    if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/**
+ * @brief Parse a hex number, advancing pos past it
+ */
+static uint64_t parseHex(const std::string &s, size_t &pos)
+{
+    uint64_t value = 0;
+    while(pos < s.size() && hexValue(s[pos]) >= 0)
+        value = (value << 4) | hexValue(s[pos++]);
+    return value;
+}
+
+/**
+ * @brief Encode a register value as little endian hex
+ */
+static void appendReg(std::string &out, REG value)
+{
+    for(unsigned int i=0; i<sizeof(REG); i++)
+    {
+        uint8_t b = (uint8_t)(value >> (8*i));
+        out += hex_digits[b >> 4];
+        out += hex_digits[b & 0xf];
+    }
+}
+
+/**
+ * @brief Decode a little endian hex register value
+ */
+static REG parseReg(const std::string &s, size_t pos)
+{
+    REG value = 0;
+    for(unsigned int i=0; i<sizeof(REG) && pos + 2*i + 1 < s.size(); i++)
+        value |= (REG)((hexValue(s[pos + 2*i]) << 4) | hexValue(s[pos + 2*i + 1])) << (8*i);
+    return value;
+}
+
+
+/**
+ * @brief Construct a new GDBStub object
+ * 
+ * @param cpu CPU to debug
+ * @param mem memory of the simulated system
+ * @param history execution history for reverse execution (optional)
+ */
+GDBStub::GDBStub(RVCPU * cpu, Memory * mem, History * history)
+{
+    this->cpu = cpu;
+    this->mem = mem;
+    this->history = history;
+    listenFd = -1;
+    connFd = -1;
+    rxPos = 0;
+    noAck = false;
+    interrupted = false;
+    memDirty = false;
+    done = false;
+}
+
+
+/**
+ * @brief Destroy the GDBStub object
+ * 
+ */
+GDBStub::~GDBStub()
+{
+    if(connFd >= 0)
+        close(connFd);
+    if(listenFd >= 0)
+        close(listenFd);
+    if(unixPath != "")
+        unlink(unixPath.c_str());
+}
+
+
+/**
+ * @brief Listen for a debugger connection
+ * 
+ * @param endpoint TCP port number (loopback), or "unix:<path>"
+ * @return true if listening
+ */
+bool GDBStub::listen(std::string endpoint)
+{
+    if(endpoint.compare(0, 5, "unix:") == 0)
+    {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        unixPath = endpoint.substr(5);
+        if(unixPath.size() >= sizeof(addr.sun_path))
+            return false;
+        strcpy(addr.sun_path, unixPath.c_str());
+        unlink(unixPath.c_str());
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listenFd < 0 || bind(listenFd, (struct sockaddr *) &addr, sizeof(addr)) != 0)
+            return false;
+    }
+    else
+    {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons((uint16_t)std::stoi(endpoint));
+
+        listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        if(listenFd < 0)
+            return false;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if(bind(listenFd, (struct sockaddr *) &addr, sizeof(addr)) != 0)
+            return false;
+    }
+    return ::listen(listenFd, 1) == 0;
+}
+
+
+/**
+ * @brief Accept a connection & serve it until the debugger detaches or
+ * kills the target
+ */
+void GDBStub::serve()
+{
+    connFd = accept(listenFd, NULL, NULL);
+    if(connFd < 0)
+    {
+        SimError::throwError("GDB: accept failed");
+        return;
+    }
+    int one = 1;
+    setsockopt(connFd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    std::string pkt;
+    while(!done && getPacket(pkt))
+    {
+        std::string reply = handle(pkt);
+        if(pkt != "k")
+            putPacket(reply);
+
+        // Acks stop after the reply to QStartNoAckMode
+        if(pkt == "QStartNoAckMode")
+            noAck = true;
+    }
+}
+
+
+// ================================== Transport ===================================
+/**
+ * @brief Receive more data from the debugger
+ * 
+ * @param block wait for data
+ * @return false if connection was closed (or no data when not blocking)
+ */
+bool GDBStub::receive(bool block)
+{
+    char buf[65536];
+    ssize_t n = recv(connFd, buf, sizeof(buf), block ? 0 : MSG_DONTWAIT);
+    if(n <= 0)
+        return false;
+
+    if(rxPos == rxBuf.size())
+    {
+        rxBuf.clear();
+        rxPos = 0;
+    }
+    rxBuf.append(buf, n);
+    return true;
+}
+
+
+/**
+ * @brief Read a byte from the debugger
+ */
+bool GDBStub::readByte(char &c)
+{
+    if(rxPos == rxBuf.size() && !receive(true))
+        return false;
+    c = rxBuf[rxPos++];
+    return true;
+}
+
+
+/**
+ * @brief Receive a packet
+ * 
+ * @param pkt packet contents
+ * @return false if connection was closed
+ */
+bool GDBStub::getPacket(std::string &pkt)
+{
+    while(true)
+    {
+        // Skip acks & interrupts received while stopped
+        char c;
+        do
+        {
+            if(!readByte(c))
+                return false;
+        } while(c != '$');
+
+        // Find end of packet (binary data has '#' escaped)
+        size_t end;
+        while((end = rxBuf.find('#', rxPos)) == std::string::npos || end + 2 >= rxBuf.size())
+        {
+            if(!receive(true))
+                return false;
+        }
+
+        pkt.assign(rxBuf, rxPos, end - rxPos);
+        uint8_t sum = 0;
+        for(size_t i=0; i<pkt.size(); i++)
+            sum += (uint8_t)pkt[i];
+        int expected = (hexValue(rxBuf[end+1]) << 4) | hexValue(rxBuf[end+2]);
+        rxPos = end + 3;
+
+        if(noAck)
+            return true;
+        if(sum == expected)
+        {
+            send(connFd, "+", 1, 0);
+            return true;
+        }
+        send(connFd, "-", 1, 0);
+    }
+}
+
+
+/**
+ * @brief Send a packet
+ * 
+ * @param pkt packet contents
+ */
+void GDBStub::putPacket(const std::string &pkt)
+{
+    uint8_t sum = 0;
+    for(size_t i=0; i<pkt.size(); i++)
+        sum += (uint8_t)pkt[i];
+
+    std::string frame = "$" + pkt + "#";
+    frame += hex_digits[sum >> 4];
+    frame += hex_digits[sum & 0xf];
+
+    while(true)
+    {
+        size_t sent = 0;
+        while(sent < frame.size())
+        {
+            ssize_t n = send(connFd, frame.data() + sent, frame.size() - sent, 0);
+            if(n <= 0)
+                return;
+            sent += n;
+        }
+        if(noAck)
+            return;
+
+        char c;
+        do
+        {
+            if(!readByte(c))
+                return;
+        } while(c != '+' && c != '-');
+        if(c == '+')
+            return;
+    }
+}
+
+
+/**
+ * @brief Check if the debugger sent an interrupt (^C)
+ */
+bool GDBStub::pollInterrupt()
+{
+    while(receive(false))
+        ;
+    for(size_t i=rxPos; i<rxBuf.size(); i++)
+    {
+        if(rxBuf[i] == 0x03)
+        {
+            rxBuf.erase(i, 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// =================================== Packets ====================================
+/**
+ * @brief Handle a packet
+ * 
+ * @param pkt packet contents
+ * @return std::string reply
+ */
+std::string GDBStub::handle(const std::string &pkt)
+{
+    if(pkt.empty())
+        return "";
+
+    size_t pos = 1;
+    switch(pkt[0])
+    {
+        case '?':
+            return stopReply();
+
+        case 'g':
+            return readRegisters();
+
+        case 'G':
+            return writeRegisters(pkt.substr(1));
+
+        case 'p':
+        {
+            unsigned int reg = parseHex(pkt, pos);
+            if(reg > 32)
+                return "E01";
+            std::string out;
+            appendReg(out, reg == 32 ? cpu->getPCValue() : cpu->getRegValue(reg));
+            return out;
+        }
+
+        case 'P':
+        {
+            unsigned int reg = parseHex(pkt, pos);
+            if(reg > 32 || pos >= pkt.size() || pkt[pos] != '=')
+                return "E01";
+            REG value = parseReg(pkt, pos + 1);
+            if(reg == 32)
+                cpu->setPCValue(value);
+            else
+                cpu->setRegValue(reg, value);
+
+            // History only covers changes made by execution
+            if(history)
+                history->rebase();
+            return "OK";
+        }
+
+        case 'm':
+        {
+            uint64_t addr = parseHex(pkt, pos);
+            pos++;
+            uint64_t len = parseHex(pkt, pos);
+            return readMemory(addr, len);
+        }
+
+        case 'M':
+        case 'X':
+        {
+            uint64_t addr = parseHex(pkt, pos);
+            pos++;
+            uint64_t len = parseHex(pkt, pos);
+            if(pos >= pkt.size() || pkt[pos] != ':')
+                return "E01";
+            return writeMemory(addr, pkt.substr(pos + 1), len, pkt[0] == 'X');
+        }
+
+        case 'b':
+            if(pkt == "bs" || pkt == "bc")
+                return reverse(pkt[1] == 's');
+            return "";
+
+        case 'c':
+        case 's':
+            if(pos < pkt.size())
+                cpu->setPCValue(parseHex(pkt, pos));
+            return resume(pkt[0] == 's');
+
+        case 'Z':
+        case 'z':
+            return breakpoint(pkt, pkt[0] == 'Z');
+
+        case 'H':
+        case 'T':
+            return "OK";
+
+        case 'D':
+            done = true;
+            return "OK";
+
+        case 'k':
+            done = true;
+            return "";
+
+        default:
+            break;
+    }
+
+    // General queries
+    if(pkt.compare(0, 10, "qSupported") == 0)
+    {
+        char buf[128];
+        sprintf(buf, "PacketSize=%x;qXfer:features:read+;swbreak+;hwbreak+;QStartNoAckMode+", PACKET_SIZE);
+        return std::string(buf) + (history ? ";ReverseStep+;ReverseContinue+" : "");
+    }
+    if(pkt == "QStartNoAckMode")
+        return "OK";
+    if(pkt.compare(0, 30, "qXfer:features:read:target.xml") == 0)
+    {
+        pos = 31;
+        uint64_t offset = parseHex(pkt, pos);
+        pos++;
+        uint64_t len = parseHex(pkt, pos);
+        std::string xml = targetXML();
+        if(offset >= xml.size())
+            return "l";
+        std::string chunk = xml.substr(offset, len);
+        return (offset + chunk.size() >= xml.size() ? "l" : "m") + chunk;
+    }
+    if(pkt == "qAttached")
+        return "1";
+    if(pkt == "qC")
+        return "QC1";
+    if(pkt == "qfThreadInfo")
+        return "m1";
+    if(pkt == "qsThreadInfo")
+        return "l";
+    if(pkt.compare(0, 5, "vKill") == 0)
+    {
+        done = true;
+        return "OK";
+    }
+
+    // Unsupported
+    return "";
+}
+
+
+/**
+ * @brief Build the stop reply for the current CPU state
+ */
+std::string GDBStub::stopReply()
+{
+    char buf[32];
+    if(interrupted)
+        return "T02";
+
+    switch(cpu->getStopReason())
+    {
+        case STOP_ECALL:
+            sprintf(buf, "W%02x", (unsigned int)(cpu->getRegValue(10) & 0xff));
+            return buf;
+        case STOP_BREAKPOINT:
+            return swBreakpoints.count(cpu->getPCValue()) ? "T05swbreak:;" : "T05hwbreak:;";
+        case STOP_WATCHPOINT:
+        {
+            const Watchpoint &w = cpu->getWatchHit();
+            const char * kind = w.type == WATCH_WRITE ? "watch" : (w.type == WATCH_READ ? "rwatch" : "awatch");
+            sprintf(buf, "T05%s:%llx;", kind, (unsigned long long)w.addr);
+            return buf;
+        }
+        default:
+            return "T05";
+    }
+}
+
+
+/**
+ * @brief Resume execution & wait for the CPU to stop
+ * 
+ * @param step execute a single instruction
+ * @return std::string stop reply
+ */
+std::string GDBStub::resume(bool step)
+{
+    // Code may have been modified through memory writes
+    if(memDirty)
+    {
+        cpu->flushDecodeCache();
+        memDirty = false;
+    }
+
+    interrupted = false;
+    if(step)
+    {
+        cpu->step();
+        return stopReply();
+    }
+
+    // Run the CPU at full speed, checking for ^C between chunks
+    while(true)
+    {
+        cpu->run(CONTINUE_CHUNK);
+        if(cpu->getStopReason() != STOP_NONE || cpu->isHalted())
+            break;
+        if(pollInterrupt())
+        {
+            interrupted = true;
+            break;
+        }
+    }
+    return stopReply();
+}
+
+
+/**
+ * @brief Execute backwards (bs/bc packets)
+ * 
+ * @param step go back a single instruction
+ * @return std::string stop reply
+ */
+std::string GDBStub::reverse(bool step)
+{
+    if(!history)
+        return "";
+
+    interrupted = false;
+    bool stopped = step ? history->reverseStep() : history->reverseContinue();
+    if(!stopped)
+        return "T05replaylog:begin;";
+    return stopReply();
+}
+
+
+/**
+ * @brief Read all registers (x0-x31, pc)
+ */
+std::string GDBStub::readRegisters()
+{
+    std::string out;
+    for(unsigned int i=0; i<32; i++)
+        appendReg(out, cpu->getRegValue(i));
+    appendReg(out, cpu->getPCValue());
+    return out;
+}
+
+
+/**
+ * @brief Write all registers (x0-x31, pc)
+ */
+std::string GDBStub::writeRegisters(const std::string &hex)
+{
+    const size_t width = 2 * sizeof(REG);
+    for(unsigned int i=1; i<33 && (i+1)*width <= hex.size(); i++)
+    {
+        REG value = parseReg(hex, i*width);
+        if(i == 32)
+            cpu->setPCValue(value);
+        else
+            cpu->setRegValue(i, value);
+    }
+    if(history)
+        history->rebase();
+    return "OK";
+}
+
+
+/**
+ * @brief Read memory
+ */
+std::string GDBStub::readMemory(uint64_t addr, uint64_t len)
+{
+    if(len == 0)
+        return "";
+    if(!mem->isValidAddress(addr) || !mem->isValidAddress(addr + len - 1))
+        return "E14";
+
+    std::string out(2*len, '0');
+    const uint8_t * p = mem->mem + addr;
+    for(uint64_t i=0; i<len; i++)
+    {
+        out[2*i] = hex_digits[p[i] >> 4];
+        out[2*i+1] = hex_digits[p[i] & 0xf];
+    }
+    return out;
+}
+
+
+/**
+ * @brief Write memory from hex (M) or escaped binary (X) data
+ */
+std::string GDBStub::writeMemory(uint64_t addr, const std::string &data, uint64_t len, bool binary)
+{
+    // Decode the whole payload first, so a short or malformed one writes nothing
+    std::vector<uint8_t> bytes;
+    if(binary)
+    {
+        for(size_t i=0; i<data.size() && bytes.size() < len; i++)
+        {
+            if(data[i] == 0x7d)
+            {
+                if(++i == data.size())
+                    return "E01";
+                bytes.push_back(data[i] ^ 0x20);
+            }
+            else
+                bytes.push_back(data[i]);
+        }
+    }
+    else
+    {
+        if(data.size() != 2*len)
+            return "E01";
+        for(size_t i=0; i<data.size(); i+=2)
+        {
+            int hi = hexValue(data[i]);
+            int lo = hexValue(data[i+1]);
+            if(hi < 0 || lo < 0)
+                return "E01";
+            bytes.push_back((hi << 4) | lo);
+        }
+    }
+    if(bytes.size() < len)
+        return "E01";
+
+    if(len == 0)
+        return "OK";
+    if(!mem->isValidAddress(addr) || !mem->isValidAddress(addr + len - 1))
+        return "E14";
+
+    memcpy(mem->mem + addr, bytes.data(), len);
+    memDirty = true;
+    if(history)
+        history->rebase();
+    return "OK";
+}
+
+
+/**
+ * @brief Insert/Remove breakpoints & watchpoints (Z/z packets)
+ */
+std::string GDBStub::breakpoint(const std::string &pkt, bool insert)
+{
+    if(pkt.size() < 4 || pkt[1] < '0' || pkt[1] > '4')
+        return "";
+
+    size_t pos = 3;
+    REG addr = parseHex(pkt, pos);
+
+    // Watchpoints (Z2: write, Z3: read, Z4: access), kind is the length
+    if(pkt[1] >= '2')
+    {
+        pos++;
+        REG len = parseHex(pkt, pos);
+        int type = pkt[1] == '2' ? WATCH_WRITE : (pkt[1] == '3' ? WATCH_READ : WATCH_ACCESS);
+        if(insert)
+            cpu->setWatchpoint(addr, len, type);
+        else
+            cpu->clearWatchpoint(addr, len, type);
+        return "OK";
+    }
+    std::unordered_set<REG> &set = (pkt[1] == '0') ? swBreakpoints : hwBreakpoints;
+
+    if(insert)
+    {
+        set.insert(addr);
+        cpu->setBreakpoint(addr);
+    }
+    else
+    {
+        set.erase(addr);
+        if(!swBreakpoints.count(addr) && !hwBreakpoints.count(addr))
+            cpu->clearBreakpoint(addr);
+    }
+    return "OK";
+}
+
+
+/**
+ * @brief Target description for qXfer:features:read
+ */
+std::string GDBStub::targetXML()
+{
+    std::string bits = std::to_string(XLEN);
+    std::string xml =
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n"
+        "<target version=\"1.0\">\n"
+        "<architecture>riscv:rv" + bits + "</architecture>\n"
+        "<feature name=\"org.gnu.gdb.riscv.cpu\">\n";
+    for(unsigned int i=0; i<32; i++)
+        xml += "<reg name=\"" + std::string(RVDisasm::regName(i)) + "\" bitsize=\"" + bits + "\" type=\"int\" regnum=\"" + std::to_string(i) + "\"/>\n";
+    xml += "<reg name=\"pc\" bitsize=\"" + bits + "\" type=\"code_ptr\" regnum=\"32\"/>\n";
+    xml += "</feature>\n</target>\n";
+    return xml;
+}
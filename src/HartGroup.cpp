@@ -0,0 +1,155 @@
+#include <thread>
+
+#include "HartGroup.h"
+#include "SimError.h"
+
+
+/**
+ * @brief Construct a new HartGroup object
+ * 
+ * @param harts harts sharing memory, hart 0 first
+ * @param quantum instructions each hart runs between synchronizations
+ * @param deterministic run harts in turn on the calling thread
+ */
+HartGroup::HartGroup(const std::vector<RVCPU *> &harts, uint64_t quantum, bool deterministic):
+    arrived(0), epoch(0)
+{
+    if(quantum == 0)
+        SimError::throwError("Hart quantum must be non-zero", true);
+
+    this->harts = harts;
+    this->quantum = quantum;
+    this->deterministic = deterministic;
+    spinLimit = std::thread::hardware_concurrency() >= harts.size() ? SPIN_LIMIT : 0;
+    budget = done = 0;
+    finished = false;
+    failed.assign(harts.size(), 0);
+    errors.resize(harts.size());
+}
+
+
+/**
+ * @brief Decide whether the run ends after the current quantum
+ */
+bool HartGroup::isFinished()
+{
+    if(done >= budget || harts[0]->isHalted())
+        return true;
+    bool all_halted = true;
+    for(size_t i=0; i<harts.size(); i++)
+    {
+        if(failed[i])
+            return true;
+        all_halted = all_halted && harts[i]->isHalted();
+    }
+    return all_halted;
+}
+
+
+/**
+ * @brief Wait until all harts have finished the current quantum
+ * The last hart to arrive accounts for the quantum & publishes the decision
+ * to stop before advancing the epoch, which releases the others.
+ */
+void HartGroup::barrier()
+{
+    uint64_t e = epoch.load(std::memory_order_acquire);
+    if(arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == harts.size())
+    {
+        arrived.store(0, std::memory_order_relaxed);
+        done += quantum < budget - done ? quantum : budget - done;
+        finished = isFinished();
+        epoch.store(e + 1, std::memory_order_release);
+        return;
+    }
+
+    unsigned int spins = 0;
+    while(epoch.load(std::memory_order_acquire) == e)
+    {
+        if(++spins > spinLimit)
+            std::this_thread::yield();
+    }
+}
+
+
+/**
+ * @brief Thread body of a hart
+ */
+void HartGroup::worker(unsigned int idx)
+{
+    // A fatal error must not exit (& free memory) under the other harts, it
+    // ends the run at the next barrier & is reported once all threads joined
+    bool prev = SimError::setThrowOnFatal(true);
+    RVCPU * hart = harts[idx];
+    while(true)
+    {
+        // done & finished only change while every hart waits at the barrier
+        uint64_t n = quantum < budget - done ? quantum : budget - done;
+        if(!failed[idx] && !hart->isHalted())
+        {
+            try
+            {
+                hart->run(n);
+            }
+            catch(const SimError::Fatal &e)
+            {
+                errors[idx] = e.message;
+                failed[idx] = 1;
+            }
+        }
+
+        barrier();
+        if(finished)
+            break;
+    }
+    SimError::setThrowOnFatal(prev);
+}
+
+
+/**
+ * @brief Run until hart 0 halts, all harts halt, or every hart ran
+ * ticks instructions
+ * 
+ * @param ticks instruction budget of each hart
+ */
+void HartGroup::run(uint64_t ticks)
+{
+    budget = ticks;
+    done = 0;
+    finished = isFinished();
+    if(finished)
+        return;
+
+    if(deterministic || harts.size() == 1)
+    {
+        while(!finished)
+        {
+            uint64_t n = quantum < budget - done ? quantum : budget - done;
+            for(size_t i=0; i<harts.size(); i++)
+            {
+                if(!harts[i]->isHalted())
+                    harts[i]->run(n);
+            }
+            done += n;
+            finished = isFinished();
+        }
+        return;
+    }
+
+    // Hart 0 runs on the calling thread
+    std::vector<std::thread> threads;
+    for(unsigned int i=1; i<harts.size(); i++)
+        threads.push_back(std::thread(&HartGroup::worker, this, i));
+    worker(0);
+    for(size_t i=0; i<threads.size(); i++)
+        threads[i].join();
+
+    for(size_t i=0; i<harts.size(); i++)
+    {
+        if(failed[i])
+        {
+            failed[i] = 0;
+            SimError::throwError("Hart " + std::to_string(i) + ": " + errors[i], true);
+        }
+    }
+}
@@ -0,0 +1,261 @@
+#include <string.h>
+
+#include "History.h"
+
+
+/**
+ * @brief Construct a new History object & attach it to the CPU
+ * 
+ * @param cpu CPU
+ * @param bus bus giving access to memory pages
+ * @param interval instructions between checkpoints
+ * @param budget memory budget in bytes
+ */
+History::History(RVCPU * cpu, Bus<REG> * bus, uint64_t interval, uint64_t budget)
+{
+    this->cpu = cpu;
+    this->bus = bus;
+    this->interval = interval ? interval : 1;
+    this->budget = budget;
+    bytes = 0;
+    nextAt = 0;
+    stopReason = STOP_NONE;
+
+    cpu->setHistory(this);
+    checkpoint();
+}
+
+
+/**
+ * @brief Destroy the History object & detach it from the CPU
+ * 
+ */
+History::~History()
+{
+    cpu->setHistory(NULL);
+}
+
+
+/**
+ * @brief Take a checkpoint
+ */
+void History::checkpoint()
+{
+    uint64_t now = cpu->instret;
+
+    // Nothing happened since the newest checkpoint, replace it
+    if(checkpoints.empty() || checkpoints.back().cpu.instret != now || !checkpoints.back().pages.empty())
+    {
+        checkpoints.push_back(Checkpoint());
+        bytes += sizeof(Checkpoint);
+    }
+    cpu->saveSnapshot(checkpoints.back().cpu);
+
+    saved.clear();
+    nextAt = now + interval;
+    evict();
+}
+
+
+/**
+ * @brief Copy a page before it is written (once per checkpoint)
+ */
+void History::saveBeforeWrite(REG page)
+{
+    if(!saved.insert(page).second)
+        return;
+
+    const unsigned int page_size = 1 << RVCPU::PAGE_SHIFT;
+    uint8_t * host = bus->hostPage(page, page_size);
+    if(!host)
+        return;
+
+    checkpoints.back().pages.push_back(PageImage());
+    PageImage &img = checkpoints.back().pages.back();
+    img.page = page;
+    img.data.assign(host, host + page_size);
+    bytes += page_size;
+    evict();
+}
+
+
+/**
+ * @brief Drop oldest checkpoints until within budget
+ * The only checkpoint left can't be dropped while an instruction is writing,
+ * if it alone is over budget the next checkpoint is taken at the end of the
+ * current block & replaces it.
+ */
+void History::evict()
+{
+    while(bytes > budget && checkpoints.size() > 1)
+    {
+        bytes -= sizeof(Checkpoint) + checkpoints.front().pages.size() * (1 << RVCPU::PAGE_SHIFT);
+        checkpoints.pop_front();
+    }
+    if(bytes > budget && !checkpoints.back().pages.empty())
+        nextAt = 0;
+}
+
+
+/**
+ * @brief Discard all history & start over from the current state
+ */
+void History::rebase()
+{
+    checkpoints.clear();
+    saved.clear();
+    bytes = 0;
+    checkpoint();
+}
+
+
+/**
+ * @brief Rewind to a checkpoint, discarding newer ones
+ */
+void History::restore(size_t idx)
+{
+    const unsigned int page_size = 1 << RVCPU::PAGE_SHIFT;
+    std::vector<REG> pages;
+
+    // Undo writes newest first, leaving each page as it was at checkpoint idx
+    for(size_t i = checkpoints.size(); i-- > idx; )
+    {
+        Checkpoint &cp = checkpoints[i];
+        for(size_t p=0; p<cp.pages.size(); p++)
+        {
+            memcpy(bus->hostPage(cp.pages[p].page, page_size), cp.pages[p].data.data(), page_size);
+            pages.push_back(cp.pages[p].page);
+        }
+        bytes -= cp.pages.size() * page_size;
+        cp.pages.clear();
+
+        if(i > idx)
+        {
+            bytes -= sizeof(Checkpoint);
+            checkpoints.pop_back();
+        }
+    }
+
+    saved.clear();
+    cpu->restoreSnapshot(checkpoints[idx].cpu);
+    if(!pages.empty())
+        cpu->invalidateDecodedPages(pages);
+    nextAt = checkpoints[idx].cpu.instret + interval;
+}
+
+
+/**
+ * @brief Execute until target instructions have retired
+ */
+bool History::replay(uint64_t target, uint64_t * last_stop)
+{
+    bool found = false;
+
+    // A breakpoint at the starting point is stepped over by run
+    if(last_stop && cpu->instret < target && cpu->hasBreakpoint(cpu->state.PC))
+    {
+        *last_stop = cpu->instret;
+        stopReason = STOP_BREAKPOINT;
+        found = true;
+    }
+
+    while(cpu->instret < target && !cpu->halted)
+    {
+        cpu->run(target - cpu->instret);
+
+        StopReason reason = cpu->stopReason;
+        if(last_stop && (reason == STOP_BREAKPOINT || reason == STOP_WATCHPOINT) && cpu->instret < target)
+        {
+            *last_stop = cpu->instret;
+            stopReason = reason;
+            stopWatch = cpu->watchHit;
+            found = true;
+        }
+    }
+    return found;
+}
+
+
+/**
+ * @brief Find newest checkpoint taken before an instruction count
+ */
+int History::findCheckpoint(uint64_t instret, bool inclusive)
+{
+    for(size_t i = checkpoints.size(); i-- > 0; )
+    {
+        uint64_t at = checkpoints[i].cpu.instret;
+        if(at < instret || (inclusive && at == instret))
+            return (int)i;
+    }
+    return -1;
+}
+
+
+/**
+ * @brief Go back one instruction
+ */
+bool History::reverseStep()
+{
+    uint64_t now = cpu->instret;
+    int idx = findCheckpoint(now, false);
+    if(idx < 0)
+        return false;
+
+    restore(idx);
+    replay(now - 1);
+    return true;
+}
+
+
+/**
+ * @brief Go back to the most recent breakpoint or watchpoint stop
+ */
+bool History::reverseContinue()
+{
+    uint64_t end = cpu->instret;
+    int idx;
+
+    // Search backwards one checkpoint interval at a time
+    while((idx = findCheckpoint(end, false)) >= 0)
+    {
+        uint64_t start = checkpoints[idx].cpu.instret;
+        uint64_t stop_at;
+
+        restore(idx);
+        if(replay(end, &stop_at))
+        {
+            // Checkpoints may have been evicted while replaying
+            int from = findCheckpoint(stop_at, true);
+            if(from < 0)
+                break;
+            restore(from);
+            replay(stop_at);
+            cpu->stopReason = stopReason;
+            cpu->watchHit = stopWatch;
+            return true;
+        }
+        end = start;
+    }
+
+    // Reached the oldest checkpoint
+    restore(0);
+    return false;
+}
+
+
+/**
+ * @brief Get number of checkpoints
+ */
+size_t History::getCheckpointCount()
+{
+    return checkpoints.size();
+}
+
+
+/**
+ * @brief Get memory used by checkpoints in bytes
+ */
+uint64_t History::getBytes()
+{
+    return bytes;
+}
@@ -1,7 +1,11 @@
 #include <vector>
+#include <fstream>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "Memory.h"
 #include "SimError.h"
+#include "RVdefs.h"
 #include "elfio.hpp"
 
 /**
@@ -13,9 +17,12 @@ Memory::Memory(uint64_t max_addr)
 {
     size = max_addr;
 
-    // Allocate memory
-    if(!(mem = new uint8_t[max_addr])) 
+    // Allocate memory, anonymous mappings are zero filled & only backed by
+    // host pages once touched
+    mem = (uint8_t *) mmap(NULL, max_addr, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(mem == MAP_FAILED) 
     {
+        mem = NULL;
         SimError::throwError("Failed to allocate memory object", true);
     }
 }
@@ -27,7 +34,9 @@ Memory::Memory(uint64_t max_addr)
  */
 Memory::~Memory()
 {
-    delete [] mem;
+    if(mem)
+        munmap(mem, size);
+    mem = NULL;
     size = 0;
 }
 
@@ -45,6 +54,65 @@ bool Memory::isValidAddress(uint64_t addr)
 }
 
 
+/**
+ * @brief Count host pages of the memory array that have been touched
+ * 
+ * @return uint64_t number of resident pages
+ */
+uint64_t Memory::pagesTouched()
+{
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    uint64_t npages = (size + page_size - 1) / page_size;
+    std::vector<unsigned char> residency(npages);
+
+    if(mincore(mem, size, residency.data()) != 0)
+        return 0;
+
+    uint64_t count = 0;
+    for(uint64_t i=0; i<npages; i++)
+        count += residency[i] & 1;
+    return count;
+}
+
+
+/**
+ * @brief Map part of a file copy-on-write over memory
+ * 
+ * @param fd file descriptor
+ * @param offset file offset
+ * @param addr memory address
+ * @param len length in bytes
+ * @return true if successful
+ */
+bool Memory::mapFile(int fd, uint64_t offset, uint64_t addr, uint64_t len)
+{
+    if(len == 0)
+        return true;
+    if(addr + len > size)
+        return false;
+
+    // Private mapping, writes by the simulation never reach the file
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+    if((offset | addr | len) % page_size == 0)
+    {
+        void * p = mmap(mem + addr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, offset);
+        if(p != MAP_FAILED)
+            return true;
+    }
+
+    while(len > 0)
+    {
+        ssize_t n = pread(fd, mem + addr, len, offset);
+        if(n <= 0)
+            return false;
+        addr += n;
+        offset += n;
+        len -= n;
+    }
+    return true;
+}
+
+
 /**
  * @brief Fetch an 8-bit byte from memory
  * 
@@ -90,19 +158,38 @@ void Memory::store(uint64_t addr, uint8_t byte)
  * @param flags_signatures allowed flag signatures
  */
 unsigned int Memory::initFromElf(std::string ifile, std::vector<int> flags_signatures)
+{
+    std::ifstream stream(ifile.c_str(), std::ios::in | std::ios::binary);
+    if (!stream) 
+    {
+        SimError::throwError("Can't find or process ELF file : " + ifile + "\n", true);
+    }
+    return initFromElf(stream, flags_signatures, ifile);
+}
+
+
+/**
+ * @brief Initialize memory from an elf image read from a stream
+ * only sections that match flag signatures are loaded
+ * 
+ * @param stream elf image
+ * @param flags_signatures allowed flag signatures
+ * @param name name of the image used in error messages
+ */
+unsigned int Memory::initFromElf(std::istream &stream, std::vector<int> flags_signatures, std::string name)
 {
     // Initialize Memory object from input ELF File
     ELFIO::elfio reader;
 
     // Load file into elf reader
-    if (!reader.load(ifile)) 
+    if (!reader.load(stream)) 
     {
-        SimError::throwError("Can't find or process ELF file : " + ifile + "\n", true);
+        SimError::throwError("Can't find or process ELF file : " + name + "\n", true);
     }
 
     // Check ELF Class, Endiness & segment count
-    if(reader.get_class() != ELFCLASS32)
-        SimError::throwError("Elf file format invalid: should be 32-bit elf\n", true);
+    if(reader.get_class() != (XLEN == 32 ? ELFCLASS32 : ELFCLASS64))
+        SimError::throwError("Elf file format invalid: should be " + std::to_string(XLEN) + "-bit elf\n", true);
     if(reader.get_encoding() != ELFDATA2LSB)
         SimError::throwError("Elf file format invalid: should be little Endian\n", true);
 
@@ -143,6 +230,7 @@ unsigned int Memory::initFromElf(std::string ifile, std::vector<int> flags_signa
                     store(seg_strt_addr + offset, seg_data[offset]);
                     offset++;
                 }
+                segments.push_back({seg_strt_addr, seg_size, seg_flags});
 
                 //if(verbose_flag)
                 //	printf("done\n");
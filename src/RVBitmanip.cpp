@@ -0,0 +1,127 @@
+#include "RVBitmanip.h"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define RVBITMANIP_X86
+#endif
+
+// ================================ Portable code =================================
+static unsigned int clzPortable(uint64_t x)
+{
+    return x ? __builtin_clzll(x) : 64;
+}
+
+static unsigned int ctzPortable(uint64_t x)
+{
+    return x ? __builtin_ctzll(x) : 64;
+}
+
+static unsigned int cpopPortable(uint64_t x)
+{
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (x * 0x0101010101010101ULL) >> 56;
+}
+
+static uint64_t clmulPortable(uint64_t a, uint64_t b, uint64_t &hi)
+{
+    uint64_t lo = a & -(b & 1);
+    hi = 0;
+    for(unsigned int i=1; i<64; i++)
+    {
+        uint64_t mask = -((b >> i) & 1);
+        lo ^= (a << i) & mask;
+        hi ^= (a >> (64 - i)) & mask;
+    }
+    return lo;
+}
+
+// =================================== x86-64 =====================================
+#ifdef RVBITMANIP_X86
+__attribute__((target("lzcnt")))
+static unsigned int clzHost(uint64_t x)
+{
+    return _lzcnt_u64(x);
+}
+
+__attribute__((target("bmi")))
+static unsigned int ctzHost(uint64_t x)
+{
+    return _tzcnt_u64(x);
+}
+
+__attribute__((target("popcnt")))
+static unsigned int cpopHost(uint64_t x)
+{
+    return _mm_popcnt_u64(x);
+}
+
+__attribute__((target("pclmul,sse4.1")))
+static uint64_t clmulHost(uint64_t a, uint64_t b, uint64_t &hi)
+{
+    __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128(a), _mm_cvtsi64_si128(b), 0x00);
+    hi = _mm_extract_epi64(p, 1);
+    return _mm_cvtsi128_si64(p);
+}
+#endif
+
+
+/**
+ * @brief Detect features of the host CPU
+ */
+static RVBitmanip::HostFeatures detectFeatures()
+{
+    RVBitmanip::HostFeatures f = {false, false, false, false};
+#ifdef RVBITMANIP_X86
+    unsigned int eax, ebx, ecx, edx;
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        f.popcnt = (ecx >> 23) & 1;
+        f.pclmul = ((ecx >> 1) & 1) && ((ecx >> 19) & 1);     // with SSE4.1 for the extract
+    }
+    if(__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx))
+        f.lzcnt = (ecx >> 5) & 1;
+    if(__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        f.tzcnt = (ebx >> 3) & 1;
+#endif
+    return f;
+}
+
+static const RVBitmanip::HostFeatures features = detectFeatures();
+
+
+/**
+ * @brief Get features of the host CPU (detected at startup)
+ */
+const RVBitmanip::HostFeatures & RVBitmanip::hostFeatures()
+{
+    return features;
+}
+
+
+// Implementations are selected once, at static initialization
+#ifdef RVBITMANIP_X86
+unsigned int (*RVBitmanip::clz64)(uint64_t) = features.lzcnt ? clzHost : clzPortable;
+unsigned int (*RVBitmanip::ctz64)(uint64_t) = features.tzcnt ? ctzHost : ctzPortable;
+unsigned int (*RVBitmanip::cpop64)(uint64_t) = features.popcnt ? cpopHost : cpopPortable;
+uint64_t (*RVBitmanip::clmul64)(uint64_t, uint64_t, uint64_t &) = features.pclmul ? clmulHost : clmulPortable;
+#else
+unsigned int (*RVBitmanip::clz64)(uint64_t) = clzPortable;
+unsigned int (*RVBitmanip::ctz64)(uint64_t) = ctzPortable;
+unsigned int (*RVBitmanip::cpop64)(uint64_t) = cpopPortable;
+uint64_t (*RVBitmanip::clmul64)(uint64_t, uint64_t, uint64_t &) = clmulPortable;
+#endif
+
+
+/**
+ * @brief Use the portable implementations whatever the host supports
+ */
+void RVBitmanip::usePortable()
+{
+    clz64 = clzPortable;
+    ctz64 = ctzPortable;
+    cpop64 = cpopPortable;
+    clmul64 = clmulPortable;
+}
@@ -1,64 +1,4293 @@
 #include <iostream>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <string.h>
 
 #include "RVCPU.h"
+#include "RVInstr.h"
+#include "RVFloat.h"
+#include "RVCompressed.h"
+#include "RVBitmanip.h"
+#include "RVCrypto.h"
+#include "History.h"
+#include "Memory.h"
+#include "SimError.h"
+
+// ============================== Instruction table ==============================
+/**
+ * @brief Raised to stop before an instruction, abandoning the rest of the
+ * executing block
+ */
+struct StopHit
+{
+    const DecodedInstr * instr;
+    StopReason reason;
+};
+
+/**
+ * @brief Raised to take an exception on an instruction, abandoning the rest
+ * of the executing block
+ */
+struct TrapHit
+{
+    const DecodedInstr * instr;
+    unsigned int cause;
+    REG tval;
+};
+
+/**
+ * @brief Instruction handlers
+ */
+struct RVExec
+{
+    // ================ Integer computational ================
+    static void LUI(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REG)in.imm; }
+    static void AUIPC(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = in.pc + in.imm; }
+
+    static void ADDI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] + in.imm; }
+    static void SLTI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)cpu.state.X[in.rs1] < in.imm; }
+    static void SLTIU(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = cpu.state.X[in.rs1] < (REG)in.imm; }
+    static void XORI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] ^ in.imm; }
+    static void ORI(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] | in.imm; }
+    static void ANDI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] & in.imm; }
+    static void SLLI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] << in.imm; }
+    static void SRLI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] >> in.imm; }
+    static void SRAI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)cpu.state.X[in.rs1] >> in.imm; }
+
+    static void ADD(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] + cpu.state.X[in.rs2]; }
+    static void SUB(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] - cpu.state.X[in.rs2]; }
+    static void SLL(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] << (cpu.state.X[in.rs2] & (XLEN-1)); }
+    static void SLT(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REGS)cpu.state.X[in.rs1] < (REGS)cpu.state.X[in.rs2]; }
+    static void SLTU(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] < cpu.state.X[in.rs2]; }
+    static void XOR(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] ^ cpu.state.X[in.rs2]; }
+    static void SRL(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] >> (cpu.state.X[in.rs2] & (XLEN-1)); }
+    static void SRA(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REGS)cpu.state.X[in.rs1] >> (cpu.state.X[in.rs2] & (XLEN-1)); }
+    static void OR(RVCPU &cpu, const DecodedInstr &in)      { cpu.state.X[in.rd] = cpu.state.X[in.rs1] | cpu.state.X[in.rs2]; }
+    static void AND(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] & cpu.state.X[in.rs2]; }
+
+    // RV64 only
+    static void ADDIW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)(int32_t)(cpu.state.X[in.rs1] + in.imm); }
+    static void SLLIW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)(int32_t)((uint32_t)cpu.state.X[in.rs1] << in.imm); }
+    static void SRLIW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)(int32_t)((uint32_t)cpu.state.X[in.rs1] >> in.imm); }
+    static void SRAIW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)((int32_t)cpu.state.X[in.rs1] >> in.imm); }
+    static void ADDW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)(cpu.state.X[in.rs1] + cpu.state.X[in.rs2]); }
+    static void SUBW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)(cpu.state.X[in.rs1] - cpu.state.X[in.rs2]); }
+    static void SLLW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)((uint32_t)cpu.state.X[in.rs1] << (cpu.state.X[in.rs2] & 31)); }
+    static void SRLW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)((uint32_t)cpu.state.X[in.rs1] >> (cpu.state.X[in.rs2] & 31)); }
+    static void SRAW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)((int32_t)cpu.state.X[in.rs1] >> (cpu.state.X[in.rs2] & 31)); }
+
+    // ================ Multiply/Divide (M) ================
+    // High halves come from host double width products (imul/mul on x86-64)
+    static void MUL(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] * cpu.state.X[in.rs2]; }
+    static void MULH(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REG)(((DREGS)(REGS)cpu.state.X[in.rs1] * (DREGS)(REGS)cpu.state.X[in.rs2]) >> XLEN); }
+    static void MULHSU(RVCPU &cpu, const DecodedInstr &in)  { cpu.state.X[in.rd] = (REG)(((DREGS)(REGS)cpu.state.X[in.rs1] * (DREGS)cpu.state.X[in.rs2]) >> XLEN); }
+    static void MULHU(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REG)(((DREG)cpu.state.X[in.rs1] * (DREG)cpu.state.X[in.rs2]) >> XLEN); }
+
+    // Division by zero & signed overflow are handled without branches: the
+    // divisor is replaced by 1 (a / 1 is already the overflow result) & the
+    // division by zero result is merged in with masks
+    template <typename S>
+    static inline S divSigned(S a, S b)
+    {
+        S zero = (b == 0);
+        S special = zero | ((a == std::numeric_limits<S>::min()) & (b == -1));
+        S d = b ^ ((b ^ 1) & -special);
+        return (a / d) | -zero;
+    }
+
+    template <typename S>
+    static inline S remSigned(S a, S b)
+    {
+        S zero = (b == 0);
+        S special = zero | ((a == std::numeric_limits<S>::min()) & (b == -1));
+        S d = b ^ ((b ^ 1) & -special);
+        return (a % d) | (a & -zero);
+    }
+
+    template <typename U>
+    static inline U divUnsigned(U a, U b)
+    {
+        U zero = (b == 0);
+        return (a / (b | zero)) | -zero;
+    }
+
+    template <typename U>
+    static inline U remUnsigned(U a, U b)
+    {
+        U zero = (b == 0);
+        return (a % (b | zero)) | (a & -zero);
+    }
+
+    static void DIV(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = divSigned<REGS>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void DIVU(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = divUnsigned<REG>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void REM(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = remSigned<REGS>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void REMU(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = remUnsigned<REG>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+
+    // RV64 only
+    static void MULW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)(cpu.state.X[in.rs1] * cpu.state.X[in.rs2]); }
+    static void DIVW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)divSigned<int32_t>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void DIVUW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)(int32_t)divUnsigned<uint32_t>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void REMW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)remSigned<int32_t>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void REMUW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)(int32_t)remUnsigned<uint32_t>(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+
+    // ================ Bit manipulation (Zba/Zbb/Zbc/Zbs) ================
+    // Address generation
+    template <int sh>
+    static void SHADD(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (cpu.state.X[in.rs1] << sh) + cpu.state.X[in.rs2]; }
+
+    template <int sh>
+    static void SHADD_UW(RVCPU &cpu, const DecodedInstr &in) { cpu.state.X[in.rd] = ((REG)(uint32_t)cpu.state.X[in.rs1] << sh) + cpu.state.X[in.rs2]; }
+
+    static void SH1ADD(RVCPU &cpu, const DecodedInstr &in)  { SHADD<1>(cpu, in); }
+    static void SH2ADD(RVCPU &cpu, const DecodedInstr &in)  { SHADD<2>(cpu, in); }
+    static void SH3ADD(RVCPU &cpu, const DecodedInstr &in)  { SHADD<3>(cpu, in); }
+    static void ADD_UW(RVCPU &cpu, const DecodedInstr &in)  { SHADD_UW<0>(cpu, in); }
+    static void SH1ADD_UW(RVCPU &cpu, const DecodedInstr &in) { SHADD_UW<1>(cpu, in); }
+    static void SH2ADD_UW(RVCPU &cpu, const DecodedInstr &in) { SHADD_UW<2>(cpu, in); }
+    static void SH3ADD_UW(RVCPU &cpu, const DecodedInstr &in) { SHADD_UW<3>(cpu, in); }
+    static void SLLI_UW(RVCPU &cpu, const DecodedInstr &in) { cpu.state.X[in.rd] = (REG)(uint32_t)cpu.state.X[in.rs1] << in.imm; }
+
+    // Basic bit manipulation, counts use host instructions (RVBitmanip)
+    static inline REG rotl(REG x, unsigned int s)           { return (x << s) | (x >> ((XLEN - s) & (XLEN - 1))); }
+    static inline uint32_t rotl32(uint32_t x, unsigned int s) { return (x << s) | (x >> ((32 - s) & 31)); }
+
+    static void ANDN(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] & ~cpu.state.X[in.rs2]; }
+    static void ORN(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = cpu.state.X[in.rs1] | ~cpu.state.X[in.rs2]; }
+    static void XNOR(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = ~(cpu.state.X[in.rs1] ^ cpu.state.X[in.rs2]); }
+    static void CLZ(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = RVBitmanip::clz64((uint64_t)cpu.state.X[in.rs1]) - (64 - XLEN); }
+    static void CTZ(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = RVBitmanip::ctz64((uint64_t)cpu.state.X[in.rs1] | (XLEN == 32 ? 1ULL << 32 : 0)); }
+    static void CPOP(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = RVBitmanip::cpop64((uint64_t)cpu.state.X[in.rs1]); }
+    static void MAX(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REGS)cpu.state.X[in.rs1] > (REGS)cpu.state.X[in.rs2] ? cpu.state.X[in.rs1] : cpu.state.X[in.rs2]; }
+    static void MAXU(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] > cpu.state.X[in.rs2] ? cpu.state.X[in.rs1] : cpu.state.X[in.rs2]; }
+    static void MIN(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REGS)cpu.state.X[in.rs1] < (REGS)cpu.state.X[in.rs2] ? cpu.state.X[in.rs1] : cpu.state.X[in.rs2]; }
+    static void MINU(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] < cpu.state.X[in.rs2] ? cpu.state.X[in.rs1] : cpu.state.X[in.rs2]; }
+    static void SEXT_B(RVCPU &cpu, const DecodedInstr &in)  { cpu.state.X[in.rd] = (REGS)(int8_t)cpu.state.X[in.rs1]; }
+    static void SEXT_H(RVCPU &cpu, const DecodedInstr &in)  { cpu.state.X[in.rd] = (REGS)(int16_t)cpu.state.X[in.rs1]; }
+    static void ZEXT_H(RVCPU &cpu, const DecodedInstr &in)  { cpu.state.X[in.rd] = (uint16_t)cpu.state.X[in.rs1]; }
+    static void ROL(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = rotl(cpu.state.X[in.rs1], cpu.state.X[in.rs2] & (XLEN - 1)); }
+    static void ROR(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = rotl(cpu.state.X[in.rs1], -cpu.state.X[in.rs2] & (XLEN - 1)); }
+    static void RORI(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = rotl(cpu.state.X[in.rs1], -in.imm & (XLEN - 1)); }
+    static void REV8(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = XLEN == 32 ? (REG)__builtin_bswap32(cpu.state.X[in.rs1]) : (REG)__builtin_bswap64(cpu.state.X[in.rs1]); }
+
+    // Every non-zero byte becomes 0xff (no carries cross bytes)
+    static void ORC_B(RVCPU &cpu, const DecodedInstr &in)
+    {
+        const REG low7 = (REG)0x7f7f7f7f7f7f7f7fULL;
+        REG x = cpu.state.X[in.rs1];
+        REG t = (((x & low7) + low7) | x) & ~low7;
+        cpu.state.X[in.rd] = (t >> 7) * 0xff;
+    }
+
+    // RV64 only
+    static void CLZW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = RVBitmanip::clz64((uint32_t)cpu.state.X[in.rs1]) - 32; }
+    static void CTZW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = RVBitmanip::ctz64((uint32_t)cpu.state.X[in.rs1] | (1ULL << 32)); }
+    static void CPOPW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = RVBitmanip::cpop64((uint32_t)cpu.state.X[in.rs1]); }
+    static void ROLW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)rotl32(cpu.state.X[in.rs1], cpu.state.X[in.rs2] & 31); }
+    static void RORW(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (REGS)(int32_t)rotl32(cpu.state.X[in.rs1], -cpu.state.X[in.rs2] & 31); }
+    static void RORIW(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (REGS)(int32_t)rotl32(cpu.state.X[in.rs1], -in.imm & 31); }
+
+    // Carry-less multiply: 0: clmul (low half), 1: clmulh (high half),
+    // 2: clmulr (bits 2*XLEN-2:XLEN-1)
+    template <int part>
+    static void CLMUL(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint64_t hi;
+        uint64_t lo = RVBitmanip::clmul64((uint64_t)cpu.state.X[in.rs1], (uint64_t)cpu.state.X[in.rs2], hi);
+        if(XLEN == 32)
+            cpu.state.X[in.rd] = (REG)(lo >> (part == 0 ? 0 : (part == 1 ? 32 : 31)));
+        else
+            cpu.state.X[in.rd] = (REG)(part == 0 ? lo : (part == 1 ? hi : (hi << 1) | (lo >> 63)));
+    }
+
+    static void CLMUL_L(RVCPU &cpu, const DecodedInstr &in) { CLMUL<0>(cpu, in); }
+    static void CLMULH(RVCPU &cpu, const DecodedInstr &in)  { CLMUL<1>(cpu, in); }
+    static void CLMULR(RVCPU &cpu, const DecodedInstr &in)  { CLMUL<2>(cpu, in); }
+
+    // Single bit instructions
+    static inline REG bit(REG index)                        { return (REG)1 << (index & (XLEN - 1)); }
+
+    static void BCLR(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] & ~bit(cpu.state.X[in.rs2]); }
+    static void BEXT(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = (cpu.state.X[in.rs1] >> (cpu.state.X[in.rs2] & (XLEN - 1))) & 1; }
+    static void BINV(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] ^ bit(cpu.state.X[in.rs2]); }
+    static void BSET(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = cpu.state.X[in.rs1] | bit(cpu.state.X[in.rs2]); }
+    static void BCLRI(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = cpu.state.X[in.rs1] & ~bit(in.imm); }
+    static void BEXTI(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = (cpu.state.X[in.rs1] >> in.imm) & 1; }
+    static void BINVI(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = cpu.state.X[in.rs1] ^ bit(in.imm); }
+    static void BSETI(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = cpu.state.X[in.rs1] | bit(in.imm); }
+
+    // ================ Scalar cryptography (Zkn/Zks) ================
+    // Byte wide AES & SM4 (RVCrypto tables): rd = rs1 ^ (table[byte bs of rs2] rotated into byte bs)
+    template <int op>
+    static void BYTEOP(RVCPU &cpu, const DecodedInstr &in)
+    {
+        unsigned int shamt = in.imm * 8;
+        uint32_t t = RVCrypto::byteTables.t[op][(cpu.state.X[in.rs2] >> shamt) & 0xff];
+        cpu.state.X[in.rd] = (REGS)(int32_t)((uint32_t)cpu.state.X[in.rs1] ^ rotl32(t, shamt));
+    }
+
+    static void AES32ESI(RVCPU &cpu, const DecodedInstr &in)    { BYTEOP<RVCrypto::AES_ENC>(cpu, in); }
+    static void AES32ESMI(RVCPU &cpu, const DecodedInstr &in)   { BYTEOP<RVCrypto::AES_ENC_MIX>(cpu, in); }
+    static void AES32DSI(RVCPU &cpu, const DecodedInstr &in)    { BYTEOP<RVCrypto::AES_DEC>(cpu, in); }
+    static void AES32DSMI(RVCPU &cpu, const DecodedInstr &in)   { BYTEOP<RVCrypto::AES_DEC_MIX>(cpu, in); }
+    static void SM4ED(RVCPU &cpu, const DecodedInstr &in)       { BYTEOP<RVCrypto::SM4_ED>(cpu, in); }
+    static void SM4KS(RVCPU &cpu, const DecodedInstr &in)       { BYTEOP<RVCrypto::SM4_KS>(cpu, in); }
+
+    // RV64 AES on the state {rs2, rs1} (AES-NI when the host has it)
+    static void AES64ES(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = RVCrypto::aes64es(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void AES64ESM(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = RVCrypto::aes64esm(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void AES64DS(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = RVCrypto::aes64ds(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void AES64DSM(RVCPU &cpu, const DecodedInstr &in)    { cpu.state.X[in.rd] = RVCrypto::aes64dsm(cpu.state.X[in.rs1], cpu.state.X[in.rs2]); }
+    static void AES64IM(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = RVCrypto::aes64im(cpu.state.X[in.rs1]); }
+    static void AES64KS1I(RVCPU &cpu, const DecodedInstr &in)   { cpu.state.X[in.rd] = RVCrypto::aes64ks1i(cpu.state.X[in.rs1], in.imm); }
+
+    static void AES64KS2(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t w0 = (uint32_t)((uint64_t)cpu.state.X[in.rs1] >> 32) ^ (uint32_t)cpu.state.X[in.rs2];
+        uint32_t w1 = w0 ^ (uint32_t)((uint64_t)cpu.state.X[in.rs2] >> 32);
+        cpu.state.X[in.rd] = (REG)(((uint64_t)w1 << 32) | w0);
+    }
+
+    // SHA-2 sigma (two rotates & a shift) and sum (three rotates) functions
+    static inline uint32_t rotr32(uint32_t x, unsigned int s) { return (x >> s) | (x << (32 - s)); }
+    static inline uint64_t rotr64(uint64_t x, unsigned int s) { return (x >> s) | (x << (64 - s)); }
+
+    template <int r0, int r1, int r2, bool sum>
+    static void SHA256(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t x = cpu.state.X[in.rs1];
+        cpu.state.X[in.rd] = (REGS)(int32_t)(rotr32(x, r0) ^ rotr32(x, r1) ^ (sum ? rotr32(x, r2) : x >> r2));
+    }
+
+    template <int r0, int r1, int r2, bool sum>
+    static void SHA512(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint64_t x = cpu.state.X[in.rs1];
+        cpu.state.X[in.rd] = (REG)(rotr64(x, r0) ^ rotr64(x, r1) ^ (sum ? rotr64(x, r2) : x >> r2));
+    }
+
+    static void SHA256SIG0(RVCPU &cpu, const DecodedInstr &in)  { SHA256<7, 18, 3, false>(cpu, in); }
+    static void SHA256SIG1(RVCPU &cpu, const DecodedInstr &in)  { SHA256<17, 19, 10, false>(cpu, in); }
+    static void SHA256SUM0(RVCPU &cpu, const DecodedInstr &in)  { SHA256<2, 13, 22, true>(cpu, in); }
+    static void SHA256SUM1(RVCPU &cpu, const DecodedInstr &in)  { SHA256<6, 11, 25, true>(cpu, in); }
+    static void SHA512SIG0(RVCPU &cpu, const DecodedInstr &in)  { SHA512<1, 8, 7, false>(cpu, in); }
+    static void SHA512SIG1(RVCPU &cpu, const DecodedInstr &in)  { SHA512<19, 61, 6, false>(cpu, in); }
+    static void SHA512SUM0(RVCPU &cpu, const DecodedInstr &in)  { SHA512<28, 34, 39, true>(cpu, in); }
+    static void SHA512SUM1(RVCPU &cpu, const DecodedInstr &in)  { SHA512<14, 18, 41, true>(cpu, in); }
+
+    // RV32 SHA-512, one half of the 64-bit result from both halves of the
+    // operand (rs1: the same half, rs2: the other one)
+    static void SHA512SIG0H(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t a = cpu.state.X[in.rs1], b = cpu.state.X[in.rs2];
+        cpu.state.X[in.rd] = (a >> 1) ^ (a >> 7) ^ (a >> 8) ^ (b << 31) ^ (b << 24);
+    }
+
+    static void SHA512SIG0L(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t a = cpu.state.X[in.rs1], b = cpu.state.X[in.rs2];
+        cpu.state.X[in.rd] = (a >> 1) ^ (a >> 7) ^ (a >> 8) ^ (b << 31) ^ (b << 25) ^ (b << 24);
+    }
+
+    static void SHA512SIG1H(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t a = cpu.state.X[in.rs1], b = cpu.state.X[in.rs2];
+        cpu.state.X[in.rd] = (a << 3) ^ (a >> 6) ^ (a >> 19) ^ (b >> 29) ^ (b << 13);
+    }
+
+    static void SHA512SIG1L(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t a = cpu.state.X[in.rs1], b = cpu.state.X[in.rs2];
+        cpu.state.X[in.rd] = (a << 3) ^ (a >> 6) ^ (a >> 19) ^ (b >> 29) ^ (b << 26) ^ (b << 13);
+    }
+
+    static void SHA512SUM0R(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t a = cpu.state.X[in.rs1], b = cpu.state.X[in.rs2];
+        cpu.state.X[in.rd] = (a << 25) ^ (a << 30) ^ (a >> 28) ^ (b >> 7) ^ (b >> 2) ^ (b << 4);
+    }
+
+    static void SHA512SUM1R(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t a = cpu.state.X[in.rs1], b = cpu.state.X[in.rs2];
+        cpu.state.X[in.rd] = (a << 23) ^ (a >> 14) ^ (a >> 18) ^ (b >> 9) ^ (b << 18) ^ (b << 14);
+    }
+
+    // SM3 permutations
+    static void SM3P0(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t x = cpu.state.X[in.rs1];
+        cpu.state.X[in.rd] = (REGS)(int32_t)(x ^ rotl32(x, 9) ^ rotl32(x, 17));
+    }
+
+    static void SM3P1(RVCPU &cpu, const DecodedInstr &in)
+    {
+        uint32_t x = cpu.state.X[in.rs1];
+        cpu.state.X[in.rd] = (REGS)(int32_t)(x ^ rotl32(x, 15) ^ rotl32(x, 23));
+    }
+
+    // ================ Control transfer ================
+    // A misaligned target raises the exception on the jump itself
+    static inline void checkTarget(RVCPU &cpu, const DecodedInstr &in, REG target)
+    {
+        if(target & cpu.fetchAlignMask)
+            cpu.raiseException(in, CAUSE_MISALIGNED_FETCH, target);
+    }
+
+    static void JAL(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG target = in.pc + in.imm;
+        checkTarget(cpu, in, target);
+        cpu.state.X[in.rd] = in.pc + in.len;
+        cpu.state.PC = target;
+    }
+
+    static void JALR(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG target = (cpu.state.X[in.rs1] + in.imm) & ~(REG)1;
+        checkTarget(cpu, in, target);
+        cpu.state.X[in.rd] = in.pc + in.len;
+        cpu.state.PC = target;
+    }
+
+    static inline void branch(RVCPU &cpu, const DecodedInstr &in, bool taken)
+    {
+        if(taken)
+        {
+            checkTarget(cpu, in, in.pc + in.imm);
+            cpu.state.PC = in.pc + in.imm;
+            cpu.curBlock->taken_count++;
+        }
+    }
+
+    static void BEQ(RVCPU &cpu, const DecodedInstr &in)     { branch(cpu, in, cpu.state.X[in.rs1] == cpu.state.X[in.rs2]); }
+    static void BNE(RVCPU &cpu, const DecodedInstr &in)     { branch(cpu, in, cpu.state.X[in.rs1] != cpu.state.X[in.rs2]); }
+    static void BLT(RVCPU &cpu, const DecodedInstr &in)     { branch(cpu, in, (REGS)cpu.state.X[in.rs1] < (REGS)cpu.state.X[in.rs2]); }
+    static void BGE(RVCPU &cpu, const DecodedInstr &in)     { branch(cpu, in, (REGS)cpu.state.X[in.rs1] >= (REGS)cpu.state.X[in.rs2]); }
+    static void BLTU(RVCPU &cpu, const DecodedInstr &in)    { branch(cpu, in, cpu.state.X[in.rs1] < cpu.state.X[in.rs2]); }
+    static void BGEU(RVCPU &cpu, const DecodedInstr &in)    { branch(cpu, in, cpu.state.X[in.rs1] >= cpu.state.X[in.rs2]); }
+
+    // ================ Loads & Stores ================
+    static void LB(RVCPU &cpu, const DecodedInstr &in)      { cpu.state.X[in.rd] = (REGS)(int8_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 1); }
+    static void LH(RVCPU &cpu, const DecodedInstr &in)      { cpu.state.X[in.rd] = (REGS)(int16_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 2); }
+    static void LW(RVCPU &cpu, const DecodedInstr &in)      { cpu.state.X[in.rd] = (REGS)(int32_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 4); }
+    static void LD(RVCPU &cpu, const DecodedInstr &in)      { cpu.state.X[in.rd] = cpu.load(in, cpu.state.X[in.rs1] + in.imm, 8); }
+    static void LBU(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (uint8_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 1); }
+    static void LHU(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (uint16_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 2); }
+    static void LWU(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (uint32_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 4); }
+
+    static void SB(RVCPU &cpu, const DecodedInstr &in)      { cpu.store(in, cpu.state.X[in.rs1] + in.imm, cpu.state.X[in.rs2], 1); }
+    static void SH(RVCPU &cpu, const DecodedInstr &in)      { cpu.store(in, cpu.state.X[in.rs1] + in.imm, cpu.state.X[in.rs2], 2); }
+    static void SW(RVCPU &cpu, const DecodedInstr &in)      { cpu.store(in, cpu.state.X[in.rs1] + in.imm, cpu.state.X[in.rs2], 4); }
+    static void SD(RVCPU &cpu, const DecodedInstr &in)      { cpu.store(in, cpu.state.X[in.rs1] + in.imm, cpu.state.X[in.rs2], 8); }
+
+    // ================ Atomics ================
+    enum AMOOp { AMO_SWAP, AMO_ADD, AMO_XOR, AMO_AND, AMO_OR, AMO_MIN, AMO_MAX, AMO_MINU, AMO_MAXU };
+
+    // Value an AMO writes to memory
+    template <typename T, int op>
+    static inline T amoResult(T old, T src)
+    {
+        typedef typename std::make_signed<T>::type S;
+        switch(op)
+        {
+            case AMO_SWAP:  return src;
+            case AMO_ADD:   return old + src;
+            case AMO_XOR:   return old ^ src;
+            case AMO_AND:   return old & src;
+            case AMO_OR:    return old | src;
+            case AMO_MIN:   return (S)old < (S)src ? old : src;
+            case AMO_MAX:   return (S)old > (S)src ? old : src;
+            case AMO_MINU:  return old < src ? old : src;
+            default:        return old > src ? old : src;
+        }
+    }
+
+    // Values loaded into rd are sign extended
+    template <typename T>
+    static inline REG extend(T value)                       { return (REG)(REGS)(typename std::make_signed<T>::type)value; }
+
+    template <typename T>
+    static void LR(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG addr = cpu.state.X[in.rs1];
+        REG pa = addr;
+        T * p = (T *)cpu.atomicAddress(in, addr, sizeof(T), WATCH_READ, pa);
+        T value = p ? __atomic_load_n(p, __ATOMIC_ACQUIRE) : (T)cpu.bus->request(pa, 0, (1 << sizeof(T)) - 1, false);
+
+        cpu.resAddr = addr;
+        cpu.resValue = value;
+        cpu.resSize = sizeof(T);
+        cpu.resValid = true;
+        cpu.state.X[in.rd] = extend(value);
+    }
+
+    template <typename T>
+    static void SC(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG addr = cpu.state.X[in.rs1];
+        bool ok = false;
+        if(cpu.resValid && cpu.resAddr == addr && cpu.resSize == sizeof(T))
+        {
+            // Succeeds if memory still holds the value the lr loaded
+            REG pa = addr;
+            T * p = (T *)cpu.atomicAddress(in, addr, sizeof(T), WATCH_WRITE, pa);
+            T expected = (T)cpu.resValue;
+            T src = (T)cpu.state.X[in.rs2];
+            if(p)
+                ok = __atomic_compare_exchange_n(p, &expected, src, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+            else if((T)cpu.bus->request(pa, 0, (1 << sizeof(T)) - 1, false) == expected)
+            {
+                cpu.bus->request(pa, (REG)src, (1 << sizeof(T)) - 1, true);
+                ok = true;
+            }
+        }
+        cpu.resValid = false;
+        cpu.state.X[in.rd] = !ok;
+    }
+
+    template <typename T, int op>
+    static void AMO(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG addr = cpu.state.X[in.rs1];
+        T src = (T)cpu.state.X[in.rs2];
+        REG pa = addr;
+        T * p = (T *)cpu.atomicAddress(in, addr, sizeof(T), WATCH_ACCESS, pa);
+        T old;
+
+        if(!p)
+        {
+            old = (T)cpu.bus->request(pa, 0, (1 << sizeof(T)) - 1, false);
+            cpu.bus->request(pa, (REG)amoResult<T, op>(old, src), (1 << sizeof(T)) - 1, true);
+        }
+        else
+        {
+            switch(op)
+            {
+                case AMO_SWAP:  old = __atomic_exchange_n(p, src, __ATOMIC_SEQ_CST); break;
+                case AMO_ADD:   old = __atomic_fetch_add(p, src, __ATOMIC_SEQ_CST); break;
+                case AMO_XOR:   old = __atomic_fetch_xor(p, src, __ATOMIC_SEQ_CST); break;
+                case AMO_AND:   old = __atomic_fetch_and(p, src, __ATOMIC_SEQ_CST); break;
+                case AMO_OR:    old = __atomic_fetch_or(p, src, __ATOMIC_SEQ_CST); break;
+                default:
+                    // No host instruction for min/max, retry until no other hart intervened
+                    old = __atomic_load_n(p, __ATOMIC_RELAXED);
+                    while(!__atomic_compare_exchange_n(p, &old, amoResult<T, op>(old, src), true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+                    break;
+            }
+        }
+        cpu.state.X[in.rd] = extend(old);
+    }
+
+    static void LR_W(RVCPU &cpu, const DecodedInstr &in)       { LR<uint32_t>(cpu, in); }
+    static void SC_W(RVCPU &cpu, const DecodedInstr &in)       { SC<uint32_t>(cpu, in); }
+    static void AMOSWAP_W(RVCPU &cpu, const DecodedInstr &in)  { AMO<uint32_t, AMO_SWAP>(cpu, in); }
+    static void AMOADD_W(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint32_t, AMO_ADD>(cpu, in); }
+    static void AMOXOR_W(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint32_t, AMO_XOR>(cpu, in); }
+    static void AMOAND_W(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint32_t, AMO_AND>(cpu, in); }
+    static void AMOOR_W(RVCPU &cpu, const DecodedInstr &in)    { AMO<uint32_t, AMO_OR>(cpu, in); }
+    static void AMOMIN_W(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint32_t, AMO_MIN>(cpu, in); }
+    static void AMOMAX_W(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint32_t, AMO_MAX>(cpu, in); }
+    static void AMOMINU_W(RVCPU &cpu, const DecodedInstr &in)  { AMO<uint32_t, AMO_MINU>(cpu, in); }
+    static void AMOMAXU_W(RVCPU &cpu, const DecodedInstr &in)  { AMO<uint32_t, AMO_MAXU>(cpu, in); }
+
+    static void LR_D(RVCPU &cpu, const DecodedInstr &in)       { LR<uint64_t>(cpu, in); }
+    static void SC_D(RVCPU &cpu, const DecodedInstr &in)       { SC<uint64_t>(cpu, in); }
+    static void AMOSWAP_D(RVCPU &cpu, const DecodedInstr &in)  { AMO<uint64_t, AMO_SWAP>(cpu, in); }
+    static void AMOADD_D(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint64_t, AMO_ADD>(cpu, in); }
+    static void AMOXOR_D(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint64_t, AMO_XOR>(cpu, in); }
+    static void AMOAND_D(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint64_t, AMO_AND>(cpu, in); }
+    static void AMOOR_D(RVCPU &cpu, const DecodedInstr &in)    { AMO<uint64_t, AMO_OR>(cpu, in); }
+    static void AMOMIN_D(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint64_t, AMO_MIN>(cpu, in); }
+    static void AMOMAX_D(RVCPU &cpu, const DecodedInstr &in)   { AMO<uint64_t, AMO_MAX>(cpu, in); }
+    static void AMOMINU_D(RVCPU &cpu, const DecodedInstr &in)  { AMO<uint64_t, AMO_MINU>(cpu, in); }
+    static void AMOMAXU_D(RVCPU &cpu, const DecodedInstr &in)  { AMO<uint64_t, AMO_MAXU>(cpu, in); }
+
+    // ================ Floating point (F/D) ================
+    // Raw bits of a value
+    template <typename T>
+    static inline uint64_t fbits(T f)
+    {
+        if(sizeof(T) == 4)
+        {
+            uint32_t bits;
+            memcpy(&bits, &f, 4);
+            return bits;
+        }
+        uint64_t bits;
+        memcpy(&bits, &f, 8);
+        return bits;
+    }
+
+    // NaN tests on the bits, comparing a signaling NaN raises NV on the host
+    template <typename T>
+    static inline bool isNaN(T f)
+    {
+        const unsigned int mant_bits = std::numeric_limits<T>::digits - 1;
+        uint64_t bits = fbits(f) & ~((uint64_t)1 << (sizeof(T) * 8 - 1));
+        return bits > ((((uint64_t)1 << (sizeof(T) * 8 - 1 - mant_bits)) - 1) << mant_bits);
+    }
+
+    template <typename T>
+    static inline bool isSignaling(T f)
+    {
+        return isNaN(f) && !((fbits(f) >> (std::numeric_limits<T>::digits - 2)) & 1);
+    }
+
+    // Single precision values are NaN-boxed in the 64-bit registers, NaN
+    // results are replaced by the canonical NaN
+    template <typename T>
+    static inline T fget(RVCPU &cpu, unsigned int reg)
+    {
+        uint64_t v = cpu.state.F[reg];
+        T f;
+        if(sizeof(T) == 4)
+        {
+            uint32_t bits = (v >> 32) == 0xffffffff ? (uint32_t)v : 0x7fc00000;
+            memcpy(&f, &bits, 4);
+        }
+        else
+            memcpy(&f, &v, 8);
+        return f;
+    }
+
+    template <typename T>
+    static inline void fset(RVCPU &cpu, unsigned int reg, T f)
+    {
+        if(sizeof(T) == 4)
+        {
+            uint32_t bits;
+            memcpy(&bits, &f, 4);
+            if(isNaN(f))
+                bits = 0x7fc00000;
+            cpu.state.F[reg] = 0xffffffff00000000ULL | bits;
+        }
+        else
+        {
+            uint64_t bits;
+            memcpy(&bits, &f, 8);
+            if(isNaN(f))
+                bits = 0x7ff8000000000000ULL;
+            cpu.state.F[reg] = bits;
+        }
+    }
+
+    // Rounding mode of an instruction (decoded into imm), switches the host
+    // FPU only if it changes
+    static inline unsigned int roundingMode(RVCPU &cpu, const DecodedInstr &in)
+    {
+        unsigned int rm = in.imm == RM_DYN ? cpu.state.frm : (unsigned int)in.imm;
+        if(rm != cpu.hostRM)
+        {
+            if(rm > RM_RMM)
+            {
+                cpu.illegalInstruction(in);
+                return RM_RNE;
+            }
+            if(rm != RM_RMM)
+            {
+                RVFloat::setHostRounding(rm);
+                cpu.hostRM = rm;
+            }
+        }
+        return rm;
+    }
+
+    enum FPOp { FP_ADD, FP_SUB, FP_MUL, FP_DIV, FP_SQRT, FP_MADD, FP_MSUB, FP_NMSUB, FP_NMADD };
+
+    template <typename T, int op>
+    static inline T fpCompute(T a, T b, T c)
+    {
+        switch(op)
+        {
+            case FP_ADD:    return a + b;
+            case FP_SUB:    return a - b;
+            case FP_MUL:    return a * b;
+            case FP_DIV:    return a / b;
+            case FP_SQRT:   return std::sqrt(a);
+            case FP_MADD:   return std::fma(a, b, c);
+            case FP_MSUB:   return std::fma(a, b, -c);
+            case FP_NMSUB:  return std::fma(-a, b, c);
+            default:        return std::fma(-a, b, -c);
+        }
+    }
+
+    // Round to nearest, ties to max magnitude: computed with round to odd in
+    // a wider format, then rounded in software
+    template <typename T, int op>
+    static T fpComputeRMM(RVCPU &cpu, T a, T b, T c)
+    {
+        typedef typename RVFloat::Wide<T>::type W;
+        W wa = a, wb = b, wc = c;
+
+        cpu.fpSyncFlags();
+        RVFloat::setHostRounding(RM_RTZ);
+        RVFloat::barrier(wa);
+        RVFloat::barrier(wb);
+        RVFloat::barrier(wc);
+        W w = fpCompute<W, op>(wa, wb, wc);
+        RVFloat::barrier(w);
+        uint32_t flags = RVFloat::hostFlags();
+        RVFloat::setHostRounding(cpu.hostRM);
+        RVFloat::clearHostFlags();
+
+        if(flags & FFLAG_NX)
+            w = RVFloat::makeOdd(w);
+        cpu.state.fflags |= flags & (FFLAG_NV | FFLAG_DZ);
+        return RVFloat::roundMaxMagnitude<T>(w, cpu.state.fflags);
+    }
+
+    template <typename T, int op>
+    static void FARITH(RVCPU &cpu, const DecodedInstr &in)
+    {
+        unsigned int rm = roundingMode(cpu, in);
+        T a = fget<T>(cpu, in.rs1);
+        T b = fget<T>(cpu, in.rs2);
+        T c = fget<T>(cpu, in.raw >> 27);
+        fset<T>(cpu, in.rd, rm != RM_RMM ? fpCompute<T, op>(a, b, c) : fpComputeRMM<T, op>(cpu, a, b, c));
+    }
+
+    // Sign injection: 0: copy, 1: negated, 2: xor
+    template <typename T, int mode>
+    static void FSGNJ(RVCPU &cpu, const DecodedInstr &in)
+    {
+        T a = fget<T>(cpu, in.rs1);
+        T b = fget<T>(cpu, in.rs2);
+        bool sign = std::signbit(b);
+        if(mode == 1)
+            sign = !sign;
+        else if(mode == 2)
+            sign = sign != (bool)std::signbit(a);
+
+        // Sign bit only, NaN payloads are kept
+        uint64_t bits = fbits(a);
+        uint64_t sign_bit = (uint64_t)1 << (sizeof(T) * 8 - 1);
+        bits = sign ? (bits | sign_bit) : (bits & ~sign_bit);
+        cpu.state.F[in.rd] = sizeof(T) == 4 ? (0xffffffff00000000ULL | bits) : bits;
+    }
+
+    template <typename T, bool max>
+    static void FMINMAX(RVCPU &cpu, const DecodedInstr &in)
+    {
+        T a = fget<T>(cpu, in.rs1);
+        T b = fget<T>(cpu, in.rs2);
+        if(isSignaling(a) || isSignaling(b))
+            cpu.state.fflags |= FFLAG_NV;
+
+        T r;
+        if(isNaN(a))
+            r = b;
+        else if(isNaN(b))
+            r = a;
+        else if(a == b)
+            r = (std::signbit(a) != max) ? a : b;     // -0 < +0
+        else
+            r = (a < b) != max ? a : b;
+        fset<T>(cpu, in.rd, r);
+    }
+
+    // Comparisons: 0: feq (quiet), 1: flt, 2: fle
+    template <typename T, int cmp>
+    static void FCMP(RVCPU &cpu, const DecodedInstr &in)
+    {
+        T a = fget<T>(cpu, in.rs1);
+        T b = fget<T>(cpu, in.rs2);
+        if(isNaN(a) || isNaN(b))
+        {
+            if(cmp != 0 || isSignaling(a) || isSignaling(b))
+                cpu.state.fflags |= FFLAG_NV;
+            cpu.state.X[in.rd] = 0;
+            return;
+        }
+        cpu.state.X[in.rd] = cmp == 0 ? a == b : (cmp == 1 ? a < b : a <= b);
+    }
+
+    template <typename T>
+    static void FCLASS(RVCPU &cpu, const DecodedInstr &in)
+    {
+        T a = fget<T>(cpu, in.rs1);
+        bool neg = std::signbit(a);
+        unsigned int cls;
+        const unsigned int mant_bits = std::numeric_limits<T>::digits - 1;
+        const uint64_t exp_max = ((uint64_t)1 << (sizeof(T) * 8 - 1 - mant_bits)) - 1;
+        uint64_t exp = (fbits(a) >> mant_bits) & exp_max;
+        uint64_t mant = fbits(a) & (((uint64_t)1 << mant_bits) - 1);
+        if(exp == exp_max)
+            cls = mant ? (isSignaling(a) ? 8 : 9) : (neg ? 0 : 7);
+        else if(exp)
+            cls = neg ? 1 : 6;
+        else
+            cls = mant ? (neg ? 2 : 5) : (neg ? 3 : 4);
+        cpu.state.X[in.rd] = 1 << cls;
+    }
+
+    // Float to integer, rounded as selected & saturated (NaN gives the
+    // maximum value)
+    template <typename T, typename I>
+    static void FCVT_TO_INT(RVCPU &cpu, const DecodedInstr &in)
+    {
+        unsigned int rm = in.imm == RM_DYN ? cpu.state.frm : (unsigned int)in.imm;
+        if(rm > RM_RMM)
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+
+        // Flags are computed here, whatever the host raises on the way is
+        // discarded
+        cpu.fpSyncFlags();
+        T a = fget<T>(cpu, in.rs1);
+        T r;
+        switch(rm)
+        {
+            case RM_RTZ:    r = std::trunc(a); break;
+            case RM_RDN:    r = std::floor(a); break;
+            case RM_RUP:    r = std::ceil(a); break;
+            case RM_RMM:    r = std::round(a); break;
+            default:
+            {
+                // Ties to even, independent of the host rounding mode
+                r = std::trunc(a);
+                T diff = std::fabs(a - r);
+                if(diff > (T)0.5 || (diff == (T)0.5 && std::fmod(r, (T)2) != 0))
+                    r += std::signbit(a) ? -1 : 1;
+                break;
+            }
+        }
+
+        // Limits are powers of two, so the comparisons are exact
+        const T lo = std::numeric_limits<I>::is_signed ? -std::ldexp((T)1, sizeof(I) * 8 - 1) : 0;
+        const T hi = std::ldexp((T)1, sizeof(I) * 8 - std::numeric_limits<I>::is_signed);
+        I v;
+        uint32_t flags = 0;
+        if(isNaN(a) || r >= hi)
+        {
+            flags = FFLAG_NV;
+            v = std::numeric_limits<I>::max();
+        }
+        else if(r < lo)
+        {
+            flags = FFLAG_NV;
+            v = std::numeric_limits<I>::min();
+        }
+        else
+        {
+            if(r != a)
+                flags = FFLAG_NX;
+            v = (I)r;
+        }
+        if(cpu.fpActive)
+            RVFloat::clearHostFlags();
+        cpu.state.fflags |= flags;
+        cpu.state.X[in.rd] = sizeof(I) == 4 ? (REG)(REGS)(int32_t)v : (REG)v;  // 32-bit results are sign extended
+    }
+
+    // Integer to float
+    template <typename T, typename I>
+    static void FCVT_FROM_INT(RVCPU &cpu, const DecodedInstr &in)
+    {
+        unsigned int rm = roundingMode(cpu, in);
+        I v = (I)cpu.state.X[in.rs1];
+        if(rm != RM_RMM)
+            fset<T>(cpu, in.rd, (T)v);
+        else
+            fset<T>(cpu, in.rd, RVFloat::roundMaxMagnitude<T>((long double)v, cpu.state.fflags));
+    }
+
+    static void FCVT_S_D(RVCPU &cpu, const DecodedInstr &in)
+    {
+        unsigned int rm = roundingMode(cpu, in);
+        double a = fget<double>(cpu, in.rs1);
+        if(rm != RM_RMM)
+            fset<float>(cpu, in.rd, (float)a);
+        else
+        {
+            if(isSignaling(a))
+                cpu.state.fflags |= FFLAG_NV;
+            fset<float>(cpu, in.rd, RVFloat::roundMaxMagnitude<float>(a, cpu.state.fflags));
+        }
+    }
+
+    static void FCVT_D_S(RVCPU &cpu, const DecodedInstr &in)
+    {
+        roundingMode(cpu, in);
+        fset<double>(cpu, in.rd, (double)fget<float>(cpu, in.rs1));
+    }
+
+    // Moves between register files (raw bits)
+    static void FMV_X_W(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REGS)(int32_t)cpu.state.F[in.rs1]; }
+    static void FMV_W_X(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.F[in.rd] = 0xffffffff00000000ULL | (uint32_t)cpu.state.X[in.rs1]; }
+    static void FMV_X_D(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.X[in.rd] = (REG)cpu.state.F[in.rs1]; }
+    static void FMV_D_X(RVCPU &cpu, const DecodedInstr &in)     { cpu.state.F[in.rd] = cpu.state.X[in.rs1]; }
+
+    // Loads & stores (64-bit accesses are split on RV32)
+    static void FLW(RVCPU &cpu, const DecodedInstr &in)         { cpu.state.F[in.rd] = 0xffffffff00000000ULL | (uint32_t)cpu.load(in, cpu.state.X[in.rs1] + in.imm, 4); }
+    static void FSW(RVCPU &cpu, const DecodedInstr &in)         { cpu.store(in, cpu.state.X[in.rs1] + in.imm, (REG)cpu.state.F[in.rs2], 4); }
+    static void FLD(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG addr = cpu.state.X[in.rs1] + in.imm;
+        if(XLEN == 32)
+        {
+            uint64_t lo = (uint32_t)cpu.load(in, addr, 4);
+            cpu.state.F[in.rd] = lo | ((uint64_t)(uint32_t)cpu.load(in, addr + 4, 4) << 32);
+        }
+        else
+            cpu.state.F[in.rd] = cpu.load(in, addr, 8);
+    }
+    static void FSD(RVCPU &cpu, const DecodedInstr &in)
+    {
+        REG addr = cpu.state.X[in.rs1] + in.imm;
+        uint64_t v = cpu.state.F[in.rs2];
+        if(XLEN == 32)
+        {
+            cpu.store(in, addr, (REG)v, 4);
+            cpu.store(in, addr + 4, (REG)(v >> 32), 4);
+        }
+        else
+            cpu.store(in, addr, (REG)v, 8);
+    }
+
+    static void FADD_S(RVCPU &cpu, const DecodedInstr &in)      { FARITH<float, FP_ADD>(cpu, in); }
+    static void FSUB_S(RVCPU &cpu, const DecodedInstr &in)      { FARITH<float, FP_SUB>(cpu, in); }
+    static void FMUL_S(RVCPU &cpu, const DecodedInstr &in)      { FARITH<float, FP_MUL>(cpu, in); }
+    static void FDIV_S(RVCPU &cpu, const DecodedInstr &in)      { FARITH<float, FP_DIV>(cpu, in); }
+    static void FSQRT_S(RVCPU &cpu, const DecodedInstr &in)     { FARITH<float, FP_SQRT>(cpu, in); }
+    static void FMADD_S(RVCPU &cpu, const DecodedInstr &in)     { FARITH<float, FP_MADD>(cpu, in); }
+    static void FMSUB_S(RVCPU &cpu, const DecodedInstr &in)     { FARITH<float, FP_MSUB>(cpu, in); }
+    static void FNMSUB_S(RVCPU &cpu, const DecodedInstr &in)    { FARITH<float, FP_NMSUB>(cpu, in); }
+    static void FNMADD_S(RVCPU &cpu, const DecodedInstr &in)    { FARITH<float, FP_NMADD>(cpu, in); }
+    static void FSGNJ_S(RVCPU &cpu, const DecodedInstr &in)     { FSGNJ<float, 0>(cpu, in); }
+    static void FSGNJN_S(RVCPU &cpu, const DecodedInstr &in)    { FSGNJ<float, 1>(cpu, in); }
+    static void FSGNJX_S(RVCPU &cpu, const DecodedInstr &in)    { FSGNJ<float, 2>(cpu, in); }
+    static void FMIN_S(RVCPU &cpu, const DecodedInstr &in)      { FMINMAX<float, false>(cpu, in); }
+    static void FMAX_S(RVCPU &cpu, const DecodedInstr &in)      { FMINMAX<float, true>(cpu, in); }
+    static void FEQ_S(RVCPU &cpu, const DecodedInstr &in)       { FCMP<float, 0>(cpu, in); }
+    static void FLT_S(RVCPU &cpu, const DecodedInstr &in)       { FCMP<float, 1>(cpu, in); }
+    static void FLE_S(RVCPU &cpu, const DecodedInstr &in)       { FCMP<float, 2>(cpu, in); }
+    static void FCLASS_S(RVCPU &cpu, const DecodedInstr &in)    { FCLASS<float>(cpu, in); }
+    static void FCVT_W_S(RVCPU &cpu, const DecodedInstr &in)    { FCVT_TO_INT<float, int32_t>(cpu, in); }
+    static void FCVT_WU_S(RVCPU &cpu, const DecodedInstr &in)   { FCVT_TO_INT<float, uint32_t>(cpu, in); }
+    static void FCVT_L_S(RVCPU &cpu, const DecodedInstr &in)    { FCVT_TO_INT<float, int64_t>(cpu, in); }
+    static void FCVT_LU_S(RVCPU &cpu, const DecodedInstr &in)   { FCVT_TO_INT<float, uint64_t>(cpu, in); }
+    static void FCVT_S_W(RVCPU &cpu, const DecodedInstr &in)    { FCVT_FROM_INT<float, int32_t>(cpu, in); }
+    static void FCVT_S_WU(RVCPU &cpu, const DecodedInstr &in)   { FCVT_FROM_INT<float, uint32_t>(cpu, in); }
+    static void FCVT_S_L(RVCPU &cpu, const DecodedInstr &in)    { FCVT_FROM_INT<float, int64_t>(cpu, in); }
+    static void FCVT_S_LU(RVCPU &cpu, const DecodedInstr &in)   { FCVT_FROM_INT<float, uint64_t>(cpu, in); }
+
+    static void FADD_D(RVCPU &cpu, const DecodedInstr &in)      { FARITH<double, FP_ADD>(cpu, in); }
+    static void FSUB_D(RVCPU &cpu, const DecodedInstr &in)      { FARITH<double, FP_SUB>(cpu, in); }
+    static void FMUL_D(RVCPU &cpu, const DecodedInstr &in)      { FARITH<double, FP_MUL>(cpu, in); }
+    static void FDIV_D(RVCPU &cpu, const DecodedInstr &in)      { FARITH<double, FP_DIV>(cpu, in); }
+    static void FSQRT_D(RVCPU &cpu, const DecodedInstr &in)     { FARITH<double, FP_SQRT>(cpu, in); }
+    static void FMADD_D(RVCPU &cpu, const DecodedInstr &in)     { FARITH<double, FP_MADD>(cpu, in); }
+    static void FMSUB_D(RVCPU &cpu, const DecodedInstr &in)     { FARITH<double, FP_MSUB>(cpu, in); }
+    static void FNMSUB_D(RVCPU &cpu, const DecodedInstr &in)    { FARITH<double, FP_NMSUB>(cpu, in); }
+    static void FNMADD_D(RVCPU &cpu, const DecodedInstr &in)    { FARITH<double, FP_NMADD>(cpu, in); }
+    static void FSGNJ_D(RVCPU &cpu, const DecodedInstr &in)     { FSGNJ<double, 0>(cpu, in); }
+    static void FSGNJN_D(RVCPU &cpu, const DecodedInstr &in)    { FSGNJ<double, 1>(cpu, in); }
+    static void FSGNJX_D(RVCPU &cpu, const DecodedInstr &in)    { FSGNJ<double, 2>(cpu, in); }
+    static void FMIN_D(RVCPU &cpu, const DecodedInstr &in)      { FMINMAX<double, false>(cpu, in); }
+    static void FMAX_D(RVCPU &cpu, const DecodedInstr &in)      { FMINMAX<double, true>(cpu, in); }
+    static void FEQ_D(RVCPU &cpu, const DecodedInstr &in)       { FCMP<double, 0>(cpu, in); }
+    static void FLT_D(RVCPU &cpu, const DecodedInstr &in)       { FCMP<double, 1>(cpu, in); }
+    static void FLE_D(RVCPU &cpu, const DecodedInstr &in)       { FCMP<double, 2>(cpu, in); }
+    static void FCLASS_D(RVCPU &cpu, const DecodedInstr &in)    { FCLASS<double>(cpu, in); }
+    static void FCVT_W_D(RVCPU &cpu, const DecodedInstr &in)    { FCVT_TO_INT<double, int32_t>(cpu, in); }
+    static void FCVT_WU_D(RVCPU &cpu, const DecodedInstr &in)   { FCVT_TO_INT<double, uint32_t>(cpu, in); }
+    static void FCVT_L_D(RVCPU &cpu, const DecodedInstr &in)    { FCVT_TO_INT<double, int64_t>(cpu, in); }
+    static void FCVT_LU_D(RVCPU &cpu, const DecodedInstr &in)   { FCVT_TO_INT<double, uint64_t>(cpu, in); }
+    static void FCVT_D_W(RVCPU &cpu, const DecodedInstr &in)    { FCVT_FROM_INT<double, int32_t>(cpu, in); }
+    static void FCVT_D_WU(RVCPU &cpu, const DecodedInstr &in)   { FCVT_FROM_INT<double, uint32_t>(cpu, in); }
+    static void FCVT_D_L(RVCPU &cpu, const DecodedInstr &in)    { FCVT_FROM_INT<double, int64_t>(cpu, in); }
+    static void FCVT_D_LU(RVCPU &cpu, const DecodedInstr &in)   { FCVT_FROM_INT<double, uint64_t>(cpu, in); }
+
+    // ================ Vector (V) ================
+    // Register groups are contiguous, so element i of a group is element i of
+    // the array at its first register. Element operations run as host kernels
+    // selected by operation & SEW, LMUL only sets vl & the register alignment.
+    enum VecGroup { VG_D = 1, VG_S2 = 2, VG_S1 = 4 };
+    enum VecForm { VF_VV, VF_VX, VF_VI };
+
+    static inline uint8_t * vreg(RVCPU &cpu, unsigned int reg)                  { return cpu.state.V + reg * cpu.vlenb; }
+    static inline bool vmasked(const DecodedInstr &in)                          { return !((in.raw >> 25) & 1); }
+    static inline const uint8_t * vmask(RVCPU &cpu, const DecodedInstr &in)     { return vmasked(in) ? cpu.state.V : NULL; }
+    static inline bool vill(RVCPU &cpu)                                         { return cpu.state.vtype >> (XLEN - 1); }
+
+    // Scalar operand, sign extended to 64 bits for SEW > XLEN
+    static inline uint64_t vscalar(RVCPU &cpu, const DecodedInstr &in, int form)
+    {
+        return form == VF_VI ? (uint64_t)(int64_t)in.imm : (uint64_t)(int64_t)(REGS)cpu.state.X[in.rs1];
+    }
+
+    // Register groups must be aligned to LMUL & a masked destination group
+    // must not overlap the mask register
+    static inline bool vrequire(RVCPU &cpu, const DecodedInstr &in, int groups)
+    {
+        unsigned int align = cpu.vlmul > 0 ? (1 << cpu.vlmul) - 1 : 0;
+        bool ok = !vill(cpu) &&
+            !((groups & VG_D) && ((in.rd & align) || (vmasked(in) && in.rd == 0))) &&
+            !((groups & VG_S2) && (in.rs2 & align)) &&
+            !((groups & VG_S1) && (in.rs1 & align));
+        if(!ok)
+            cpu.illegalInstruction(in);
+        return ok;
+    }
+
+    // Loads & stores use EMUL = EEW / SEW * LMUL for the data group
+    static inline bool vrequireEEW(RVCPU &cpu, const DecodedInstr &in, unsigned int eew)
+    {
+        int emul = __builtin_ctz(eew) - (int)cpu.vsew + cpu.vlmul;
+        bool ok = !vill(cpu) && emul >= -3 && emul <= 3 &&
+            !(emul > 0 && (in.rd & ((1 << emul) - 1))) && !(vmasked(in) && in.rd == 0);
+        if(!ok)
+            cpu.illegalInstruction(in);
+        return ok;
+    }
+
+    template <int op, int form>
+    static void VBINARY(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, VG_D | VG_S2 | (form == VF_VV ? VG_S1 : 0)))
+            return;
+        RVVector::kernels->binary[op][cpu.vsew](vreg(cpu, in.rd), vreg(cpu, in.rs2), form == VF_VV ? vreg(cpu, in.rs1) : NULL,
+            vscalar(cpu, in, form), vmask(cpu, in), cpu.state.vstart, cpu.state.vl);
+        cpu.state.vstart = 0;
+    }
+
+    // Comparisons write mask bits, so vd may be the mask register
+    template <int op, int form>
+    static void VCOMPARE(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, VG_S2 | (form == VF_VV ? VG_S1 : 0)))
+            return;
+        RVVector::kernels->compare[op][cpu.vsew](vreg(cpu, in.rd), vreg(cpu, in.rs2), form == VF_VV ? vreg(cpu, in.rs1) : NULL,
+            vscalar(cpu, in, form), vmask(cpu, in), cpu.state.vstart, cpu.state.vl);
+        cpu.state.vstart = 0;
+    }
+
+    template <int op, int form>
+    static void VTERNARY(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, VG_D | VG_S2 | (form == VF_VV ? VG_S1 : 0)))
+            return;
+        RVVector::kernels->ternary[op][cpu.vsew](vreg(cpu, in.rd), vreg(cpu, in.rs2), form == VF_VV ? vreg(cpu, in.rs1) : NULL,
+            vscalar(cpu, in, form), vmask(cpu, in), cpu.state.vstart, cpu.state.vl);
+        cpu.state.vstart = 0;
+    }
+
+    // vd[0] = vs1[0] op active elements of vs2
+    template <int op>
+    static void VREDUCE(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(cpu.state.vstart != 0)
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+        if(!vrequire(cpu, in, VG_S2) || cpu.state.vl == 0)
+            return;
+
+        unsigned int sew = 1 << cpu.vsew;
+        uint64_t init = 0;
+        memcpy(&init, vreg(cpu, in.rs1), sew);
+        uint64_t r = RVVector::kernels->reduce[op][cpu.vsew](vreg(cpu, in.rs2), init, vmask(cpu, in), 0, cpu.state.vl);
+        memcpy(vreg(cpu, in.rd), &r, sew);
+    }
+
+    // vmerge: vd = v0 ? (vs1 or scalar) : vs2, vmv.v (unmasked): vd = vs1 or scalar
+    template <int form>
+    static void VMERGE(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, VG_D | (vmasked(in) ? VG_S2 : 0) | (form == VF_VV ? VG_S1 : 0)))
+            return;
+        RVVector::kernels->merge[cpu.vsew](vreg(cpu, in.rd), vreg(cpu, in.rs2), form == VF_VV ? vreg(cpu, in.rs1) : NULL,
+            vscalar(cpu, in, form), vmask(cpu, in), cpu.state.vstart, cpu.state.vl);
+        cpu.state.vstart = 0;
+    }
+
+    // Whole register moves ignore vtype & vl
+    template <unsigned int nr>
+    static void VMVNR(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if((in.rd | in.rs2) & (nr - 1))
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+        unsigned int len = nr * cpu.vlenb;
+        unsigned int start = vill(cpu) ? 0 : cpu.state.vstart << cpu.vsew;
+        if(start < len)
+            memmove(vreg(cpu, in.rd) + start, vreg(cpu, in.rs2) + start, len - start);
+        cpu.state.vstart = 0;
+    }
+
+    static void VMV_X_S(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, 0))
+            return;
+        int64_t v = 0;
+        memcpy(&v, vreg(cpu, in.rs2), 1 << cpu.vsew);
+        unsigned int shift = 64 - (8 << cpu.vsew);
+        cpu.state.X[in.rd] = (REG)((v << shift) >> shift);
+        cpu.state.vstart = 0;
+    }
+
+    static void VMV_S_X(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, 0))
+            return;
+        if(cpu.state.vstart < cpu.state.vl)
+        {
+            uint64_t v = (uint64_t)(int64_t)(REGS)cpu.state.X[in.rs1];
+            memcpy(vreg(cpu, in.rd), &v, 1 << cpu.vsew);
+        }
+        cpu.state.vstart = 0;
+    }
+
+    // Active mask bits of vs2 in 64-bit words
+    template <typename F>
+    static inline void vmaskWords(RVCPU &cpu, const DecodedInstr &in, F f)
+    {
+        const uint8_t * vs2 = vreg(cpu, in.rs2);
+        const uint8_t * mask = vmask(cpu, in);
+        for(unsigned int i=0; i<cpu.state.vl; i+=64)
+        {
+            uint64_t bits, m = ~0ULL;
+            memcpy(&bits, vs2 + i / 8, 8);
+            if(mask)
+                memcpy(&m, mask + i / 8, 8);
+            if(cpu.state.vl - i < 64)
+                m &= (1ULL << (cpu.state.vl - i)) - 1;
+            if(!f(i, bits & m))
+                break;
+        }
+    }
+
+    static void VCPOP_M(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(cpu.state.vstart != 0)
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+        if(!vrequire(cpu, in, 0))
+            return;
+        REG count = 0;
+        vmaskWords(cpu, in, [&](unsigned int, uint64_t bits) { count += RVBitmanip::cpop64(bits); return true; });
+        cpu.state.X[in.rd] = count;
+    }
+
+    static void VFIRST_M(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(cpu.state.vstart != 0)
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+        if(!vrequire(cpu, in, 0))
+            return;
+        REG first = ~(REG)0;
+        vmaskWords(cpu, in, [&](unsigned int i, uint64_t bits) {
+            if(bits)
+                first = i + RVBitmanip::ctz64(bits);
+            return bits == 0;
+        });
+        cpu.state.X[in.rd] = first;
+    }
+
+    static void VID_V(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, VG_D))
+            return;
+        uint8_t * vd = vreg(cpu, in.rd);
+        const uint8_t * mask = vmask(cpu, in);
+        unsigned int sew = 1 << cpu.vsew;
+        for(uint64_t i=cpu.state.vstart; i<cpu.state.vl; i++)
+        {
+            if(!mask || ((mask[i >> 3] >> (i & 7)) & 1))
+                memcpy(vd + i * sew, &i, sew);
+        }
+        cpu.state.vstart = 0;
+    }
+
+    // Mask logical operations on bits vstart to vl-1, a byte at a time
+    enum MaskOp { VM_ANDN, VM_AND, VM_OR, VM_XOR, VM_ORN, VM_NAND, VM_NOR, VM_XNOR };
+
+    template <int op>
+    static inline uint8_t maskOp(uint8_t a, uint8_t b)
+    {
+        switch(op)
+        {
+            case VM_ANDN:   return a & ~b;
+            case VM_AND:    return a & b;
+            case VM_OR:     return a | b;
+            case VM_XOR:    return a ^ b;
+            case VM_ORN:    return a | ~b;
+            case VM_NAND:   return ~(a & b);
+            case VM_NOR:    return ~(a | b);
+            default:        return ~(a ^ b);
+        }
+    }
+
+    template <int op>
+    static void VMASKOP(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, 0))
+            return;
+        uint8_t * vd = vreg(cpu, in.rd);
+        const uint8_t * vs2 = vreg(cpu, in.rs2);
+        const uint8_t * vs1 = vreg(cpu, in.rs1);
+        for(unsigned int i=cpu.state.vstart; i<cpu.state.vl; )
+        {
+            unsigned int lo = i & 7;
+            unsigned int n = std::min(8 - lo, (unsigned int)cpu.state.vl - i);
+            uint8_t bits = ((1 << n) - 1) << lo;
+            uint8_t r = maskOp<op>(vs2[i >> 3], vs1[i >> 3]);
+            vd[i >> 3] = (vd[i >> 3] & ~bits) | (r & bits);
+            i += n;
+        }
+        cpu.state.vstart = 0;
+    }
+
+    // Configuration: rs1 = x0 requests VLMAX (rd != x0) or keeps vl (rd = x0)
+    static inline void vsetvl(RVCPU &cpu, const DecodedInstr &in, REG avl, REG vtype)
+    {
+        cpu.vecSetType(vtype);
+        if(!vill(cpu))
+            cpu.state.vl = avl < cpu.vlmax ? avl : cpu.vlmax;
+        cpu.state.vstart = 0;
+        cpu.state.X[in.rd] = cpu.state.vl;
+    }
+
+    static inline REG vavl(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(((in.raw >> 15) & 0x1f) != 0)
+            return cpu.state.X[in.rs1];
+        return ((in.raw >> 7) & 0x1f) != 0 ? ~(REG)0 : cpu.state.vl;
+    }
+
+    static void VSETVLI(RVCPU &cpu, const DecodedInstr &in)     { vsetvl(cpu, in, vavl(cpu, in), in.imm); }
+    static void VSETIVLI(RVCPU &cpu, const DecodedInstr &in)    { vsetvl(cpu, in, in.rs1, in.imm); }
+    static void VSETVL(RVCPU &cpu, const DecodedInstr &in)      { vsetvl(cpu, in, vavl(cpu, in), cpu.state.X[in.rs2]); }
+
+    // Unit-stride & strided loads/stores of elements vstart to vl-1
+    template <unsigned int eew, bool strided>
+    static void VLOAD(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequireEEW(cpu, in, eew))
+            return;
+        cpu.vecLoad(in, vreg(cpu, in.rd), cpu.state.X[in.rs1], strided ? cpu.state.X[in.rs2] : eew, eew,
+            vmask(cpu, in), cpu.state.vstart, cpu.state.vl);
+        cpu.state.vstart = 0;
+    }
+
+    template <unsigned int eew, bool strided>
+    static void VSTORE(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequireEEW(cpu, in, eew))
+            return;
+        cpu.vecStore(in, vreg(cpu, in.rd), cpu.state.X[in.rs1], strided ? cpu.state.X[in.rs2] : eew, eew,
+            vmask(cpu, in), cpu.state.vstart, cpu.state.vl);
+        cpu.state.vstart = 0;
+    }
+
+    // Mask loads/stores transfer ceil(vl / 8) bytes
+    static void VLM_V(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, 0))
+            return;
+        cpu.vecLoad(in, vreg(cpu, in.rd), cpu.state.X[in.rs1], 1, 1, NULL, cpu.state.vstart, (cpu.state.vl + 7) / 8);
+        cpu.state.vstart = 0;
+    }
+
+    static void VSM_V(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(!vrequire(cpu, in, 0))
+            return;
+        cpu.vecStore(in, vreg(cpu, in.rd), cpu.state.X[in.rs1], 1, 1, NULL, cpu.state.vstart, (cpu.state.vl + 7) / 8);
+        cpu.state.vstart = 0;
+    }
+
+    // Whole register loads/stores ignore vtype & vl
+    template <unsigned int nr, unsigned int eew>
+    static void VLNR(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(in.rd & (nr - 1))
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+        cpu.vecLoad(in, vreg(cpu, in.rd), cpu.state.X[in.rs1], eew, eew, NULL, cpu.state.vstart, nr * cpu.vlenb / eew);
+        cpu.state.vstart = 0;
+    }
+
+    template <unsigned int nr>
+    static void VSNR(RVCPU &cpu, const DecodedInstr &in)
+    {
+        if(in.rd & (nr - 1))
+        {
+            cpu.illegalInstruction(in);
+            return;
+        }
+        cpu.vecStore(in, vreg(cpu, in.rd), cpu.state.X[in.rs1], 1, 1, NULL, cpu.state.vstart, nr * cpu.vlenb);
+        cpu.state.vstart = 0;
+    }
+
+    static void VADD_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_ADD, VF_VV>(cpu, in); }
+    static void VADD_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_ADD, VF_VX>(cpu, in); }
+    static void VADD_VI(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_ADD, VF_VI>(cpu, in); }
+    static void VSUB_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SUB, VF_VV>(cpu, in); }
+    static void VSUB_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SUB, VF_VX>(cpu, in); }
+    static void VRSUB_VX(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_RSUB, VF_VX>(cpu, in); }
+    static void VRSUB_VI(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_RSUB, VF_VI>(cpu, in); }
+    static void VMINU_VV(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_MINU, VF_VV>(cpu, in); }
+    static void VMINU_VX(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_MINU, VF_VX>(cpu, in); }
+    static void VMIN_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_MIN, VF_VV>(cpu, in); }
+    static void VMIN_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_MIN, VF_VX>(cpu, in); }
+    static void VMAXU_VV(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_MAXU, VF_VV>(cpu, in); }
+    static void VMAXU_VX(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_MAXU, VF_VX>(cpu, in); }
+    static void VMAX_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_MAX, VF_VV>(cpu, in); }
+    static void VMAX_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_MAX, VF_VX>(cpu, in); }
+    static void VAND_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_AND, VF_VV>(cpu, in); }
+    static void VAND_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_AND, VF_VX>(cpu, in); }
+    static void VAND_VI(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_AND, VF_VI>(cpu, in); }
+    static void VOR_VV(RVCPU &cpu, const DecodedInstr &in)      { VBINARY<RVVector::OP_OR, VF_VV>(cpu, in); }
+    static void VOR_VX(RVCPU &cpu, const DecodedInstr &in)      { VBINARY<RVVector::OP_OR, VF_VX>(cpu, in); }
+    static void VOR_VI(RVCPU &cpu, const DecodedInstr &in)      { VBINARY<RVVector::OP_OR, VF_VI>(cpu, in); }
+    static void VXOR_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_XOR, VF_VV>(cpu, in); }
+    static void VXOR_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_XOR, VF_VX>(cpu, in); }
+    static void VXOR_VI(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_XOR, VF_VI>(cpu, in); }
+    static void VSLL_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SLL, VF_VV>(cpu, in); }
+    static void VSLL_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SLL, VF_VX>(cpu, in); }
+    static void VSLL_VI(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SLL, VF_VI>(cpu, in); }
+    static void VSRL_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SRL, VF_VV>(cpu, in); }
+    static void VSRL_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SRL, VF_VX>(cpu, in); }
+    static void VSRL_VI(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SRL, VF_VI>(cpu, in); }
+    static void VSRA_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SRA, VF_VV>(cpu, in); }
+    static void VSRA_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SRA, VF_VX>(cpu, in); }
+    static void VSRA_VI(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_SRA, VF_VI>(cpu, in); }
+    static void VMULHU_VV(RVCPU &cpu, const DecodedInstr &in)   { VBINARY<RVVector::OP_MULHU, VF_VV>(cpu, in); }
+    static void VMULHU_VX(RVCPU &cpu, const DecodedInstr &in)   { VBINARY<RVVector::OP_MULHU, VF_VX>(cpu, in); }
+    static void VMUL_VV(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_MUL, VF_VV>(cpu, in); }
+    static void VMUL_VX(RVCPU &cpu, const DecodedInstr &in)     { VBINARY<RVVector::OP_MUL, VF_VX>(cpu, in); }
+    static void VMULHSU_VV(RVCPU &cpu, const DecodedInstr &in)  { VBINARY<RVVector::OP_MULHSU, VF_VV>(cpu, in); }
+    static void VMULHSU_VX(RVCPU &cpu, const DecodedInstr &in)  { VBINARY<RVVector::OP_MULHSU, VF_VX>(cpu, in); }
+    static void VMULH_VV(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_MULH, VF_VV>(cpu, in); }
+    static void VMULH_VX(RVCPU &cpu, const DecodedInstr &in)    { VBINARY<RVVector::OP_MULH, VF_VX>(cpu, in); }
+    static void VMSEQ_VV(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_EQ, VF_VV>(cpu, in); }
+    static void VMSEQ_VX(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_EQ, VF_VX>(cpu, in); }
+    static void VMSEQ_VI(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_EQ, VF_VI>(cpu, in); }
+    static void VMSNE_VV(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_NE, VF_VV>(cpu, in); }
+    static void VMSNE_VX(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_NE, VF_VX>(cpu, in); }
+    static void VMSNE_VI(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_NE, VF_VI>(cpu, in); }
+    static void VMSLTU_VV(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_LTU, VF_VV>(cpu, in); }
+    static void VMSLTU_VX(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_LTU, VF_VX>(cpu, in); }
+    static void VMSLT_VV(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_LT, VF_VV>(cpu, in); }
+    static void VMSLT_VX(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_LT, VF_VX>(cpu, in); }
+    static void VMSLEU_VV(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_LEU, VF_VV>(cpu, in); }
+    static void VMSLEU_VX(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_LEU, VF_VX>(cpu, in); }
+    static void VMSLEU_VI(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_LEU, VF_VI>(cpu, in); }
+    static void VMSLE_VV(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_LE, VF_VV>(cpu, in); }
+    static void VMSLE_VX(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_LE, VF_VX>(cpu, in); }
+    static void VMSLE_VI(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_LE, VF_VI>(cpu, in); }
+    static void VMSGTU_VX(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_GTU, VF_VX>(cpu, in); }
+    static void VMSGTU_VI(RVCPU &cpu, const DecodedInstr &in)   { VCOMPARE<RVVector::CMP_GTU, VF_VI>(cpu, in); }
+    static void VMSGT_VX(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_GT, VF_VX>(cpu, in); }
+    static void VMSGT_VI(RVCPU &cpu, const DecodedInstr &in)    { VCOMPARE<RVVector::CMP_GT, VF_VI>(cpu, in); }
+    static void VMERGE_VVM(RVCPU &cpu, const DecodedInstr &in)  { VMERGE<VF_VV>(cpu, in); }
+    static void VMERGE_VXM(RVCPU &cpu, const DecodedInstr &in)  { VMERGE<VF_VX>(cpu, in); }
+    static void VMERGE_VIM(RVCPU &cpu, const DecodedInstr &in)  { VMERGE<VF_VI>(cpu, in); }
+    static void VMV_V_V(RVCPU &cpu, const DecodedInstr &in)     { VMERGE<VF_VV>(cpu, in); }
+    static void VMV_V_X(RVCPU &cpu, const DecodedInstr &in)     { VMERGE<VF_VX>(cpu, in); }
+    static void VMV_V_I(RVCPU &cpu, const DecodedInstr &in)     { VMERGE<VF_VI>(cpu, in); }
+    static void VMV1R_V(RVCPU &cpu, const DecodedInstr &in)     { VMVNR<1>(cpu, in); }
+    static void VMV2R_V(RVCPU &cpu, const DecodedInstr &in)     { VMVNR<2>(cpu, in); }
+    static void VMV4R_V(RVCPU &cpu, const DecodedInstr &in)     { VMVNR<4>(cpu, in); }
+    static void VMV8R_V(RVCPU &cpu, const DecodedInstr &in)     { VMVNR<8>(cpu, in); }
+    static void VREDSUM_VS(RVCPU &cpu, const DecodedInstr &in)  { VREDUCE<RVVector::OP_ADD>(cpu, in); }
+    static void VREDAND_VS(RVCPU &cpu, const DecodedInstr &in)  { VREDUCE<RVVector::OP_AND>(cpu, in); }
+    static void VREDOR_VS(RVCPU &cpu, const DecodedInstr &in)   { VREDUCE<RVVector::OP_OR>(cpu, in); }
+    static void VREDXOR_VS(RVCPU &cpu, const DecodedInstr &in)  { VREDUCE<RVVector::OP_XOR>(cpu, in); }
+    static void VREDMINU_VS(RVCPU &cpu, const DecodedInstr &in) { VREDUCE<RVVector::OP_MINU>(cpu, in); }
+    static void VREDMIN_VS(RVCPU &cpu, const DecodedInstr &in)  { VREDUCE<RVVector::OP_MIN>(cpu, in); }
+    static void VREDMAXU_VS(RVCPU &cpu, const DecodedInstr &in) { VREDUCE<RVVector::OP_MAXU>(cpu, in); }
+    static void VREDMAX_VS(RVCPU &cpu, const DecodedInstr &in)  { VREDUCE<RVVector::OP_MAX>(cpu, in); }
+    static void VMADD_VV(RVCPU &cpu, const DecodedInstr &in)    { VTERNARY<RVVector::OP_MADD, VF_VV>(cpu, in); }
+    static void VMADD_VX(RVCPU &cpu, const DecodedInstr &in)    { VTERNARY<RVVector::OP_MADD, VF_VX>(cpu, in); }
+    static void VNMSUB_VV(RVCPU &cpu, const DecodedInstr &in)   { VTERNARY<RVVector::OP_NMSUB, VF_VV>(cpu, in); }
+    static void VNMSUB_VX(RVCPU &cpu, const DecodedInstr &in)   { VTERNARY<RVVector::OP_NMSUB, VF_VX>(cpu, in); }
+    static void VMACC_VV(RVCPU &cpu, const DecodedInstr &in)    { VTERNARY<RVVector::OP_MACC, VF_VV>(cpu, in); }
+    static void VMACC_VX(RVCPU &cpu, const DecodedInstr &in)    { VTERNARY<RVVector::OP_MACC, VF_VX>(cpu, in); }
+    static void VNMSAC_VV(RVCPU &cpu, const DecodedInstr &in)   { VTERNARY<RVVector::OP_NMSAC, VF_VV>(cpu, in); }
+    static void VNMSAC_VX(RVCPU &cpu, const DecodedInstr &in)   { VTERNARY<RVVector::OP_NMSAC, VF_VX>(cpu, in); }
+    static void VMANDN_MM(RVCPU &cpu, const DecodedInstr &in)   { VMASKOP<VM_ANDN>(cpu, in); }
+    static void VMAND_MM(RVCPU &cpu, const DecodedInstr &in)    { VMASKOP<VM_AND>(cpu, in); }
+    static void VMOR_MM(RVCPU &cpu, const DecodedInstr &in)     { VMASKOP<VM_OR>(cpu, in); }
+    static void VMXOR_MM(RVCPU &cpu, const DecodedInstr &in)    { VMASKOP<VM_XOR>(cpu, in); }
+    static void VMORN_MM(RVCPU &cpu, const DecodedInstr &in)    { VMASKOP<VM_ORN>(cpu, in); }
+    static void VMNAND_MM(RVCPU &cpu, const DecodedInstr &in)   { VMASKOP<VM_NAND>(cpu, in); }
+    static void VMNOR_MM(RVCPU &cpu, const DecodedInstr &in)    { VMASKOP<VM_NOR>(cpu, in); }
+    static void VMXNOR_MM(RVCPU &cpu, const DecodedInstr &in)   { VMASKOP<VM_XNOR>(cpu, in); }
+    static void VLE8_V(RVCPU &cpu, const DecodedInstr &in)      { VLOAD<1, false>(cpu, in); }
+    static void VLE16_V(RVCPU &cpu, const DecodedInstr &in)     { VLOAD<2, false>(cpu, in); }
+    static void VLE32_V(RVCPU &cpu, const DecodedInstr &in)     { VLOAD<4, false>(cpu, in); }
+    static void VLE64_V(RVCPU &cpu, const DecodedInstr &in)     { VLOAD<8, false>(cpu, in); }
+    static void VSE8_V(RVCPU &cpu, const DecodedInstr &in)      { VSTORE<1, false>(cpu, in); }
+    static void VSE16_V(RVCPU &cpu, const DecodedInstr &in)     { VSTORE<2, false>(cpu, in); }
+    static void VSE32_V(RVCPU &cpu, const DecodedInstr &in)     { VSTORE<4, false>(cpu, in); }
+    static void VSE64_V(RVCPU &cpu, const DecodedInstr &in)     { VSTORE<8, false>(cpu, in); }
+    static void VLSE8_V(RVCPU &cpu, const DecodedInstr &in)     { VLOAD<1, true>(cpu, in); }
+    static void VLSE16_V(RVCPU &cpu, const DecodedInstr &in)    { VLOAD<2, true>(cpu, in); }
+    static void VLSE32_V(RVCPU &cpu, const DecodedInstr &in)    { VLOAD<4, true>(cpu, in); }
+    static void VLSE64_V(RVCPU &cpu, const DecodedInstr &in)    { VLOAD<8, true>(cpu, in); }
+    static void VSSE8_V(RVCPU &cpu, const DecodedInstr &in)     { VSTORE<1, true>(cpu, in); }
+    static void VSSE16_V(RVCPU &cpu, const DecodedInstr &in)    { VSTORE<2, true>(cpu, in); }
+    static void VSSE32_V(RVCPU &cpu, const DecodedInstr &in)    { VSTORE<4, true>(cpu, in); }
+    static void VSSE64_V(RVCPU &cpu, const DecodedInstr &in)    { VSTORE<8, true>(cpu, in); }
+    static void VL1RE8_V(RVCPU &cpu, const DecodedInstr &in)    { VLNR<1, 1>(cpu, in); }
+    static void VL1RE16_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<1, 2>(cpu, in); }
+    static void VL1RE32_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<1, 4>(cpu, in); }
+    static void VL1RE64_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<1, 8>(cpu, in); }
+    static void VL2RE8_V(RVCPU &cpu, const DecodedInstr &in)    { VLNR<2, 1>(cpu, in); }
+    static void VL2RE16_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<2, 2>(cpu, in); }
+    static void VL2RE32_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<2, 4>(cpu, in); }
+    static void VL2RE64_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<2, 8>(cpu, in); }
+    static void VL4RE8_V(RVCPU &cpu, const DecodedInstr &in)    { VLNR<4, 1>(cpu, in); }
+    static void VL4RE16_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<4, 2>(cpu, in); }
+    static void VL4RE32_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<4, 4>(cpu, in); }
+    static void VL4RE64_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<4, 8>(cpu, in); }
+    static void VL8RE8_V(RVCPU &cpu, const DecodedInstr &in)    { VLNR<8, 1>(cpu, in); }
+    static void VL8RE16_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<8, 2>(cpu, in); }
+    static void VL8RE32_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<8, 4>(cpu, in); }
+    static void VL8RE64_V(RVCPU &cpu, const DecodedInstr &in)   { VLNR<8, 8>(cpu, in); }
+    static void VS1R_V(RVCPU &cpu, const DecodedInstr &in)      { VSNR<1>(cpu, in); }
+    static void VS2R_V(RVCPU &cpu, const DecodedInstr &in)      { VSNR<2>(cpu, in); }
+    static void VS4R_V(RVCPU &cpu, const DecodedInstr &in)      { VSNR<4>(cpu, in); }
+    static void VS8R_V(RVCPU &cpu, const DecodedInstr &in)      { VSNR<8>(cpu, in); }
+
+    // ================ System ================
+    static void FENCE(RVCPU &, const DecodedInstr &)        { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+    static void FENCE_I(RVCPU &cpu, const DecodedInstr &)   { cpu.flushPending = true; }
+    static void ECALL(RVCPU &cpu, const DecodedInstr &in)   { cpu.takeException(in, CAUSE_USER_ECALL + cpu.state.priv, 0); }
+    static void EBREAK(RVCPU &cpu, const DecodedInstr &in)  { cpu.takeException(in, CAUSE_BREAKPOINT, in.pc); }
+    static void MRET(RVCPU &cpu, const DecodedInstr &in)    { cpu.trapReturn(in, PRIV_M); }
+    static void SRET(RVCPU &cpu, const DecodedInstr &in)    { cpu.trapReturn(in, PRIV_S); }
+    static void WFI(RVCPU &, const DecodedInstr &)          { }
+    static void SFENCE_VMA(RVCPU &cpu, const DecodedInstr &in)  { cpu.sfenceVMA(in); }
+
+    static void CSRRW(RVCPU &cpu, const DecodedInstr &in)   { cpu.csrOp(in, cpu.state.X[in.rs1], 0); }
+    static void CSRRS(RVCPU &cpu, const DecodedInstr &in)   { cpu.csrOp(in, cpu.state.X[in.rs1], 1); }
+    static void CSRRC(RVCPU &cpu, const DecodedInstr &in)   { cpu.csrOp(in, cpu.state.X[in.rs1], 2); }
+    static void CSRRWI(RVCPU &cpu, const DecodedInstr &in)  { cpu.csrOp(in, in.rs1, 0); }
+    static void CSRRSI(RVCPU &cpu, const DecodedInstr &in)  { cpu.csrOp(in, in.rs1, 1); }
+    static void CSRRCI(RVCPU &cpu, const DecodedInstr &in)  { cpu.csrOp(in, in.rs1, 2); }
+
+    static void ILLEGAL(RVCPU &cpu, const DecodedInstr &in) { cpu.illegalInstruction(in); }
+
+    // Decoded in place of an instruction that can not be fetched, the fault
+    // is only raised if execution reaches it
+    static void FETCH_ACCESS_FAULT(RVCPU &cpu, const DecodedInstr &in)  { cpu.raiseException(in, CAUSE_FETCH_ACCESS, (REG)in.imm); }
+    static void FETCH_PAGE_FAULT(RVCPU &cpu, const DecodedInstr &in)    { cpu.raiseException(in, CAUSE_FETCH_PAGE_FAULT, (REG)in.imm); }
+    static void FETCH_MISALIGNED(RVCPU &cpu, const DecodedInstr &in)    { cpu.raiseException(in, CAUSE_MISALIGNED_FETCH, (REG)in.imm); }
+
+    // Swapped in for the handler of the instruction at a breakpoint, unwinds
+    // out of the block before the instruction executes
+    static void BREAKPOINT(RVCPU &, const DecodedInstr &in) { throw StopHit{&in, STOP_BREAKPOINT}; }
+};
+
+
+/**
+ * @brief Supported instructions
+ */
+static const InstrDesc instr_table[] =
+{
+    // name         mask        match       format      handler             event class         flags           xlen
+    {"lui",         0x0000007f, 0x00000037, FMT_U,      RVExec::LUI,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"auipc",       0x0000007f, 0x00000017, FMT_U,      RVExec::AUIPC,      HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"jal",         0x0000007f, 0x0000006f, FMT_J,      RVExec::JAL,        HPM_EV_JUMP,        F_WRD|F_TERM,   0,  EXT_I},
+    {"jalr",        0x0000707f, 0x00000067, FMT_IM,     RVExec::JALR,       HPM_EV_JUMP,        F_WRD|F_TERM,   0,  EXT_I},
+
+    {"beq",         0x0000707f, 0x00000063, FMT_B,      RVExec::BEQ,        HPM_EV_BRANCH,      F_TERM,         0,  EXT_I},
+    {"bne",         0x0000707f, 0x00001063, FMT_B,      RVExec::BNE,        HPM_EV_BRANCH,      F_TERM,         0,  EXT_I},
+    {"blt",         0x0000707f, 0x00004063, FMT_B,      RVExec::BLT,        HPM_EV_BRANCH,      F_TERM,         0,  EXT_I},
+    {"bge",         0x0000707f, 0x00005063, FMT_B,      RVExec::BGE,        HPM_EV_BRANCH,      F_TERM,         0,  EXT_I},
+    {"bltu",        0x0000707f, 0x00006063, FMT_B,      RVExec::BLTU,       HPM_EV_BRANCH,      F_TERM,         0,  EXT_I},
+    {"bgeu",        0x0000707f, 0x00007063, FMT_B,      RVExec::BGEU,       HPM_EV_BRANCH,      F_TERM,         0,  EXT_I},
+
+    {"lb",          0x0000707f, 0x00000003, FMT_IM,     RVExec::LB,         HPM_EV_LOAD,        F_WRD,          0,  EXT_I},
+    {"lh",          0x0000707f, 0x00001003, FMT_IM,     RVExec::LH,         HPM_EV_LOAD,        F_WRD,          0,  EXT_I},
+    {"lw",          0x0000707f, 0x00002003, FMT_IM,     RVExec::LW,         HPM_EV_LOAD,        F_WRD,          0,  EXT_I},
+    {"ld",          0x0000707f, 0x00003003, FMT_IM,     RVExec::LD,         HPM_EV_LOAD,        F_WRD,          64, EXT_I},
+    {"lbu",         0x0000707f, 0x00004003, FMT_IM,     RVExec::LBU,        HPM_EV_LOAD,        F_WRD,          0,  EXT_I},
+    {"lhu",         0x0000707f, 0x00005003, FMT_IM,     RVExec::LHU,        HPM_EV_LOAD,        F_WRD,          0,  EXT_I},
+    {"lwu",         0x0000707f, 0x00006003, FMT_IM,     RVExec::LWU,        HPM_EV_LOAD,        F_WRD,          64, EXT_I},
+    {"sb",          0x0000707f, 0x00000023, FMT_S,      RVExec::SB,         HPM_EV_STORE,       0,              0,  EXT_I},
+    {"sh",          0x0000707f, 0x00001023, FMT_S,      RVExec::SH,         HPM_EV_STORE,       0,              0,  EXT_I},
+    {"sw",          0x0000707f, 0x00002023, FMT_S,      RVExec::SW,         HPM_EV_STORE,       0,              0,  EXT_I},
+    {"sd",          0x0000707f, 0x00003023, FMT_S,      RVExec::SD,         HPM_EV_STORE,       0,              64, EXT_I},
+
+    {"addi",        0x0000707f, 0x00000013, FMT_I,      RVExec::ADDI,       HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"slti",        0x0000707f, 0x00002013, FMT_I,      RVExec::SLTI,       HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"sltiu",       0x0000707f, 0x00003013, FMT_I,      RVExec::SLTIU,      HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"xori",        0x0000707f, 0x00004013, FMT_I,      RVExec::XORI,       HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"ori",         0x0000707f, 0x00006013, FMT_I,      RVExec::ORI,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"andi",        0x0000707f, 0x00007013, FMT_I,      RVExec::ANDI,       HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"slli",        0xfe00707f, 0x00001013, FMT_SHAMT,  RVExec::SLLI,       HPM_EV_NONE,        F_WRD,          32, EXT_I},
+    {"srli",        0xfe00707f, 0x00005013, FMT_SHAMT,  RVExec::SRLI,       HPM_EV_NONE,        F_WRD,          32, EXT_I},
+    {"srai",        0xfe00707f, 0x40005013, FMT_SHAMT,  RVExec::SRAI,       HPM_EV_NONE,        F_WRD,          32, EXT_I},
+    {"slli",        0xfc00707f, 0x00001013, FMT_SHAMT,  RVExec::SLLI,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"srli",        0xfc00707f, 0x00005013, FMT_SHAMT,  RVExec::SRLI,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"srai",        0xfc00707f, 0x40005013, FMT_SHAMT,  RVExec::SRAI,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+
+    {"add",         0xfe00707f, 0x00000033, FMT_R,      RVExec::ADD,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"sub",         0xfe00707f, 0x40000033, FMT_R,      RVExec::SUB,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"sll",         0xfe00707f, 0x00001033, FMT_R,      RVExec::SLL,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"slt",         0xfe00707f, 0x00002033, FMT_R,      RVExec::SLT,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"sltu",        0xfe00707f, 0x00003033, FMT_R,      RVExec::SLTU,       HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"xor",         0xfe00707f, 0x00004033, FMT_R,      RVExec::XOR,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"srl",         0xfe00707f, 0x00005033, FMT_R,      RVExec::SRL,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"sra",         0xfe00707f, 0x40005033, FMT_R,      RVExec::SRA,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"or",          0xfe00707f, 0x00006033, FMT_R,      RVExec::OR,         HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+    {"and",         0xfe00707f, 0x00007033, FMT_R,      RVExec::AND,        HPM_EV_NONE,        F_WRD,          0,  EXT_I},
+
+    {"addiw",       0x0000707f, 0x0000001b, FMT_I,      RVExec::ADDIW,      HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"slliw",       0xfe00707f, 0x0000101b, FMT_SHAMT,  RVExec::SLLIW,      HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"srliw",       0xfe00707f, 0x0000501b, FMT_SHAMT,  RVExec::SRLIW,      HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"sraiw",       0xfe00707f, 0x4000501b, FMT_SHAMT,  RVExec::SRAIW,      HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"addw",        0xfe00707f, 0x0000003b, FMT_R,      RVExec::ADDW,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"subw",        0xfe00707f, 0x4000003b, FMT_R,      RVExec::SUBW,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"sllw",        0xfe00707f, 0x0000103b, FMT_R,      RVExec::SLLW,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"srlw",        0xfe00707f, 0x0000503b, FMT_R,      RVExec::SRLW,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+    {"sraw",        0xfe00707f, 0x4000503b, FMT_R,      RVExec::SRAW,       HPM_EV_NONE,        F_WRD,          64, EXT_I},
+
+
+    {"mul",         0xfe00707f, 0x02000033, FMT_R,      RVExec::MUL,        HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"mulh",        0xfe00707f, 0x02001033, FMT_R,      RVExec::MULH,       HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"mulhsu",      0xfe00707f, 0x02002033, FMT_R,      RVExec::MULHSU,     HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"mulhu",       0xfe00707f, 0x02003033, FMT_R,      RVExec::MULHU,      HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"div",         0xfe00707f, 0x02004033, FMT_R,      RVExec::DIV,        HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"divu",        0xfe00707f, 0x02005033, FMT_R,      RVExec::DIVU,       HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"rem",         0xfe00707f, 0x02006033, FMT_R,      RVExec::REM,        HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+    {"remu",        0xfe00707f, 0x02007033, FMT_R,      RVExec::REMU,       HPM_EV_NONE,        F_WRD,          0,  EXT_M},
+
+    {"mulw",        0xfe00707f, 0x0200003b, FMT_R,      RVExec::MULW,       HPM_EV_NONE,        F_WRD,          64, EXT_M},
+    {"divw",        0xfe00707f, 0x0200403b, FMT_R,      RVExec::DIVW,       HPM_EV_NONE,        F_WRD,          64, EXT_M},
+    {"divuw",       0xfe00707f, 0x0200503b, FMT_R,      RVExec::DIVUW,      HPM_EV_NONE,        F_WRD,          64, EXT_M},
+    {"remw",        0xfe00707f, 0x0200603b, FMT_R,      RVExec::REMW,       HPM_EV_NONE,        F_WRD,          64, EXT_M},
+    {"remuw",       0xfe00707f, 0x0200703b, FMT_R,      RVExec::REMUW,      HPM_EV_NONE,        F_WRD,          64, EXT_M},
+
+    {"lr.w",        0xf9f0707f, 0x1000202f, FMT_AMO,    RVExec::LR_W,       HPM_EV_LOAD,        F_WRD,          0,  EXT_A},
+    {"sc.w",        0xf800707f, 0x1800202f, FMT_AMO,    RVExec::SC_W,       HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amoswap.w",   0xf800707f, 0x0800202f, FMT_AMO,    RVExec::AMOSWAP_W,  HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amoadd.w",    0xf800707f, 0x0000202f, FMT_AMO,    RVExec::AMOADD_W,   HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amoxor.w",    0xf800707f, 0x2000202f, FMT_AMO,    RVExec::AMOXOR_W,   HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amoand.w",    0xf800707f, 0x6000202f, FMT_AMO,    RVExec::AMOAND_W,   HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amoor.w",     0xf800707f, 0x4000202f, FMT_AMO,    RVExec::AMOOR_W,    HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amomin.w",    0xf800707f, 0x8000202f, FMT_AMO,    RVExec::AMOMIN_W,   HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amomax.w",    0xf800707f, 0xa000202f, FMT_AMO,    RVExec::AMOMAX_W,   HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amominu.w",   0xf800707f, 0xc000202f, FMT_AMO,    RVExec::AMOMINU_W,  HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+    {"amomaxu.w",   0xf800707f, 0xe000202f, FMT_AMO,    RVExec::AMOMAXU_W,  HPM_EV_STORE,       F_WRD,          0,  EXT_A},
+
+    {"lr.d",        0xf9f0707f, 0x1000302f, FMT_AMO,    RVExec::LR_D,       HPM_EV_LOAD,        F_WRD,          64, EXT_A},
+    {"sc.d",        0xf800707f, 0x1800302f, FMT_AMO,    RVExec::SC_D,       HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amoswap.d",   0xf800707f, 0x0800302f, FMT_AMO,    RVExec::AMOSWAP_D,  HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amoadd.d",    0xf800707f, 0x0000302f, FMT_AMO,    RVExec::AMOADD_D,   HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amoxor.d",    0xf800707f, 0x2000302f, FMT_AMO,    RVExec::AMOXOR_D,   HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amoand.d",    0xf800707f, 0x6000302f, FMT_AMO,    RVExec::AMOAND_D,   HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amoor.d",     0xf800707f, 0x4000302f, FMT_AMO,    RVExec::AMOOR_D,    HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amomin.d",    0xf800707f, 0x8000302f, FMT_AMO,    RVExec::AMOMIN_D,   HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amomax.d",    0xf800707f, 0xa000302f, FMT_AMO,    RVExec::AMOMAX_D,   HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amominu.d",   0xf800707f, 0xc000302f, FMT_AMO,    RVExec::AMOMINU_D,  HPM_EV_STORE,       F_WRD,          64, EXT_A},
+    {"amomaxu.d",   0xf800707f, 0xe000302f, FMT_AMO,    RVExec::AMOMAXU_D,  HPM_EV_STORE,       F_WRD,          64, EXT_A},
+
+    {"flw",         0x0000707f, 0x00002007, FMT_IM,     RVExec::FLW,        HPM_EV_LOAD,        F_FRD,          0,  EXT_F},
+    {"fsw",         0x0000707f, 0x00002027, FMT_S,      RVExec::FSW,        HPM_EV_STORE,       F_FRS2,         0,  EXT_F},
+    {"fmadd.s",     0x0600007f, 0x00000043, FMT_R4,     RVExec::FMADD_S,    HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fmsub.s",     0x0600007f, 0x00000047, FMT_R4,     RVExec::FMSUB_S,    HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fnmsub.s",    0x0600007f, 0x0000004b, FMT_R4,     RVExec::FNMSUB_S,   HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fnmadd.s",    0x0600007f, 0x0000004f, FMT_R4,     RVExec::FNMADD_S,   HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fadd.s",      0xfe00007f, 0x00000053, FMT_R,      RVExec::FADD_S,     HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fsub.s",      0xfe00007f, 0x08000053, FMT_R,      RVExec::FSUB_S,     HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fmul.s",      0xfe00007f, 0x10000053, FMT_R,      RVExec::FMUL_S,     HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fdiv.s",      0xfe00007f, 0x18000053, FMT_R,      RVExec::FDIV_S,     HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fsqrt.s",     0xfff0007f, 0x58000053, FMT_R1,     RVExec::FSQRT_S,    HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fsgnj.s",     0xfe00707f, 0x20000053, FMT_R,      RVExec::FSGNJ_S,    HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fsgnjn.s",    0xfe00707f, 0x20001053, FMT_R,      RVExec::FSGNJN_S,   HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fsgnjx.s",    0xfe00707f, 0x20002053, FMT_R,      RVExec::FSGNJX_S,   HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fmin.s",      0xfe00707f, 0x28000053, FMT_R,      RVExec::FMIN_S,     HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fmax.s",      0xfe00707f, 0x28001053, FMT_R,      RVExec::FMAX_S,     HPM_EV_NONE,        F_FP,           0,  EXT_F},
+    {"fcvt.s.d",    0xfff0007f, 0x40100053, FMT_R1,     RVExec::FCVT_S_D,   HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fcvt.d.s",    0xfff0007f, 0x42000053, FMT_R1,     RVExec::FCVT_D_S,   HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"feq.s",       0xfe00707f, 0xa0002053, FMT_R,      RVExec::FEQ_S,      HPM_EV_NONE,        F_WRD|F_FRS,    0,  EXT_F},
+    {"flt.s",       0xfe00707f, 0xa0001053, FMT_R,      RVExec::FLT_S,      HPM_EV_NONE,        F_WRD|F_FRS,    0,  EXT_F},
+    {"fle.s",       0xfe00707f, 0xa0000053, FMT_R,      RVExec::FLE_S,      HPM_EV_NONE,        F_WRD|F_FRS,    0,  EXT_F},
+    {"fclass.s",    0xfff0707f, 0xe0001053, FMT_R1,     RVExec::FCLASS_S,   HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_F},
+    {"fcvt.w.s",    0xfff0007f, 0xc0000053, FMT_R1,     RVExec::FCVT_W_S,   HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_F},
+    {"fcvt.wu.s",   0xfff0007f, 0xc0100053, FMT_R1,     RVExec::FCVT_WU_S,  HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_F},
+    {"fcvt.l.s",    0xfff0007f, 0xc0200053, FMT_R1,     RVExec::FCVT_L_S,   HPM_EV_NONE,        F_WRD|F_FRS1,   64, EXT_F},
+    {"fcvt.lu.s",   0xfff0007f, 0xc0300053, FMT_R1,     RVExec::FCVT_LU_S,  HPM_EV_NONE,        F_WRD|F_FRS1,   64, EXT_F},
+    {"fcvt.s.w",    0xfff0007f, 0xd0000053, FMT_R1,     RVExec::FCVT_S_W,   HPM_EV_NONE,        F_FRD,          0,  EXT_F},
+    {"fcvt.s.wu",   0xfff0007f, 0xd0100053, FMT_R1,     RVExec::FCVT_S_WU,  HPM_EV_NONE,        F_FRD,          0,  EXT_F},
+    {"fcvt.s.l",    0xfff0007f, 0xd0200053, FMT_R1,     RVExec::FCVT_S_L,   HPM_EV_NONE,        F_FRD,          64, EXT_F},
+    {"fcvt.s.lu",   0xfff0007f, 0xd0300053, FMT_R1,     RVExec::FCVT_S_LU,  HPM_EV_NONE,        F_FRD,          64, EXT_F},
+    {"fmv.x.w",     0xfff0707f, 0xe0000053, FMT_R1,     RVExec::FMV_X_W,    HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_F},
+    {"fmv.w.x",     0xfff0707f, 0xf0000053, FMT_R1,     RVExec::FMV_W_X,    HPM_EV_NONE,        F_FRD,          0,  EXT_F},
+
+    {"fld",         0x0000707f, 0x00003007, FMT_IM,     RVExec::FLD,        HPM_EV_LOAD,        F_FRD,          0,  EXT_D},
+    {"fsd",         0x0000707f, 0x00003027, FMT_S,      RVExec::FSD,        HPM_EV_STORE,       F_FRS2,         0,  EXT_D},
+    {"fmadd.d",     0x0600007f, 0x02000043, FMT_R4,     RVExec::FMADD_D,    HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fmsub.d",     0x0600007f, 0x02000047, FMT_R4,     RVExec::FMSUB_D,    HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fnmsub.d",    0x0600007f, 0x0200004b, FMT_R4,     RVExec::FNMSUB_D,   HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fnmadd.d",    0x0600007f, 0x0200004f, FMT_R4,     RVExec::FNMADD_D,   HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fadd.d",      0xfe00007f, 0x02000053, FMT_R,      RVExec::FADD_D,     HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fsub.d",      0xfe00007f, 0x0a000053, FMT_R,      RVExec::FSUB_D,     HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fmul.d",      0xfe00007f, 0x12000053, FMT_R,      RVExec::FMUL_D,     HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fdiv.d",      0xfe00007f, 0x1a000053, FMT_R,      RVExec::FDIV_D,     HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fsqrt.d",     0xfff0007f, 0x5a000053, FMT_R1,     RVExec::FSQRT_D,    HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fsgnj.d",     0xfe00707f, 0x22000053, FMT_R,      RVExec::FSGNJ_D,    HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fsgnjn.d",    0xfe00707f, 0x22001053, FMT_R,      RVExec::FSGNJN_D,   HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fsgnjx.d",    0xfe00707f, 0x22002053, FMT_R,      RVExec::FSGNJX_D,   HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fmin.d",      0xfe00707f, 0x2a000053, FMT_R,      RVExec::FMIN_D,     HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"fmax.d",      0xfe00707f, 0x2a001053, FMT_R,      RVExec::FMAX_D,     HPM_EV_NONE,        F_FP,           0,  EXT_D},
+    {"feq.d",       0xfe00707f, 0xa2002053, FMT_R,      RVExec::FEQ_D,      HPM_EV_NONE,        F_WRD|F_FRS,    0,  EXT_D},
+    {"flt.d",       0xfe00707f, 0xa2001053, FMT_R,      RVExec::FLT_D,      HPM_EV_NONE,        F_WRD|F_FRS,    0,  EXT_D},
+    {"fle.d",       0xfe00707f, 0xa2000053, FMT_R,      RVExec::FLE_D,      HPM_EV_NONE,        F_WRD|F_FRS,    0,  EXT_D},
+    {"fclass.d",    0xfff0707f, 0xe2001053, FMT_R1,     RVExec::FCLASS_D,   HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_D},
+    {"fcvt.w.d",    0xfff0007f, 0xc2000053, FMT_R1,     RVExec::FCVT_W_D,   HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_D},
+    {"fcvt.wu.d",   0xfff0007f, 0xc2100053, FMT_R1,     RVExec::FCVT_WU_D,  HPM_EV_NONE,        F_WRD|F_FRS1,   0,  EXT_D},
+    {"fcvt.l.d",    0xfff0007f, 0xc2200053, FMT_R1,     RVExec::FCVT_L_D,   HPM_EV_NONE,        F_WRD|F_FRS1,   64, EXT_D},
+    {"fcvt.lu.d",   0xfff0007f, 0xc2300053, FMT_R1,     RVExec::FCVT_LU_D,  HPM_EV_NONE,        F_WRD|F_FRS1,   64, EXT_D},
+    {"fcvt.d.w",    0xfff0007f, 0xd2000053, FMT_R1,     RVExec::FCVT_D_W,   HPM_EV_NONE,        F_FRD,          0,  EXT_D},
+    {"fcvt.d.wu",   0xfff0007f, 0xd2100053, FMT_R1,     RVExec::FCVT_D_WU,  HPM_EV_NONE,        F_FRD,          0,  EXT_D},
+    {"fcvt.d.l",    0xfff0007f, 0xd2200053, FMT_R1,     RVExec::FCVT_D_L,   HPM_EV_NONE,        F_FRD,          64, EXT_D},
+    {"fcvt.d.lu",   0xfff0007f, 0xd2300053, FMT_R1,     RVExec::FCVT_D_LU,  HPM_EV_NONE,        F_FRD,          64, EXT_D},
+    {"fmv.x.d",     0xfff0707f, 0xe2000053, FMT_R1,     RVExec::FMV_X_D,    HPM_EV_NONE,        F_WRD|F_FRS1,   64, EXT_D},
+    {"fmv.d.x",     0xfff0707f, 0xf2000053, FMT_R1,     RVExec::FMV_D_X,    HPM_EV_NONE,        F_FRD,          64, EXT_D},
+
+    {"sh1add",       0xfe00707f, 0x20002033, FMT_R,      RVExec::SH1ADD,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBA},
+    {"sh2add",       0xfe00707f, 0x20004033, FMT_R,      RVExec::SH2ADD,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBA},
+    {"sh3add",       0xfe00707f, 0x20006033, FMT_R,      RVExec::SH3ADD,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBA},
+    {"add.uw",       0xfe00707f, 0x0800003b, FMT_R,      RVExec::ADD_UW,     HPM_EV_NONE,        F_WRD,          64, EXT_ZBA},
+    {"sh1add.uw",    0xfe00707f, 0x2000203b, FMT_R,      RVExec::SH1ADD_UW,  HPM_EV_NONE,        F_WRD,          64, EXT_ZBA},
+    {"sh2add.uw",    0xfe00707f, 0x2000403b, FMT_R,      RVExec::SH2ADD_UW,  HPM_EV_NONE,        F_WRD,          64, EXT_ZBA},
+    {"sh3add.uw",    0xfe00707f, 0x2000603b, FMT_R,      RVExec::SH3ADD_UW,  HPM_EV_NONE,        F_WRD,          64, EXT_ZBA},
+    {"slli.uw",      0xfc00707f, 0x0800101b, FMT_SHAMT,  RVExec::SLLI_UW,    HPM_EV_NONE,        F_WRD,          64, EXT_ZBA},
+
+    {"andn",         0xfe00707f, 0x40007033, FMT_R,      RVExec::ANDN,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"orn",          0xfe00707f, 0x40006033, FMT_R,      RVExec::ORN,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"xnor",         0xfe00707f, 0x40004033, FMT_R,      RVExec::XNOR,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"clz",          0xfff0707f, 0x60001013, FMT_R1,     RVExec::CLZ,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"ctz",          0xfff0707f, 0x60101013, FMT_R1,     RVExec::CTZ,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"cpop",         0xfff0707f, 0x60201013, FMT_R1,     RVExec::CPOP,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"max",          0xfe00707f, 0x0a006033, FMT_R,      RVExec::MAX,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"maxu",         0xfe00707f, 0x0a007033, FMT_R,      RVExec::MAXU,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"min",          0xfe00707f, 0x0a004033, FMT_R,      RVExec::MIN,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"minu",         0xfe00707f, 0x0a005033, FMT_R,      RVExec::MINU,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"sext.b",       0xfff0707f, 0x60401013, FMT_R1,     RVExec::SEXT_B,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"sext.h",       0xfff0707f, 0x60501013, FMT_R1,     RVExec::SEXT_H,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"zext.h",       0xfff0707f, 0x08004033, FMT_R1,     RVExec::ZEXT_H,     HPM_EV_NONE,        F_WRD,          32, EXT_ZBB},
+    {"zext.h",       0xfff0707f, 0x0800403b, FMT_R1,     RVExec::ZEXT_H,     HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"rol",          0xfe00707f, 0x60001033, FMT_R,      RVExec::ROL,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"ror",          0xfe00707f, 0x60005033, FMT_R,      RVExec::ROR,        HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"rori",         0xfe00707f, 0x60005013, FMT_SHAMT,  RVExec::RORI,       HPM_EV_NONE,        F_WRD,          32, EXT_ZBB},
+    {"rori",         0xfc00707f, 0x60005013, FMT_SHAMT,  RVExec::RORI,       HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"orc.b",        0xfff0707f, 0x28705013, FMT_R1,     RVExec::ORC_B,      HPM_EV_NONE,        F_WRD,          0,  EXT_ZBB},
+    {"rev8",         0xfff0707f, 0x69805013, FMT_R1,     RVExec::REV8,       HPM_EV_NONE,        F_WRD,          32, EXT_ZBB},
+    {"rev8",         0xfff0707f, 0x6b805013, FMT_R1,     RVExec::REV8,       HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"clzw",         0xfff0707f, 0x6000101b, FMT_R1,     RVExec::CLZW,       HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"ctzw",         0xfff0707f, 0x6010101b, FMT_R1,     RVExec::CTZW,       HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"cpopw",        0xfff0707f, 0x6020101b, FMT_R1,     RVExec::CPOPW,      HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"rolw",         0xfe00707f, 0x6000103b, FMT_R,      RVExec::ROLW,       HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"rorw",         0xfe00707f, 0x6000503b, FMT_R,      RVExec::RORW,       HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+    {"roriw",        0xfe00707f, 0x6000501b, FMT_SHAMT,  RVExec::RORIW,      HPM_EV_NONE,        F_WRD,          64, EXT_ZBB},
+
+    {"clmul",        0xfe00707f, 0x0a001033, FMT_R,      RVExec::CLMUL_L,    HPM_EV_NONE,        F_WRD,          0,  EXT_ZBC},
+    {"clmulh",       0xfe00707f, 0x0a003033, FMT_R,      RVExec::CLMULH,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBC},
+    {"clmulr",       0xfe00707f, 0x0a002033, FMT_R,      RVExec::CLMULR,     HPM_EV_NONE,        F_WRD,          0,  EXT_ZBC},
+
+    {"bclr",         0xfe00707f, 0x48001033, FMT_R,      RVExec::BCLR,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBS},
+    {"bext",         0xfe00707f, 0x48005033, FMT_R,      RVExec::BEXT,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBS},
+    {"binv",         0xfe00707f, 0x68001033, FMT_R,      RVExec::BINV,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBS},
+    {"bset",         0xfe00707f, 0x28001033, FMT_R,      RVExec::BSET,       HPM_EV_NONE,        F_WRD,          0,  EXT_ZBS},
+    {"bclri",        0xfe00707f, 0x48001013, FMT_SHAMT,  RVExec::BCLRI,      HPM_EV_NONE,        F_WRD,          32, EXT_ZBS},
+    {"bclri",        0xfc00707f, 0x48001013, FMT_SHAMT,  RVExec::BCLRI,      HPM_EV_NONE,        F_WRD,          64, EXT_ZBS},
+    {"bexti",        0xfe00707f, 0x48005013, FMT_SHAMT,  RVExec::BEXTI,      HPM_EV_NONE,        F_WRD,          32, EXT_ZBS},
+    {"bexti",        0xfc00707f, 0x48005013, FMT_SHAMT,  RVExec::BEXTI,      HPM_EV_NONE,        F_WRD,          64, EXT_ZBS},
+    {"binvi",        0xfe00707f, 0x68001013, FMT_SHAMT,  RVExec::BINVI,      HPM_EV_NONE,        F_WRD,          32, EXT_ZBS},
+    {"binvi",        0xfc00707f, 0x68001013, FMT_SHAMT,  RVExec::BINVI,      HPM_EV_NONE,        F_WRD,          64, EXT_ZBS},
+    {"bseti",        0xfe00707f, 0x28001013, FMT_SHAMT,  RVExec::BSETI,      HPM_EV_NONE,        F_WRD,          32, EXT_ZBS},
+    {"bseti",        0xfc00707f, 0x28001013, FMT_SHAMT,  RVExec::BSETI,      HPM_EV_NONE,        F_WRD,          64, EXT_ZBS},
+
+    {"aes32esi",     0x3e00707f, 0x22000033, FMT_RBS,    RVExec::AES32ESI,   HPM_EV_NONE,        F_WRD,          32, EXT_ZKNE},
+    {"aes32esmi",    0x3e00707f, 0x26000033, FMT_RBS,    RVExec::AES32ESMI,  HPM_EV_NONE,        F_WRD,          32, EXT_ZKNE},
+    {"aes32dsi",     0x3e00707f, 0x2a000033, FMT_RBS,    RVExec::AES32DSI,   HPM_EV_NONE,        F_WRD,          32, EXT_ZKND},
+    {"aes32dsmi",    0x3e00707f, 0x2e000033, FMT_RBS,    RVExec::AES32DSMI,  HPM_EV_NONE,        F_WRD,          32, EXT_ZKND},
+    {"aes64es",      0xfe00707f, 0x32000033, FMT_R,      RVExec::AES64ES,    HPM_EV_NONE,        F_WRD,          64, EXT_ZKNE},
+    {"aes64esm",     0xfe00707f, 0x36000033, FMT_R,      RVExec::AES64ESM,   HPM_EV_NONE,        F_WRD,          64, EXT_ZKNE},
+    {"aes64ds",      0xfe00707f, 0x3a000033, FMT_R,      RVExec::AES64DS,    HPM_EV_NONE,        F_WRD,          64, EXT_ZKND},
+    {"aes64dsm",     0xfe00707f, 0x3e000033, FMT_R,      RVExec::AES64DSM,   HPM_EV_NONE,        F_WRD,          64, EXT_ZKND},
+    {"aes64im",      0xfff0707f, 0x30001013, FMT_R1,     RVExec::AES64IM,    HPM_EV_NONE,        F_WRD,          64, EXT_ZKND},
+    {"aes64ks1i",    0xff00707f, 0x31001013, FMT_RNUM,   RVExec::AES64KS1I,  HPM_EV_NONE,        F_WRD,          64, EXT_ZKND_ZKNE},
+    {"aes64ks2",     0xfe00707f, 0x7e000033, FMT_R,      RVExec::AES64KS2,   HPM_EV_NONE,        F_WRD,          64, EXT_ZKND_ZKNE},
+
+    {"sha256sig0",   0xfff0707f, 0x10201013, FMT_R1,     RVExec::SHA256SIG0, HPM_EV_NONE,        F_WRD,          0,  EXT_ZKNH},
+    {"sha256sig1",   0xfff0707f, 0x10301013, FMT_R1,     RVExec::SHA256SIG1, HPM_EV_NONE,        F_WRD,          0,  EXT_ZKNH},
+    {"sha256sum0",   0xfff0707f, 0x10001013, FMT_R1,     RVExec::SHA256SUM0, HPM_EV_NONE,        F_WRD,          0,  EXT_ZKNH},
+    {"sha256sum1",   0xfff0707f, 0x10101013, FMT_R1,     RVExec::SHA256SUM1, HPM_EV_NONE,        F_WRD,          0,  EXT_ZKNH},
+    {"sha512sig0h",  0xfe00707f, 0x5c000033, FMT_R,      RVExec::SHA512SIG0H, HPM_EV_NONE,       F_WRD,          32, EXT_ZKNH},
+    {"sha512sig0l",  0xfe00707f, 0x54000033, FMT_R,      RVExec::SHA512SIG0L, HPM_EV_NONE,       F_WRD,          32, EXT_ZKNH},
+    {"sha512sig1h",  0xfe00707f, 0x5e000033, FMT_R,      RVExec::SHA512SIG1H, HPM_EV_NONE,       F_WRD,          32, EXT_ZKNH},
+    {"sha512sig1l",  0xfe00707f, 0x56000033, FMT_R,      RVExec::SHA512SIG1L, HPM_EV_NONE,       F_WRD,          32, EXT_ZKNH},
+    {"sha512sum0r",  0xfe00707f, 0x50000033, FMT_R,      RVExec::SHA512SUM0R, HPM_EV_NONE,       F_WRD,          32, EXT_ZKNH},
+    {"sha512sum1r",  0xfe00707f, 0x52000033, FMT_R,      RVExec::SHA512SUM1R, HPM_EV_NONE,       F_WRD,          32, EXT_ZKNH},
+    {"sha512sig0",   0xfff0707f, 0x10601013, FMT_R1,     RVExec::SHA512SIG0, HPM_EV_NONE,        F_WRD,          64, EXT_ZKNH},
+    {"sha512sig1",   0xfff0707f, 0x10701013, FMT_R1,     RVExec::SHA512SIG1, HPM_EV_NONE,        F_WRD,          64, EXT_ZKNH},
+    {"sha512sum0",   0xfff0707f, 0x10401013, FMT_R1,     RVExec::SHA512SUM0, HPM_EV_NONE,        F_WRD,          64, EXT_ZKNH},
+    {"sha512sum1",   0xfff0707f, 0x10501013, FMT_R1,     RVExec::SHA512SUM1, HPM_EV_NONE,        F_WRD,          64, EXT_ZKNH},
+
+    {"sm4ed",        0x3e00707f, 0x30000033, FMT_RBS,    RVExec::SM4ED,      HPM_EV_NONE,        F_WRD,          0,  EXT_ZKSED},
+    {"sm4ks",        0x3e00707f, 0x34000033, FMT_RBS,    RVExec::SM4KS,      HPM_EV_NONE,        F_WRD,          0,  EXT_ZKSED},
+    {"sm3p0",        0xfff0707f, 0x10801013, FMT_R1,     RVExec::SM3P0,      HPM_EV_NONE,        F_WRD,          0,  EXT_ZKSH},
+    {"sm3p1",        0xfff0707f, 0x10901013, FMT_R1,     RVExec::SM3P1,      HPM_EV_NONE,        F_WRD,          0,  EXT_ZKSH},
+
+    {"vadd.vv",     0xfc00707f, 0x00000057, FMT_VV,      RVExec::VADD_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vadd.vx",     0xfc00707f, 0x00004057, FMT_VV,      RVExec::VADD_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vadd.vi",     0xfc00707f, 0x00003057, FMT_VI,      RVExec::VADD_VI,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsub.vv",     0xfc00707f, 0x08000057, FMT_VV,      RVExec::VSUB_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vsub.vx",     0xfc00707f, 0x08004057, FMT_VV,      RVExec::VSUB_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vrsub.vx",    0xfc00707f, 0x0c004057, FMT_VV,      RVExec::VRSUB_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vrsub.vi",    0xfc00707f, 0x0c003057, FMT_VI,      RVExec::VRSUB_VI,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vminu.vv",    0xfc00707f, 0x10000057, FMT_VV,      RVExec::VMINU_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vminu.vx",    0xfc00707f, 0x10004057, FMT_VV,      RVExec::VMINU_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmin.vv",     0xfc00707f, 0x14000057, FMT_VV,      RVExec::VMIN_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmin.vx",     0xfc00707f, 0x14004057, FMT_VV,      RVExec::VMIN_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmaxu.vv",    0xfc00707f, 0x18000057, FMT_VV,      RVExec::VMAXU_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmaxu.vx",    0xfc00707f, 0x18004057, FMT_VV,      RVExec::VMAXU_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmax.vv",     0xfc00707f, 0x1c000057, FMT_VV,      RVExec::VMAX_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmax.vx",     0xfc00707f, 0x1c004057, FMT_VV,      RVExec::VMAX_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vand.vv",     0xfc00707f, 0x24000057, FMT_VV,      RVExec::VAND_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vand.vx",     0xfc00707f, 0x24004057, FMT_VV,      RVExec::VAND_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vand.vi",     0xfc00707f, 0x24003057, FMT_VI,      RVExec::VAND_VI,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vor.vv",      0xfc00707f, 0x28000057, FMT_VV,      RVExec::VOR_VV,      HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vor.vx",      0xfc00707f, 0x28004057, FMT_VV,      RVExec::VOR_VX,      HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vor.vi",      0xfc00707f, 0x28003057, FMT_VI,      RVExec::VOR_VI,      HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vxor.vv",     0xfc00707f, 0x2c000057, FMT_VV,      RVExec::VXOR_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vxor.vx",     0xfc00707f, 0x2c004057, FMT_VV,      RVExec::VXOR_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vxor.vi",     0xfc00707f, 0x2c003057, FMT_VI,      RVExec::VXOR_VI,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsll.vv",     0xfc00707f, 0x94000057, FMT_VV,      RVExec::VSLL_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vsll.vx",     0xfc00707f, 0x94004057, FMT_VV,      RVExec::VSLL_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsll.vi",     0xfc00707f, 0x94003057, FMT_VIU,     RVExec::VSLL_VI,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsrl.vv",     0xfc00707f, 0xa0000057, FMT_VV,      RVExec::VSRL_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vsrl.vx",     0xfc00707f, 0xa0004057, FMT_VV,      RVExec::VSRL_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsrl.vi",     0xfc00707f, 0xa0003057, FMT_VIU,     RVExec::VSRL_VI,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsra.vv",     0xfc00707f, 0xa4000057, FMT_VV,      RVExec::VSRA_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vsra.vx",     0xfc00707f, 0xa4004057, FMT_VV,      RVExec::VSRA_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vsra.vi",     0xfc00707f, 0xa4003057, FMT_VIU,     RVExec::VSRA_VI,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmulhu.vv",   0xfc00707f, 0x90002057, FMT_VV,      RVExec::VMULHU_VV,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmulhu.vx",   0xfc00707f, 0x90006057, FMT_VV,      RVExec::VMULHU_VX,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmul.vv",     0xfc00707f, 0x94002057, FMT_VV,      RVExec::VMUL_VV,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmul.vx",     0xfc00707f, 0x94006057, FMT_VV,      RVExec::VMUL_VX,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmulhsu.vv",  0xfc00707f, 0x98002057, FMT_VV,      RVExec::VMULHSU_VV,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmulhsu.vx",  0xfc00707f, 0x98006057, FMT_VV,      RVExec::VMULHSU_VX,  HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmulh.vv",    0xfc00707f, 0x9c002057, FMT_VV,      RVExec::VMULH_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmulh.vx",    0xfc00707f, 0x9c006057, FMT_VV,      RVExec::VMULH_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmseq.vv",    0xfc00707f, 0x60000057, FMT_VV,      RVExec::VMSEQ_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmseq.vx",    0xfc00707f, 0x60004057, FMT_VV,      RVExec::VMSEQ_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmseq.vi",    0xfc00707f, 0x60003057, FMT_VI,      RVExec::VMSEQ_VI,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsne.vv",    0xfc00707f, 0x64000057, FMT_VV,      RVExec::VMSNE_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmsne.vx",    0xfc00707f, 0x64004057, FMT_VV,      RVExec::VMSNE_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsne.vi",    0xfc00707f, 0x64003057, FMT_VI,      RVExec::VMSNE_VI,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsltu.vv",   0xfc00707f, 0x68000057, FMT_VV,      RVExec::VMSLTU_VV,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmsltu.vx",   0xfc00707f, 0x68004057, FMT_VV,      RVExec::VMSLTU_VX,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmslt.vv",    0xfc00707f, 0x6c000057, FMT_VV,      RVExec::VMSLT_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmslt.vx",    0xfc00707f, 0x6c004057, FMT_VV,      RVExec::VMSLT_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsleu.vv",   0xfc00707f, 0x70000057, FMT_VV,      RVExec::VMSLEU_VV,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmsleu.vx",   0xfc00707f, 0x70004057, FMT_VV,      RVExec::VMSLEU_VX,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsleu.vi",   0xfc00707f, 0x70003057, FMT_VI,      RVExec::VMSLEU_VI,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsle.vv",    0xfc00707f, 0x74000057, FMT_VV,      RVExec::VMSLE_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmsle.vx",    0xfc00707f, 0x74004057, FMT_VV,      RVExec::VMSLE_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsle.vi",    0xfc00707f, 0x74003057, FMT_VI,      RVExec::VMSLE_VI,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsgtu.vx",   0xfc00707f, 0x78004057, FMT_VV,      RVExec::VMSGTU_VX,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsgtu.vi",   0xfc00707f, 0x78003057, FMT_VI,      RVExec::VMSGTU_VI,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsgt.vx",    0xfc00707f, 0x7c004057, FMT_VV,      RVExec::VMSGT_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmsgt.vi",    0xfc00707f, 0x7c003057, FMT_VI,      RVExec::VMSGT_VI,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmerge.vvm",  0xfe00707f, 0x5c000057, FMT_VV,      RVExec::VMERGE_VVM,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmerge.vxm",  0xfe00707f, 0x5c004057, FMT_VV,      RVExec::VMERGE_VXM,  HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmerge.vim",  0xfe00707f, 0x5c003057, FMT_VI,      RVExec::VMERGE_VIM,  HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmv.v.v",     0xfff0707f, 0x5e000057, FMT_R1,      RVExec::VMV_V_V,     HPM_EV_NONE,     F_VRD|F_VRS1,      0,  EXT_V},
+    {"vmv.v.x",     0xfff0707f, 0x5e004057, FMT_R1,      RVExec::VMV_V_X,     HPM_EV_NONE,     F_VRD,             0,  EXT_V},
+    {"vmv.v.i",     0xfff0707f, 0x5e003057, FMT_VI1,     RVExec::VMV_V_I,     HPM_EV_NONE,     F_VRD,             0,  EXT_V},
+    {"vmv1r.v",     0xfe0ff07f, 0x9e003057, FMT_VR2,     RVExec::VMV1R_V,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmv2r.v",     0xfe0ff07f, 0x9e00b057, FMT_VR2,     RVExec::VMV2R_V,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmv4r.v",     0xfe0ff07f, 0x9e01b057, FMT_VR2,     RVExec::VMV4R_V,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmv8r.v",     0xfe0ff07f, 0x9e03b057, FMT_VR2,     RVExec::VMV8R_V,     HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vredsum.vs",  0xfc00707f, 0x00002057, FMT_VV,      RVExec::VREDSUM_VS,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredand.vs",  0xfc00707f, 0x04002057, FMT_VV,      RVExec::VREDAND_VS,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredor.vs",   0xfc00707f, 0x08002057, FMT_VV,      RVExec::VREDOR_VS,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredxor.vs",  0xfc00707f, 0x0c002057, FMT_VV,      RVExec::VREDXOR_VS,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredminu.vs", 0xfc00707f, 0x10002057, FMT_VV,      RVExec::VREDMINU_VS, HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredmin.vs",  0xfc00707f, 0x14002057, FMT_VV,      RVExec::VREDMIN_VS,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredmaxu.vs", 0xfc00707f, 0x18002057, FMT_VV,      RVExec::VREDMAXU_VS, HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vredmax.vs",  0xfc00707f, 0x1c002057, FMT_VV,      RVExec::VREDMAX_VS,  HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmadd.vv",    0xfc00707f, 0xa4002057, FMT_R,       RVExec::VMADD_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmadd.vx",    0xfc00707f, 0xa4006057, FMT_R,       RVExec::VMADD_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vnmsub.vv",   0xfc00707f, 0xac002057, FMT_R,       RVExec::VNMSUB_VV,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vnmsub.vx",   0xfc00707f, 0xac006057, FMT_R,       RVExec::VNMSUB_VX,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmacc.vv",    0xfc00707f, 0xb4002057, FMT_R,       RVExec::VMACC_VV,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmacc.vx",    0xfc00707f, 0xb4006057, FMT_R,       RVExec::VMACC_VX,    HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vnmsac.vv",   0xfc00707f, 0xbc002057, FMT_R,       RVExec::VNMSAC_VV,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vnmsac.vx",   0xfc00707f, 0xbc006057, FMT_R,       RVExec::VNMSAC_VX,   HPM_EV_NONE,     F_VRD|F_VRS2,      0,  EXT_V},
+    {"vmandn.mm",   0xfe00707f, 0x62002057, FMT_VV,      RVExec::VMANDN_MM,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmand.mm",    0xfe00707f, 0x66002057, FMT_VV,      RVExec::VMAND_MM,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmor.mm",     0xfe00707f, 0x6a002057, FMT_VV,      RVExec::VMOR_MM,     HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmxor.mm",    0xfe00707f, 0x6e002057, FMT_VV,      RVExec::VMXOR_MM,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmorn.mm",    0xfe00707f, 0x72002057, FMT_VV,      RVExec::VMORN_MM,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmnand.mm",   0xfe00707f, 0x76002057, FMT_VV,      RVExec::VMNAND_MM,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmnor.mm",    0xfe00707f, 0x7a002057, FMT_VV,      RVExec::VMNOR_MM,    HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmxnor.mm",   0xfe00707f, 0x7e002057, FMT_VV,      RVExec::VMXNOR_MM,   HPM_EV_NONE,     F_VRD|F_VRS1|F_VRS2, 0,  EXT_V},
+    {"vmv.x.s",     0xfe0ff07f, 0x42002057, FMT_VR2,     RVExec::VMV_X_S,     HPM_EV_NONE,     F_WRD|F_VRS2,      0,  EXT_V},
+    {"vmv.s.x",     0xfff0707f, 0x42006057, FMT_R1,      RVExec::VMV_S_X,     HPM_EV_NONE,     F_VRD,             0,  EXT_V},
+    {"vcpop.m",     0xfc0ff07f, 0x40082057, FMT_VR2,     RVExec::VCPOP_M,     HPM_EV_NONE,     F_WRD|F_VRS2,      0,  EXT_V},
+    {"vfirst.m",    0xfc0ff07f, 0x4008a057, FMT_VR2,     RVExec::VFIRST_M,    HPM_EV_NONE,     F_WRD|F_VRS2,      0,  EXT_V},
+    {"vid.v",       0xfdfff07f, 0x5008a057, FMT_VD,      RVExec::VID_V,       HPM_EV_NONE,     F_VRD,             0,  EXT_V},
+    {"vsetvli",     0x8000707f, 0x00007057, FMT_VSETVLI, RVExec::VSETVLI,     HPM_EV_NONE,     F_WRD,             0,  EXT_V},
+    {"vsetivli",    0xc000707f, 0xc0007057, FMT_VSETIVLI, RVExec::VSETIVLI,    HPM_EV_NONE,     F_WRD,             0,  EXT_V},
+    {"vsetvl",      0xfe00707f, 0x80007057, FMT_R,       RVExec::VSETVL,      HPM_EV_NONE,     F_WRD,             0,  EXT_V},
+    {"vle8.v",      0xfdf0707f, 0x00000007, FMT_VL,      RVExec::VLE8_V,      HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vle16.v",     0xfdf0707f, 0x00005007, FMT_VL,      RVExec::VLE16_V,     HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vle32.v",     0xfdf0707f, 0x00006007, FMT_VL,      RVExec::VLE32_V,     HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vle64.v",     0xfdf0707f, 0x00007007, FMT_VL,      RVExec::VLE64_V,     HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vse8.v",      0xfdf0707f, 0x00000027, FMT_VL,      RVExec::VSE8_V,      HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vse16.v",     0xfdf0707f, 0x00005027, FMT_VL,      RVExec::VSE16_V,     HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vse32.v",     0xfdf0707f, 0x00006027, FMT_VL,      RVExec::VSE32_V,     HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vse64.v",     0xfdf0707f, 0x00007027, FMT_VL,      RVExec::VSE64_V,     HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vlse8.v",     0xfc00707f, 0x08000007, FMT_VLS,     RVExec::VLSE8_V,     HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vlse16.v",    0xfc00707f, 0x08005007, FMT_VLS,     RVExec::VLSE16_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vlse32.v",    0xfc00707f, 0x08006007, FMT_VLS,     RVExec::VLSE32_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vlse64.v",    0xfc00707f, 0x08007007, FMT_VLS,     RVExec::VLSE64_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vsse8.v",     0xfc00707f, 0x08000027, FMT_VLS,     RVExec::VSSE8_V,     HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vsse16.v",    0xfc00707f, 0x08005027, FMT_VLS,     RVExec::VSSE16_V,    HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vsse32.v",    0xfc00707f, 0x08006027, FMT_VLS,     RVExec::VSSE32_V,    HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vsse64.v",    0xfc00707f, 0x08007027, FMT_VLS,     RVExec::VSSE64_V,    HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vlm.v",       0xfff0707f, 0x02b00007, FMT_VL,      RVExec::VLM_V,       HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vsm.v",       0xfff0707f, 0x02b00027, FMT_VL,      RVExec::VSM_V,       HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vl1re8.v",    0xfff0707f, 0x02800007, FMT_VL,      RVExec::VL1RE8_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl1re16.v",   0xfff0707f, 0x02805007, FMT_VL,      RVExec::VL1RE16_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl1re32.v",   0xfff0707f, 0x02806007, FMT_VL,      RVExec::VL1RE32_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl1re64.v",   0xfff0707f, 0x02807007, FMT_VL,      RVExec::VL1RE64_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl2re8.v",    0xfff0707f, 0x22800007, FMT_VL,      RVExec::VL2RE8_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl2re16.v",   0xfff0707f, 0x22805007, FMT_VL,      RVExec::VL2RE16_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl2re32.v",   0xfff0707f, 0x22806007, FMT_VL,      RVExec::VL2RE32_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl2re64.v",   0xfff0707f, 0x22807007, FMT_VL,      RVExec::VL2RE64_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl4re8.v",    0xfff0707f, 0x62800007, FMT_VL,      RVExec::VL4RE8_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl4re16.v",   0xfff0707f, 0x62805007, FMT_VL,      RVExec::VL4RE16_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl4re32.v",   0xfff0707f, 0x62806007, FMT_VL,      RVExec::VL4RE32_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl4re64.v",   0xfff0707f, 0x62807007, FMT_VL,      RVExec::VL4RE64_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl8re8.v",    0xfff0707f, 0xe2800007, FMT_VL,      RVExec::VL8RE8_V,    HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl8re16.v",   0xfff0707f, 0xe2805007, FMT_VL,      RVExec::VL8RE16_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl8re32.v",   0xfff0707f, 0xe2806007, FMT_VL,      RVExec::VL8RE32_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vl8re64.v",   0xfff0707f, 0xe2807007, FMT_VL,      RVExec::VL8RE64_V,   HPM_EV_LOAD,     F_VRD,             0,  EXT_V},
+    {"vs1r.v",      0xfff0707f, 0x02800027, FMT_VL,      RVExec::VS1R_V,      HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vs2r.v",      0xfff0707f, 0x22800027, FMT_VL,      RVExec::VS2R_V,      HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vs4r.v",      0xfff0707f, 0x62800027, FMT_VL,      RVExec::VS4R_V,      HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+    {"vs8r.v",      0xfff0707f, 0xe2800027, FMT_VL,      RVExec::VS8R_V,      HPM_EV_STORE,    F_VRD,             0,  EXT_V},
+
+    {"fence",       0x0000707f, 0x0000000f, FMT_FENCE,  RVExec::FENCE,      HPM_EV_NONE,        0,              0,  EXT_I},
+    {"fence.i",     0x0000707f, 0x0000100f, FMT_NONE,   RVExec::FENCE_I,    HPM_EV_NONE,        F_TERM,         0,  EXT_I},
+    {"ecall",       0xffffffff, 0x00000073, FMT_NONE,   RVExec::ECALL,      HPM_EV_NONE,        F_TERM,         0,  EXT_I},
+    {"ebreak",      0xffffffff, 0x00100073, FMT_NONE,   RVExec::EBREAK,     HPM_EV_NONE,        F_TERM,         0,  EXT_I},
+    {"mret",        0xffffffff, 0x30200073, FMT_NONE,   RVExec::MRET,       HPM_EV_NONE,        F_TERM,         0,  EXT_I},
+    {"sret",        0xffffffff, 0x10200073, FMT_NONE,   RVExec::SRET,       HPM_EV_NONE,        F_TERM,         0,  EXT_I},
+    {"wfi",         0xffffffff, 0x10500073, FMT_NONE,   RVExec::WFI,        HPM_EV_NONE,        0,              0,  EXT_I},
+    {"sfence.vma",  0xfe007fff, 0x12000073, FMT_RR,     RVExec::SFENCE_VMA, HPM_EV_NONE,        F_TERM,         0,  EXT_I},
+
+    {"csrrw",       0x0000707f, 0x00001073, FMT_CSR,    RVExec::CSRRW,      HPM_EV_NONE,        F_WRD|F_TERM,   0,  EXT_I},
+    {"csrrs",       0x0000707f, 0x00002073, FMT_CSR,    RVExec::CSRRS,      HPM_EV_NONE,        F_WRD|F_TERM,   0,  EXT_I},
+    {"csrrc",       0x0000707f, 0x00003073, FMT_CSR,    RVExec::CSRRC,      HPM_EV_NONE,        F_WRD|F_TERM,   0,  EXT_I},
+    {"csrrwi",      0x0000707f, 0x00005073, FMT_CSRI,   RVExec::CSRRWI,     HPM_EV_NONE,        F_WRD|F_TERM,   0,  EXT_I},
+    {"csrrsi",      0x0000707f, 0x00006073, FMT_CSRI,   RVExec::CSRRSI,     HPM_EV_NONE,        F_WRD|F_TERM,   0,  EXT_I},
+    {"csrrci",      0x0000707f, 0x00007073, FMT_CSRI,   RVExec::CSRRCI,     HPM_EV_NONE,        F_WRD|F_TERM,   0,  EXT_I},
+};
+
+
+/**
+ * @brief Instruction table entries grouped by major opcode
+ */
+struct OpcodeIndex
+{
+    std::vector<const InstrDesc *> entries[128];
+
+    OpcodeIndex()
+    {
+        for(unsigned int i=0; i<sizeof(instr_table)/sizeof(instr_table[0]); i++)
+        {
+            const InstrDesc * d = &instr_table[i];
+            if(d->xlen != 0 && d->xlen != XLEN)
+                continue;
+            entries[d->match & 0x7f].push_back(d);
+        }
+    }
+};
+
+
+/**
+ * @brief Find description of an instruction
+ * 
+ * @param raw raw instruction
+ * @return const InstrDesc* description, NULL if instruction is unknown
+ */
+const InstrDesc * findInstr(uint32_t raw)
+{
+    static const OpcodeIndex index;
+
+    const std::vector<const InstrDesc *> &bucket = index.entries[raw & 0x7f];
+    for(unsigned int i=0; i<bucket.size(); i++)
+    {
+        if((raw & bucket[i]->mask) == bucket[i]->match)
+            return bucket[i];
+    }
+    return NULL;
+}
+
+
+// ==================================== RVCPU =====================================
+/**
+ * @brief Construct a new RVCPU object
+ * 
+ * @param pc_init_address program counter reset address
+ * @param ISA_def RISC-V ISA definition
+ * @param system_bus bus object pointer
+ * @param hart_id hart id
+ */
+RVCPU::RVCPU(REG pc_init_address, ISAdef ISA_def, Bus<REG> *system_bus, unsigned int hart_id):
+    itlbPages(64, 4, XLEN == 32 ? 10 : 9),
+    dtlbPages(64, 4, XLEN == 32 ? 10 : 9),
+    dcache(32*1024, 4, 64)
+{
+    PC_RESET_ADDR = pc_init_address;
+    CPU_ISA = ISA_def;
+    nRegs = ISA_def.ISA_EMBEDDED ? 16 : 32;
+    bus = system_bus;
+    hartId = hart_id;
+    history = NULL;
+    markerStop = false;
+    dcacheModelForced = false;
+    hostRM = RM_RNE;
+    fpActive = false;
+    fetchAlignMask = ISA_def.ISA_C ? 0x1 : 0x3;
+
+    vlenb = 0;
+    if(ISA_def.ISA_V)
+    {
+        if(ISA_def.VLEN != 128 && ISA_def.VLEN != 256 && ISA_def.VLEN != 512)
+            SimError::throwError("Unsupported VLEN " + std::to_string(ISA_def.VLEN) + " (128, 256 or 512)", true);
+        vlenb = ISA_def.VLEN / 8;
+    }
+    reset();
+}
+
+
+/**
+ * @brief Get the value of the specified register
+ * 
+ * @param reg_no register number
+ */
+REG RVCPU::getRegValue(unsigned int reg_no)
+{
+    return state.X[reg_no];
+}
+
+
+/**
+ * @brief Get value of program counter
+ */
+REG RVCPU::getPCValue()
+{
+    return state.PC;
+}
+
+
+/**
+ * @brief Set the value of the specified register
+ * 
+ * @param reg_no register number
+ * @param value value
+ */
+void RVCPU::setRegValue(unsigned int reg_no, REG value)
+{
+    if(reg_no != 0)
+        state.X[reg_no] = value;
+}
+
+
+/**
+ * @brief Set value of program counter
+ * 
+ * @param value address
+ */
+void RVCPU::setPCValue(REG value)
+{
+    state.PC = value;
+}
+
+
+/**
+ * @brief Get/Set raw value of a floating point register
+ * 
+ * @param reg_no register number
+ */
+uint64_t RVCPU::getFRegValue(unsigned int reg_no)
+{
+    return state.F[reg_no];
+}
+
+void RVCPU::setFRegValue(unsigned int reg_no, uint64_t value)
+{
+    state.F[reg_no] = value;
+}
+
+
+/**
+ * @brief Check if CPU has halted (ecall/ebreak)
+ */
+bool RVCPU::isHalted()
+{
+    return halted;
+}
+
+
+/**
+ * @brief Get reason the last call to run returned
+ */
+StopReason RVCPU::getStopReason()
+{
+    return stopReason;
+}
+
+
+/**
+ * @brief Add a breakpoint
+ * The handler of the instruction is swapped in every decoded block holding
+ * it, the decode cache is kept.
+ * 
+ * @param addr address
+ */
+void RVCPU::setBreakpoint(REG addr)
+{
+    if(!breakpoints.insert(addr).second)
+        return;
+
+    for(auto it = blocks.begin(); it != blocks.end(); ++it)
+    {
+        DecodedInstr * instr = findDecoded(it->second, addr);
+        if(instr)
+            instr->exec = RVExec::BREAKPOINT;
+    }
+}
+
+
+/**
+ * @brief Remove a breakpoint
+ * Decoded blocks holding the instruction are discarded & built again on
+ * their next execution, which restores the original handler (including
+ * pseudo-instructions raising fetch faults, which have no encoding to
+ * decode again).
+ * 
+ * @param addr address
+ */
+void RVCPU::clearBreakpoint(REG addr)
+{
+    if(!breakpoints.erase(addr))
+        return;
+
+    bool removed = false;
+    auto it = blocks.begin();
+    while(it != blocks.end())
+    {
+        if(findDecoded(it->second, addr))
+        {
+            foldBlockEvents(it->second);
+            it = blocks.erase(it);
+            removed = true;
+        }
+        else
+            it++;
+    }
+    if(removed)
+        memset(jumpCache, 0, sizeof(jumpCache));
+}
+
+
+/**
+ * @brief Check for a breakpoint at an address
+ */
+bool RVCPU::hasBreakpoint(REG addr)
+{
+    return breakpoints.count(addr) != 0;
+}
+
+
+/**
+ * @brief Get breakpoint addresses
+ */
+const std::unordered_set<REG> & RVCPU::getBreakpoints()
+{
+    return breakpoints;
+}
+
+
+/**
+ * @brief Add a data watchpoint
+ * Watched pages are dropped from the data TLB so that only accesses to them
+ * are checked against the watched ranges.
+ * 
+ * @param addr start address
+ * @param len length in bytes
+ * @param type accesses to watch (WatchType)
+ */
+void RVCPU::setWatchpoint(REG addr, REG len, int type)
+{
+    if(len == 0)
+        len = 1;
+    Watchpoint w = {addr, len, type};
+    watchpoints.push_back(w);
+
+    REG last = (addr + len - 1) >> PAGE_SHIFT;
+    for(REG page = addr >> PAGE_SHIFT; page <= last; page++)
+        watchPages[page << PAGE_SHIFT] |= type;
+    flushDTLB();
+}
+
+
+/**
+ * @brief Remove a data watchpoint
+ * 
+ * @return false if no such watchpoint exists
+ */
+bool RVCPU::clearWatchpoint(REG addr, REG len, int type)
+{
+    if(len == 0)
+        len = 1;
+    bool found = false;
+    for(unsigned int i=0; i<watchpoints.size(); i++)
+    {
+        if(watchpoints[i].addr == addr && watchpoints[i].len == len && watchpoints[i].type == type)
+        {
+            watchpoints.erase(watchpoints.begin() + i);
+            found = true;
+            break;
+        }
+    }
+
+    // Recompute watched pages
+    watchPages.clear();
+    for(unsigned int i=0; i<watchpoints.size(); i++)
+    {
+        REG last = (watchpoints[i].addr + watchpoints[i].len - 1) >> PAGE_SHIFT;
+        for(REG page = watchpoints[i].addr >> PAGE_SHIFT; page <= last; page++)
+            watchPages[page << PAGE_SHIFT] |= watchpoints[i].type;
+    }
+    flushDTLB();
+    return found;
+}
+
+
+/**
+ * @brief Get watchpoints
+ */
+const std::vector<Watchpoint> & RVCPU::getWatchpoints()
+{
+    return watchpoints;
+}
+
+
+/**
+ * @brief Get the watchpoint that stopped the CPU
+ */
+const Watchpoint & RVCPU::getWatchHit()
+{
+    return watchHit;
+}
+
+/**
+ * @brief Get number of instructions retired since reset
+ */
+uint64_t RVCPU::getInstret()
+{
+    return instret;
+}
+
+
+/**
+ * @brief Get simulation statistics
+ */
+const CPUStats & RVCPU::getStats()
+{
+    return stats;
+}
+
+
+/**
+ * @brief Get hart id
+ */
+unsigned int RVCPU::getHartId()
+{
+    return hartId;
+}
+
+/**
+ * @brief Reset CPU
+ */
+void RVCPU::reset()
+{
+    // Reset PC
+    state.PC = PC_RESET_ADDR;
+
+    // Clear registers
+    for(unsigned int i=0; i<32 + 1; i++)
+    {
+        state.X[i] = 0;
+    }
+    memset(state.F, 0, sizeof(state.F));
+    state.fflags = 0;
+    state.frm = RM_RNE;
+    memset(state.V, 0, sizeof(state.V));
+    state.vl = 0;
+    state.vstart = 0;
+    state.vxrm = 0;
+    state.vxsat = 0;
+    state.vtype = (REG)1 << (XLEN - 1);
+    vsew = 0;
+    vlmul = 0;
+    vlmax = 0;
+    halted = false;
+    stopReason = STOP_NONE;
+    stopsSuppressed = false;
+    simMarker = 0;
+    resValid = false;
+
+    // M-mode with translation off, mtvec 0 until the program installs a
+    // trap handler. UXL & SXL are fixed to 64 bits.
+    memset(state.tcsr, 0, sizeof(state.tcsr));
+    state.tcsr[TCSR_MSTATUS] = MSTATUS_MPP | (REG)(XLEN == 64 ? MSTATUS_XL_64 : 0);
+    state.priv = PRIV_M;
+    itlbPages.reset();
+    dtlbPages.reset();
+    flushDTLB();
+    flushTranslatedTLBs();
+    updateTranslation();
+
+    // Clear decode cache
+    flushDecodeCache();
+    flushPending = false;
+    curBlock = NULL;
+    fatalInstr = NULL;
+
+    // Clear counters
+    instret = 0;
+    memset(evFolded, 0, sizeof(evFolded));
+    memset(counters, 0, sizeof(counters));
+    memset(mhpmevent, 0, sizeof(mhpmevent));
+    mcountinhibit = 0;
+    dcache.reset();
+    updateCacheModel();
+
+    memset(&stats, 0, sizeof(stats));
+}
+
+
+/**
+ * @brief Discard all decoded blocks (call after modifying code in memory)
+ */
+void RVCPU::flushDecodeCache()
+{
+    // Fold block level event counts into totals before discarding blocks
+    for(std::unordered_map<REG, DecodedBlock>::iterator it = blocks.begin(); it != blocks.end(); it++)
+        foldBlockEvents(it->second);
+    blocks.clear();
+    memset(jumpCache, 0, sizeof(jumpCache));
+    stats.cacheFlushes++;
+}
+
+
+/**
+ * @brief Remove decoded blocks of modified pages
+ */
+void RVCPU::invalidateDecodedPages(const std::vector<REG> &pages)
+{
+    std::unordered_set<REG> modified(pages.begin(), pages.end());
+    bool removed = false;
+
+    std::unordered_map<REG, DecodedBlock>::iterator it = blocks.begin();
+    while(it != blocks.end())
+    {
+        // Blocks never cross a page boundary, except for a last instruction
+        // straddling into the next page
+        const REG mask = ~(REG)((1 << PAGE_SHIFT) - 1);
+        const uint64_t tail = it->second.tail_pa;
+        if(modified.count(it->first & mask) || (tail < DecodedBlock::TAIL_FAULT && modified.count((REG)tail)))
+        {
+            foldBlockEvents(it->second);
+            it = blocks.erase(it);
+            removed = true;
+        }
+        else
+            it++;
+    }
+    if(removed)
+        memset(jumpCache, 0, sizeof(jumpCache));
+}
+
+
+/**
+ * @brief Fold block level event counts into totals
+ */
+void RVCPU::foldBlockEvents(const DecodedBlock &blk)
+{
+    for(unsigned int ev=0; ev<HPM_EV_COUNT; ev++)
+        evFolded[ev] += blk.exec_count * blk.static_events[ev];
+    evFolded[HPM_EV_BRANCH_TAKEN] += blk.taken_count;
+}
+
+
+/**
+ * @brief Get or build the decoded block starting at pc
+ */
+DecodedBlock * RVCPU::lookupBlock(REG pc)
+{
+    // Only reachable with C disabled while the PC is 2 byte aligned, or
+    // when the PC is set from outside (entry point, debugger)
+    if(pc & fetchAlignMask)
+    {
+        buildFaultBlock(faultBlock, pc, CAUSE_MISALIGNED_FETCH);
+        return &faultBlock;
+    }
+
+    // Blocks are keyed by physical address, the instruction TLB of the
+    // context translates without a walk
+    uint64_t pa = pc;
+    if(fetchCtx != CTX_BARE)
+    {
+        const ITLBEntry &e = itlbCur[(pc >> PAGE_SHIFT) & (ITLB_SIZE - 1)];
+        const REG offset = pc & ((1 << PAGE_SHIFT) - 1);
+        if(e.tag == pc - offset)
+            pa = e.ppage | offset;
+        else
+        {
+            unsigned int cause;
+            if(!translateFetch(pc, pa, cause))
+            {
+                buildFaultBlock(faultBlock, pc, cause);
+                return &faultBlock;
+            }
+        }
+    }
+
+    DecodedBlock ** slot = &jumpCache[(pc >> 1) & (JUMP_CACHE_SIZE-1)];
+    DecodedBlock * cached = *slot;
+    if(cached && cached->start_pc == pc && cached->start_pa == pa &&
+       (cached->tail_pa == DecodedBlock::NO_TAIL || blockTailValid(*cached)))
+    {
+        stats.blockHits++;
+        return cached;
+    }
+
+    if(!bus->mem->isValidAddress(pa))
+    {
+        buildFaultBlock(faultBlock, pc, CAUSE_FETCH_ACCESS);
+        return &faultBlock;
+    }
+
+    std::unordered_map<REG, DecodedBlock>::iterator it = blocks.find((REG)pa);
+    if(it == blocks.end())
+    {
+        stats.blockMisses++;
+        DecodedBlock &blk = blocks[(REG)pa];
+        buildBlock(blk, pc, pa);
+        *slot = &blk;
+    }
+    else if(it->second.start_pc != pc ||
+            (it->second.tail_pa != DecodedBlock::NO_TAIL && !blockTailValid(it->second)))
+    {
+        // Same code mapped at another address, or the page the last
+        // instruction straddles into was remapped
+        stats.blockMisses++;
+        foldBlockEvents(it->second);
+        buildBlock(it->second, pc, pa);
+        *slot = &it->second;
+    }
+    else
+    {
+        stats.blockHits++;
+        *slot = &it->second;
+    }
+    return *slot;
+}
+
+
+/**
+ * @brief Check that the page a block's last instruction straddles into
+ * still maps to the same physical page
+ */
+bool RVCPU::blockTailValid(const DecodedBlock &blk)
+{
+    const REG next = (blk.start_pc | (REG)((1 << PAGE_SHIFT) - 1)) + 1;
+    uint64_t pa = next;
+    unsigned int cause;
+    if(fetchCtx != CTX_BARE && !translateFetch(next, pa, cause))
+        return blk.tail_pa == DecodedBlock::TAIL_FAULT;
+    return blk.tail_pa == pa;
+}
+
+
+/**
+ * @brief Get the physical address of an instruction that can be fetched
+ * 
+ * @return false if the fetch faults (cause set)
+ */
+bool RVCPU::fetchAddress(REG pc, uint64_t &pa, unsigned int &cause)
+{
+    pa = pc;
+    cause = CAUSE_MISALIGNED_FETCH;
+    if(pc & fetchAlignMask)
+        return false;
+    if(fetchCtx != CTX_BARE && !translateFetch(pc, pa, cause))
+        return false;
+    cause = CAUSE_FETCH_ACCESS;
+    return bus->mem->isValidAddress(pa);
+}
+
+
+/**
+ * @brief Decode a fetch fault in place of an instruction that can not be fetched
+ */
+static void decodeFetchFault(DecodedInstr &instr, REG pc, REG addr, unsigned int cause)
+{
+    memset(&instr, 0, sizeof(instr));
+    switch(cause)
+    {
+        case CAUSE_FETCH_PAGE_FAULT:    instr.exec = RVExec::FETCH_PAGE_FAULT; break;
+        case CAUSE_MISALIGNED_FETCH:    instr.exec = RVExec::FETCH_MISALIGNED; break;
+        default:                        instr.exec = RVExec::FETCH_ACCESS_FAULT; break;
+    }
+    instr.pc = pc;
+    instr.imm = (REGS)addr;
+    instr.evclass = HPM_EV_NONE;
+}
+
+
+/**
+ * @brief Make blk a single instruction raising a fetch fault at pc
+ */
+void RVCPU::buildFaultBlock(DecodedBlock &blk, REG pc, unsigned int cause, bool tag_breakpoints)
+{
+    blk.start_pc = pc;
+    blk.end_pc = pc + 2;
+    blk.start_pa = DecodedBlock::NO_TAIL;
+    blk.tail_pa = DecodedBlock::NO_TAIL;
+    blk.exec_count = 0;
+    blk.taken_count = 0;
+    memset(blk.static_events, 0, sizeof(blk.static_events));
+    blk.instrs.resize(1);
+
+    DecodedInstr &instr = blk.instrs[0];
+    decodeFetchFault(instr, pc, pc, cause);
+    instr.len = 2;
+    if(tag_breakpoints && !breakpoints.empty() && breakpoints.count(pc))
+        instr.exec = RVExec::BREAKPOINT;
+    blk.static_events[instr.evclass]++;
+}
+
+
+/**
+ * @brief Decode instructions starting at pc into blk
+ * 
+ * @param blk block
+ * @param pc start address
+ * @param pa physical start address
+ * @param max_instrs maximum number of instructions
+ * @param tag_breakpoints replace instructions at breakpoints with a stop
+ */
+void RVCPU::buildBlock(DecodedBlock &blk, REG pc, uint64_t pa, unsigned int max_instrs, bool tag_breakpoints)
+{
+    blk.start_pc = pc;
+    blk.start_pa = pa;
+    blk.tail_pa = DecodedBlock::NO_TAIL;
+    blk.exec_count = 0;
+    blk.taken_count = 0;
+    memset(blk.static_events, 0, sizeof(blk.static_events));
+    blk.instrs.clear();
+
+    // Blocks end at a page boundary, only their last instruction can
+    // straddle into the next page. Code is read at physical addresses.
+    REG page = pc >> 12;
+    while(true)
+    {
+        // Fetched in 16-bit parcels, compressed instructions are expanded
+        // to their 32-bit equivalents
+        DecodedInstr instr;
+        const uint64_t ipa = pa + (pc - blk.start_pc);
+        REG fault_addr = pc;
+        unsigned int fault_cause = CAUSE_FETCH_ACCESS;
+        bool fetched = bus->mem->isValidAddress(ipa);
+        uint32_t raw = 0;
+        uint16_t parcel = 0;
+        unsigned int len = 2;
+        if(fetched)
+        {
+            raw = parcel = (uint16_t)bus->request((REG)ipa, 0, 0b11, false);
+            if(!RVCompressed::isCompressed(raw))
+            {
+                uint64_t hpa = ipa + 2;
+                fault_addr = pc + 2;
+                fetched = true;
+                if(((pc + 2) >> 12) != page)
+                {
+                    // The upper half is in the next page, which has its own
+                    // translation
+                    hpa = pc + 2;
+                    if(fetchCtx != CTX_BARE)
+                        fetched = translateFetch(pc + 2, hpa, fault_cause);
+                    blk.tail_pa = fetched ? hpa : DecodedBlock::TAIL_FAULT;
+                }
+                fetched = fetched && bus->mem->isValidAddress(hpa);
+                if(fetched)
+                {
+                    raw |= (uint32_t)bus->request((REG)hpa, 0, 0b11, false) << 16;
+                    len = 4;
+                }
+            }
+            else if(CPU_ISA.ISA_C)
+            {
+                // Reserved encodings keep the 16-bit value & decode as illegal
+                uint32_t full = RVCompressed::expand(raw);
+                if(full)
+                    raw = full;
+            }
+        }
+
+        bool terminates = true;
+        if(fetched)
+            terminates = decode(pc, raw, instr);
+        else
+        {
+            // Raised only if execution reaches the instruction
+            decodeFetchFault(instr, pc, fault_addr, fault_cause);
+        }
+        instr.len = len;
+        instr.parcel = parcel;
+
+        if(tag_breakpoints && !breakpoints.empty() && breakpoints.count(pc))
+            instr.exec = RVExec::BREAKPOINT;
+
+        blk.instrs.push_back(instr);
+        blk.static_events[instr.evclass]++;
+        pc += len;
+
+        if(terminates || blk.instrs.size() >= max_instrs || (pc >> 12) != page)
+            break;
+    }
+    blk.end_pc = pc;
+}
+
+
+/**
+ * @brief Find the decoded instruction at pc in a block
+ * 
+ * @return DecodedInstr* instruction or NULL if pc is outside the block
+ */
+DecodedInstr * RVCPU::findDecoded(DecodedBlock &blk, REG pc)
+{
+    if(pc < blk.start_pc || pc >= blk.end_pc)
+        return NULL;
+
+    for(unsigned int i=0; i<blk.instrs.size(); i++)
+    {
+        if(blk.instrs[i].pc == pc)
+            return &blk.instrs[i];
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Check if the ISA includes an extension (InstrExt)
+ */
+bool RVCPU::hasExtension(uint8_t ext)
+{
+    switch(ext)
+    {
+        case EXT_I: return true;
+        case EXT_M: return CPU_ISA.ISA_M;
+        case EXT_A: return CPU_ISA.ISA_A;
+        case EXT_F: return CPU_ISA.ISA_F;
+        case EXT_D: return CPU_ISA.ISA_F && CPU_ISA.ISA_D;
+        case EXT_ZBA: return CPU_ISA.ISA_ZBA;
+        case EXT_ZBB: return CPU_ISA.ISA_ZBB;
+        case EXT_ZBC: return CPU_ISA.ISA_ZBC;
+        case EXT_ZBS: return CPU_ISA.ISA_ZBS;
+        case EXT_V: return CPU_ISA.ISA_V;
+        case EXT_ZKND: return CPU_ISA.ISA_ZKND;
+        case EXT_ZKNE: return CPU_ISA.ISA_ZKNE;
+        case EXT_ZKND_ZKNE: return CPU_ISA.ISA_ZKND || CPU_ISA.ISA_ZKNE;
+        case EXT_ZKNH: return CPU_ISA.ISA_ZKNH;
+        case EXT_ZKSED: return CPU_ISA.ISA_ZKSED;
+        case EXT_ZKSH: return CPU_ISA.ISA_ZKSH;
+        default:    return false;
+    }
+}
+
+
+/**
+ * @brief Decode an instruction
+ * 
+ * @return true if instruction terminates a block
+ */
+bool RVCPU::decode(REG pc, uint32_t raw, DecodedInstr &instr)
+{
+    instr.pc = pc;
+    instr.raw = raw;
+    instr.rd = (raw >> 7) & 0x1f;
+    instr.rs1 = (raw >> 15) & 0x1f;
+    instr.rs2 = (raw >> 20) & 0x1f;
+    instr.imm = 0;
+    instr.evclass = HPM_EV_NONE;
+    instr.exec = RVExec::ILLEGAL;
+
+    const InstrDesc * d = findInstr(raw);
+    if(!d || !hasExtension(d->ext))
+        return true;
+
+    // Extract immediate & check register operands
+    bool uses_rd = true, uses_rs1 = true, uses_rs2 = false;
+    switch(d->fmt)
+    {
+        case FMT_R:
+        case FMT_R4:
+        case FMT_AMO:
+            uses_rs2 = true;
+            break;
+        case FMT_R1:
+        case FMT_VL:
+            break;
+        case FMT_RR:
+            uses_rd = false;
+            uses_rs2 = true;
+            break;
+        case FMT_I:
+        case FMT_IM:
+            instr.imm = (int32_t)raw >> 20;
+            break;
+        case FMT_S:
+            uses_rd = false;
+            uses_rs2 = true;
+            instr.imm = (int32_t)((((int32_t)raw >> 25) << 5) | ((raw >> 7) & 0x1f));
+            break;
+        case FMT_B:
+            uses_rd = false;
+            uses_rs2 = true;
+            instr.imm = (int32_t)((((int32_t)raw >> 31) << 12) | ((raw << 4) & 0x800) | ((raw >> 20) & 0x7e0) | ((raw >> 7) & 0x1e));
+            break;
+        case FMT_U:
+            uses_rs1 = false;
+            instr.imm = (int32_t)(raw & 0xfffff000);
+            break;
+        case FMT_J:
+            uses_rs1 = false;
+            instr.imm = (int32_t)((((int32_t)raw >> 31) << 20) | (raw & 0xff000) | ((raw >> 9) & 0x800) | ((raw >> 20) & 0x7fe));
+            break;
+        case FMT_SHAMT:
+            instr.imm = (raw >> 20) & 0x3f;
+            break;
+        case FMT_CSR:
+            instr.imm = raw >> 20;
+            break;
+        case FMT_CSRI:
+            uses_rs1 = false;
+            instr.imm = raw >> 20;
+            break;
+        case FMT_FENCE:
+        case FMT_NONE:
+            uses_rd = uses_rs1 = false;
+            break;
+        case FMT_VV:
+        case FMT_VLS:
+            uses_rs2 = true;
+            break;
+        case FMT_VI:
+            uses_rs1 = false;
+            uses_rs2 = true;
+            instr.imm = ((int32_t)raw << 12) >> 27;
+            break;
+        case FMT_VIU:
+            uses_rs1 = false;
+            uses_rs2 = true;
+            instr.imm = (raw >> 15) & 0x1f;
+            break;
+        case FMT_VR2:
+            uses_rs1 = false;
+            uses_rs2 = true;
+            break;
+        case FMT_VI1:
+            uses_rs1 = false;
+            instr.imm = ((int32_t)raw << 12) >> 27;
+            break;
+        case FMT_VD:
+            uses_rs1 = false;
+            break;
+        case FMT_VSETVLI:
+            instr.imm = (raw >> 20) & 0x7ff;
+            break;
+        case FMT_VSETIVLI:
+            uses_rs1 = false;
+            instr.imm = (raw >> 20) & 0x3ff;
+            break;
+        case FMT_RBS:
+            uses_rs2 = true;
+            instr.imm = raw >> 30;
+            break;
+        case FMT_RNUM:
+            instr.imm = (raw >> 20) & 0xf;
+            if(instr.imm > 10)
+                return true;
+            break;
+    }
+
+    // Floating point & vector register operands are not limited by RVE
+    uses_rd = uses_rd && !(d->flags & (F_FRD | F_VRD));
+    uses_rs1 = uses_rs1 && !(d->flags & (F_FRS1 | F_VRS1));
+    uses_rs2 = uses_rs2 && !(d->flags & (F_FRS2 | F_VRS2));
+    if((uses_rd && instr.rd >= nRegs) || (uses_rs1 && instr.rs1 >= nRegs) || (uses_rs2 && instr.rs2 >= nRegs))
+        return true;
+
+    // Floating point instructions with a rounding mode field keep it in imm,
+    // reserved static modes are illegal
+    if((d->ext == EXT_F || d->ext == EXT_D) && !(d->mask & 0x7000))
+    {
+        instr.imm = (raw >> 12) & 0x7;
+        if(instr.imm > RM_RMM && instr.imm != RM_DYN)
+            return true;
+    }
+
+    if((d->flags & F_WRD) && instr.rd == 0)
+        instr.rd = REG_SINK;
+
+    instr.exec = d->exec;
+    instr.evclass = d->evclass;
+    return d->flags & F_TERM;
+}
+
+
+/**
+ * @brief Execute at most limit instructions of a block
+ */
+void RVCPU::execBlock(DecodedBlock * blk, unsigned long int limit)
+{
+    const DecodedInstr * instrs = blk->instrs.data();
+    unsigned long int n = blk->instrs.size();
+    curBlock = blk;
+
+    if(limit >= n)
+    {
+        // Counted once per block, control transfers overwrite the PC
+        blk->exec_count++;
+        instret += n;
+        state.PC = blk->end_pc;
+    }
+    else
+    {
+        // Partial execution, count instructions individually
+        n = limit;
+        instret += n;
+        for(unsigned long int i=0; i<n; i++)
+            evFolded[instrs[i].evclass]++;
+        state.PC = instrs[n].pc;
+    }
+
+    for(unsigned long int i=0; i<n; i++)
+    {
+        instrs[i].exec(*this, instrs[i]);
+    }
+}
+
+
+/**
+ * @brief Stop the current block before an instruction
+ * Accounting for the instructions from there onwards, which were counted at
+ * block entry but never executed, is undone.
+ */
+void RVCPU::abortBlock(const DecodedInstr &at, StopReason reason)
+{
+    DecodedBlock * blk = curBlock;
+    const DecodedInstr * instrs = blk->instrs.data();
+    unsigned long int done = &at - instrs;
+    unsigned long int counted;
+
+    // Only the (unexecuted) last instruction of a block redirects the PC, so
+    // it still holds the value set at block entry
+    if(state.PC == blk->end_pc)
+    {
+        // Whole block was counted, convert to a partial execution
+        blk->exec_count--;
+        counted = blk->instrs.size();
+        for(unsigned long int i=0; i<done; i++)
+            evFolded[instrs[i].evclass]++;
+    }
+    else
+    {
+        counted = done;
+        while(instrs[counted].pc != state.PC)
+            counted++;
+        for(unsigned long int i=done; i<counted; i++)
+            evFolded[instrs[i].evclass]--;
+    }
+
+    instret -= counted - done;
+    state.PC = at.pc;
+    stopReason = reason;
+}
+
+
+/**
+ * @brief Abort the executing block at the instruction whose unhandled
+ * exception is being reported as a fatal error
+ */
+void RVCPU::abortFatal()
+{
+    if(fatalInstr)
+    {
+        abortBlock(*fatalInstr, STOP_NONE);
+        fatalInstr = NULL;
+    }
+}
+
+
+/**
+ * @brief Memory access helpers used by instruction handlers
+ */
+inline REG RVCPU::load(const DecodedInstr &instr, REG addr, unsigned int nbytes)
+{
+    if(dcacheModelEnabled)
+        dcache.access(addr);
+
+    // Tag only matches for naturally aligned accesses to unwatched pages
+    const TLBEntry &e = dtlbCur[(addr >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+    if(e.readTag != (addr & (~(REG)((1 << PAGE_SHIFT) - 1) | (nbytes - 1))))
+        return loadSlow(instr, addr, nbytes);
+
+    const uint8_t * p = e.host + (addr & ((1 << PAGE_SHIFT) - 1));
+    switch(nbytes)
+    {
+        case 1: return *p;
+        case 2: { uint16_t v; memcpy(&v, p, 2); return v; }
+        case 4: { uint32_t v; memcpy(&v, p, 4); return v; }
+        default: { uint64_t v; memcpy(&v, p, 8); return (REG)v; }
+    }
+}
+
+inline void RVCPU::store(const DecodedInstr &instr, REG addr, REG data, unsigned int nbytes)
+{
+    if(dcacheModelEnabled)
+        dcache.access(addr);
+
+    const TLBEntry &e = dtlbCur[(addr >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+    if(e.writeTag != (addr & (~(REG)((1 << PAGE_SHIFT) - 1) | (nbytes - 1))))
+    {
+        storeSlow(instr, addr, data, nbytes);
+        return;
+    }
+
+    uint8_t * p = e.host + (addr & ((1 << PAGE_SHIFT) - 1));
+    switch(nbytes)
+    {
+        case 1: *p = (uint8_t)data; break;
+        case 2: { uint16_t v = (uint16_t)data; memcpy(p, &v, 2); break; }
+        case 4: { uint32_t v = (uint32_t)data; memcpy(p, &v, 4); break; }
+        default: { uint64_t v = (uint64_t)data; memcpy(p, &v, 8); break; }
+    }
+}
+
+REG RVCPU::loadSlow(const DecodedInstr &instr, REG addr, unsigned int nbytes)
+{
+    if(!watchPages.empty())
+        checkWatchpoints(instr, addr, nbytes, WATCH_READ);
+
+    // Misaligned accesses crossing into another page are split into bytes,
+    // each translated on its own
+    if(dataCtx != CTX_BARE && (addr & ((1 << PAGE_SHIFT) - 1)) + nbytes > (1 << PAGE_SHIFT))
+    {
+        REG value = 0;
+        for(unsigned int i=0; i<nbytes; i++)
+            value |= loadSlow(instr, addr + i, 1) << (8 * i);
+        return value;
+    }
+
+    REG pa = translateData(instr, addr, nbytes, WATCH_READ);
+    return bus->request(pa, 0, (1 << nbytes) - 1, false);
+}
+
+void RVCPU::storeSlow(const DecodedInstr &instr, REG addr, REG data, unsigned int nbytes)
+{
+    if(!watchPages.empty())
+        checkWatchpoints(instr, addr, nbytes, WATCH_WRITE);
+
+    if(dataCtx != CTX_BARE && (addr & ((1 << PAGE_SHIFT) - 1)) + nbytes > (1 << PAGE_SHIFT))
+    {
+        for(unsigned int i=0; i<nbytes; i++)
+            storeSlow(instr, addr + i, data >> (8 * i), 1);
+        return;
+    }
+
+    REG pa = translateData(instr, addr, nbytes, WATCH_WRITE);
+    bus->request(pa, data, (1 << nbytes) - 1, true);
+}
+
+
+/**
+ * @brief Translate a data address & refill its data TLB entry, raises page
+ * faults & access faults. Pages are saved for reverse debugging before a
+ * write.
+ * 
+ * @param type accesses made (WatchType)
+ * @return REG physical address
+ */
+REG RVCPU::translateData(const DecodedInstr &instr, REG va, unsigned int nbytes, int type)
+{
+    const int access = (type & WATCH_WRITE) ? ACCESS_STORE : ACCESS_LOAD;
+    uint64_t pa = va;
+    bool readable = true, writable = true;
+    if(dataCtx != CTX_BARE)
+    {
+        unsigned int cause;
+        const TLB::Entry * e = translate(va, access, dataCtx, pa, cause);
+        if(!e)
+            raiseException(instr, cause, va);
+
+        // Stores only take the fast path once the page is dirty
+        readable = pagePermitted(e->flags, ACCESS_LOAD, dataCtx);
+        writable = pagePermitted(e->flags, ACCESS_STORE, dataCtx) && (e->flags & PTE_D);
+    }
+    if(!bus->mem->isValidAddress(pa) || !bus->mem->isValidAddress(pa + nbytes - 1))
+        raiseException(instr, access == ACCESS_STORE ? CAUSE_STORE_ACCESS : CAUSE_LOAD_ACCESS, va);
+
+    // Keep contents of pages as they were at the last checkpoint
+    if(history && (type & WATCH_WRITE))
+    {
+        const REG mask = ~(REG)((1 << PAGE_SHIFT) - 1);
+        history->saveBeforeWrite((REG)pa & mask);
+        history->saveBeforeWrite((REG)(pa + nbytes - 1) & mask);
+    }
+    fillDTLB(va, pa, readable, writable);
+    return (REG)pa;
+}
+
+
+/**
+ * @brief Get host memory for an atomic access
+ * Checks alignment & watchpoints, translates the address, and saves the page
+ * for reverse debugging before a write.
+ * 
+ * @param type accesses made (WatchType)
+ * @param pa physical address (set if NULL is returned)
+ * @return uint8_t* host address, NULL if addr is not plain memory
+ */
+uint8_t * RVCPU::atomicAddress(const DecodedInstr &instr, REG addr, unsigned int nbytes, int type, REG &pa)
+{
+    // lr raises load exceptions, sc & amos store exceptions
+    if(addr & (nbytes - 1))
+        raiseException(instr, type == WATCH_READ ? CAUSE_MISALIGNED_LOAD : CAUSE_MISALIGNED_STORE, addr);
+    if(dcacheModelEnabled)
+        dcache.access(addr);
+
+    // Aligned, so the tag is the page address
+    const REG page = addr & ~(REG)((1 << PAGE_SHIFT) - 1);
+    const TLBEntry &e = dtlbCur[(addr >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+    if((!(type & WATCH_READ) || e.readTag == page) && (!(type & WATCH_WRITE) || e.writeTag == page))
+        return e.host + (addr - page);
+
+    if(!watchPages.empty())
+        checkWatchpoints(instr, addr, nbytes, type);
+    pa = translateData(instr, addr, nbytes, type);
+
+    const REG ppage = pa & ~(REG)((1 << PAGE_SHIFT) - 1);
+    uint8_t * host = bus->hostPage(ppage, 1 << PAGE_SHIFT);
+    return host ? host + (pa - ppage) : NULL;
+}
+
+
+/**
+ * @brief Refill the data TLB entry for the virtual page containing va
+ * 
+ * @param pa physical address va translates to
+ * @param readable/writable accesses permitted by the translation
+ */
+void RVCPU::fillDTLB(REG va, uint64_t pa, bool readable, bool writable)
+{
+    REG page = va & ~(REG)((1 << PAGE_SHIFT) - 1);
+    REG ppage = (REG)pa & ~(REG)((1 << PAGE_SHIFT) - 1);
+    TLBEntry &e = dtlbCur[(va >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+
+    e.host = bus->hostPage(ppage, 1 << PAGE_SHIFT);
+    e.readTag = (e.host && readable) ? page : TLB_INVALID;
+    e.writeTag = (e.host && writable) ? page : TLB_INVALID;
+
+    // Track first write to each page after a checkpoint
+    if(history && !history->isSaved(ppage))
+        e.writeTag = TLB_INVALID;
+
+    // Keep watched accesses on the slow path
+    if(!watchPages.empty())
+    {
+        std::unordered_map<REG, int>::iterator it = watchPages.find(page);
+        if(it != watchPages.end())
+        {
+            if(it->second & WATCH_READ)
+                e.readTag = TLB_INVALID;
+            if(it->second & WATCH_WRITE)
+                e.writeTag = TLB_INVALID;
+        }
+    }
+}
+
+
+/**
+ * @brief Invalidate all data TLB entries (of every context)
+ */
+void RVCPU::flushDTLB()
+{
+    for(unsigned int ctx=0; ctx<CTX_COUNT; ctx++)
+    {
+        for(unsigned int i=0; i<DTLB_SIZE; i++)
+        {
+            dtlb[ctx][i].readTag = dtlb[ctx][i].writeTag = TLB_INVALID;
+            dtlb[ctx][i].host = NULL;
+        }
+    }
+}
+
+
+/**
+ * @brief Invalidate the direct mapped TLBs of the translated contexts
+ */
+void RVCPU::flushTranslatedTLBs()
+{
+    for(unsigned int ctx=CTX_S; ctx<CTX_COUNT; ctx++)
+    {
+        for(unsigned int i=0; i<DTLB_SIZE; i++)
+        {
+            dtlb[ctx][i].readTag = dtlb[ctx][i].writeTag = TLB_INVALID;
+            dtlb[ctx][i].host = NULL;
+        }
+        for(unsigned int i=0; i<ITLB_SIZE; i++)
+            itlb[ctx][i].tag = TLB_INVALID;
+    }
+}
+
+
+// ===================================== MMU ======================================
+/**
+ * @brief Satp fields (Sv32 on RV32, Sv39 on RV64)
+ */
+static inline bool satpPaging(REG satp)     { return XLEN == 32 ? (satp >> 31) != 0 : ((uint64_t)satp >> 60) != 0; }
+static inline uint16_t satpASID(REG satp)   { return XLEN == 32 ? (satp >> 22) & 0x1ff : ((uint64_t)satp >> 44) & 0xffff; }
+static inline uint64_t satpPPN(REG satp)    { return XLEN == 32 ? satp & 0x3fffff : (uint64_t)satp & 0xfffffffffffULL; }
+
+/**
+ * @brief Page table geometry: levels, index bits per level & PTE size
+ */
+static const unsigned int PT_LEVELS = XLEN == 32 ? 2 : 3;
+static const unsigned int PT_BITS = XLEN == 32 ? 10 : 9;
+static const unsigned int PTE_SIZE = XLEN == 32 ? 4 : 8;
+static const uint64_t VPN_MASK = (1ULL << (PT_LEVELS * PT_BITS)) - 1;
+
+/**
+ * @brief Page fault & access fault causes by access type (AccessType)
+ */
+static const unsigned int pageFaultCause[] = {CAUSE_FETCH_PAGE_FAULT, CAUSE_LOAD_PAGE_FAULT, CAUSE_STORE_PAGE_FAULT};
+static const unsigned int accessFaultCause[] = {CAUSE_FETCH_ACCESS, CAUSE_LOAD_ACCESS, CAUSE_STORE_ACCESS};
+
+
+/**
+ * @brief Select translation contexts after a change of privilege, satp or
+ * mstatus
+ * M-mode is never translated. With MPRV set, M-mode loads & stores use the
+ * privilege level in MPP.
+ */
+void RVCPU::updateTranslation()
+{
+    const REG status = state.tcsr[TCSR_MSTATUS];
+    const bool paging = satpPaging(state.tcsr[TCSR_SATP]);
+    unsigned int data_priv = state.priv;
+    if(state.priv == PRIV_M && (status & MSTATUS_MPRV))
+        data_priv = (status & MSTATUS_MPP) >> 11;
+
+    fetchCtx = (!paging || state.priv == PRIV_M) ? CTX_BARE : (state.priv == PRIV_S ? CTX_S : CTX_U);
+    dataCtx = (!paging || data_priv == PRIV_M) ? CTX_BARE : (data_priv == PRIV_S ? CTX_S : CTX_U);
+    dtlbCur = dtlb[dataCtx];
+    itlbCur = itlb[fetchCtx];
+}
+
+
+/**
+ * @brief Check the permissions of a page for an access
+ * S-mode only reaches user pages for loads & stores with SUM set, MXR makes
+ * executable pages readable.
+ */
+bool RVCPU::pagePermitted(uint8_t flags, int access, unsigned int ctx)
+{
+    const REG status = state.tcsr[TCSR_MSTATUS];
+    if(ctx == CTX_U)
+    {
+        if(!(flags & PTE_U))
+            return false;
+    }
+    else if((flags & PTE_U) && (access == ACCESS_FETCH || !(status & MSTATUS_SUM)))
+        return false;
+
+    switch(access)
+    {
+        case ACCESS_FETCH:  return flags & PTE_X;
+        case ACCESS_LOAD:   return (flags & PTE_R) || ((flags & PTE_X) && (status & MSTATUS_MXR));
+        default:            return flags & PTE_W;
+    }
+}
+
+
+/**
+ * @brief Translate a virtual address in a context
+ * Looks up the translation TLBs, walking the page table on a miss. A store
+ * to a page that is not dirty walks again to set D.
+ * 
+ * @param va virtual address
+ * @param access access type (AccessType)
+ * @param ctx translation context (not CTX_BARE)
+ * @param pa physical address
+ * @param cause exception cause if the translation fails
+ * @return TLB::Entry* translation, NULL on a fault
+ */
+TLB::Entry * RVCPU::translate(REG va, int access, unsigned int ctx, uint64_t &pa, unsigned int &cause)
+{
+    // Sv39 addresses are sign extended from bit 38
+    if(XLEN == 64)
+    {
+        uint64_t top = (uint64_t)va >> 38;
+        if(top != 0 && top != (1ULL << (64 - 38)) - 1)
+        {
+            cause = pageFaultCause[access];
+            return NULL;
+        }
+    }
+
+    const uint64_t vpn = ((uint64_t)va >> PAGE_SHIFT) & VPN_MASK;
+    TLB &tlb = access == ACCESS_FETCH ? itlbPages : dtlbPages;
+    TLB::Entry * e = tlb.lookup(vpn, satpASID(state.tcsr[TCSR_SATP]));
+    if(e)
+    {
+        if(!pagePermitted(e->flags, access, ctx))
+        {
+            cause = pageFaultCause[access];
+            return NULL;
+        }
+        if(access == ACCESS_STORE && !(e->flags & PTE_D))
+            e = walk(va, access, ctx, cause);
+    }
+    else
+        e = walk(va, access, ctx, cause);
+
+    if(e)
+        pa = (e->ppn << PAGE_SHIFT) | (va & ((1 << PAGE_SHIFT) - 1));
+    return e;
+}
+
+
+/**
+ * @brief Walk the page table (Sv32/Sv39) & cache the translation
+ * Page table entries are read & their A/D bits set through host pointers
+ * into memory, atomically since other harts may share the table.
+ * Superpages are cached as the 4 KiB page containing va.
+ * 
+ * @return TLB::Entry* translation, NULL on a fault
+ */
+TLB::Entry * RVCPU::walk(REG va, int access, unsigned int ctx, unsigned int &cause)
+{
+    const REG satp = state.tcsr[TCSR_SATP];
+    const uint64_t vpn = ((uint64_t)va >> PAGE_SHIFT) & VPN_MASK;
+    uint64_t table = satpPPN(satp) << PAGE_SHIFT;
+
+    stats.pageWalks++;
+    cause = pageFaultCause[access];
+    for(int level = PT_LEVELS - 1; level >= 0; level--)
+    {
+        const uint64_t pte_addr = table + ((vpn >> (level * PT_BITS)) & ((1 << PT_BITS) - 1)) * PTE_SIZE;
+        if(!bus->mem->isValidAddress(pte_addr) || !bus->mem->isValidAddress(pte_addr + PTE_SIZE - 1))
+        {
+            cause = accessFaultCause[access];
+            return NULL;
+        }
+        uint8_t * host = bus->mem->mem + pte_addr;
+        uint64_t pte = PTE_SIZE == 4 ? __atomic_load_n((uint32_t *)host, __ATOMIC_ACQUIRE)
+                                     : __atomic_load_n((uint64_t *)host, __ATOMIC_ACQUIRE);
+
+        // Sv39 bits 63:54 are reserved (no Svpbmt or Svnapot)
+        if(!(pte & PTE_V) || ((pte & PTE_W) && !(pte & PTE_R)) || (PTE_SIZE == 8 && (pte >> 54)))
+            return NULL;
+        uint64_t ppn = (pte >> 10) & (PTE_SIZE == 4 ? 0x3fffff : 0xfffffffffffULL);
+        if(!(pte & (PTE_R | PTE_X)))
+        {
+            // Pointer to the next level, A, D & U are reserved in it
+            if(pte & (PTE_A | PTE_D | PTE_U))
+                return NULL;
+            table = ppn << PAGE_SHIFT;
+            continue;
+        }
+
+        // Superpages must be aligned to their size
+        const uint64_t level_mask = (1ULL << (level * PT_BITS)) - 1;
+        uint8_t flags = (uint8_t)pte;
+        if((ppn & level_mask) || !pagePermitted(flags, access, ctx))
+            return NULL;
+
+        const uint8_t update = PTE_A | (access == ACCESS_STORE ? PTE_D : 0);
+        if((flags & update) != update)
+        {
+            if(history)
+                history->saveBeforeWrite((REG)pte_addr & ~(REG)((1 << PAGE_SHIFT) - 1));
+            if(PTE_SIZE == 4)
+                __atomic_fetch_or((uint32_t *)host, (uint32_t)update, __ATOMIC_SEQ_CST);
+            else
+                __atomic_fetch_or((uint64_t *)host, (uint64_t)update, __ATOMIC_SEQ_CST);
+            flags |= update;
+        }
+
+        TLB &tlb = access == ACCESS_FETCH ? itlbPages : dtlbPages;
+        return tlb.insert(vpn, ppn | (vpn & level_mask), satpASID(satp), flags, level);
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Translate an instruction address & refill its instruction TLB entry
+ * 
+ * @return false if the fetch faults (cause set)
+ */
+bool RVCPU::translateFetch(REG va, uint64_t &pa, unsigned int &cause)
+{
+    if(!translate(va, ACCESS_FETCH, fetchCtx, pa, cause))
+        return false;
+
+    ITLBEntry &e = itlbCur[(va >> PAGE_SHIFT) & (ITLB_SIZE - 1)];
+    e.tag = va & ~(REG)((1 << PAGE_SHIFT) - 1);
+    e.ppage = pa & ~(uint64_t)((1 << PAGE_SHIFT) - 1);
+    return true;
+}
+
+
+/**
+ * @brief Execute sfence.vma
+ * rs1 selects a virtual address & rs2 an ASID, x0 meaning all of them.
+ * Decoded blocks are kept, they are found by physical address & their
+ * translation is checked on lookup.
+ */
+void RVCPU::sfenceVMA(const DecodedInstr &instr)
+{
+    if(state.priv == PRIV_U || (state.priv == PRIV_S && (state.tcsr[TCSR_MSTATUS] & MSTATUS_TVM)))
+        illegalInstruction(instr);
+
+    const bool match_vpn = instr.rs1 != 0;
+    const bool match_asid = instr.rs2 != 0;
+    const uint64_t vpn = ((uint64_t)state.X[instr.rs1] >> PAGE_SHIFT) & VPN_MASK;
+    const uint16_t asid = XLEN == 32 ? state.X[instr.rs2] & 0x1ff : state.X[instr.rs2] & 0xffff;
+    itlbPages.flush(match_vpn, vpn, match_asid, asid);
+    dtlbPages.flush(match_vpn, vpn, match_asid, asid);
+    flushTranslatedTLBs();
+}
+
+
+/**
+ * @brief Stop before instr if an access hits a watchpoint
+ */
+void RVCPU::checkWatchpoints(const DecodedInstr &instr, REG addr, unsigned int nbytes, int type)
+{
+    if(stopsSuppressed)
+        return;
+
+    for(unsigned int i=0; i<watchpoints.size(); i++)
+    {
+        const Watchpoint &w = watchpoints[i];
+        if((w.type & type) && addr < w.addr + w.len && w.addr < addr + nbytes)
+        {
+            watchHit = w;
+            throw StopHit{&instr, STOP_WATCHPOINT};
+        }
+    }
+}
+
+
+/**
+ * @brief Report an illegal instruction
+ */
+void RVCPU::illegalInstruction(const DecodedInstr &instr)
+{
+    // Compressed instructions report their 16-bit encoding, not the expansion
+    raiseException(instr, CAUSE_ILLEGAL_INSTRUCTION, instr.len == 2 ? instr.parcel : instr.raw);
+}
+
+
+// ==================================== Traps =====================================
+/**
+ * @brief Raise an exception on an instruction
+ * Unwinds out of the executing block to the trap handler, so it never
+ * returns. Without a handler (not delegated & mtvec is 0) the exception is a
+ * fatal error.
+ * 
+ * @param instr instruction raising the exception
+ * @param cause exception cause (TrapCause)
+ * @param tval value for mtval/stval
+ */
+void RVCPU::raiseException(const DecodedInstr &instr, unsigned int cause, REG tval)
+{
+    stats.traps[cause]++;
+    if(!hasTrapHandler(cause))
+        unhandledException(instr, cause, tval);
+    throw TrapHit{&instr, cause, tval};
+}
+
+
+/**
+ * @brief Take an exception raised by the last instruction of the executing
+ * block (ecall/ebreak)
+ * Nothing follows it in the block, so the handler is entered directly
+ * instead of unwinding. Without a handler the CPU halts.
+ */
+void RVCPU::takeException(const DecodedInstr &instr, unsigned int cause, REG tval)
+{
+    stats.traps[cause]++;
+    if(!hasTrapHandler(cause))
+    {
+        unhandledException(instr, cause, tval);
+        return;
+    }
+    abortBlock(instr, STOP_NONE);
+    enterTrap(cause, tval);
+}
+
+
+/**
+ * @brief Report an exception raised without a trap handler
+ * ecall & ebreak halt the CPU, other exceptions are fatal errors.
+ */
+void RVCPU::unhandledException(const DecodedInstr &instr, unsigned int cause, REG tval)
+{
+    // Addresses are printed at full XLEN width
+    char errmsg[128];
+    const int w = XLEN / 4;
+    const unsigned long long addr = (unsigned long long)tval, pc = (unsigned long long)instr.pc;
+    switch(cause)
+    {
+        case CAUSE_USER_ECALL:
+        case CAUSE_SUPERVISOR_ECALL:
+        case CAUSE_MACHINE_ECALL:
+            halted = true;
+            stopReason = STOP_ECALL;
+            return;
+        case CAUSE_BREAKPOINT:
+            halted = true;
+            stopReason = STOP_EBREAK;
+            return;
+        case CAUSE_ILLEGAL_INSTRUCTION:
+            snprintf(errmsg, sizeof(errmsg), "Illegal instruction 0x%08llx at PC 0x%0*llx", addr, w, pc);
+            break;
+        case CAUSE_MISALIGNED_FETCH:
+            snprintf(errmsg, sizeof(errmsg), "Instruction address misaligned : 0x%0*llx", w, addr);
+            break;
+        case CAUSE_MISALIGNED_LOAD:
+        case CAUSE_MISALIGNED_STORE:
+            snprintf(errmsg, sizeof(errmsg), "Misaligned atomic access to 0x%0*llx at PC 0x%0*llx", w, addr, w, pc);
+            break;
+        case CAUSE_FETCH_PAGE_FAULT:
+        case CAUSE_LOAD_PAGE_FAULT:
+        case CAUSE_STORE_PAGE_FAULT:
+            snprintf(errmsg, sizeof(errmsg), "Page fault at 0x%0*llx, PC 0x%0*llx", w, addr, w, pc);
+            break;
+        default:
+            snprintf(errmsg, sizeof(errmsg), "Address out of bounds : 0x%0*llx", w, addr);
+            break;
+    }
+    fatalInstr = &instr;
+    SimError::throwError(errmsg, true);
+    fatalInstr = NULL;
+}
+
+
+/**
+ * @brief Check if an exception is handled by a trap handler (delegated to
+ * S-mode or mtvec set)
+ */
+bool RVCPU::hasTrapHandler(unsigned int cause)
+{
+    return (state.priv <= PRIV_S && ((state.tcsr[TCSR_MEDELEG] >> cause) & 1)) || state.tcsr[TCSR_MTVEC];
+}
+
+
+/**
+ * @brief Enter the trap handler for an exception raised at the PC
+ * Exceptions from S-mode & U-mode that medeleg delegates are taken in
+ * S-mode, all others in M-mode. They always go to the tvec base, only
+ * interrupts use vectored mode.
+ */
+void RVCPU::enterTrap(unsigned int cause, REG tval)
+{
+    REG &status = state.tcsr[TCSR_MSTATUS];
+    if(state.priv <= PRIV_S && ((state.tcsr[TCSR_MEDELEG] >> cause) & 1))
+    {
+        status = (status & ~(REG)(MSTATUS_SIE | MSTATUS_SPIE | MSTATUS_SPP)) |
+            ((status & MSTATUS_SIE) ? MSTATUS_SPIE : 0) | (state.priv == PRIV_S ? MSTATUS_SPP : 0);
+        state.tcsr[TCSR_SEPC] = state.PC;
+        state.tcsr[TCSR_SCAUSE] = cause;
+        state.tcsr[TCSR_STVAL] = tval;
+        state.priv = PRIV_S;
+        state.PC = state.tcsr[TCSR_STVEC] & ~(REG)0x3;
+    }
+    else
+    {
+        status = (status & ~(REG)(MSTATUS_MIE | MSTATUS_MPIE | MSTATUS_MPP)) |
+            ((status & MSTATUS_MIE) ? MSTATUS_MPIE : 0) | ((REG)state.priv << 11);
+        state.tcsr[TCSR_MEPC] = state.PC;
+        state.tcsr[TCSR_MCAUSE] = cause;
+        state.tcsr[TCSR_MTVAL] = tval;
+        state.priv = PRIV_M;
+        state.PC = state.tcsr[TCSR_MTVEC] & ~(REG)0x3;
+    }
+    updateTranslation();
+}
+
+
+/**
+ * @brief Return from a trap handler (mret/sret)
+ * Both end their block, so setting the PC is all it takes to continue at
+ * the exception PC.
+ * 
+ * @param instr return instruction
+ * @param from privilege level of the handler
+ */
+void RVCPU::trapReturn(const DecodedInstr &instr, unsigned int from)
+{
+    REG &status = state.tcsr[TCSR_MSTATUS];
+    if(from == PRIV_M)
+    {
+        if(state.priv != PRIV_M)
+            illegalInstruction(instr);
+        state.priv = (status & MSTATUS_MPP) >> 11;
+        status = (status & ~(REG)(MSTATUS_MIE | MSTATUS_MPP)) | ((status & MSTATUS_MPIE) ? MSTATUS_MIE : 0) | MSTATUS_MPIE;
+        if(state.priv != PRIV_M)
+            status &= ~(REG)MSTATUS_MPRV;
+        state.PC = state.tcsr[TCSR_MEPC] & ~fetchAlignMask;
+    }
+    else
+    {
+        if(state.priv == PRIV_U || (state.priv == PRIV_S && (status & MSTATUS_TSR)))
+            illegalInstruction(instr);
+        state.priv = (status & MSTATUS_SPP) ? PRIV_S : PRIV_U;
+        status = (status & ~(REG)(MSTATUS_SIE | MSTATUS_SPP | MSTATUS_MPRV)) | ((status & MSTATUS_SPIE) ? MSTATUS_SIE : 0) | MSTATUS_SPIE;
+        state.PC = state.tcsr[TCSR_SEPC] & ~fetchAlignMask;
+    }
+    updateTranslation();
+}
+
+
+// ================================ Floating point ================================
+/**
+ * @brief Take over the host FPU (run entry)
+ * Exceptions raised by the simulator itself are discarded & the host starts
+ * out rounding to nearest.
+ */
+void RVCPU::fpEnter()
+{
+    RVFloat::clearHostFlags();
+    RVFloat::setHostRounding(RM_RNE);
+    hostRM = RM_RNE;
+    fpActive = true;
+}
+
+
+/**
+ * @brief Give back the host FPU (run exit)
+ */
+void RVCPU::fpLeave()
+{
+    fpSyncFlags();
+    if(hostRM != RM_RNE)
+        RVFloat::setHostRounding(RM_RNE);
+    fpActive = false;
+}
+
+
+/**
+ * @brief Fold exceptions raised in the host FPU into fflags
+ */
+void RVCPU::fpSyncFlags()
+{
+    if(!fpActive)
+        return;
+    state.fflags |= RVFloat::hostFlags();
+    RVFloat::clearHostFlags();
+}
+
+
+// ==================================== Vector ====================================
+/**
+ * @brief Set vtype (vill if the type is not supported)
+ * SEW up to 64 bits, fractional LMUL down to SEW / 64.
+ */
+void RVCPU::vecSetType(REG vtype)
+{
+    unsigned int sew = (vtype >> 3) & 0x7;
+    int lmul = (int)((vtype & 0x7) ^ 0x4) - 4;
+    if((vtype >> 8) != 0 || sew > 3 || lmul == -4 || (int)sew > 3 + lmul)
+    {
+        state.vtype = (REG)1 << (XLEN - 1);
+        state.vl = 0;
+        vlmax = 0;
+        return;
+    }
+
+    state.vtype = vtype;
+    vsew = sew;
+    vlmul = lmul;
+    vlmax = (lmul >= 0 ? vlenb << lmul : vlenb >> -lmul) >> sew;
+}
+
+
+/**
+ * @brief Load elements start to end-1 of a register group
+ * Unit-stride runs within a page mapped by the data TLB are copied (or
+ * merged under the mask) straight from host memory.
+ */
+void RVCPU::vecLoad(const DecodedInstr &instr, uint8_t * v, REG addr, REG stride, unsigned int eew,
+    const uint8_t * mask, unsigned int start, unsigned int end)
+{
+    const REG offset_mask = (1 << PAGE_SHIFT) - 1;
+    for(unsigned int i=start; i<end; )
+    {
+        REG a = addr + (REG)i * stride;
+        if(stride == eew && !(a & (eew - 1)) && !dcacheModelEnabled)
+        {
+            const TLBEntry &e = dtlbCur[(a >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+            if(e.readTag == (a & ~offset_mask))
+            {
+                unsigned int n = std::min<REG>(end - i, (offset_mask + 1 - (a & offset_mask)) / eew);
+                const uint8_t * p = e.host + (a & offset_mask);
+                if(mask)
+                {
+                    // Kernels index both operands by element number
+                    const uint8_t * base = (const uint8_t *)((uintptr_t)p - (uintptr_t)i * eew);
+                    RVVector::kernels->merge[__builtin_ctz(eew)](v, v, base, 0, mask, i, i + n);
+                }
+                else
+                    memcpy(v + i * eew, p, n * eew);
+                i += n;
+                continue;
+            }
+        }
+
+        if(!mask || ((mask[i >> 3] >> (i & 7)) & 1))
+        {
+            // A trap on this element restarts the instruction from it
+            state.vstart = i;
+            uint64_t value;
+            if(XLEN == 32 && eew == 8)
+                value = loadElement64(instr, a);
+            else
+                value = load(instr, a, eew);
+            memcpy(v + i * eew, &value, eew);
+        }
+        i++;
+    }
+}
+
+
+/**
+ * @brief Store elements start to end-1 of a register group
+ * Unmasked unit-stride runs within a page mapped by the data TLB are copied
+ * straight to host memory.
+ */
+void RVCPU::vecStore(const DecodedInstr &instr, const uint8_t * v, REG addr, REG stride, unsigned int eew,
+    const uint8_t * mask, unsigned int start, unsigned int end)
+{
+    const REG offset_mask = (1 << PAGE_SHIFT) - 1;
+    for(unsigned int i=start; i<end; )
+    {
+        REG a = addr + (REG)i * stride;
+        if(!mask && stride == eew && !(a & (eew - 1)) && !dcacheModelEnabled)
+        {
+            const TLBEntry &e = dtlbCur[(a >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+            if(e.writeTag == (a & ~offset_mask))
+            {
+                unsigned int n = std::min<REG>(end - i, (offset_mask + 1 - (a & offset_mask)) / eew);
+                memcpy(e.host + (a & offset_mask), v + i * eew, n * eew);
+                i += n;
+                continue;
+            }
+        }
+
+        if(!mask || ((mask[i >> 3] >> (i & 7)) & 1))
+        {
+            state.vstart = i;
+            uint64_t value = 0;
+            memcpy(&value, v + i * eew, eew);
+            if(XLEN == 32 && eew == 8)
+                storeElement64(instr, a, value);
+            else
+                store(instr, a, (REG)value, eew);
+        }
+        i++;
+    }
+}
 
 
 /**
- * @brief Construct a new RVCPU object
+ * @brief Check watchpoints & translate the 8 bytes of a 64-bit element on
+ * RV32 (REG can't hold it)
  * 
- * @param pc_init_address program counter reset address
- * @param ISA_def RISC-V ISA definition
- * @param system_bus bus object pointer
+ * @param type access made (WatchType)
+ * @param pa physical addresses of the bytes in the first & second page
+ * @return unsigned int bytes in the first page
  */
-RVCPU::RVCPU(REG pc_init_address, ISAdef ISA_def, Bus<REG> *system_bus)
+unsigned int RVCPU::translateElement64(const DecodedInstr &instr, REG addr, int type, REG pa[2])
 {
-    PC_RESET_ADDR = pc_init_address;
-    CPU_ISA = ISA_def;
-    nRegs = ISA_def.ISA_EMBEDDED ? XLEN/2 : XLEN;
-    bus = system_bus;
+    if(!watchPages.empty())
+        checkWatchpoints(instr, addr, 8, type);
+
+    const unsigned int offset = addr & ((1 << PAGE_SHIFT) - 1);
+    const unsigned int first = offset + 8 > (1 << PAGE_SHIFT) ? (1 << PAGE_SHIFT) - offset : 8;
+    pa[0] = translateData(instr, addr, first, type);
+    pa[1] = first < 8 ? translateData(instr, addr + first, 8 - first, type) : pa[0] + first;
+    return first;
+}
+
+
+uint64_t RVCPU::loadElement64(const DecodedInstr &instr, REG addr)
+{
+    if(dcacheModelEnabled)
+        dcache.access(addr);
+
+    uint64_t value;
+    const TLBEntry &e = dtlbCur[(addr >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+    if(e.readTag == (addr & (~(REG)((1 << PAGE_SHIFT) - 1) | 7)))
+    {
+        memcpy(&value, e.host + (addr & ((1 << PAGE_SHIFT) - 1)), 8);
+        return value;
+    }
+
+    REG pa[2];
+    const unsigned int first = translateElement64(instr, addr, WATCH_READ, pa);
+    if(first == 8)
+        return (uint64_t)bus->request(pa[0], 0, 0xf, false) | ((uint64_t)bus->request(pa[0] + 4, 0, 0xf, false) << 32);
+    value = 0;
+    for(unsigned int b=0; b<8; b++)
+        value |= (uint64_t)(uint8_t)bus->request(b < first ? pa[0] + b : pa[1] + (b - first), 0, 1, false) << (8 * b);
+    return value;
+}
+
+
+void RVCPU::storeElement64(const DecodedInstr &instr, REG addr, uint64_t data)
+{
+    if(dcacheModelEnabled)
+        dcache.access(addr);
+
+    const TLBEntry &e = dtlbCur[(addr >> PAGE_SHIFT) & (DTLB_SIZE - 1)];
+    if(e.writeTag == (addr & (~(REG)((1 << PAGE_SHIFT) - 1) | 7)))
+    {
+        memcpy(e.host + (addr & ((1 << PAGE_SHIFT) - 1)), &data, 8);
+        return;
+    }
+
+    REG pa[2];
+    const unsigned int first = translateElement64(instr, addr, WATCH_WRITE, pa);
+    if(first == 8)
+    {
+        bus->request(pa[0], (REG)data, 0xf, true);
+        bus->request(pa[0] + 4, (REG)(data >> 32), 0xf, true);
+        return;
+    }
+    for(unsigned int b=0; b<8; b++)
+        bus->request(b < first ? pa[0] + b : pa[1] + (b - first), (REG)(data >> (8 * b)) & 0xff, 1, true);
 }
 
 
 /**
- * @brief Get the value of the specified register
+ * @brief Get vector register length in bits (0 without the V extension)
+ */
+unsigned int RVCPU::getVLEN()
+{
+    return vlenb * 8;
+}
+
+
+// ==================================== CSRs ======================================
+/**
+ * @brief Index of a trap CSR in the CSR array (TrapCSR), -1 if addr is not one
+ */
+static int trapCSRIndex(uint16_t addr)
+{
+    switch(addr)
+    {
+        case CSR::MSTATUS:  return TCSR_MSTATUS;
+        case CSR::MIE:      return TCSR_MIE;
+        case CSR::MTVEC:    return TCSR_MTVEC;
+        case CSR::MSCRATCH: return TCSR_MSCRATCH;
+        case CSR::MEPC:     return TCSR_MEPC;
+        case CSR::MCAUSE:   return TCSR_MCAUSE;
+        case CSR::MTVAL:    return TCSR_MTVAL;
+        case CSR::MIP:      return TCSR_MIP;
+        case CSR::MEDELEG:  return TCSR_MEDELEG;
+        case CSR::MIDELEG:  return TCSR_MIDELEG;
+        case CSR::MCOUNTEREN:   return TCSR_MCOUNTEREN;
+        case CSR::STVEC:    return TCSR_STVEC;
+        case CSR::SCOUNTEREN:   return TCSR_SCOUNTEREN;
+        case CSR::SSCRATCH: return TCSR_SSCRATCH;
+        case CSR::SEPC:     return TCSR_SEPC;
+        case CSR::SCAUSE:   return TCSR_SCAUSE;
+        case CSR::STVAL:    return TCSR_STVAL;
+        case CSR::SATP:     return TCSR_SATP;
+        default:            return -1;
+    }
+}
+
+/**
+ * @brief Writable bits of the trap CSRs, others keep their value
+ */
+static const REG trapCSRWritable[TCSR_COUNT] =
+{
+    (REG)(MSTATUS_SIE | MSTATUS_MIE | MSTATUS_SPIE | MSTATUS_MPIE | MSTATUS_SPP | MSTATUS_VS | MSTATUS_MPP |
+          MSTATUS_FS | MSTATUS_MPRV | MSTATUS_SUM | MSTATUS_MXR | MSTATUS_TVM | MSTATUS_TW | MSTATUS_TSR),   // mstatus
+    0xaaa,                          // mie: S & M software, timer & external
+    ~(REG)0x2,                      // mtvec: BASE & MODE (direct/vectored)
+    ~(REG)0,                        // mscratch
+    ~(REG)0x1,                      // mepc
+    ~(REG)0,                        // mcause
+    ~(REG)0,                        // mtval
+    0,                              // mip, there are no interrupt sources
+    0xb3ff,                         // medeleg: all but ecall from M
+    0x222,                          // mideleg: S interrupts
+    0xffffffff,                     // mcounteren
+    ~(REG)0x2,                      // stvec
+    0xffffffff,                     // scounteren
+    ~(REG)0,                        // sscratch
+    ~(REG)0x1,                      // sepc
+    ~(REG)0,                        // scause
+    ~(REG)0,                        // stval
+    ~(REG)0                         // satp (WARL on the mode)
+};
+
+/**
+ * @brief Fields of mstatus visible through sstatus, and the writable ones
+ */
+static const REG SSTATUS_MASK = (REG)(MSTATUS_SIE | MSTATUS_SPIE | MSTATUS_SPP | MSTATUS_VS | MSTATUS_FS |
+    MSTATUS_SUM | MSTATUS_MXR | (XLEN == 64 ? MSTATUS_UXL : 0)) | (REG)1 << (XLEN - 1);
+static const REG SSTATUS_WRITABLE = (REG)(MSTATUS_SIE | MSTATUS_SPIE | MSTATUS_SPP | MSTATUS_VS | MSTATUS_FS |
+    MSTATUS_SUM | MSTATUS_MXR);
+
+/**
+ * @brief Check if the translation mode of a satp value is supported (Bare,
+ * Sv32 or Sv39)
+ */
+static inline bool satpModeValid(REG satp)
+{
+    if(XLEN == 32)
+        return true;
+    uint64_t mode = (uint64_t)satp >> 60;
+    return mode == 0 || mode == 8;
+}
+
+/**
+ * @brief Execute a csr instruction
  * 
- * @param reg_no register number
+ * @param instr decoded instruction
+ * @param operand rs1 value or zero extended immediate
+ * @param op 0: write, 1: set bits, 2: clear bits
  */
-REG RVCPU::getRegValue(unsigned int reg_no)
+void RVCPU::csrOp(const DecodedInstr &instr, REG operand, int op)
 {
-    return state.X[reg_no];
+    uint16_t addr = (uint16_t)instr.imm;
+    bool rd_zero = ((instr.raw >> 7) & 0x1f) == 0;
+    bool rs1_zero = ((instr.raw >> 15) & 0x1f) == 0;
+    bool do_read = !(op == 0 && rd_zero);
+    bool do_write = (op == 0) || !rs1_zero;
+
+    // This instruction was counted at block entry but must not see itself
+    instret--;
+
+    // Accessible from the privilege level in bits 9:8 up
+    REG old = 0;
+    bool ok = ((addr >> 8) & 0x3) <= state.priv;
+    if(ok && do_read)
+        ok = csrRead(addr, old);
+    instret++;
+
+    // Written after the increment, so a value written to a counter replaces
+    // this instruction's own count
+    if(ok && do_write)
+    {
+        REG value = (op == 0) ? operand : (op == 1) ? (old | operand) : (old & ~operand);
+        ok = ((addr >> 10) != 0x3) && csrWrite(addr, value);
+    }
+
+    if(!ok)
+    {
+        illegalInstruction(instr);
+        return;
+    }
+    state.X[instr.rd] = old;
 }
 
 
 /**
- * @brief Get value of program counter
+ * @brief Read a CSR
+ * 
+ * @return false if the CSR does not exist
  */
-REG RVCPU::getPCValue()
+bool RVCPU::csrRead(uint16_t addr, REG &value)
 {
-    return state.PC;
+    if(addr >= CSR::FFLAGS && addr <= CSR::FCSR)
+    {
+        if(!CPU_ISA.ISA_F)
+            return false;
+        fpSyncFlags();
+        value = addr == CSR::FFLAGS ? state.fflags : (addr == CSR::FRM ? state.frm : (state.frm << 5) | state.fflags);
+        return true;
+    }
+    if(addr == CSR::VSTART || addr == CSR::VXSAT || addr == CSR::VXRM || addr == CSR::VCSR ||
+       (addr >= CSR::VL && addr <= CSR::VLENB))
+    {
+        if(!CPU_ISA.ISA_V)
+            return false;
+        switch(addr)
+        {
+            case CSR::VSTART:   value = state.vstart; break;
+            case CSR::VXSAT:    value = state.vxsat; break;
+            case CSR::VXRM:     value = state.vxrm; break;
+            case CSR::VCSR:     value = (state.vxrm << 1) | state.vxsat; break;
+            case CSR::VL:       value = state.vl; break;
+            case CSR::VTYPE:    value = state.vtype; break;
+            default:            value = vlenb; break;
+        }
+        return true;
+    }
+    if(addr == CSR::SIMMARKER)
+    {
+        value = simMarker;
+        return true;
+    }
+    if(addr == CSR::SATP && state.priv == PRIV_S && (state.tcsr[TCSR_MSTATUS] & MSTATUS_TVM))
+        return false;
+    int tcsr = trapCSRIndex(addr);
+    if(tcsr >= 0)
+    {
+        // Bit 1 of mepc & sepc reads as 0 without C, SD summarizes FS & VS
+        value = state.tcsr[tcsr];
+        if(tcsr == TCSR_MEPC || tcsr == TCSR_SEPC)
+            value &= ~fetchAlignMask;
+        if(tcsr == TCSR_MSTATUS && (value & (MSTATUS_FS | MSTATUS_VS)))
+            value |= (REG)1 << (XLEN - 1);
+        return true;
+    }
+    if(addr == CSR::SSTATUS)
+    {
+        csrRead(CSR::MSTATUS, value);
+        value &= SSTATUS_MASK;
+        return true;
+    }
+    if(addr == CSR::SIE || addr == CSR::SIP)
+    {
+        value = state.tcsr[addr == CSR::SIE ? TCSR_MIE : TCSR_MIP] & state.tcsr[TCSR_MIDELEG];
+        return true;
+    }
+    if(addr == CSR::MISA)
+    {
+        value = (REG)(XLEN == 32 ? 1 : 2) << (XLEN - 2);
+        value |= (REG)1 << ((CPU_ISA.ISA_EMBEDDED ? 'E' : 'I') - 'A');
+        value |= (REG)CPU_ISA.ISA_M << ('M' - 'A');
+        value |= (REG)CPU_ISA.ISA_A << ('A' - 'A');
+        value |= (REG)CPU_ISA.ISA_F << ('F' - 'A');
+        value |= (REG)CPU_ISA.ISA_D << ('D' - 'A');
+        value |= (REG)CPU_ISA.ISA_C << ('C' - 'A');
+        value |= (REG)CPU_ISA.ISA_V << ('V' - 'A');
+        value |= (REG)1 << ('S' - 'A');
+        value |= (REG)1 << ('U' - 'A');
+        return true;
+    }
+    if(XLEN == 32 && addr == CSR::MSTATUSH)
+    {
+        value = 0;
+        return true;
+    }
+    if(addr >= CSR::MVENDORID && addr <= CSR::MIMPID)
+    {
+        value = 0;
+        return true;
+    }
+    if(addr == CSR::MHARTID)
+    {
+        value = hartId;
+        return true;
+    }
+    if(addr == CSR::MCOUNTINHIBIT)
+    {
+        value = mcountinhibit;
+        return true;
+    }
+    if(addr >= CSR::MHPMEVENT3 && addr <= CSR::MHPMEVENT31)
+    {
+        value = mhpmevent[addr & 0x1f];
+        return true;
+    }
+    if(((addr >= CSR::CYCLE && addr <= CSR::HPMCOUNTER31) || (addr >= CSR::CYCLEH && addr <= CSR::HPMCOUNTER31H)) &&
+       state.priv != PRIV_M)
+    {
+        // Counters are enabled for S-mode by mcounteren, then for U-mode by
+        // scounteren
+        unsigned int bit = addr & 0x1f;
+        if(!((state.tcsr[TCSR_MCOUNTEREN] >> bit) & 1) ||
+           (state.priv == PRIV_U && !((state.tcsr[TCSR_SCOUNTEREN] >> bit) & 1)))
+            return false;
+    }
+    if((addr >= CSR::MCYCLE && addr <= CSR::MHPMCOUNTER31 && addr != CSR::MCYCLE + 1) ||
+       (addr >= CSR::CYCLE && addr <= CSR::HPMCOUNTER31))
+    {
+        value = (REG)counterValue(addr & 0x1f);
+        return true;
+    }
+    if(XLEN == 32 && ((addr >= CSR::MCYCLEH && addr <= CSR::MHPMCOUNTER31H && addr != CSR::MCYCLEH + 1) ||
+                      (addr >= CSR::CYCLEH && addr <= CSR::HPMCOUNTER31H)))
+    {
+        value = (REG)(counterValue(addr & 0x1f) >> 32);
+        return true;
+    }
+    return false;
 }
 
+
 /**
- * @brief Reset CPU
+ * @brief Write a CSR
+ * 
+ * @return false if the CSR does not exist
  */
-void RVCPU::reset()
+bool RVCPU::csrWrite(uint16_t addr, REG value)
 {
-    // Reset PC
-    state.PC = PC_RESET_ADDR;
+    if(addr >= CSR::FFLAGS && addr <= CSR::FCSR)
+    {
+        if(!CPU_ISA.ISA_F)
+            return false;
 
-    // Clear registers
-    for(unsigned int i=0; i<nRegs; i++)
+        // Exceptions raised before the write are overwritten
+        if(fpActive)
+            RVFloat::clearHostFlags();
+        if(addr != CSR::FRM)
+            state.fflags = value & 0x1f;
+        if(addr != CSR::FFLAGS)
+            state.frm = (addr == CSR::FRM ? value : value >> 5) & 0x7;
+        return true;
+    }
+    if(addr == CSR::VSTART || addr == CSR::VXSAT || addr == CSR::VXRM || addr == CSR::VCSR)
     {
-        state.X[i] = 0;
+        if(!CPU_ISA.ISA_V)
+            return false;
+
+        // vstart holds element indices up to VLEN - 1
+        if(addr == CSR::VSTART)
+            state.vstart = value & (vlenb * 8 - 1);
+        if(addr == CSR::VXSAT || addr == CSR::VCSR)
+            state.vxsat = value & 0x1;
+        if(addr == CSR::VXRM)
+            state.vxrm = value & 0x3;
+        if(addr == CSR::VCSR)
+            state.vxrm = (value >> 1) & 0x3;
+        return true;
+    }
+    if(addr == CSR::SIMMARKER)
+    {
+        simMarker = value;
+        if(markerStop)
+            stopReason = STOP_MARKER;
+        return true;
+    }
+    int tcsr = trapCSRIndex(addr);
+    if(tcsr == TCSR_MSTATUS)
+    {
+        writeStatus(value, trapCSRWritable[TCSR_MSTATUS]);
+        return true;
+    }
+    if(tcsr == TCSR_SATP)
+    {
+        if(state.priv == PRIV_S && (state.tcsr[TCSR_MSTATUS] & MSTATUS_TVM))
+            return false;
+
+        // Unsupported modes leave satp unchanged. Translations of other
+        // address spaces stay cached, tagged with their ASID.
+        if(satpModeValid(value))
+        {
+            state.tcsr[TCSR_SATP] = value;
+            flushTranslatedTLBs();
+            updateTranslation();
+        }
+        return true;
+    }
+    if(tcsr >= 0)
+    {
+        const REG mask = trapCSRWritable[tcsr];
+        state.tcsr[tcsr] = (state.tcsr[tcsr] & ~mask) | (value & mask);
+        return true;
+    }
+    if(addr == CSR::SSTATUS)
+    {
+        writeStatus(value, SSTATUS_WRITABLE);
+        return true;
+    }
+    if(addr == CSR::SIE)
+    {
+        const REG mask = trapCSRWritable[TCSR_MIE] & state.tcsr[TCSR_MIDELEG];
+        state.tcsr[TCSR_MIE] = (state.tcsr[TCSR_MIE] & ~mask) | (value & mask);
+        return true;
+    }
+    if(addr == CSR::SIP)
+    {
+        // No interrupt sources, pending bits are read-only zero
+        return true;
+    }
+    if(addr == CSR::MISA || (XLEN == 32 && addr == CSR::MSTATUSH))
+    {
+        // Fixed, writes are ignored
+        return true;
     }
+    if(addr == CSR::MCOUNTINHIBIT)
+    {
+        // time can not be inhibited
+        value &= ~(REG)0x2;
+        uint32_t changed = (uint32_t)(value ^ mcountinhibit);
+        uint64_t current[32];
+        for(unsigned int i=0; i<32; i++)
+            current[i] = counterValue(i);
+        mcountinhibit = value;
+        for(unsigned int i=0; i<32; i++)
+        {
+            if((changed >> i) & 1)
+                counterSet(i, current[i]);
+        }
+        return true;
+    }
+    if(addr >= CSR::MHPMEVENT3 && addr <= CSR::MHPMEVENT31)
+    {
+        unsigned int idx = addr & 0x1f;
+        uint64_t current = counterValue(idx);
+        mhpmevent[idx] = value;
+        counterSet(idx, current);
+
+        updateCacheModel();
+        return true;
+    }
+    if(addr >= CSR::MCYCLE && addr <= CSR::MHPMCOUNTER31 && addr != CSR::MCYCLE + 1)
+    {
+        unsigned int idx = addr & 0x1f;
+        uint64_t current = counterValue(idx);
+        if(XLEN == 32)
+            counterSet(idx, (current & 0xffffffff00000000ULL) | (uint32_t)value);
+        else
+            counterSet(idx, value);
+        return true;
+    }
+    if(XLEN == 32 && addr >= CSR::MCYCLEH && addr <= CSR::MHPMCOUNTER31H && addr != CSR::MCYCLEH + 1)
+    {
+        unsigned int idx = addr & 0x1f;
+        uint64_t current = counterValue(idx);
+        counterSet(idx, (current & 0xffffffffULL) | ((uint64_t)value << 32));
+        return true;
+    }
+    return false;
+}
+
+
+/**
+ * @brief Write mstatus fields & legalize them
+ * MPP can not hold the reserved level 2, FS & VS are either off or dirty.
+ * 
+ * @param mask bits written
+ */
+void RVCPU::writeStatus(REG value, REG mask)
+{
+    REG &status = state.tcsr[TCSR_MSTATUS];
+    const REG old = status;
+    if(!CPU_ISA.ISA_F)
+        mask &= ~(REG)MSTATUS_FS;
+    if(!CPU_ISA.ISA_V)
+        mask &= ~(REG)MSTATUS_VS;
+
+    status = (status & ~mask) | (value & mask);
+    if((status & MSTATUS_MPP) == (2 << 11))
+        status &= ~(REG)MSTATUS_MPP;
+    if(status & MSTATUS_FS)
+        status |= MSTATUS_FS;
+    if(status & MSTATUS_VS)
+        status |= MSTATUS_VS;
+
+    // Permissions cached in the direct mapped TLBs depend on SUM & MXR
+    if((old ^ status) & (MSTATUS_SUM | MSTATUS_MXR))
+        flushTranslatedTLBs();
+    updateTranslation();
+}
+
+
+// ============================= Performance counters =============================
+/**
+ * @brief Compute total count of an event
+ */
+uint64_t RVCPU::eventTotal(unsigned int event)
+{
+    if(event == HPM_EV_NONE || event >= HPM_EV_COUNT)
+        return 0;
+    if(event == HPM_EV_DCACHE_ACCESS)
+        return dcache.accesses;
+    if(event == HPM_EV_DCACHE_MISS)
+        return dcache.misses;
+
+    uint64_t total = evFolded[event];
+    for(std::unordered_map<REG, DecodedBlock>::iterator it = blocks.begin(); it != blocks.end(); it++)
+    {
+        if(event == HPM_EV_BRANCH_TAKEN)
+            total += it->second.taken_count;
+        else
+            total += it->second.exec_count * it->second.static_events[event];
+    }
+    return total;
+}
+
+
+/**
+ * @brief Get the raw count a counter is derived from
+ */
+uint64_t RVCPU::counterSource(unsigned int idx)
+{
+    // Without a timing model every instruction takes a cycle
+    if(idx < 3)
+        return instret;
+    return eventTotal(mhpmevent[idx]);
+}
+
+
+/**
+ * @brief Get counter value
+ */
+uint64_t RVCPU::counterValue(unsigned int idx)
+{
+    if((mcountinhibit >> idx) & 1)
+        return counters[idx].base;
+    return counters[idx].base + (counterSource(idx) - counters[idx].snap);
+}
+
+
+/**
+ * @brief Set counter value
+ */
+void RVCPU::counterSet(unsigned int idx, uint64_t value)
+{
+    counters[idx].base = value;
+    counters[idx].snap = counterSource(idx);
+}
+
+
+/**
+ * @brief Enable/Disable stopping when the program writes the marker CSR
+ */
+void RVCPU::setMarkerStop(bool enable)
+{
+    markerStop = enable;
+}
+
+
+/**
+ * @brief Get value last written to the marker CSR
+ */
+REG RVCPU::getMarker()
+{
+    return simMarker;
+}
+
+
+/**
+ * @brief Save architectural & counter state
+ */
+void RVCPU::saveSnapshot(CPUSnapshot &snap)
+{
+    fpSyncFlags();
+    snap.PC = state.PC;
+    for(unsigned int i=0; i<32; i++)
+    {
+        snap.X[i] = state.X[i];
+        snap.F[i] = state.F[i];
+    }
+    snap.fcsr = (state.frm << 5) | state.fflags;
+    memcpy(snap.V, state.V, sizeof(snap.V));
+    snap.vl = state.vl;
+    snap.vtype = state.vtype;
+    snap.vstart = state.vstart;
+    snap.vcsr = (state.vxrm << 1) | state.vxsat;
+    snap.halted = halted;
+    snap.instret = instret;
+    for(unsigned int ev=0; ev<HPM_EV_COUNT; ev++)
+        snap.events[ev] = eventTotal(ev);
+    for(unsigned int i=0; i<32; i++)
+    {
+        snap.counterBase[i] = counters[i].base;
+        snap.counterSnap[i] = counters[i].snap;
+        snap.mhpmevent[i] = mhpmevent[i];
+    }
+    snap.mcountinhibit = mcountinhibit;
+    memcpy(snap.tcsr, state.tcsr, sizeof(snap.tcsr));
+    snap.priv = state.priv;
+    snap.dcacheModelEnabled = dcacheModelEnabled;
+    snap.dcache = dcache;
+
+    // Next write to each page takes the slow path again
+    flushDTLB();
+}
+
+
+/**
+ * @brief Restore architectural & counter state
+ * Decoded blocks are kept, event totals are adjusted around their counts.
+ */
+void RVCPU::restoreSnapshot(const CPUSnapshot &snap)
+{
+    state.PC = snap.PC;
+    for(unsigned int i=0; i<32; i++)
+    {
+        state.X[i] = snap.X[i];
+        state.F[i] = snap.F[i];
+    }
+    state.X[REG_SINK] = 0;
+    state.fflags = snap.fcsr & 0x1f;
+    state.frm = (snap.fcsr >> 5) & 0x7;
+    if(fpActive)
+        RVFloat::clearHostFlags();
+    memcpy(state.V, snap.V, sizeof(state.V));
+    vecSetType(snap.vtype);
+    state.vl = snap.vl;
+    state.vstart = snap.vstart;
+    state.vxrm = (snap.vcsr >> 1) & 0x3;
+    state.vxsat = snap.vcsr & 0x1;
+    memcpy(state.tcsr, snap.tcsr, sizeof(state.tcsr));
+    state.priv = snap.priv;
+    halted = snap.halted;
+    stopReason = STOP_NONE;
+
+    // Block derived events, cache model events come with the model
+    instret = snap.instret;
+    for(unsigned int ev=0; ev<HPM_EV_DCACHE_ACCESS; ev++)
+        evFolded[ev] += snap.events[ev] - eventTotal(ev);
+    for(unsigned int i=0; i<32; i++)
+    {
+        counters[i].base = snap.counterBase[i];
+        counters[i].snap = snap.counterSnap[i];
+        mhpmevent[i] = snap.mhpmevent[i];
+    }
+    mcountinhibit = snap.mcountinhibit;
+    dcache = snap.dcache;
+    updateCacheModel();
+
+    // Page tables may have changed with memory
+    itlbPages.reset();
+    dtlbPages.reset();
+    flushDTLB();
+    flushTranslatedTLBs();
+    updateTranslation();
+}
+
+
+/**
+ * @brief Attach execution history for reverse debugging
+ */
+void RVCPU::setHistory(History * hist)
+{
+    history = hist;
+    flushDTLB();
+}
+
+
+/**
+ * @brief Enable the cache model if forced or selected by an event
+ */
+void RVCPU::updateCacheModel()
+{
+    dcacheModelEnabled = dcacheModelForced;
+    for(unsigned int i=3; i<32; i++)
+    {
+        if(mhpmevent[i] == HPM_EV_DCACHE_ACCESS || mhpmevent[i] == HPM_EV_DCACHE_MISS)
+            dcacheModelEnabled = true;
+    }
+}
+
+
+/**
+ * @brief Simulate the data cache model even if no event selects it
+ */
+void RVCPU::setCacheModelForced(bool enable)
+{
+    dcacheModelForced = enable;
+    updateCacheModel();
+}
+
+
+/**
+ * @brief Get the data cache model
+ */
+const CacheModel & RVCPU::getDCache()
+{
+    return dcache;
+}
+
+
+/**
+ * @brief Execute the instruction the CPU is stopped at, ignoring
+ * breakpoints & watchpoints
+ */
+void RVCPU::stepOverStop()
+{
+    DecodedBlock blk;
+    uint64_t pa;
+    unsigned int cause;
+    if(fetchAddress(state.PC, pa, cause))
+        buildBlock(blk, state.PC, pa, 1, false);
+    else
+        buildFaultBlock(blk, state.PC, cause, false);
+    stopsSuppressed = true;
+    try
+    {
+        execBlock(&blk, 1);
+    }
+    catch(const TrapHit &hit)
+    {
+        abortBlock(*hit.instr, STOP_NONE);
+        enterTrap(hit.cause, hit.tval);
+    }
+    catch(const SimError::Fatal &)
+    {
+        abortFatal();
+        stopsSuppressed = false;
+        foldBlockEvents(blk);
+        throw;
+    }
+    stopsSuppressed = false;
+    foldBlockEvents(blk);
 }
 
+
 /**
  * @brief Step CPU by a cycle
  */
 void RVCPU::step()
 {
-    std::cout <<"step" <<"\n";
+    run(1);
 }
 
 /**
@@ -66,8 +4295,73 @@ void RVCPU::step()
  */
 void RVCPU::run(unsigned long int ticks)
 {
-    for(unsigned long int c = 0; c<ticks; c++)
+    if(halted)
+        return;
+    StopReason last = stopReason;
+    stopReason = STOP_NONE;
+
+    // The host FPU is only borrowed while running, also if a fatal error
+    // unwinds out of run
+    struct FPUGuard
     {
-        step();
+        RVCPU * cpu;
+        ~FPUGuard() { if(cpu) cpu->fpLeave(); }
+    } fpu_guard = {CPU_ISA.ISA_F ? this : NULL};
+    if(fpu_guard.cpu)
+        fpEnter();
+
+    // Resuming from a breakpoint or watchpoint executes the instruction the
+    // CPU stopped at
+    if(ticks > 0 && (last == STOP_WATCHPOINT || (!breakpoints.empty() && breakpoints.count(state.PC))))
+    {
+        stepOverStop();
+        ticks--;
+        if(flushPending)
+        {
+            flushDecodeCache();
+            flushPending = false;
+        }
+    }
+
+    while(ticks > 0 && stopReason == STOP_NONE)
+    {
+        DecodedBlock * blk = lookupBlock(state.PC);
+        unsigned long int n = blk->instrs.size();
+        unsigned long int executed = (n < ticks) ? n : ticks;
+
+        try
+        {
+            execBlock(blk, ticks);
+        }
+        catch(const StopHit &hit)
+        {
+            abortBlock(*hit.instr, hit.reason);
+            break;
+        }
+        catch(const TrapHit &hit)
+        {
+            // The trapping instruction does not retire but takes its tick,
+            // decoded blocks stay valid
+            executed = hit.instr - blk->instrs.data() + 1;
+            abortBlock(*hit.instr, STOP_NONE);
+            enterTrap(hit.cause, hit.tval);
+        }
+        catch(const SimError::Fatal &)
+        {
+            // PC & instret are left at the faulting instruction, so the CPU
+            // can be inspected (embedders get the error as an exception)
+            abortFatal();
+            throw;
+        }
+        ticks -= executed;
+
+        if(flushPending)
+        {
+            flushDecodeCache();
+            flushPending = false;
+        }
+
+        if(history && history->due(instret))
+            history->checkpoint();
     }
 }
\ No newline at end of file
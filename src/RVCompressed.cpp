@@ -0,0 +1,209 @@
+#include "RVCompressed.h"
+#include "RVdefs.h"
+
+/**
+ * @brief Major opcodes of the expanded instructions
+ */
+enum
+{
+    OP_LOAD     = 0x03,
+    OP_LOAD_FP  = 0x07,
+    OP_IMM      = 0x13,
+    OP_IMM_32   = 0x1b,
+    OP_STORE    = 0x23,
+    OP_STORE_FP = 0x27,
+    OP_OP       = 0x33,
+    OP_LUI      = 0x37,
+    OP_OP_32    = 0x3b,
+    OP_BRANCH   = 0x63,
+    OP_JALR     = 0x67,
+    OP_JAL      = 0x6f
+};
+
+/**
+ * @brief Get bits hi:lo of a compressed instruction
+ */
+static inline uint32_t bits(uint32_t c, unsigned int hi, unsigned int lo)
+{
+    return (c >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+/**
+ * @brief Sign extend the low n bits of v
+ */
+static inline int32_t sext(uint32_t v, unsigned int n)
+{
+    return (int32_t)(v << (32 - n)) >> (32 - n);
+}
+
+/**
+ * @brief 32-bit instruction encoders
+ */
+static inline uint32_t encodeR(uint32_t op, uint32_t rd, uint32_t f3, uint32_t rs1, uint32_t rs2, uint32_t f7)
+{
+    return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static inline uint32_t encodeI(uint32_t op, uint32_t rd, uint32_t f3, uint32_t rs1, int32_t imm)
+{
+    return ((uint32_t)imm << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+static inline uint32_t encodeS(uint32_t op, uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm)
+{
+    return (((uint32_t)imm >> 5) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | ((imm & 0x1f) << 7) | op;
+}
+
+static inline uint32_t encodeB(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 12) & 1) << 31) | (((u >> 5) & 0x3f) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12)
+        | (((u >> 1) & 0xf) << 8) | (((u >> 11) & 1) << 7) | OP_BRANCH;
+}
+
+static inline uint32_t encodeJ(uint32_t rd, int32_t imm)
+{
+    uint32_t u = (uint32_t)imm;
+    return (((u >> 20) & 1) << 31) | (((u >> 1) & 0x3ff) << 21) | (((u >> 11) & 1) << 20) | (((u >> 12) & 0xff) << 12)
+        | (rd << 7) | OP_JAL;
+}
+
+
+/**
+ * @brief Expand a compressed instruction
+ * 
+ * @param c compressed instruction
+ * @return uint32_t equivalent 32-bit instruction, 0 (illegal) for
+ * reserved encodings
+ */
+uint32_t RVCompressed::expand(uint16_t c)
+{
+    // Full register fields & the x8-x15 fields (rd'/rs1'/rs2')
+    uint32_t rd = bits(c, 11, 7);
+    uint32_t rs2 = bits(c, 6, 2);
+    uint32_t rdp = bits(c, 4, 2) + 8;
+    uint32_t rs1p = bits(c, 9, 7) + 8;
+
+    // Common immediates
+    int32_t imm6 = sext((bits(c, 12, 12) << 5) | bits(c, 6, 2), 6);
+    uint32_t shamt = (bits(c, 12, 12) << 5) | bits(c, 6, 2);
+    uint32_t uimm_w = (bits(c, 12, 10) << 3) | (bits(c, 6, 6) << 2) | (bits(c, 5, 5) << 6);     // c.lw/c.sw
+    uint32_t uimm_d = (bits(c, 12, 10) << 3) | (bits(c, 6, 5) << 6);                            // c.ld/c.sd
+    int32_t jimm = sext((bits(c, 12, 12) << 11) | (bits(c, 11, 11) << 4) | (bits(c, 10, 9) << 8) | (bits(c, 8, 8) << 10)
+        | (bits(c, 7, 7) << 6) | (bits(c, 6, 6) << 7) | (bits(c, 5, 3) << 1) | (bits(c, 2, 2) << 5), 12);
+    int32_t bimm = sext((bits(c, 12, 12) << 8) | (bits(c, 11, 10) << 3) | (bits(c, 6, 5) << 6) | (bits(c, 4, 3) << 1)
+        | (bits(c, 2, 2) << 5), 9);
+
+    switch((bits(c, 1, 0) << 3) | bits(c, 15, 13))
+    {
+        // ======== Quadrant 0 ========
+        case 0x00:      // c.addi4spn
+        {
+            uint32_t nzuimm = (bits(c, 12, 11) << 4) | (bits(c, 10, 7) << 6) | (bits(c, 6, 6) << 2) | (bits(c, 5, 5) << 3);
+            return nzuimm ? encodeI(OP_IMM, rdp, 0, 2, nzuimm) : 0;
+        }
+        case 0x01:      // c.fld
+            return encodeI(OP_LOAD_FP, rdp, 3, rs1p, uimm_d);
+        case 0x02:      // c.lw
+            return encodeI(OP_LOAD, rdp, 2, rs1p, uimm_w);
+        case 0x03:      // c.flw (RV32), c.ld (RV64)
+            return XLEN == 32 ? encodeI(OP_LOAD_FP, rdp, 2, rs1p, uimm_w) : encodeI(OP_LOAD, rdp, 3, rs1p, uimm_d);
+        case 0x05:      // c.fsd
+            return encodeS(OP_STORE_FP, 3, rs1p, rdp, uimm_d);
+        case 0x06:      // c.sw
+            return encodeS(OP_STORE, 2, rs1p, rdp, uimm_w);
+        case 0x07:      // c.fsw (RV32), c.sd (RV64)
+            return XLEN == 32 ? encodeS(OP_STORE_FP, 2, rs1p, rdp, uimm_w) : encodeS(OP_STORE, 3, rs1p, rdp, uimm_d);
+
+        // ======== Quadrant 1 ========
+        case 0x08:      // c.addi, c.nop
+            return encodeI(OP_IMM, rd, 0, rd, imm6);
+        case 0x09:      // c.jal (RV32), c.addiw (RV64)
+            if(XLEN == 32)
+                return encodeJ(1, jimm);
+            return rd ? encodeI(OP_IMM_32, rd, 0, rd, imm6) : 0;
+        case 0x0a:      // c.li
+            return encodeI(OP_IMM, rd, 0, 0, imm6);
+        case 0x0b:
+        {
+            if(rd == 2)
+            {
+                // c.addi16sp
+                int32_t nzimm = sext((bits(c, 12, 12) << 9) | (bits(c, 6, 6) << 4) | (bits(c, 5, 5) << 6) | (bits(c, 4, 3) << 7)
+                    | (bits(c, 2, 2) << 5), 10);
+                return nzimm ? encodeI(OP_IMM, 2, 0, 2, nzimm) : 0;
+            }
+
+            // c.lui
+            return imm6 ? ((uint32_t)imm6 << 12) | (rd << 7) | OP_LUI : 0;
+        }
+        case 0x0c:
+        {
+            switch(bits(c, 11, 10))
+            {
+                case 0:     // c.srli
+                case 1:     // c.srai
+                    if(XLEN == 32 && (shamt & 0x20))
+                        return 0;
+                    return encodeI(OP_IMM, rs1p, 5, rs1p, shamt | (bits(c, 11, 10) << 10));
+                case 2:     // c.andi
+                    return encodeI(OP_IMM, rs1p, 7, rs1p, imm6);
+                default:
+                {
+                    static const uint32_t f3[4] = {0, 4, 6, 7};    // sub, xor, or, and
+                    uint32_t op = bits(c, 6, 5);
+                    if(!bits(c, 12, 12))
+                        return encodeR(OP_OP, rs1p, f3[op], rs1p, rdp, op == 0 ? 0x20 : 0);
+                    if(XLEN == 32 || op >= 2)
+                        return 0;
+                    return encodeR(OP_OP_32, rs1p, 0, rs1p, rdp, op == 0 ? 0x20 : 0);   // c.subw, c.addw
+                }
+            }
+        }
+        case 0x0d:      // c.j
+            return encodeJ(0, jimm);
+        case 0x0e:      // c.beqz
+            return encodeB(0, rs1p, 0, bimm);
+        case 0x0f:      // c.bnez
+            return encodeB(1, rs1p, 0, bimm);
+
+        // ======== Quadrant 2 ========
+        case 0x10:      // c.slli
+            if(XLEN == 32 && (shamt & 0x20))
+                return 0;
+            return encodeI(OP_IMM, rd, 1, rd, shamt);
+        case 0x11:      // c.fldsp
+            return encodeI(OP_LOAD_FP, rd, 3, 2, (bits(c, 12, 12) << 5) | (bits(c, 6, 5) << 3) | (bits(c, 4, 2) << 6));
+        case 0x12:      // c.lwsp
+            return rd ? encodeI(OP_LOAD, rd, 2, 2, (bits(c, 12, 12) << 5) | (bits(c, 6, 4) << 2) | (bits(c, 3, 2) << 6)) : 0;
+        case 0x13:      // c.flwsp (RV32), c.ldsp (RV64)
+            if(XLEN == 32)
+                return encodeI(OP_LOAD_FP, rd, 2, 2, (bits(c, 12, 12) << 5) | (bits(c, 6, 4) << 2) | (bits(c, 3, 2) << 6));
+            return rd ? encodeI(OP_LOAD, rd, 3, 2, (bits(c, 12, 12) << 5) | (bits(c, 6, 5) << 3) | (bits(c, 4, 2) << 6)) : 0;
+        case 0x14:
+        {
+            if(!bits(c, 12, 12))
+            {
+                if(rs2)         // c.mv
+                    return encodeR(OP_OP, rd, 0, 0, rs2, 0);
+                return rd ? encodeI(OP_JALR, 0, 0, rd, 0) : 0;     // c.jr
+            }
+            if(rs2)             // c.add
+                return encodeR(OP_OP, rd, 0, rd, rs2, 0);
+            if(rd)              // c.jalr
+                return encodeI(OP_JALR, 1, 0, rd, 0);
+            return 0x00100073;  // c.ebreak
+        }
+        case 0x15:      // c.fsdsp
+            return encodeS(OP_STORE_FP, 3, 2, rs2, (bits(c, 12, 10) << 3) | (bits(c, 9, 7) << 6));
+        case 0x16:      // c.swsp
+            return encodeS(OP_STORE, 2, 2, rs2, (bits(c, 12, 9) << 2) | (bits(c, 8, 7) << 6));
+        case 0x17:      // c.fswsp (RV32), c.sdsp (RV64)
+            if(XLEN == 32)
+                return encodeS(OP_STORE_FP, 2, 2, rs2, (bits(c, 12, 9) << 2) | (bits(c, 8, 7) << 6));
+            return encodeS(OP_STORE, 3, 2, rs2, (bits(c, 12, 10) << 3) | (bits(c, 9, 7) << 6));
+
+        default:        // reserved (quadrant 0, funct3 4)
+            return 0;
+    }
+}
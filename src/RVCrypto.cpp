@@ -0,0 +1,279 @@
+#include "RVCrypto.h"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define RVCRYPTO_X86
+#endif
+
+// =================================== Tables =====================================
+static const uint8_t aesSbox[256] =
+{
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static const uint8_t sm4Sbox[256] =
+{
+    0xd6, 0x90, 0xe9, 0xfe, 0xcc, 0xe1, 0x3d, 0xb7, 0x16, 0xb6, 0x14, 0xc2, 0x28, 0xfb, 0x2c, 0x05,
+    0x2b, 0x67, 0x9a, 0x76, 0x2a, 0xbe, 0x04, 0xc3, 0xaa, 0x44, 0x13, 0x26, 0x49, 0x86, 0x06, 0x99,
+    0x9c, 0x42, 0x50, 0xf4, 0x91, 0xef, 0x98, 0x7a, 0x33, 0x54, 0x0b, 0x43, 0xed, 0xcf, 0xac, 0x62,
+    0xe4, 0xb3, 0x1c, 0xa9, 0xc9, 0x08, 0xe8, 0x95, 0x80, 0xdf, 0x94, 0xfa, 0x75, 0x8f, 0x3f, 0xa6,
+    0x47, 0x07, 0xa7, 0xfc, 0xf3, 0x73, 0x17, 0xba, 0x83, 0x59, 0x3c, 0x19, 0xe6, 0x85, 0x4f, 0xa8,
+    0x68, 0x6b, 0x81, 0xb2, 0x71, 0x64, 0xda, 0x8b, 0xf8, 0xeb, 0x0f, 0x4b, 0x70, 0x56, 0x9d, 0x35,
+    0x1e, 0x24, 0x0e, 0x5e, 0x63, 0x58, 0xd1, 0xa2, 0x25, 0x22, 0x7c, 0x3b, 0x01, 0x21, 0x78, 0x87,
+    0xd4, 0x00, 0x46, 0x57, 0x9f, 0xd3, 0x27, 0x52, 0x4c, 0x36, 0x02, 0xe7, 0xa0, 0xc4, 0xc8, 0x9e,
+    0xea, 0xbf, 0x8a, 0xd2, 0x40, 0xc7, 0x38, 0xb5, 0xa3, 0xf7, 0xf2, 0xce, 0xf9, 0x61, 0x15, 0xa1,
+    0xe0, 0xae, 0x5d, 0xa4, 0x9b, 0x34, 0x1a, 0x55, 0xad, 0x93, 0x32, 0x30, 0xf5, 0x8c, 0xb1, 0xe3,
+    0x1d, 0xf6, 0xe2, 0x2e, 0x82, 0x66, 0xca, 0x60, 0xc0, 0x29, 0x23, 0xab, 0x0d, 0x53, 0x4e, 0x6f,
+    0xd5, 0xdb, 0x37, 0x45, 0xde, 0xfd, 0x8e, 0x2f, 0x03, 0xff, 0x6a, 0x72, 0x6d, 0x6c, 0x5b, 0x51,
+    0x8d, 0x1b, 0xaf, 0x92, 0xbb, 0xdd, 0xbc, 0x7f, 0x11, 0xd9, 0x5c, 0x41, 0x1f, 0x10, 0x5a, 0xd8,
+    0x0a, 0xc1, 0x31, 0x88, 0xa5, 0xcd, 0x7b, 0xbd, 0x2d, 0x74, 0xd0, 0x12, 0xb8, 0xe5, 0xb4, 0xb0,
+    0x89, 0x69, 0x97, 0x4a, 0x0c, 0x96, 0x77, 0x7e, 0x65, 0xb9, 0xf1, 0x09, 0xc5, 0x6e, 0xc6, 0x84,
+    0x18, 0xf0, 0x7d, 0xec, 0x3a, 0xdc, 0x4d, 0x20, 0x79, 0xee, 0x5f, 0x3e, 0xd7, 0xcb, 0x39, 0x48
+};
+// AES key schedule round constants (none for round 10)
+static const uint8_t aesRcon[11] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36, 0x00};
+
+static inline uint32_t rotl32(uint32_t x, unsigned int s)
+{
+    return (x << s) | (x >> ((32 - s) & 31));
+}
+
+/**
+ * @brief Multiply in GF(2^8) modulo the AES polynomial
+ */
+static uint8_t gfmul(uint8_t a, uint8_t b)
+{
+    uint8_t r = 0;
+    for(; b; b >>= 1)
+    {
+        if(b & 1)
+            r ^= a;
+        a = (a << 1) ^ (a & 0x80 ? 0x1b : 0);
+    }
+    return r;
+}
+
+/**
+ * @brief Build the byte operation tables
+ */
+static RVCrypto::ByteTables buildTables()
+{
+    using namespace RVCrypto;
+    ByteTables tables;
+
+    uint8_t aesInvSbox[256];
+    for(unsigned int x=0; x<256; x++)
+        aesInvSbox[aesSbox[x]] = x;
+
+    for(unsigned int x=0; x<256; x++)
+    {
+        uint32_t s = aesSbox[x], si = aesInvSbox[x];
+        tables.t[AES_ENC][x] = s;
+        tables.t[AES_ENC_MIX][x] = gfmul(s, 2) | (s << 8) | (s << 16) | ((uint32_t)gfmul(s, 3) << 24);
+        tables.t[AES_DEC][x] = si;
+        tables.t[AES_DEC_MIX][x] = gfmul(si, 14) | (gfmul(si, 9) << 8) | (gfmul(si, 13) << 16) | ((uint32_t)gfmul(si, 11) << 24);
+        tables.t[AES_IMC][x] = gfmul(x, 14) | (gfmul(x, 9) << 8) | (gfmul(x, 13) << 16) | ((uint32_t)gfmul(x, 11) << 24);
+
+        uint32_t b = sm4Sbox[x];
+        tables.t[SM4_ED][x] = b ^ (b << 8) ^ (b << 2) ^ (b << 18) ^ ((b & 0x3f) << 26) ^ ((b & 0xc0) << 10);
+        tables.t[SM4_KS][x] = b ^ ((b & 0x07) << 29) ^ ((b & 0xfe) << 7) ^ ((b & 0x01) << 23) ^ ((b & 0xf8) << 13);
+    }
+    return tables;
+}
+
+const RVCrypto::ByteTables RVCrypto::byteTables = buildTables();
+
+
+// ================================ Portable code =================================
+/**
+ * @brief Byte i of the 128-bit state {hi, lo}
+ */
+static inline unsigned int stateByte(uint64_t lo, uint64_t hi, unsigned int i)
+{
+    return ((i < 8 ? lo : hi) >> (8 * (i & 7))) & 0xff;
+}
+
+/**
+ * @brief Apply a byte operation to the first two columns of the state after
+ * ShiftRows (or InvShiftRows), with MixColumns folded into the table
+ */
+template <bool inverse>
+static uint64_t aesColumns(const uint32_t * table, uint64_t lo, uint64_t hi)
+{
+    uint64_t result = 0;
+    for(unsigned int c=0; c<2; c++)
+    {
+        uint32_t col = 0;
+        for(unsigned int r=0; r<4; r++)
+        {
+            // Row r is rotated left by r columns (right for the inverse)
+            unsigned int src = (4 * (inverse ? c + 4 - r : c + r) + r) & 15;
+            col ^= rotl32(table[stateByte(lo, hi, src)], 8 * r);
+        }
+        result |= (uint64_t)col << (32 * c);
+    }
+    return result;
+}
+
+static uint64_t aes64esPortable(uint64_t lo, uint64_t hi)
+{
+    return aesColumns<false>(RVCrypto::byteTables.t[RVCrypto::AES_ENC], lo, hi);
+}
+
+static uint64_t aes64esmPortable(uint64_t lo, uint64_t hi)
+{
+    return aesColumns<false>(RVCrypto::byteTables.t[RVCrypto::AES_ENC_MIX], lo, hi);
+}
+
+static uint64_t aes64dsPortable(uint64_t lo, uint64_t hi)
+{
+    return aesColumns<true>(RVCrypto::byteTables.t[RVCrypto::AES_DEC], lo, hi);
+}
+
+static uint64_t aes64dsmPortable(uint64_t lo, uint64_t hi)
+{
+    return aesColumns<true>(RVCrypto::byteTables.t[RVCrypto::AES_DEC_MIX], lo, hi);
+}
+
+static uint64_t aes64imPortable(uint64_t x)
+{
+    // Rows are not shifted when only the two columns of x take part
+    const uint32_t * table = RVCrypto::byteTables.t[RVCrypto::AES_IMC];
+    uint64_t result = 0;
+    for(unsigned int c=0; c<2; c++)
+    {
+        uint32_t col = 0;
+        for(unsigned int r=0; r<4; r++)
+            col ^= rotl32(table[(x >> (32 * c + 8 * r)) & 0xff], 8 * r);
+        result |= (uint64_t)col << (32 * c);
+    }
+    return result;
+}
+
+static uint64_t aes64ks1iPortable(uint64_t x, unsigned int rnum)
+{
+    const uint32_t * sbox = RVCrypto::byteTables.t[RVCrypto::AES_ENC];
+    uint32_t w = x >> 32;
+    if(rnum != 10)
+        w = rotl32(w, 24);
+    w = sbox[w & 0xff] | (sbox[(w >> 8) & 0xff] << 8) | (sbox[(w >> 16) & 0xff] << 16) | (sbox[w >> 24] << 24);
+    w ^= aesRcon[rnum];
+    return ((uint64_t)w << 32) | w;
+}
+
+// =================================== x86-64 =====================================
+#ifdef RVCRYPTO_X86
+// AES-NI rounds end with AddRoundKey, a zero key leaves the state as is
+__attribute__((target("aes")))
+static uint64_t aes64esHost(uint64_t lo, uint64_t hi)
+{
+    return _mm_cvtsi128_si64(_mm_aesenclast_si128(_mm_set_epi64x(hi, lo), _mm_setzero_si128()));
+}
+
+__attribute__((target("aes")))
+static uint64_t aes64esmHost(uint64_t lo, uint64_t hi)
+{
+    return _mm_cvtsi128_si64(_mm_aesenc_si128(_mm_set_epi64x(hi, lo), _mm_setzero_si128()));
+}
+
+__attribute__((target("aes")))
+static uint64_t aes64dsHost(uint64_t lo, uint64_t hi)
+{
+    return _mm_cvtsi128_si64(_mm_aesdeclast_si128(_mm_set_epi64x(hi, lo), _mm_setzero_si128()));
+}
+
+__attribute__((target("aes")))
+static uint64_t aes64dsmHost(uint64_t lo, uint64_t hi)
+{
+    return _mm_cvtsi128_si64(_mm_aesdec_si128(_mm_set_epi64x(hi, lo), _mm_setzero_si128()));
+}
+
+__attribute__((target("aes")))
+static uint64_t aes64imHost(uint64_t x)
+{
+    return _mm_cvtsi128_si64(_mm_aesimc_si128(_mm_cvtsi64_si128(x)));
+}
+
+__attribute__((target("aes")))
+static uint64_t aes64ks1iHost(uint64_t x, unsigned int rnum)
+{
+    // Word 0 is SubWord of word 1 of x, word 1 is the same word rotated
+    uint64_t assist = _mm_cvtsi128_si64(_mm_aeskeygenassist_si128(_mm_cvtsi64_si128(x), 0));
+    uint32_t w = (rnum == 10 ? (uint32_t)assist : (uint32_t)(assist >> 32)) ^ aesRcon[rnum];
+    return ((uint64_t)w << 32) | w;
+}
+#endif
+
+
+/**
+ * @brief Detect features of the host CPU
+ */
+static RVCrypto::HostFeatures detectFeatures()
+{
+    RVCrypto::HostFeatures f = {false};
+#ifdef RVCRYPTO_X86
+    unsigned int eax, ebx, ecx, edx;
+    if(__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        f.aesni = (ecx >> 25) & 1;
+#endif
+    return f;
+}
+
+static const RVCrypto::HostFeatures features = detectFeatures();
+
+
+/**
+ * @brief Get features of the host CPU (detected at startup)
+ */
+const RVCrypto::HostFeatures & RVCrypto::hostFeatures()
+{
+    return features;
+}
+
+
+// Implementations are selected once, at static initialization
+#ifdef RVCRYPTO_X86
+uint64_t (*RVCrypto::aes64es)(uint64_t, uint64_t) = features.aesni ? aes64esHost : aes64esPortable;
+uint64_t (*RVCrypto::aes64esm)(uint64_t, uint64_t) = features.aesni ? aes64esmHost : aes64esmPortable;
+uint64_t (*RVCrypto::aes64ds)(uint64_t, uint64_t) = features.aesni ? aes64dsHost : aes64dsPortable;
+uint64_t (*RVCrypto::aes64dsm)(uint64_t, uint64_t) = features.aesni ? aes64dsmHost : aes64dsmPortable;
+uint64_t (*RVCrypto::aes64im)(uint64_t) = features.aesni ? aes64imHost : aes64imPortable;
+uint64_t (*RVCrypto::aes64ks1i)(uint64_t, unsigned int) = features.aesni ? aes64ks1iHost : aes64ks1iPortable;
+#else
+uint64_t (*RVCrypto::aes64es)(uint64_t, uint64_t) = aes64esPortable;
+uint64_t (*RVCrypto::aes64esm)(uint64_t, uint64_t) = aes64esmPortable;
+uint64_t (*RVCrypto::aes64ds)(uint64_t, uint64_t) = aes64dsPortable;
+uint64_t (*RVCrypto::aes64dsm)(uint64_t, uint64_t) = aes64dsmPortable;
+uint64_t (*RVCrypto::aes64im)(uint64_t) = aes64imPortable;
+uint64_t (*RVCrypto::aes64ks1i)(uint64_t, unsigned int) = aes64ks1iPortable;
+#endif
+
+
+/**
+ * @brief Use the lookup tables whatever the host supports
+ */
+void RVCrypto::usePortable()
+{
+    aes64es = aes64esPortable;
+    aes64esm = aes64esmPortable;
+    aes64ds = aes64dsPortable;
+    aes64dsm = aes64dsmPortable;
+    aes64im = aes64imPortable;
+    aes64ks1i = aes64ks1iPortable;
+}
@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "RVDisasm.h"
+#include "RVInstr.h"
+#include "RVCompressed.h"
+#include "RVdefs.h"
+
+/**
+ * @brief ABI register names
+ */
+static const char * reg_names[32] =
+{
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+    "s0", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+};
+
+/**
+ * @brief ABI floating point register names
+ */
+static const char * freg_names[32] =
+{
+    "ft0", "ft1", "ft2", "ft3", "ft4", "ft5", "ft6", "ft7",
+    "fs0", "fs1", "fa0", "fa1", "fa2", "fa3", "fa4", "fa5",
+    "fa6", "fa7", "fs2", "fs3", "fs4", "fs5", "fs6", "fs7",
+    "fs8", "fs9", "fs10", "fs11", "ft8", "ft9", "ft10", "ft11"
+};
+
+/**
+ * @brief Vector register names
+ */
+static const char * vreg_names[32] =
+{
+    "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7",
+    "v8", "v9", "v10", "v11", "v12", "v13", "v14", "v15",
+    "v16", "v17", "v18", "v19", "v20", "v21", "v22", "v23",
+    "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31"
+};
+
+/**
+ * @brief Rounding mode suffixes
+ */
+static const char * rm_names[8] = {"rne", "rtz", "rdn", "rup", "rmm", "?", "?", "dyn"};
+
+/**
+ * @brief Named CSRs
+ */
+struct CSRName
+{
+    uint16_t addr;
+    const char * name;
+};
+
+static const CSRName csr_names[] =
+{
+    {CSR::FFLAGS,           "fflags"},
+    {CSR::FRM,              "frm"},
+    {CSR::FCSR,             "fcsr"},
+    {CSR::VSTART,           "vstart"},
+    {CSR::VXSAT,            "vxsat"},
+    {CSR::VXRM,             "vxrm"},
+    {CSR::VCSR,             "vcsr"},
+    {CSR::VL,               "vl"},
+    {CSR::VTYPE,            "vtype"},
+    {CSR::VLENB,            "vlenb"},
+    {CSR::SSTATUS,          "sstatus"},
+    {CSR::SIE,              "sie"},
+    {CSR::STVEC,            "stvec"},
+    {CSR::SCOUNTEREN,       "scounteren"},
+    {CSR::SSCRATCH,         "sscratch"},
+    {CSR::SEPC,             "sepc"},
+    {CSR::SCAUSE,           "scause"},
+    {CSR::STVAL,            "stval"},
+    {CSR::SIP,              "sip"},
+    {CSR::SATP,             "satp"},
+    {CSR::MVENDORID,        "mvendorid"},
+    {CSR::MARCHID,          "marchid"},
+    {CSR::MIMPID,           "mimpid"},
+    {CSR::MHARTID,          "mhartid"},
+    {CSR::MSTATUS,          "mstatus"},
+    {CSR::MISA,             "misa"},
+    {CSR::MEDELEG,          "medeleg"},
+    {CSR::MIDELEG,          "mideleg"},
+    {CSR::MIE,              "mie"},
+    {CSR::MTVEC,            "mtvec"},
+    {CSR::MCOUNTEREN,       "mcounteren"},
+    {CSR::MSTATUSH,         "mstatush"},
+    {CSR::MSCRATCH,         "mscratch"},
+    {CSR::MEPC,             "mepc"},
+    {CSR::MCAUSE,           "mcause"},
+    {CSR::MTVAL,            "mtval"},
+    {CSR::MIP,              "mip"},
+    {CSR::MCOUNTINHIBIT,    "mcountinhibit"},
+    {CSR::MCYCLE,           "mcycle"},
+    {CSR::MINSTRET,         "minstret"},
+    {CSR::MCYCLEH,          "mcycleh"},
+    {CSR::MINSTRETH,        "minstreth"},
+    {CSR::CYCLE,            "cycle"},
+    {CSR::TIME,             "time"},
+    {CSR::INSTRET,          "instret"},
+    {CSR::CYCLEH,           "cycleh"},
+    {CSR::CYCLEH + 1,       "timeh"},
+    {CSR::CYCLEH + 2,       "instreth"},
+};
+
+
+/**
+ * @brief Get ABI name of an integer register
+ * 
+ * @param reg register number
+ * @return const char* ABI name
+ */
+const char * RVDisasm::regName(unsigned int reg)
+{
+    return reg < 32 ? reg_names[reg] : "?";
+}
+
+
+/**
+ * @brief Get ABI name of a floating point register
+ * 
+ * @param reg register number
+ * @return const char* ABI name
+ */
+const char * RVDisasm::fregName(unsigned int reg)
+{
+    return reg < 32 ? freg_names[reg] : "?";
+}
+
+
+/**
+ * @brief Get name of a vector register
+ * 
+ * @param reg register number
+ * @return const char* name (v0-v31)
+ */
+const char * RVDisasm::vregName(unsigned int reg)
+{
+    return reg < 32 ? vreg_names[reg] : "?";
+}
+
+
+/**
+ * @brief Format a vtype value as in vsetvli (e.g. "e32, m1, ta, ma")
+ * 
+ * @param vtype vtype value
+ * @return std::string formatted type
+ */
+std::string RVDisasm::vtypeName(uint64_t vtype)
+{
+    static const char * const lmul_names[8] = {"m1", "m2", "m4", "m8", "?", "mf8", "mf4", "mf2"};
+    unsigned int sew = (vtype >> 3) & 0x7;
+    if((vtype >> 8) != 0 || sew > 3)
+    {
+        char buf[24];
+        sprintf(buf, "0x%llx", (unsigned long long)vtype);
+        return buf;
+    }
+
+    return "e" + std::to_string(8 << sew) + ", " + lmul_names[vtype & 0x7] +
+        ((vtype >> 6) & 1 ? ", ta" : ", tu") + ((vtype >> 7) & 1 ? ", ma" : ", mu");
+}
+
+
+/**
+ * @brief Get name of a CSR
+ * 
+ * @param addr csr address
+ * @return std::string name, or hex address if unknown
+ */
+std::string RVDisasm::csrName(uint16_t addr)
+{
+    for(unsigned int i=0; i<sizeof(csr_names)/sizeof(csr_names[0]); i++)
+    {
+        if(csr_names[i].addr == addr)
+            return csr_names[i].name;
+    }
+
+    // Numbered counter CSRs
+    unsigned int n = addr & 0x1f;
+    if(n >= 3)
+    {
+        if(addr >= CSR::MHPMEVENT3 && addr <= CSR::MHPMEVENT31)
+            return "mhpmevent" + std::to_string(n);
+        if(addr >= CSR::MHPMCOUNTER3 && addr <= CSR::MHPMCOUNTER31)
+            return "mhpmcounter" + std::to_string(n);
+        if(addr >= CSR::MHPMCOUNTER3H && addr <= CSR::MHPMCOUNTER31H)
+            return "mhpmcounter" + std::to_string(n) + "h";
+        if(addr >= CSR::CYCLE + 3 && addr <= CSR::HPMCOUNTER31)
+            return "hpmcounter" + std::to_string(n);
+        if(addr >= CSR::CYCLEH + 3 && addr <= CSR::HPMCOUNTER31H)
+            return "hpmcounter" + std::to_string(n) + "h";
+    }
+
+    char buf[8];
+    sprintf(buf, "0x%03x", addr);
+    return buf;
+}
+
+
+/**
+ * @brief Format fence predecessor/successor set
+ */
+static std::string fenceSet(unsigned int bits)
+{
+    std::string s;
+    if(bits & 8) s += 'i';
+    if(bits & 4) s += 'o';
+    if(bits & 2) s += 'r';
+    if(bits & 1) s += 'w';
+    return s;
+}
+
+
+/**
+ * @brief Disassemble an instruction
+ * 
+ * @param raw raw instruction (16-bit if compressed)
+ * @param pc instruction address (used to resolve branch & jump targets)
+ * @return std::string disassembly
+ */
+std::string RVDisasm::disassemble(uint32_t raw, uint64_t pc)
+{
+    char buf[80];
+
+    // Compressed instructions are shown as the instructions they expand to
+    if(RVCompressed::isCompressed(raw))
+    {
+        uint32_t full = RVCompressed::expand(raw);
+        if(!full)
+        {
+            sprintf(buf, "unknown 0x%04x", raw & 0xffff);
+            return buf;
+        }
+        raw = full;
+    }
+
+    const InstrDesc * d = findInstr(raw);
+    if(!d)
+    {
+        sprintf(buf, "unknown 0x%08x", raw);
+        return buf;
+    }
+
+    const char * rd = (d->flags & F_VRD ? vregName : d->flags & F_FRD ? fregName : regName)((raw >> 7) & 0x1f);
+    const char * rs1 = (d->flags & F_VRS1 ? vregName : d->flags & F_FRS1 ? fregName : regName)((raw >> 15) & 0x1f);
+    const char * rs2 = (d->flags & F_VRS2 ? vregName : d->flags & F_FRS2 ? fregName : regName)((raw >> 20) & 0x1f);
+    int32_t imm_i = (int32_t)raw >> 20;
+    int32_t simm5 = ((int32_t)raw << 12) >> 27;
+    uint64_t mask = XLEN == 32 ? 0xffffffffULL : ~0ULL;
+
+    switch(d->fmt)
+    {
+        case FMT_R:
+            sprintf(buf, "%s %s, %s, %s", d->name, rd, rs1, rs2);
+            break;
+        case FMT_R1:
+            sprintf(buf, "%s %s, %s", d->name, rd, rs1);
+            break;
+        case FMT_RR:
+            sprintf(buf, "%s %s, %s", d->name, rs1, rs2);
+            break;
+        case FMT_R4:
+            sprintf(buf, "%s %s, %s, %s, %s", d->name, rd, rs1, rs2, fregName(raw >> 27));
+            break;
+        case FMT_RBS:
+            sprintf(buf, "%s %s, %s, %s, %u", d->name, rd, rs1, rs2, raw >> 30);
+            break;
+        case FMT_RNUM:
+            sprintf(buf, "%s %s, %s, %u", d->name, rd, rs1, (raw >> 20) & 0xf);
+            break;
+        case FMT_I:
+            sprintf(buf, "%s %s, %s, %d", d->name, rd, rs1, imm_i);
+            break;
+        case FMT_IM:
+            sprintf(buf, "%s %s, %d(%s)", d->name, rd, imm_i, rs1);
+            break;
+        case FMT_S:
+        {
+            int32_t imm = (((int32_t)raw >> 25) << 5) | ((raw >> 7) & 0x1f);
+            sprintf(buf, "%s %s, %d(%s)", d->name, rs2, imm, rs1);
+            break;
+        }
+        case FMT_B:
+        {
+            int32_t imm = (((int32_t)raw >> 31) << 12) | ((raw << 4) & 0x800) | ((raw >> 20) & 0x7e0) | ((raw >> 7) & 0x1e);
+            sprintf(buf, "%s %s, %s, 0x%llx", d->name, rs1, rs2, (unsigned long long)((pc + imm) & mask));
+            break;
+        }
+        case FMT_U:
+            sprintf(buf, "%s %s, 0x%x", d->name, rd, raw >> 12);
+            break;
+        case FMT_J:
+        {
+            int32_t imm = (((int32_t)raw >> 31) << 20) | (raw & 0xff000) | ((raw >> 9) & 0x800) | ((raw >> 20) & 0x7fe);
+            sprintf(buf, "%s %s, 0x%llx", d->name, rd, (unsigned long long)((pc + imm) & mask));
+            break;
+        }
+        case FMT_SHAMT:
+            sprintf(buf, "%s %s, %s, %u", d->name, rd, rs1, (raw >> 20) & 0x3f);
+            break;
+        case FMT_CSR:
+            sprintf(buf, "%s %s, %s, %s", d->name, rd, csrName(raw >> 20).c_str(), rs1);
+            break;
+        case FMT_CSRI:
+            sprintf(buf, "%s %s, %s, %u", d->name, rd, csrName(raw >> 20).c_str(), (raw >> 15) & 0x1f);
+            break;
+        case FMT_AMO:
+        {
+            // Ordering suffix from the aq & rl bits
+            static const char * const order[] = {"", ".rl", ".aq", ".aqrl"};
+            std::string name = std::string(d->name) + order[(raw >> 25) & 0x3];
+            if(strncmp(d->name, "lr.", 3) == 0)
+                sprintf(buf, "%s %s, (%s)", name.c_str(), rd, rs1);
+            else
+                sprintf(buf, "%s %s, %s, (%s)", name.c_str(), rd, rs2, rs1);
+            break;
+        }
+        case FMT_FENCE:
+            sprintf(buf, "%s %s, %s", d->name, fenceSet((raw >> 24) & 0xf).c_str(), fenceSet((raw >> 20) & 0xf).c_str());
+            break;
+        case FMT_VV:
+            sprintf(buf, "%s %s, %s, %s", d->name, rd, rs2, rs1);
+            break;
+        case FMT_VI:
+            sprintf(buf, "%s %s, %s, %d", d->name, rd, rs2, simm5);
+            break;
+        case FMT_VIU:
+            sprintf(buf, "%s %s, %s, %u", d->name, rd, rs2, (raw >> 15) & 0x1f);
+            break;
+        case FMT_VR2:
+            sprintf(buf, "%s %s, %s", d->name, rd, rs2);
+            break;
+        case FMT_VI1:
+            sprintf(buf, "%s %s, %d", d->name, rd, simm5);
+            break;
+        case FMT_VD:
+            sprintf(buf, "%s %s", d->name, rd);
+            break;
+        case FMT_VL:
+            sprintf(buf, "%s %s, (%s)", d->name, rd, rs1);
+            break;
+        case FMT_VLS:
+            sprintf(buf, "%s %s, (%s), %s", d->name, rd, rs1, rs2);
+            break;
+        case FMT_VSETVLI:
+            sprintf(buf, "%s %s, %s, %s", d->name, rd, rs1, vtypeName((raw >> 20) & 0x7ff).c_str());
+            break;
+        case FMT_VSETIVLI:
+            sprintf(buf, "%s %s, %u, %s", d->name, rd, (raw >> 15) & 0x1f, vtypeName((raw >> 20) & 0x3ff).c_str());
+            break;
+        case FMT_NONE:
+            sprintf(buf, "%s", d->name);
+            break;
+    }
+
+    // Vector mask operand, optional (vm bit decoded) or required (vm = 0
+    // matched), configuration instructions have no vm bit
+    if(d->ext == EXT_V && (d->match & 0x707f) != 0x7057)
+    {
+        if(!(d->mask & (1 << 25)) && !((raw >> 25) & 1))
+            return std::string(buf) + ", v0.t";
+        if((d->mask & (1 << 25)) && !((d->match >> 25) & 1))
+            return std::string(buf) + ", v0";
+    }
+
+    // Static rounding mode of floating point instructions
+    unsigned int rm = (raw >> 12) & 0x7;
+    if((d->ext == EXT_F || d->ext == EXT_D) && !(d->mask & 0x7000) && rm != RM_DYN)
+        return std::string(buf) + ", " + rm_names[rm];
+    return buf;
+}
@@ -0,0 +1,39 @@
+#include <cfenv>
+
+#include "RVFloat.h"
+
+/**
+ * @brief Get exception flags raised in the host FPU (as fflags bits)
+ */
+uint32_t RVFloat::hostFlags()
+{
+    int ex = fetestexcept(FE_ALL_EXCEPT);
+    uint32_t flags = 0;
+    if(ex & FE_INEXACT)     flags |= FFLAG_NX;
+    if(ex & FE_UNDERFLOW)   flags |= FFLAG_UF;
+    if(ex & FE_OVERFLOW)    flags |= FFLAG_OF;
+    if(ex & FE_DIVBYZERO)   flags |= FFLAG_DZ;
+    if(ex & FE_INVALID)     flags |= FFLAG_NV;
+    return flags;
+}
+
+
+/**
+ * @brief Clear host FPU exception flags
+ */
+void RVFloat::clearHostFlags()
+{
+    feclearexcept(FE_ALL_EXCEPT);
+}
+
+
+/**
+ * @brief Set host FPU rounding mode
+ * 
+ * @param rm RoundingMode (RM_RNE - RM_RUP)
+ */
+void RVFloat::setHostRounding(unsigned int rm)
+{
+    static const int host_modes[] = {FE_TONEAREST, FE_TOWARDZERO, FE_DOWNWARD, FE_UPWARD};
+    fesetround(host_modes[rm & 3]);
+}
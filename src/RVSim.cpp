@@ -1,8 +1,12 @@
 #include <iostream>
 #include <string>
+#include <chrono>
+#include <algorithm>
 #include <stdint.h>
+#include <unistd.h>
 
 #include "cxxopts.hpp"
+#include "elfio.hpp"
 
 #include "SimInfo.h"
 #include "Util.h"
@@ -11,6 +15,21 @@
 #include "Bus.h"
 #include "Memory.h"
 #include "RVCPU.h"
+#include "SimStats.h"
+#include "RVDisasm.h"
+#include "RVCompressed.h"
+#include "GDBStub.h"
+#include "History.h"
+#include "CheckpointFile.h"
+#include "ForkRunner.h"
+#include "BBVProfiler.h"
+#include "SampledSim.h"
+#include "HartGroup.h"
+#include "BatchRunner.h"
+#include "Signature.h"
+#include "RVBitmanip.h"
+#include "RVVector.h"
+#include "RVCrypto.h"
 
 // ============ Global variables ==============
 // Flags
@@ -19,30 +38,124 @@ bool debug_mode;
 
 unsigned long int maxitr;
 unsigned long int mem_size;
+unsigned int vlen;
+bool portable_code;
 
 std::string ifile = "";
 std::string signature_file = "";
+std::string stats_file = "";
+std::string gdb_endpoint = "";
+std::string save_checkpoint = "";
+std::string restore_checkpoint = "";
+bool dense_checkpoint;
 
+std::string fork_inputs = "";
+std::string fork_at = "";
+std::string fork_input_addr = "";
+unsigned int fork_jobs;
+
+std::string batch_list = "";
+std::string compliance_dir = "";
+unsigned int batch_jobs;
+
+std::string bbv_file = "";
+std::string simpoints_file = "";
+std::string simpoint_weights = "";
+unsigned long int bbv_interval;
+unsigned long int simpoint_warmup;
+
+bool reverse_debug;
+unsigned long int reverse_interval;
+unsigned long int reverse_budget;
+
+unsigned long int heartbeat_interval;
+
+unsigned int nharts;
+unsigned long int hart_quantum;
+bool deterministic_harts;
+
+// Host timing
+std::chrono::steady_clock::time_point sim_start_time;
+double elf_load_time;
 
 
 // Object pointers
 Bus<REG> * bus;
 Memory * mem;
 RVCPU * cpu;
+std::vector<RVCPU *> harts;     // harts[0] == cpu
+History * history = NULL;
+
+// Disassembly of executable segments
+Util::DisassemblyTable disasm_table;
+
+/**
+ * @brief Collect run statistics
+ * 
+ * @param status exit status
+ * @return SimStats statistics
+ */
+SimStats collect_stats(int status)
+{
+    SimStats s;
+    s.input = ifile;
+    s.exit_status = status;
+    s.halted = cpu->isHalted();
+    s.instret = 0;
+    for(size_t i=0; i<harts.size(); i++)
+        s.instret += harts[i]->getInstret();
+    s.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - sim_start_time).count();
+    s.elf_load_time = elf_load_time;
+    s.pages_touched = mem->pagesTouched();
+    s.page_size = sysconf(_SC_PAGESIZE);
+    s.cpu = cpu->getStats();
+    for(size_t i=1; i<harts.size(); i++)
+    {
+        const CPUStats &hs = harts[i]->getStats();
+        s.cpu.blockHits += hs.blockHits;
+        s.cpu.blockMisses += hs.blockMisses;
+        s.cpu.cacheFlushes += hs.cacheFlushes;
+        s.cpu.pageWalks += hs.pageWalks;
+        for(unsigned int c=0; c<CAUSE_COUNT; c++)
+            s.cpu.traps[c] += hs.traps[c];
+    }
+    return s;
+}
 
 /** 
- * @brief Exit simulator
+ * @brief Dump results & tear down the simulated system when exiting
+ * (SimError::Exit handler)
  */
-void SimError::Exit(int status)
+void sim_exit(int status)
 {
+    if(signature_file != "" && cpu && mem && ifile != "")
+    {
+        Signature sig;
+        std::string err = sig.read(ifile, mem);
+        if(err != "")
+            std::cerr << "Failed to dump signature: " << err << std::endl;
+        else if(!sig.write(signature_file))
+            std::cerr << "Failed to write signature file " << signature_file << std::endl;
+    }
+
+    if(stats_file != "" && cpu && mem)
+    {
+        try
+        {
+            collect_stats(status).write(stats_file);
+        }
+        catch(const char * e)
+        {
+            std::cerr << "Failed to write stats file " << stats_file << ": " << e << std::endl;
+        }
+    }
+
     if(bus)
         bus->~Bus();
     if(mem)
         mem->~Memory();
     if(cpu)
         cpu->~RVCPU();
-
-    exit(status);
 }
 
 /**
@@ -67,18 +180,44 @@ void parse_commandline_args(int argc, char**argv, std::string &infile)
 		options.add_options("General")
 		("h,help", "Show this message")
 		("version", "Show version information")
-		("i,input", "Specify an input file", cxxopts::value<std::string>(infile));
+		("i,input", "Specify an input file", cxxopts::value<std::string>(infile))
+		("batch", "Run every ELF file listed (one per line) in its own simulator, in parallel", cxxopts::value<std::string>(batch_list)->default_value(""))
+		("j,jobs", "Number of threads for batch runs (0: number of CPUs)", cxxopts::value<unsigned int>(batch_jobs)->default_value("0"));
 		
 		options.add_options("Config")
 		("maxitr", "Specify maximum simulation iterations", cxxopts::value<unsigned long int>(maxitr)->default_value(std::to_string(100000)))
 		("memsize", "Specify size of memory to simulate", cxxopts::value<unsigned long int>(mem_size)->default_value(std::to_string(65536)))
+		("vlen", "Vector register length in bits (128, 256 or 512)", cxxopts::value<unsigned int>(vlen)->default_value("128"))
+		("portable", "Run bit manipulation, vector & crypto instructions with portable code instead of host CPU features", cxxopts::value<bool>(portable_code)->default_value("false"))
+		("stats-file", "Write run statistics at exit (JSON, or CSV if the filename ends with .csv)", cxxopts::value<std::string>(stats_file)->default_value(""))
+		("heartbeat", "Print a progress line every N seconds of host time (0: off)", cxxopts::value<unsigned long int>(heartbeat_interval)->default_value("0"))
+		("harts", "Number of harts sharing memory, each simulated on its own host thread", cxxopts::value<unsigned int>(nharts)->default_value("1"))
+		("quantum", "Instructions each hart runs between synchronizations", cxxopts::value<unsigned long int>(hart_quantum)->default_value("10000"))
+		("deterministic", "Run harts in turn on one host thread for reproducible runs", cxxopts::value<bool>(deterministic_harts)->default_value("false"))
+		("save-checkpoint", "Save a checkpoint of the simulator when the run ends", cxxopts::value<std::string>(save_checkpoint)->default_value(""))
+		("restore-checkpoint", "Start from a checkpoint instead of loading an ELF file", cxxopts::value<std::string>(restore_checkpoint)->default_value(""))
+		("dense-checkpoint", "Store all memory pages in saved checkpoints, not only non-zero ones", cxxopts::value<bool>(dense_checkpoint)->default_value("false"))
+		("fork-inputs", "Boot to the fork point once, then run one forked test per input file listed", cxxopts::value<std::string>(fork_inputs)->default_value(""))
+		("fork-at", "Fork point: \"marker\" (write to CSR 0x8c0), a symbol or an address", cxxopts::value<std::string>(fork_at)->default_value("marker"))
+		("fork-input-addr", "Symbol or address test inputs are loaded at", cxxopts::value<std::string>(fork_input_addr)->default_value("test_input"))
+		("fork-jobs", "Maximum number of forked tests running at once (0: number of CPUs)", cxxopts::value<unsigned int>(fork_jobs)->default_value("0"))
+		("bbv", "Write SimPoint basic block vectors to file", cxxopts::value<std::string>(bbv_file)->default_value(""))
+		("bbv-interval", "Instructions per basic block vector / simpoint interval", cxxopts::value<unsigned long int>(bbv_interval)->default_value("10000000"))
+		("simpoints", "Sampled simulation of the intervals listed in a SimPoint simpoints file", cxxopts::value<std::string>(simpoints_file)->default_value(""))
+		("simpoint-weights", "SimPoint weights file for sampled simulation", cxxopts::value<std::string>(simpoint_weights)->default_value(""))
+		("simpoint-warmup", "Instructions of cache model warm up before each simpoint", cxxopts::value<unsigned long int>(simpoint_warmup)->default_value("1000000"))
 		//("uart-broadcast", "enable uart broadcasting over", cxxopts::value<unsigned long int>(mem_size)->default_value(std::to_string(default_mem_size)))
 		;
 
 		options.add_options("Debug")
 		("v,verbose", "Turn on verbose output", cxxopts::value<bool>(verbose_flag)->default_value("false"))
 		("d,debug", "Start in debug mode", cxxopts::value<bool>(debug_mode)->default_value("false"))
-		("signature", "Enable signature sump at hault (Used for riscv compliance tests)", cxxopts::value<std::string>(signature_file)->default_value(""))
+		("gdb", "Wait for a GDB connection on a TCP port (loopback) or unix:<path>", cxxopts::value<std::string>(gdb_endpoint)->default_value(""))
+		("reverse", "Record execution history for reverse debugging", cxxopts::value<bool>(reverse_debug)->default_value("false"))
+		("reverse-interval", "Instructions between reverse debugging checkpoints", cxxopts::value<unsigned long int>(reverse_interval)->default_value("1000000"))
+		("reverse-budget", "Memory budget for reverse debugging checkpoints in MiB", cxxopts::value<unsigned long int>(reverse_budget)->default_value("256"))
+		("signature", "Dump the signature (begin_signature to end_signature) to a file at exit, or to a directory in batch & compliance runs", cxxopts::value<std::string>(signature_file)->default_value(""))
+		("compliance", "Run all compliance tests (ELF files with reference signatures) under a directory in parallel", cxxopts::value<std::string>(compliance_dir)->default_value(""))
 		;
 
 
@@ -111,7 +250,7 @@ void parse_commandline_args(int argc, char**argv, std::string &infile)
 		{
 			SimError::throwError("Multiple input files specified", true);
 		}
-		if (result.count("input")==0)
+		if (result.count("input")==0 && restore_checkpoint == "" && batch_list == "" && compliance_dir == "")
 		{
 			SimError::throwError("No input files specified", true);
 		}
@@ -128,78 +267,269 @@ void parse_commandline_args(int argc, char**argv, std::string &infile)
 
 
 
-// Implement Bus
-template <class REG>
-REG Bus<REG>::request(REG address, REG data, int sel, bool write) 
+/**
+ * @brief Create disassembly table covering all executable segments
+ */
+void init_disasm_table()
 {
-    if(write)
+    for(unsigned int i=0; i<mem->segments.size(); i++)
     {
-        if(sel & 0b0001)
-            mem->store(address, (uint8_t)(data & 0x000000ff));
-        
-        if(sel & 0b0010)
-            mem->store(address+1, (uint8_t)(data & 0x0000ff00)>>8);
-
-        if(sel & 0b0100)
-            mem->store(address+2, (uint8_t)(data & 0x00ff0000)>>16);
-
-        if(sel & 0b1000)
-            mem->store(address+3, (uint8_t)(data & 0xff000000)>>24);
-
-        return 0;
+        if(mem->segments[i].flags & PF_X)
+            disasm_table.addSegment(mem->segments[i].addr, mem->segments[i].size);
     }
+}
+
+/**
+ * @brief Get disassembly of the instruction in memory at an address
+ * 
+ * @param pc address
+ * @param len instruction length in bytes (optional)
+ * @return std::string raw instruction & disassembly
+ */
+std::string get_disassembly(REG pc, unsigned int * len = NULL)
+{
+    if(len)
+        *len = 2;
+    if(!mem->isValidAddress(pc) || !mem->isValidAddress(pc + 1))
+        return "<invalid address>";
+
+    char buf[16];
+    uint32_t raw = (uint16_t)bus->request(pc, 0, 0b11, false);
+    if(RVCompressed::isCompressed(raw))
+        sprintf(buf, "%8.4x  ", raw);
     else
     {
-        REG rdata = 0;
+        if(!mem->isValidAddress(pc + 3))
+            return "<invalid address>";
+        raw |= (uint32_t)bus->request(pc + 2, 0, 0b11, false) << 16;
+        sprintf(buf, "%08x  ", raw);
+        if(len)
+            *len = 4;
+    }
+    return buf + disasm_table.text(pc, raw);
+}
 
-        if(sel & 0b0001)
-            rdata |= (REG) mem->fetch(address);
-        
-        if(sel & 0b0010)
-            rdata |= ((REG) mem->fetch(address+1)) << 8;
+/**
+ * @brief Resolve an address given as a number or a symbol of the input file
+ * 
+ * @param str address or symbol name
+ * @return REG address
+ */
+REG resolve_address(std::string str)
+{
+    if(str.size() > 0 && isdigit(str[0]))
+        return (REG)std::stoull(str, 0, 0);
 
-        if(sel & 0b0100)
-            rdata |= ((REG) mem->fetch(address+2)) << 16;
+    uint64_t addr = 0;
+    if(ifile == "" || !Util::getSymbolAddress(ifile, str, addr))
+        SimError::throwError("Unknown symbol \"" + str + "\"", true);
+    return (REG)addr;
+}
 
-        if(sel & 0b1000)
-            rdata |= ((REG) mem->fetch(address+3)) << 24;
+/**
+ * @brief Get name of a watchpoint type
+ */
+const char * watch_type_name(int type)
+{
+    return type == WATCH_WRITE ? "write" : (type == WATCH_READ ? "read" : "access");
+}
 
-        return rdata;
+/**
+ * @brief Run simulation, tracing every instruction in verbose mode
+ * 
+ * @param ticks number of instructions
+ */
+void run_sim(unsigned long int ticks)
+{
+    if(!verbose_flag)
+    {
+        cpu->run(ticks);
+        return;
     }
-}
 
+    bool first = true;
+    while(ticks > 0 && !cpu->isHalted())
+    {
+        REG pc = cpu->getPCValue();
+        if(!first && cpu->hasBreakpoint(pc))
+            break;
+        printf("0x%08llx: %s\n", (unsigned long long)pc, get_disassembly(pc).c_str());
+        cpu->step();
+        ticks--;
+        first = false;
+        if(cpu->getStopReason() == STOP_WATCHPOINT || cpu->getStopReason() == STOP_MARKER)
+            break;
+    }
+}
 
 
 int main(int argc, char ** argv)
 {
+    SimError::setExitHandler(sim_exit);
+
     // Parse CLI Arguments
     parse_commandline_args(argc, argv, ifile);
+    if(portable_code)
+    {
+        RVBitmanip::usePortable();
+        RVVector::usePortable();
+        RVCrypto::usePortable();
+    }
 
-    // Create memory object
-    mem = new Memory(65536);
-
-    // Create a new RVCPU object
     ISAdef cpu_isa_definition = 
     {
         false, // ISA_EMBEDDED
-        false, // ISA_M
-        false, // ISA_A
-        false, // ISA_F
-        false, // ISA_D
-        false  // ISA_C
+        true,  // ISA_M
+        true,  // ISA_A
+        true,  // ISA_F
+        true,  // ISA_D
+        true,  // ISA_C
+        true,  // ISA_ZBA
+        true,  // ISA_ZBB
+        true,  // ISA_ZBC
+        true,  // ISA_ZBS
+        true,  // ISA_ZKND
+        true,  // ISA_ZKNE
+        true,  // ISA_ZKNH
+        true,  // ISA_ZKSED
+        true,  // ISA_ZKSH
+        true,  // ISA_V
+        vlen   // VLEN
     };
-    
-    cpu = new RVCPU(0x00000000, cpu_isa_definition, bus);
+
+    if(batch_list != "")
+    {
+        std::vector<std::string> elfs;
+        try
+        {
+            std::vector<std::string> lines = Util::fRead(batch_list);
+            for(unsigned int i=0; i<lines.size(); i++)
+                if(Util::strip(lines[i]) != "")
+                    elfs.push_back(Util::strip(lines[i]));
+        }
+        catch(const char * e)
+        {
+            SimError::throwError("Can't read batch list : " + batch_list, true);
+        }
+
+        BatchRunner runner(cpu_isa_definition, mem_size, maxitr, batch_jobs);
+        runner.setSignatureDir(signature_file);
+        unsigned int failed = runner.run(elfs);
+        SimError::Exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+    if(compliance_dir != "")
+    {
+        std::vector<std::string> elfs, references;
+        BatchRunner::findTests(compliance_dir, elfs, references);
+        if(elfs.empty())
+            SimError::throwError("No compliance tests found in " + compliance_dir, true);
+
+        BatchRunner runner(cpu_isa_definition, mem_size, maxitr, batch_jobs);
+        runner.setSignatureDir(signature_file);
+        unsigned int failed = runner.run(elfs, references);
+        SimError::Exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+    }
+
+    if(nharts == 0)
+        SimError::throwError("At least one hart is needed", true);
+    if(nharts > 1 && (debug_mode || gdb_endpoint != "" || reverse_debug || fork_inputs != "" || simpoints_file != "" || bbv_file != "" ||
+                      save_checkpoint != "" || restore_checkpoint != ""))
+        SimError::throwError("Multiple harts are only supported for plain runs", true);
+
+    // Create memory object & load program (all loadable segments), or map
+    // memory from a checkpoint
+    std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+    CheckpointFile * checkpoint = NULL;
+    REG entry = 0;
+    if(restore_checkpoint != "")
+    {
+        checkpoint = new CheckpointFile(restore_checkpoint);
+        mem = new Memory(checkpoint->getMemSize());
+    }
+    else
+    {
+        mem = new Memory(mem_size);
+        entry = mem->initFromElf(ifile, {PF_R|PF_X, PF_R, PF_R|PF_W, PF_R|PF_W|PF_X});
+    }
+
+    // Create bus
+    bus = new Bus<REG>(mem);
+
+    // Create a new RVCPU object
+    cpu = new RVCPU(entry, cpu_isa_definition, bus);
+    harts.push_back(cpu);
+    for(unsigned int i=1; i<nharts; i++)
+        harts.push_back(new RVCPU(entry, cpu_isa_definition, bus, i));
+    if(checkpoint)
+    {
+        checkpoint->restore(cpu, mem);
+        delete checkpoint;
+    }
+    elf_load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count();
+    init_disasm_table();
 	
+	// Record execution history for reverse debugging
+	if(reverse_debug)
+	{
+		history = new History(cpu, bus, reverse_interval, (uint64_t)reverse_budget << 20);
+	}
+
 	// Run simulation
-	if(debug_mode)
+	sim_start_time = std::chrono::steady_clock::now();
+	if(fork_inputs != "")
+	{
+		std::vector<std::string> inputs;
+		try
+		{
+			std::vector<std::string> lines = Util::fRead(fork_inputs);
+			for(unsigned int i=0; i<lines.size(); i++)
+				if(Util::strip(lines[i]) != "")
+					inputs.push_back(Util::strip(lines[i]));
+		}
+		catch(const char * e)
+		{
+			SimError::throwError("Can't read input list : " + fork_inputs, true);
+		}
+		REG input_addr = resolve_address(fork_input_addr);
+
+		// Boot to the fork point once
+		REG fork_pc = 0;
+		if(fork_at == "marker")
+			cpu->setMarkerStop(true);
+		else
+			cpu->setBreakpoint(fork_pc = resolve_address(fork_at));
+		run_sim(maxitr);
+		if(cpu->getStopReason() != STOP_MARKER && cpu->getStopReason() != STOP_BREAKPOINT)
+			SimError::throwError("Fork point \"" + fork_at + "\" not reached", true);
+		cpu->setMarkerStop(false);
+		if(fork_at != "marker")
+			cpu->clearBreakpoint(fork_pc);
+
+		ForkRunner runner(cpu, mem, input_addr, maxitr, fork_jobs);
+		unsigned int failed = runner.run(inputs);
+		SimError::Exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+	else if(gdb_endpoint != "")
+	{
+		{
+			GDBStub stub(cpu, mem, history);
+			if(!stub.listen(gdb_endpoint))
+				SimError::throwError("Unable to listen for GDB on " + gdb_endpoint, true);
+
+			std::cout << "Waiting for GDB connection on " << gdb_endpoint << "..." << std::endl;
+			stub.serve();
+		}
+		SimError::Exit(EXIT_SUCCESS);
+	}
+	else if(debug_mode)
 	{
 		std::string input;
 		while(true)
 		{
 			// Parse Input
 			std::cout << ": ";
-			getline(std::cin, input);
+			if(!getline(std::cin, input))
+				SimError::Exit(EXIT_SUCCESS);
 			
 			// Tokenize
 			std::vector<std::string> token;
@@ -215,17 +545,19 @@ int main(int argc, char ** argv)
 			else if(token[0] == "r")
 			{
 				// Run indefinitely
-				cpu->run(-1);
+				run_sim(-1);
 			}
 			else if(token[0] == "rst")
 			{
 				// Reset Simulator
 				cpu->reset();
+				if(history)
+					history->rebase();
 			}
 			else if(token[0] == "")
 			{
 				// Run for 1 cycles
-				cpu->run(1);
+				run_sim(1);
 			}
 			else if(token[0] == "for")
 			{
@@ -233,7 +565,76 @@ int main(int argc, char ** argv)
 				if(token.size()<2)
 					SimError::throwError("\"for\" command expects one argument\n");
 				else
-					cpu->run(std::stoi(token[1]));
+					run_sim(std::stoi(token[1]));
+			}
+			else if(token[0] == "rs" || token[0] == "rc")
+			{
+				// reverse step/continue
+				if(!history)
+					SimError::throwError("Reverse execution requires --reverse\n");
+				else if(!(token[0] == "rs" ? history->reverseStep() : history->reverseContinue()))
+					printf("Reached start of history at PC 0x%08x\n", (unsigned int)cpu->getPCValue());
+			}
+			else if(token[0] == "save")
+			{
+				// save checkpoint
+				if(token.size()<2)
+					SimError::throwError("\"save\" command expects a file name\n");
+				else
+					CheckpointFile::save(token[1], cpu, mem, !dense_checkpoint);
+			}
+			else if(token[0] == "dis")
+			{
+				// disassemble [count] instructions from pc or [addr]
+				unsigned long int count = token.size() > 1 ? std::stoul(token[1]) : 1;
+				REG addr = token.size() > 2 ? (REG)std::stoull(token[2], 0, 0) : cpu->getPCValue();
+				for(unsigned long int i=0; i<count; i++)
+				{
+					unsigned int len;
+					std::string text = get_disassembly(addr, &len);
+					printf("0x%08llx: %s\n", (unsigned long long)addr, text.c_str());
+					addr += len;
+				}
+			}
+			else if(token[0] == "b" || token[0] == "d")
+			{
+				// set/delete breakpoint
+				if(token.size()<2)
+					SimError::throwError("\"" + token[0] + "\" command expects an address\n");
+				else if(token[0] == "b")
+					cpu->setBreakpoint((REG)std::stoull(token[1], 0, 0));
+				else
+					cpu->clearBreakpoint((REG)std::stoull(token[1], 0, 0));
+			}
+			else if(token[0] == "watch" || token[0] == "rwatch" || token[0] == "awatch" || token[0] == "dw")
+			{
+				// set/delete watchpoint
+				int type = token[0] == "rwatch" ? WATCH_READ : (token[0] == "awatch" ? WATCH_ACCESS : WATCH_WRITE);
+				if(token.size()<2)
+					SimError::throwError("\"" + token[0] + "\" command expects an address\n");
+				else if(token[0] != "dw")
+					cpu->setWatchpoint((REG)std::stoull(token[1], 0, 0), token.size() > 2 ? (REG)std::stoull(token[2], 0, 0) : 4, type);
+				else
+				{
+					// delete all watchpoints at address
+					REG addr = (REG)std::stoull(token[1], 0, 0);
+					std::vector<Watchpoint> watches = cpu->getWatchpoints();
+					for(unsigned int i=0; i<watches.size(); i++)
+						if(watches[i].addr == addr)
+							cpu->clearWatchpoint(watches[i].addr, watches[i].len, watches[i].type);
+				}
+			}
+			else if(token[0] == "bl")
+			{
+				// list breakpoints & watchpoints
+				std::vector<REG> addrs(cpu->getBreakpoints().begin(), cpu->getBreakpoints().end());
+				std::sort(addrs.begin(), addrs.end());
+				for(unsigned int i=0; i<addrs.size(); i++)
+					printf("0x%08llx: %s\n", (unsigned long long)addrs[i], get_disassembly(addrs[i]).c_str());
+
+				const std::vector<Watchpoint> &watches = cpu->getWatchpoints();
+				for(unsigned int i=0; i<watches.size(); i++)
+					printf("0x%08llx: %s %llu bytes\n", (unsigned long long)watches[i].addr, watch_type_name(watches[i].type), (unsigned long long)watches[i].len);
 			}
 			else if(token[0] == "verbose-on")
 			{
@@ -250,11 +651,79 @@ int main(int argc, char ** argv)
 				SimError::throwError("Unknown command \"" + token[0] + "\"\n");
 			}
 			input.clear();
+
+			bool ran = (token[0] == "r" || token[0] == "for" || token[0] == "" || token[0] == "rc");
+			if(cpu->isHalted())
+				printf("CPU halted at PC 0x%08x\n", (unsigned int)cpu->getPCValue());
+			else if(ran && cpu->getStopReason() == STOP_WATCHPOINT)
+				printf("Watchpoint (%s) 0x%08x hit at PC 0x%08x\n", watch_type_name(cpu->getWatchHit().type), (unsigned int)cpu->getWatchHit().addr, (unsigned int)cpu->getPCValue());
+			else if(ran && cpu->hasBreakpoint(cpu->getPCValue()))
+				printf("Breakpoint at PC 0x%08x\n", (unsigned int)cpu->getPCValue());
 		}
 	}
+	else if(simpoints_file != "")
+	{
+		if(simpoint_weights == "")
+			SimError::throwError("Sampled simulation needs a simpoint weights file (--simpoint-weights)", true);
+
+		SampledSim sampled(cpu, simpoints_file, simpoint_weights, bbv_interval, simpoint_warmup);
+		unsigned int missing = sampled.run();
+		SimError::Exit(missing ? EXIT_FAILURE : EXIT_SUCCESS);
+	}
+	else if(harts.size() > 1)
+	{
+		HartGroup group(harts, hart_quantum, deterministic_harts);
+		group.run(maxitr);
+
+		if(!cpu->isHalted())
+			SimError::throwWarning("Maximum iterations reached");
+		SimError::Exit(EXIT_SUCCESS);
+	}
 	else
 	{
-		cpu->run(-1);
+		BBVProfiler * bbv = bbv_file != "" ? new BBVProfiler(cpu, bbv_file, bbv_interval) : NULL;
+
+		if(heartbeat_interval == 0 && !bbv)
+		{
+			run_sim(maxitr);
+		}
+		else
+		{
+			// Run in chunks so progress can be reported & intervals sampled
+			const unsigned long int chunk = 1 << 20;
+			unsigned long int remaining = maxitr;
+			std::chrono::steady_clock::time_point next_beat = sim_start_time + std::chrono::seconds(heartbeat_interval);
+
+			while(remaining > 0 && !cpu->isHalted())
+			{
+				unsigned long int n = remaining < chunk ? remaining : chunk;
+				if(bbv && bbv->untilSample() < n)
+					n = bbv->untilSample();
+				run_sim(n);
+				remaining -= n;
+
+				if(bbv)
+					bbv->update();
+				if(heartbeat_interval != 0 && std::chrono::steady_clock::now() >= next_beat)
+				{
+					std::cerr << collect_stats(EXIT_SUCCESS).heartbeat() << std::endl;
+					next_beat += std::chrono::seconds(heartbeat_interval);
+				}
+			}
+		}
+
+		if(bbv)
+		{
+			bbv->finish();
+			std::cout << "Wrote " << bbv->getIntervalCount() << " basic block vectors to " << bbv_file << std::endl;
+			delete bbv;
+		}
+
+		if(!cpu->isHalted())
+			SimError::throwWarning("Maximum iterations reached");
+		if(save_checkpoint != "")
+			CheckpointFile::save(save_checkpoint, cpu, mem, !dense_checkpoint);
+		SimError::Exit(EXIT_SUCCESS);
 	}
 
 	// Control must never Reach Here //
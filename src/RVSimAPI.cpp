@@ -0,0 +1,195 @@
+#include <new>
+
+#include "RVSimAPI.h"
+#include "Simulator.h"
+
+/**
+ * @brief Simulator behind a C handle
+ */
+struct rvsim
+{
+    Simulator sim;
+
+    rvsim(ISAdef isa, uint64_t mem_size): sim(isa, mem_size) {}
+};
+
+
+/**
+ * @brief Get XLEN of the library (32 or 64)
+ */
+unsigned int rvsim_xlen(void)
+{
+    return XLEN;
+}
+
+
+/**
+ * @brief Create a simulator
+ * 
+ * @param isa ISA extensions (RVSIM_ISA_* flags)
+ * @param mem_size memory size in bytes
+ * @return rvsim_t* simulator, NULL if memory can't be allocated
+ */
+rvsim_t * rvsim_create(unsigned int isa, uint64_t mem_size)
+{
+    ISAdef def =
+    {
+        (isa & RVSIM_ISA_E) != 0,
+        (isa & RVSIM_ISA_M) != 0,
+        (isa & RVSIM_ISA_A) != 0,
+        (isa & RVSIM_ISA_F) != 0,
+        (isa & RVSIM_ISA_D) != 0,
+        (isa & RVSIM_ISA_C) != 0,
+        (isa & RVSIM_ISA_ZBA) != 0,
+        (isa & RVSIM_ISA_ZBB) != 0,
+        (isa & RVSIM_ISA_ZBC) != 0,
+        (isa & RVSIM_ISA_ZBS) != 0,
+        (isa & RVSIM_ISA_ZKND) != 0,
+        (isa & RVSIM_ISA_ZKNE) != 0,
+        (isa & RVSIM_ISA_ZKNH) != 0,
+        (isa & RVSIM_ISA_ZKSED) != 0,
+        (isa & RVSIM_ISA_ZKSH) != 0,
+        (isa & RVSIM_ISA_V) != 0,
+        (isa & RVSIM_VLEN_512) ? 512u : (isa & RVSIM_VLEN_256) ? 256u : 128u
+    };
+
+    rvsim_t * sim = new (std::nothrow) rvsim(def, mem_size);
+    if(sim && !sim->sim.getCPU())
+    {
+        delete sim;
+        sim = NULL;
+    }
+    return sim;
+}
+
+
+/**
+ * @brief Destroy a simulator
+ */
+void rvsim_destroy(rvsim_t * sim)
+{
+    delete sim;
+}
+
+
+/**
+ * @brief Load an ELF file & reset the CPU to its entry point
+ */
+int rvsim_load_elf(rvsim_t * sim, const char * filename)
+{
+    return sim->sim.load(std::string(filename));
+}
+
+
+/**
+ * @brief Load an ELF image from host memory & reset the CPU to its entry point
+ */
+int rvsim_load_elf_buffer(rvsim_t * sim, const void * data, size_t size)
+{
+    return sim->sim.load(data, size);
+}
+
+
+/**
+ * @brief Run the CPU
+ * 
+ * @param budget maximum number of instructions
+ */
+int rvsim_run(rvsim_t * sim, uint64_t budget)
+{
+    return sim->sim.run(budget);
+}
+
+
+/**
+ * @brief Get message of the last fatal error ("" if none)
+ */
+const char * rvsim_error(rvsim_t * sim)
+{
+    return sim->sim.getError().c_str();
+}
+
+
+/**
+ * @brief Read/Write integer registers (x0-x31) & PC
+ */
+uint64_t rvsim_get_reg(rvsim_t * sim, unsigned int reg)
+{
+    return reg < 32 ? (uint64_t)sim->sim.getCPU()->getRegValue(reg) : 0;
+}
+
+void rvsim_set_reg(rvsim_t * sim, unsigned int reg, uint64_t value)
+{
+    if(reg > 0 && reg < 32)
+        sim->sim.getCPU()->setRegValue(reg, (REG)value);
+}
+
+uint64_t rvsim_get_pc(rvsim_t * sim)
+{
+    return sim->sim.getCPU()->getPCValue();
+}
+
+void rvsim_set_pc(rvsim_t * sim, uint64_t value)
+{
+    sim->sim.getCPU()->setPCValue((REG)value);
+}
+
+
+/**
+ * @brief Get number of instructions retired since the program was loaded
+ */
+uint64_t rvsim_instret(rvsim_t * sim)
+{
+    return sim->sim.getCPU()->getInstret();
+}
+
+
+/**
+ * @brief Get a direct view of guest RAM
+ * 
+ * @param addr guest address
+ * @param len bytes of RAM from addr to the end of memory (optional)
+ * @return uint8_t* host pointer to addr, NULL if addr is outside memory
+ */
+uint8_t * rvsim_memory(rvsim_t * sim, uint64_t addr, uint64_t * len)
+{
+    Memory * mem = sim->sim.getMemory();
+    if(addr >= mem->size)
+        return NULL;
+    if(len)
+        *len = mem->size - addr;
+    return mem->mem + addr;
+}
+
+
+/**
+ * @brief Get a region loaded from the ELF file
+ * 
+ * @param index region index
+ * @param addr guest address of the region
+ * @param len size of the region in bytes
+ * @return uint8_t* host pointer to the region, NULL if index is out of range
+ */
+uint8_t * rvsim_region(rvsim_t * sim, unsigned int index, uint64_t * addr, uint64_t * len)
+{
+    Memory * mem = sim->sim.getMemory();
+    if(index >= mem->segments.size())
+        return NULL;
+
+    const Memory::Segment &seg = mem->segments[index];
+    if(addr)
+        *addr = seg.addr;
+    if(len)
+        *len = seg.size;
+    return mem->mem + seg.addr;
+}
+
+
+/**
+ * @brief Discard decoded instructions after the host wrote code through a
+ * memory view
+ */
+void rvsim_code_modified(rvsim_t * sim)
+{
+    sim->sim.getCPU()->flushDecodeCache();
+}
@@ -0,0 +1,569 @@
+#include <string.h>
+#include <limits>
+#include <type_traits>
+
+#include "RVVector.h"
+
+#if defined(__x86_64__)
+#define RVVECTOR_X86
+#endif
+
+#define KERNEL_INLINE inline __attribute__((always_inline))
+
+using namespace RVVector;
+
+// ============================== Element operations ==============================
+// Operations work on elements & GCC vectors alike: U is the unsigned element
+// (or vector) type, S its signed counterpart & BITS the SEW. Operations that
+// have no vector form (simd = false) only get scalar kernels.
+
+// 16-bit operands would be multiplied as (signed) int
+template <typename U>
+static KERNEL_INLINE U mul(U a, U b)                        { return a * b; }
+static KERNEL_INLINE uint16_t mul(uint16_t a, uint16_t b)   { return (uint32_t)a * b; }
+
+// Double width types for the high half of products
+template <typename U> struct Wide;
+template <> struct Wide<uint8_t>    { typedef uint16_t U; typedef int16_t S; };
+template <> struct Wide<uint16_t>   { typedef uint32_t U; typedef int32_t S; };
+template <> struct Wide<uint32_t>   { typedef uint64_t U; typedef int64_t S; };
+template <> struct Wide<uint64_t>   { typedef unsigned __int128 U; typedef __int128 S; };
+
+#define BINARY_OP(name, simd_ok, expr) \
+    struct name \
+    { \
+        static const bool simd = simd_ok; \
+        template <typename U, typename S, int BITS> \
+        static KERNEL_INLINE U apply(U a, U b) { return expr; } \
+    }
+
+BINARY_OP(OpAdd,    true,   a + b);
+BINARY_OP(OpSub,    true,   a - b);
+BINARY_OP(OpRsub,   true,   b - a);
+BINARY_OP(OpAnd,    true,   a & b);
+BINARY_OP(OpOr,     true,   a | b);
+BINARY_OP(OpXor,    true,   a ^ b);
+BINARY_OP(OpSll,    true,   a << (b & (BITS - 1)));
+BINARY_OP(OpSrl,    true,   a >> (b & (BITS - 1)));
+BINARY_OP(OpSra,    true,   (U)((S)a >> (S)(b & (BITS - 1))));
+BINARY_OP(OpMinu,   true,   a < b ? a : b);
+BINARY_OP(OpMin,    true,   (S)a < (S)b ? a : b);
+BINARY_OP(OpMaxu,   true,   a > b ? a : b);
+BINARY_OP(OpMax,    true,   (S)a > (S)b ? a : b);
+BINARY_OP(OpMul,    true,   mul(a, b));
+BINARY_OP(OpMulh,   false,  (U)(((typename Wide<U>::S)(S)a * (typename Wide<U>::S)(S)b) >> BITS));
+BINARY_OP(OpMulhu,  false,  (U)(((typename Wide<U>::U)a * (typename Wide<U>::U)b) >> BITS));
+BINARY_OP(OpMulhsu, false,  (U)(((typename Wide<U>::S)(S)a * (typename Wide<U>::S)b) >> BITS));
+
+// Reductions start from the identity of the operation, which also replaces
+// inactive elements in vector loops
+template <typename Op, typename U, typename S>
+struct Identity                     { static U value() { return 0; } };
+template <typename U, typename S>
+struct Identity<OpAnd, U, S>        { static U value() { return (U)~(U)0; } };
+template <typename U, typename S>
+struct Identity<OpMinu, U, S>       { static U value() { return (U)~(U)0; } };
+template <typename U, typename S>
+struct Identity<OpMin, U, S>        { static U value() { return (U)std::numeric_limits<S>::max(); } };
+template <typename U, typename S>
+struct Identity<OpMax, U, S>        { static U value() { return (U)std::numeric_limits<S>::min(); } };
+
+// Comparisons give a bool for elements & a lane mask (0/-1) for vectors
+#define COMPARE_OP(name, expr) \
+    struct name \
+    { \
+        template <typename U, typename S> \
+        static KERNEL_INLINE auto apply(U a, U b) -> decltype(expr) { return expr; } \
+    }
+
+COMPARE_OP(CmpEq,   a == b);
+COMPARE_OP(CmpNe,   a != b);
+COMPARE_OP(CmpLtu,  a < b);
+COMPARE_OP(CmpLt,   (S)a < (S)b);
+COMPARE_OP(CmpLeu,  a <= b);
+COMPARE_OP(CmpLe,   (S)a <= (S)b);
+COMPARE_OP(CmpGtu,  a > b);
+COMPARE_OP(CmpGt,   (S)a > (S)b);
+
+// Multiply-add: d is vd, a is vs2 & b is vs1 or the scalar
+#define TERNARY_OP(name, expr) \
+    struct name \
+    { \
+        template <typename U, typename S, int BITS> \
+        static KERNEL_INLINE U apply(U d, U a, U b) { return expr; } \
+    }
+
+TERNARY_OP(OpMacc,  d + mul(b, a));
+TERNARY_OP(OpNmsac, d - mul(b, a));
+TERNARY_OP(OpMadd,  mul(b, d) + a);
+TERNARY_OP(OpNmsub, a - mul(b, d));
+
+
+// ================================ Element access ================================
+template <typename T>
+static KERNEL_INLINE T ld(const uint8_t * p, unsigned int i)
+{
+    T v;
+    memcpy(&v, p + i * sizeof(T), sizeof(T));
+    return v;
+}
+
+template <typename T>
+static KERNEL_INLINE void st(uint8_t * p, unsigned int i, T v)
+{
+    memcpy(p + i * sizeof(T), &v, sizeof(T));
+}
+
+// Element i is active if unmasked or its mask bit is set
+static KERNEL_INLINE bool active(const uint8_t * mask, unsigned int i)
+{
+    return !mask || ((mask[i >> 3] >> (i & 7)) & 1);
+}
+
+static KERNEL_INLINE void setBit(uint8_t * vd, unsigned int i, bool bit)
+{
+    vd[i >> 3] = (vd[i >> 3] & ~(1 << (i & 7))) | (bit << (i & 7));
+}
+
+/**
+ * @brief Mask bytes expanded to one byte per element (0 or -1)
+ */
+struct MaskBytes
+{
+    uint64_t bytes[256];
+
+    MaskBytes()
+    {
+        for(unsigned int m=0; m<256; m++)
+        {
+            bytes[m] = 0;
+            for(unsigned int b=0; b<8; b++)
+                if((m >> b) & 1)
+                    bytes[m] |= 0xffULL << (b * 8);
+        }
+    }
+};
+static const MaskBytes maskBytes;
+
+/**
+ * @brief Expand the mask bits of elements start to end-1 for vector blends
+ */
+static void expandMask(int8_t * lanes, const uint8_t * mask, unsigned int start, unsigned int end)
+{
+    for(unsigned int i = start & ~7u; i < end; i += 8)
+        memcpy(lanes + i, &maskBytes.bytes[mask[i >> 3]], 8);
+}
+
+
+// ================================= Vector loops =================================
+/**
+ * @brief Loops over whole GCC vectors of VB bytes
+ * Each returns the first element left for the scalar loop; m holds the
+ * expanded mask (NULL if unmasked).
+ */
+template <int VB, typename U>
+struct Vec
+{
+    typedef typename std::make_signed<U>::type S;
+    typedef U VU __attribute__((vector_size(VB)));
+    typedef S VS __attribute__((vector_size(VB)));
+    typedef int8_t VM __attribute__((vector_size(VB / sizeof(U))));
+    static const unsigned int N = VB / sizeof(U);
+    static const int BITS = sizeof(U) * 8;
+
+    static KERNEL_INLINE VU load(const uint8_t * p, unsigned int i)     { VU v; memcpy(&v, p + i * sizeof(U), VB); return v; }
+    static KERNEL_INLINE void store(uint8_t * p, unsigned int i, const VU &v) { memcpy(p + i * sizeof(U), &v, VB); }
+    static KERNEL_INLINE VS lanes(const int8_t * m, unsigned int i)     { VM v; memcpy(&v, m + i, N); return __builtin_convertvector(v, VS); }
+
+    template <typename Op>
+    static KERNEL_INLINE unsigned int binary(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, U x, const int8_t * m,
+        unsigned int i, unsigned int end)
+    {
+        const VU vx = (VU){} + x;
+        for(; i + N <= end; i += N)
+        {
+            VU r = Op::template apply<VU, VS, BITS>(load(vs2, i), vs1 ? load(vs1, i) : vx);
+            if(m)
+                r = lanes(m, i) ? r : load(vd, i);
+            store(vd, i, r);
+        }
+        return i;
+    }
+
+    template <typename Op>
+    static KERNEL_INLINE unsigned int compare(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, U x, const uint8_t * mask,
+        unsigned int i, unsigned int end)
+    {
+        const VU vx = (VU){} + x;
+        for(; i + N <= end; i += N)
+        {
+            auto r = Op::template apply<VU, VS>(load(vs2, i), vs1 ? load(vs1, i) : vx);
+            for(unsigned int j=0; j<N; j++)
+                if(active(mask, i + j))
+                    setBit(vd, i + j, r[j] != 0);
+        }
+        return i;
+    }
+
+    template <typename Op>
+    static KERNEL_INLINE unsigned int ternary(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, U x, const int8_t * m,
+        unsigned int i, unsigned int end)
+    {
+        const VU vx = (VU){} + x;
+        for(; i + N <= end; i += N)
+        {
+            VU d = load(vd, i);
+            VU r = Op::template apply<VU, VS, BITS>(d, load(vs2, i), vs1 ? load(vs1, i) : vx);
+            if(m)
+                r = lanes(m, i) ? r : d;
+            store(vd, i, r);
+        }
+        return i;
+    }
+
+    template <typename Op>
+    static KERNEL_INLINE unsigned int reduce(const uint8_t * vs2, U &acc, const int8_t * m, unsigned int i, unsigned int end)
+    {
+        if(i + N > end)
+            return i;
+
+        const VU id = (VU){} + Identity<Op, U, S>::value();
+        VU vacc = id;
+        for(; i + N <= end; i += N)
+        {
+            VU a = load(vs2, i);
+            if(m)
+                a = lanes(m, i) ? a : id;
+            vacc = Op::template apply<VU, VS, BITS>(vacc, a);
+        }
+        for(unsigned int j=0; j<N; j++)
+            acc = Op::template apply<U, S, BITS>(acc, vacc[j]);
+        return i;
+    }
+
+    static KERNEL_INLINE unsigned int merge(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, U x, const int8_t * m,
+        unsigned int i, unsigned int end)
+    {
+        const VU vx = (VU){} + x;
+        for(; i + N <= end; i += N)
+        {
+            VU r = vs1 ? load(vs1, i) : vx;
+            if(m)
+                r = lanes(m, i) ? r : load(vs2, i);
+            store(vd, i, r);
+        }
+        return i;
+    }
+};
+
+/**
+ * @brief No vector loops in scalar kernels
+ */
+template <typename U>
+struct Vec<0, U>
+{
+    template <typename Op>
+    static KERNEL_INLINE unsigned int binary(uint8_t *, const uint8_t *, const uint8_t *, U, const int8_t *, unsigned int i, unsigned int)      { return i; }
+    template <typename Op>
+    static KERNEL_INLINE unsigned int compare(uint8_t *, const uint8_t *, const uint8_t *, U, const uint8_t *, unsigned int i, unsigned int)    { return i; }
+    template <typename Op>
+    static KERNEL_INLINE unsigned int ternary(uint8_t *, const uint8_t *, const uint8_t *, U, const int8_t *, unsigned int i, unsigned int)     { return i; }
+    template <typename Op>
+    static KERNEL_INLINE unsigned int reduce(const uint8_t *, U &, const int8_t *, unsigned int i, unsigned int)                                 { return i; }
+    static KERNEL_INLINE unsigned int merge(uint8_t *, const uint8_t *, const uint8_t *, U, const int8_t *, unsigned int i, unsigned int)       { return i; }
+};
+
+
+// =================================== Kernels ====================================
+// Vector loops first, scalar loops finish the remaining elements
+template <int VB, typename U, typename Op>
+static KERNEL_INLINE void binaryKernel(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+    unsigned int start, unsigned int end)
+{
+    typedef typename std::make_signed<U>::type S;
+    int8_t lanes[MAX_VLEN];
+    if(VB && mask)
+        expandMask(lanes, mask, start, end);
+
+    unsigned int i = Vec<VB, U>::template binary<Op>(vd, vs2, vs1, (U)x, mask ? lanes : NULL, start, end);
+    for(; i<end; i++)
+    {
+        if(active(mask, i))
+            st<U>(vd, i, Op::template apply<U, S, sizeof(U) * 8>(ld<U>(vs2, i), vs1 ? ld<U>(vs1, i) : (U)x));
+    }
+}
+
+template <int VB, typename U, typename Op>
+static KERNEL_INLINE void compareKernel(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+    unsigned int start, unsigned int end)
+{
+    typedef typename std::make_signed<U>::type S;
+    unsigned int i = Vec<VB, U>::template compare<Op>(vd, vs2, vs1, (U)x, mask, start, end);
+    for(; i<end; i++)
+    {
+        if(active(mask, i))
+            setBit(vd, i, Op::template apply<U, S>(ld<U>(vs2, i), vs1 ? ld<U>(vs1, i) : (U)x));
+    }
+}
+
+template <int VB, typename U, typename Op>
+static KERNEL_INLINE void ternaryKernel(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+    unsigned int start, unsigned int end)
+{
+    typedef typename std::make_signed<U>::type S;
+    int8_t lanes[MAX_VLEN];
+    if(VB && mask)
+        expandMask(lanes, mask, start, end);
+
+    unsigned int i = Vec<VB, U>::template ternary<Op>(vd, vs2, vs1, (U)x, mask ? lanes : NULL, start, end);
+    for(; i<end; i++)
+    {
+        if(active(mask, i))
+            st<U>(vd, i, Op::template apply<U, S, sizeof(U) * 8>(ld<U>(vd, i), ld<U>(vs2, i), vs1 ? ld<U>(vs1, i) : (U)x));
+    }
+}
+
+template <int VB, typename U, typename Op>
+static KERNEL_INLINE uint64_t reduceKernel(const uint8_t * vs2, uint64_t init, const uint8_t * mask, unsigned int start, unsigned int end)
+{
+    typedef typename std::make_signed<U>::type S;
+    int8_t lanes[MAX_VLEN];
+    if(VB && mask)
+        expandMask(lanes, mask, start, end);
+
+    U acc = (U)init;
+    unsigned int i = Vec<VB, U>::template reduce<Op>(vs2, acc, mask ? lanes : NULL, start, end);
+    for(; i<end; i++)
+    {
+        if(active(mask, i))
+            acc = Op::template apply<U, S, sizeof(U) * 8>(acc, ld<U>(vs2, i));
+    }
+    return acc;
+}
+
+template <int VB, typename U>
+static KERNEL_INLINE void mergeKernel(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+    unsigned int start, unsigned int end)
+{
+    int8_t lanes[MAX_VLEN];
+    if(VB && mask)
+        expandMask(lanes, mask, start, end);
+
+    unsigned int i = Vec<VB, U>::merge(vd, vs2, vs1, (U)x, mask ? lanes : NULL, start, end);
+    for(; i<end; i++)
+    {
+        U v = vs1 ? ld<U>(vs1, i) : (U)x;
+        st<U>(vd, i, active(mask, i) ? v : ld<U>(vs2, i));
+    }
+}
+
+
+/**
+ * @brief Kernel entry points for host vectors of VB bytes (0: scalar code)
+ */
+template <int VB>
+struct Level
+{
+    template <typename U, typename Op>
+    static void binary(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask, unsigned int start, unsigned int end)
+    {
+        binaryKernel<VB, U, Op>(vd, vs2, vs1, x, mask, start, end);
+    }
+
+    template <typename U, typename Op>
+    static void compare(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask, unsigned int start, unsigned int end)
+    {
+        compareKernel<VB, U, Op>(vd, vs2, vs1, x, mask, start, end);
+    }
+
+    template <typename U, typename Op>
+    static void ternary(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask, unsigned int start, unsigned int end)
+    {
+        ternaryKernel<VB, U, Op>(vd, vs2, vs1, x, mask, start, end);
+    }
+
+    template <typename U, typename Op>
+    static uint64_t reduce(const uint8_t * vs2, uint64_t init, const uint8_t * mask, unsigned int start, unsigned int end)
+    {
+        return reduceKernel<VB, U, Op>(vs2, init, mask, start, end);
+    }
+
+    template <typename U>
+    static void merge(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask, unsigned int start, unsigned int end)
+    {
+        mergeKernel<VB, U>(vd, vs2, vs1, x, mask, start, end);
+    }
+};
+
+#ifdef RVVECTOR_X86
+/**
+ * @brief The same kernels compiled for AVX2
+ */
+template <>
+struct Level<32>
+{
+    template <typename U, typename Op>
+    static __attribute__((target("avx2"))) void binary(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+        unsigned int start, unsigned int end)
+    {
+        binaryKernel<32, U, Op>(vd, vs2, vs1, x, mask, start, end);
+    }
+
+    template <typename U, typename Op>
+    static __attribute__((target("avx2"))) void compare(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+        unsigned int start, unsigned int end)
+    {
+        compareKernel<32, U, Op>(vd, vs2, vs1, x, mask, start, end);
+    }
+
+    template <typename U, typename Op>
+    static __attribute__((target("avx2"))) void ternary(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+        unsigned int start, unsigned int end)
+    {
+        ternaryKernel<32, U, Op>(vd, vs2, vs1, x, mask, start, end);
+    }
+
+    template <typename U, typename Op>
+    static __attribute__((target("avx2"))) uint64_t reduce(const uint8_t * vs2, uint64_t init, const uint8_t * mask, unsigned int start, unsigned int end)
+    {
+        return reduceKernel<32, U, Op>(vs2, init, mask, start, end);
+    }
+
+    template <typename U>
+    static __attribute__((target("avx2"))) void merge(uint8_t * vd, const uint8_t * vs2, const uint8_t * vs1, uint64_t x, const uint8_t * mask,
+        unsigned int start, unsigned int end)
+    {
+        mergeKernel<32, U>(vd, vs2, vs1, x, mask, start, end);
+    }
+};
+#endif
+
+
+// ================================ Kernel tables =================================
+// One entry per SEW, operations without a vector form use the scalar kernels
+template <typename L, typename Op>
+static void setBinary(Kernels &k, BinaryOp op)
+{
+    typedef typename std::conditional<Op::simd, L, Level<0> >::type K;
+    k.binary[op][0] = K::template binary<uint8_t, Op>;
+    k.binary[op][1] = K::template binary<uint16_t, Op>;
+    k.binary[op][2] = K::template binary<uint32_t, Op>;
+    k.binary[op][3] = K::template binary<uint64_t, Op>;
+}
+
+template <typename L, typename Op>
+static void setCompare(Kernels &k, CompareOp op)
+{
+    k.compare[op][0] = L::template compare<uint8_t, Op>;
+    k.compare[op][1] = L::template compare<uint16_t, Op>;
+    k.compare[op][2] = L::template compare<uint32_t, Op>;
+    k.compare[op][3] = L::template compare<uint64_t, Op>;
+}
+
+template <typename L, typename Op>
+static void setTernary(Kernels &k, TernaryOp op)
+{
+    k.ternary[op][0] = L::template ternary<uint8_t, Op>;
+    k.ternary[op][1] = L::template ternary<uint16_t, Op>;
+    k.ternary[op][2] = L::template ternary<uint32_t, Op>;
+    k.ternary[op][3] = L::template ternary<uint64_t, Op>;
+}
+
+template <typename L, typename Op>
+static void setReduce(Kernels &k, BinaryOp op)
+{
+    k.reduce[op][0] = L::template reduce<uint8_t, Op>;
+    k.reduce[op][1] = L::template reduce<uint16_t, Op>;
+    k.reduce[op][2] = L::template reduce<uint32_t, Op>;
+    k.reduce[op][3] = L::template reduce<uint64_t, Op>;
+}
+
+template <typename L>
+static Kernels makeKernels(const char * name)
+{
+    Kernels k;
+    memset(&k, 0, sizeof(k));
+    k.name = name;
+
+    setBinary<L, OpAdd>(k, OP_ADD);
+    setBinary<L, OpSub>(k, OP_SUB);
+    setBinary<L, OpRsub>(k, OP_RSUB);
+    setBinary<L, OpAnd>(k, OP_AND);
+    setBinary<L, OpOr>(k, OP_OR);
+    setBinary<L, OpXor>(k, OP_XOR);
+    setBinary<L, OpSll>(k, OP_SLL);
+    setBinary<L, OpSrl>(k, OP_SRL);
+    setBinary<L, OpSra>(k, OP_SRA);
+    setBinary<L, OpMinu>(k, OP_MINU);
+    setBinary<L, OpMin>(k, OP_MIN);
+    setBinary<L, OpMaxu>(k, OP_MAXU);
+    setBinary<L, OpMax>(k, OP_MAX);
+    setBinary<L, OpMul>(k, OP_MUL);
+    setBinary<L, OpMulh>(k, OP_MULH);
+    setBinary<L, OpMulhu>(k, OP_MULHU);
+    setBinary<L, OpMulhsu>(k, OP_MULHSU);
+
+    setCompare<L, CmpEq>(k, CMP_EQ);
+    setCompare<L, CmpNe>(k, CMP_NE);
+    setCompare<L, CmpLtu>(k, CMP_LTU);
+    setCompare<L, CmpLt>(k, CMP_LT);
+    setCompare<L, CmpLeu>(k, CMP_LEU);
+    setCompare<L, CmpLe>(k, CMP_LE);
+    setCompare<L, CmpGtu>(k, CMP_GTU);
+    setCompare<L, CmpGt>(k, CMP_GT);
+
+    setTernary<L, OpMacc>(k, OP_MACC);
+    setTernary<L, OpNmsac>(k, OP_NMSAC);
+    setTernary<L, OpMadd>(k, OP_MADD);
+    setTernary<L, OpNmsub>(k, OP_NMSUB);
+
+    setReduce<L, OpAdd>(k, OP_ADD);
+    setReduce<L, OpAnd>(k, OP_AND);
+    setReduce<L, OpOr>(k, OP_OR);
+    setReduce<L, OpXor>(k, OP_XOR);
+    setReduce<L, OpMinu>(k, OP_MINU);
+    setReduce<L, OpMin>(k, OP_MIN);
+    setReduce<L, OpMaxu>(k, OP_MAXU);
+    setReduce<L, OpMax>(k, OP_MAX);
+
+    k.merge[0] = L::template merge<uint8_t>;
+    k.merge[1] = L::template merge<uint16_t>;
+    k.merge[2] = L::template merge<uint32_t>;
+    k.merge[3] = L::template merge<uint64_t>;
+    return k;
+}
+
+
+/**
+ * @brief Select the kernels for the host CPU
+ * SSE2 is part of x86-64, AVX2 also needs the OS to save the upper halves of
+ * the registers, which __builtin_cpu_supports checks.
+ */
+static const Kernels scalarKernels = makeKernels<Level<0> >("scalar");
+
+#ifdef RVVECTOR_X86
+static const Kernels sseKernels = makeKernels<Level<16> >("sse2");
+static const Kernels avx2Kernels = makeKernels<Level<32> >("avx2");
+
+static const Kernels * selectKernels()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? &avx2Kernels : &sseKernels;
+}
+#else
+static const Kernels * selectKernels()
+{
+    return &scalarKernels;
+}
+#endif
+
+const Kernels * RVVector::kernels = selectKernels();
+
+
+/**
+ * @brief Use the scalar kernels whatever the host supports
+ */
+void RVVector::usePortable()
+{
+    kernels = &scalarKernels;
+}
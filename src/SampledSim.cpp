@@ -0,0 +1,151 @@
+#include <sstream>
+#include <algorithm>
+#include <map>
+
+#include "SampledSim.h"
+#include "SimError.h"
+#include "Util.h"
+
+
+/**
+ * @brief Construct a new SampledSim object
+ * 
+ * @param cpu CPU at the start of the program
+ * @param simpoints_file simpoints file ("<interval> <id>" per line)
+ * @param weights_file weights file ("<weight> <id>" per line)
+ * @param interval instructions per interval (as used to collect the
+ * basic block vectors)
+ * @param warmup instructions of cache warm up before each interval
+ */
+SampledSim::SampledSim(RVCPU * cpu, std::string simpoints_file, std::string weights_file, uint64_t interval, uint64_t warmup)
+{
+    this->cpu = cpu;
+    this->interval = interval;
+    this->warmup = warmup;
+    if(interval == 0)
+        SimError::throwError("Simpoint interval must be non-zero", true);
+
+    std::vector<std::string> lines;
+    try
+    {
+        lines = Util::fRead(weights_file);
+    }
+    catch(const char * e)
+    {
+        SimError::throwError("Can't read simpoint weights : " + weights_file, true);
+    }
+    std::map<unsigned int, double> weights;
+    for(size_t i=0; i<lines.size(); i++)
+    {
+        if(Util::strip(lines[i]) == "")
+            continue;
+        std::istringstream ss(lines[i]);
+        double weight;
+        unsigned int id;
+        if(!(ss >> weight >> id))
+            SimError::throwError("Malformed line in " + weights_file + " : " + lines[i], true);
+        weights[id] = weight;
+    }
+
+    try
+    {
+        lines = Util::fRead(simpoints_file);
+    }
+    catch(const char * e)
+    {
+        SimError::throwError("Can't read simpoints : " + simpoints_file, true);
+    }
+    for(size_t i=0; i<lines.size(); i++)
+    {
+        if(Util::strip(lines[i]) == "")
+            continue;
+        std::istringstream ss(lines[i]);
+        SimPoint p = SimPoint();
+        if(!(ss >> p.interval >> p.id))
+            SimError::throwError("Malformed line in " + simpoints_file + " : " + lines[i], true);
+        if(weights.find(p.id) == weights.end())
+            SimError::throwError("No weight for simpoint " + std::to_string(p.id), true);
+        p.weight = weights[p.id];
+        points.push_back(p);
+    }
+
+    // Simulate in program order
+    std::sort(points.begin(), points.end(), [](const SimPoint &a, const SimPoint &b) { return a.interval < b.interval; });
+}
+
+
+/**
+ * @brief Run exactly n instructions (fewer if the CPU halts)
+ */
+void SampledSim::runFor(uint64_t n)
+{
+    uint64_t target = cpu->getInstret() + n;
+    while(cpu->getInstret() < target && !cpu->isHalted())
+        cpu->run(target - cpu->getInstret());
+}
+
+
+/**
+ * @brief Simulate all simpoints & print the weighted results
+ * 
+ * @return unsigned int number of simpoints not reached
+ */
+unsigned int SampledSim::run()
+{
+    for(size_t i=0; i<points.size(); i++)
+    {
+        SimPoint &p = points[i];
+        uint64_t start = p.interval * interval;
+        uint64_t warm_start = start > warmup ? start - warmup : 0;
+
+        // Fast-forward functionally, then warm up the cache model
+        cpu->setCacheModelForced(false);
+        if(cpu->getInstret() < warm_start)
+            runFor(warm_start - cpu->getInstret());
+        cpu->setCacheModelForced(true);
+        if(cpu->getInstret() < start)
+            runFor(start - cpu->getInstret());
+        if(cpu->isHalted() || cpu->getInstret() > start)
+            continue;
+
+        // Detailed simulation of the interval
+        uint64_t instret = cpu->getInstret();
+        uint64_t accesses = cpu->getDCache().accesses;
+        uint64_t misses = cpu->getDCache().misses;
+        runFor(interval);
+        p.reached = true;
+        p.instret = cpu->getInstret() - instret;
+        p.accesses = cpu->getDCache().accesses - accesses;
+        p.misses = cpu->getDCache().misses - misses;
+    }
+    cpu->setCacheModelForced(false);
+
+    // Summary
+    unsigned int missing = 0;
+    double weight_sum = 0, mpki = 0, miss_rate = 0;
+    printf("%-8s %12s %8s %16s %14s %14s %10s\n", "SimPoint", "Interval", "Weight", "Instructions", "D$ Accesses", "D$ Misses", "MPKI");
+    for(size_t i=0; i<points.size(); i++)
+    {
+        const SimPoint &p = points[i];
+        if(!p.reached)
+        {
+            printf("%-8u %12llu %8.4f %s\n", p.id, (unsigned long long)p.interval, p.weight, "not reached");
+            missing++;
+            continue;
+        }
+
+        double p_mpki = p.instret ? 1000.0 * p.misses / p.instret : 0;
+        printf("%-8u %12llu %8.4f %16llu %14llu %14llu %10.4f\n", p.id, (unsigned long long)p.interval, p.weight,
+            (unsigned long long)p.instret, (unsigned long long)p.accesses, (unsigned long long)p.misses, p_mpki);
+        weight_sum += p.weight;
+        mpki += p.weight * p_mpki;
+        miss_rate += p.weight * (p.accesses ? (double)p.misses / p.accesses : 0);
+    }
+    if(weight_sum > 0)
+    {
+        printf("Weighted D$ MPKI      : %.4f\n", mpki / weight_sum);
+        printf("Weighted D$ miss rate : %.4f%%\n", 100.0 * miss_rate / weight_sum);
+    }
+    printf("%u/%u simpoints simulated, %llu instructions in total\n", (unsigned int)points.size() - missing, (unsigned int)points.size(), (unsigned long long)cpu->getInstret());
+    return missing;
+}
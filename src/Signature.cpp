@@ -0,0 +1,93 @@
+#include <fstream>
+#include <algorithm>
+
+#include "Signature.h"
+#include "Util.h"
+
+
+/**
+ * @brief Read the signature of a finished simulation
+ * 
+ * @param elf ELF file the symbols are looked up in
+ * @param mem memory of the simulation
+ * @param granularity bytes per line (4 or 8)
+ * @return std::string error, empty on success
+ */
+std::string Signature::read(const std::string &elf, Memory * mem, unsigned int granularity)
+{
+    lines.clear();
+
+    std::vector<uint64_t> addrs;
+    if(!Util::getSymbolAddresses(elf, {"begin_signature", "end_signature"}, addrs))
+        return "begin_signature/end_signature symbols not found";
+    uint64_t begin = addrs[0], end = addrs[1];
+    if(end < begin || (end > begin && (!mem->isValidAddress(begin) || !mem->isValidAddress(end - 1))))
+        return "signature outside of memory";
+
+    // Little endian words, printed most significant byte first
+    char buf[20];
+    for(uint64_t addr = begin; addr < end; addr += granularity)
+    {
+        uint64_t word = 0;
+        for(unsigned int i=0; i<granularity && addr + i < end; i++)
+            word |= (uint64_t)mem->mem[addr + i] << (8*i);
+        sprintf(buf, granularity == 8 ? "%016llx" : "%08llx", (unsigned long long)word);
+        lines.push_back(buf);
+    }
+    return "";
+}
+
+
+/**
+ * @brief Write the signature to a file
+ * 
+ * @return false if the file can't be written
+ */
+bool Signature::write(const std::string &filename) const
+{
+    std::ofstream f(filename);
+    for(size_t i=0; i<lines.size(); i++)
+        f << lines[i] << "\n";
+    return (bool)f;
+}
+
+
+/**
+ * @brief Compare against a reference signature (case insensitive)
+ * 
+ * @param reference reference lines
+ * @return long index of the first mismatching line, -1 if equal
+ */
+long Signature::compare(const std::vector<std::string> &reference) const
+{
+    size_t n = 0;
+    for(size_t i=0; i<reference.size(); i++)
+    {
+        std::string ref = Util::strip(reference[i]);
+        if(ref.empty())
+            continue;
+        std::transform(ref.begin(), ref.end(), ref.begin(), ::tolower);
+        if(n >= lines.size() || lines[n] != ref)
+            return n;
+        n++;
+    }
+    return n == lines.size() ? -1 : (long)n;
+}
+
+
+/**
+ * @brief Bytes per line of a reference signature file
+ * 
+ * @param reference reference lines
+ * @return unsigned int 4 or 8
+ */
+unsigned int Signature::granularityOf(const std::vector<std::string> &reference)
+{
+    for(size_t i=0; i<reference.size(); i++)
+    {
+        std::string ref = Util::strip(reference[i]);
+        if(!ref.empty())
+            return ref.size() > 8 ? 8 : 4;
+    }
+    return 4;
+}
@@ -1,8 +1,43 @@
 #include <iostream>
 #include <string>
+#include <stdlib.h>
 
 #include "SimError.h"
 
+/**
+ * @brief Fatal errors throw instead of exiting on this thread
+ */
+static thread_local bool throw_on_fatal = false;
+
+/**
+ * @brief Function called by Exit before exiting
+ */
+static void (*exit_handler)(int status) = NULL;
+
+/**
+ * @brief Exit the simulator
+ * 
+ * @param status exit status
+ */
+void SimError::Exit(int status)
+{
+    if(exit_handler)
+        exit_handler(status);
+    exit(status);
+}
+
+
+/**
+ * @brief Set function called by Exit to clean up before exiting
+ * 
+ * @param handler exit handler (NULL: none)
+ */
+void SimError::setExitHandler(void (*handler)(int status))
+{
+    exit_handler = handler;
+}
+
+
 /**
  * @brief Throws error generated in the std::cerr stream
  * 
@@ -12,6 +47,9 @@
  */
 void SimError::throwError(std::string message, bool exit_flag)
 {
+    if(exit_flag && throw_on_fatal)
+        throw Fatal{message};
+
     std::cerr << COLOR_RED <<"!ERROR: " << COLOR_RESET << message << std::endl;
     if(exit_flag)
     {
@@ -19,6 +57,20 @@ void SimError::throwError(std::string message, bool exit_flag)
     }
 }
 
+
+/**
+ * @brief Throw Fatal on fatal errors instead of exiting (per thread)
+ * 
+ * @param enable throw instead of exiting
+ * @return bool previous setting
+ */
+bool SimError::setThrowOnFatal(bool enable)
+{
+    bool prev = throw_on_fatal;
+    throw_on_fatal = enable;
+    return prev;
+}
+
 /**
  * @brief Throws warning generated by assembler in the std::cerr stream
  * 
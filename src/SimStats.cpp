@@ -0,0 +1,135 @@
+#include <fstream>
+#include <sstream>
+
+#include "SimStats.h"
+
+/**
+ * @brief Names of trap causes used in exported statistics
+ */
+static const char * trap_cause_names[CAUSE_COUNT] =
+{
+    "misaligned_fetch",
+    "fetch_access",
+    "illegal_instruction",
+    "breakpoint",
+    "misaligned_load",
+    "load_access",
+    "misaligned_store",
+    "store_access",
+    "user_ecall",
+    "supervisor_ecall",
+    "reserved_10",
+    "machine_ecall",
+    "fetch_page_fault",
+    "load_page_fault",
+    "reserved_14",
+    "store_page_fault"
+};
+
+
+/**
+ * @brief Escape a string for use in a JSON document
+ */
+static std::string jsonEscape(const std::string &s)
+{
+    std::string out;
+    for(unsigned int i=0; i<s.size(); i++)
+    {
+        if(s[i] == '"' || s[i] == '\\')
+            out += '\\';
+        out += s[i];
+    }
+    return out;
+}
+
+
+/**
+ * @brief Simulation throughput
+ * 
+ * @return double million instructions per second of host time
+ */
+double SimStats::mips() const
+{
+    return wall_time > 0 ? (double)instret / wall_time / 1e6 : 0;
+}
+
+
+/**
+ * @brief Write statistics to a file, CSV if the filename ends with
+ * ".csv" and JSON otherwise
+ * 
+ * @param filepath output file
+ */
+void SimStats::write(std::string filepath) const
+{
+    std::ofstream f(filepath);
+    if(!f)
+    {
+        throw "file writing failed";
+    }
+
+    uint64_t total_traps = 0;
+    for(unsigned int i=0; i<CAUSE_COUNT; i++)
+        total_traps += cpu.traps[i];
+
+    bool csv = filepath.size() >= 4 && filepath.compare(filepath.size()-4, 4, ".csv") == 0;
+    if(csv)
+    {
+        f << "input,exit_status,halted,instructions_retired,host_wall_time_s,mips,elf_load_time_s,"
+          << "memory_pages_touched,memory_page_size,tcache_hits,tcache_misses,tcache_flushes,page_walks,traps";
+        for(unsigned int i=0; i<CAUSE_COUNT; i++)
+            f << ",traps_" << trap_cause_names[i];
+        f << "\n";
+
+        f << "\"" << input << "\"," << exit_status << "," << (halted ? 1 : 0) << "," << instret << ","
+          << wall_time << "," << mips() << "," << elf_load_time << ","
+          << pages_touched << "," << page_size << ","
+          << cpu.blockHits << "," << cpu.blockMisses << "," << cpu.cacheFlushes << "," << cpu.pageWalks << "," << total_traps;
+        for(unsigned int i=0; i<CAUSE_COUNT; i++)
+            f << "," << cpu.traps[i];
+        f << "\n";
+    }
+    else
+    {
+        f << "{\n"
+          << "    \"input\": \"" << jsonEscape(input) << "\",\n"
+          << "    \"exit_status\": " << exit_status << ",\n"
+          << "    \"halted\": " << (halted ? "true" : "false") << ",\n"
+          << "    \"instructions_retired\": " << instret << ",\n"
+          << "    \"host_wall_time_s\": " << wall_time << ",\n"
+          << "    \"mips\": " << mips() << ",\n"
+          << "    \"elf_load_time_s\": " << elf_load_time << ",\n"
+          << "    \"memory_pages_touched\": " << pages_touched << ",\n"
+          << "    \"memory_page_size\": " << page_size << ",\n"
+          << "    \"translation_cache\": {\n"
+          << "        \"hits\": " << cpu.blockHits << ",\n"
+          << "        \"misses\": " << cpu.blockMisses << ",\n"
+          << "        \"flushes\": " << cpu.cacheFlushes << "\n"
+          << "    },\n"
+          << "    \"page_walks\": " << cpu.pageWalks << ",\n"
+          << "    \"traps\": {\n"
+          << "        \"total\": " << total_traps;
+        for(unsigned int i=0; i<CAUSE_COUNT; i++)
+        {
+            if(cpu.traps[i])
+                f << ",\n        \"" << trap_cause_names[i] << "\": " << cpu.traps[i];
+        }
+        f << "\n    }\n"
+          << "}\n";
+    }
+    f.close();
+}
+
+
+/**
+ * @brief Format a one line progress report
+ * 
+ * @return std::string heartbeat line
+ */
+std::string SimStats::heartbeat() const
+{
+    std::stringstream s;
+    s << "[heartbeat] time: " << wall_time << " s, instret: " << instret
+      << ", MIPS: " << mips() << ", tcache misses: " << cpu.blockMisses;
+    return s.str();
+}
@@ -0,0 +1,205 @@
+#include <fstream>
+#include <sstream>
+
+#include "Simulator.h"
+#include "SimError.h"
+#include "elfio.hpp"
+
+
+/**
+ * @brief Makes fatal errors throw SimError::Fatal in the current scope
+ */
+struct FatalGuard
+{
+    bool prev;
+    FatalGuard()  { prev = SimError::setThrowOnFatal(true); }
+    ~FatalGuard() { SimError::setThrowOnFatal(prev); }
+};
+
+
+/**
+ * @brief Strip trailing newlines from an error message
+ */
+static std::string error_message(const SimError::Fatal &e)
+{
+    std::string msg = e.message;
+    while(!msg.empty() && msg.back() == '\n')
+        msg.pop_back();
+    return msg;
+}
+
+
+/**
+ * @brief Construct a new Simulator object
+ * If memory can't be allocated, every later call returns SIM_ERROR.
+ * 
+ * @param isa ISA of the simulated CPU
+ * @param mem_size memory size in bytes
+ */
+Simulator::Simulator(ISAdef isa, uint64_t mem_size)
+{
+    mem = NULL;
+    bus = NULL;
+    cpu = NULL;
+    failed = false;
+
+    FatalGuard guard;
+    try
+    {
+        mem = new Memory(mem_size);
+        bus = new Bus<REG>(mem);
+        cpu = new RVCPU(0, isa, bus);
+    }
+    catch(const SimError::Fatal &e)
+    {
+        error = error_message(e);
+    }
+}
+
+
+/**
+ * @brief Destroy the Simulator object
+ * 
+ */
+Simulator::~Simulator()
+{
+    delete cpu;
+    delete bus;
+    delete mem;
+}
+
+
+/**
+ * @brief Load an ELF image & reset the CPU to its entry point
+ * Memory is not cleared, so a simulator can be reused for programs that
+ * initialize all the memory they use.
+ * 
+ * @param stream ELF image
+ * @param name name of the image used in error messages
+ */
+SimStatus Simulator::loadStream(std::istream &stream, const std::string &name)
+{
+    if(!cpu)
+        return SIM_ERROR;
+
+    FatalGuard guard;
+    try
+    {
+        mem->segments.clear();
+        REG entry = mem->initFromElf(stream, {PF_R|PF_X, PF_R, PF_R|PF_W, PF_R|PF_W|PF_X}, name);
+        cpu->reset();
+        cpu->setPCValue(entry);
+        failed = false;
+        error = "";
+    }
+    catch(const SimError::Fatal &e)
+    {
+        error = error_message(e);
+        return SIM_ERROR;
+    }
+    return SIM_OK;
+}
+
+
+/**
+ * @brief Load all loadable segments of an ELF file & set PC to its entry
+ * point
+ * 
+ * @param elf ELF file
+ * @return SimStatus SIM_OK or SIM_ERROR
+ */
+SimStatus Simulator::load(const std::string &elf)
+{
+    std::ifstream stream(elf.c_str(), std::ios::in | std::ios::binary);
+    if(!stream)
+    {
+        error = "Can't find or process ELF file : " + elf;
+        return SIM_ERROR;
+    }
+
+    SimStatus status = loadStream(stream, elf);
+    if(status == SIM_OK)
+        elfFile = elf;
+    return status;
+}
+
+
+/**
+ * @brief Load all loadable segments of an ELF image in host memory & set
+ * PC to its entry point
+ * 
+ * @param data ELF image
+ * @param size size of the image in bytes
+ * @return SimStatus SIM_OK or SIM_ERROR
+ */
+SimStatus Simulator::load(const void * data, size_t size)
+{
+    std::istringstream stream(std::string((const char *)data, size), std::ios::in | std::ios::binary);
+    SimStatus status = loadStream(stream, "<buffer>");
+    if(status == SIM_OK)
+        elfFile = "";
+    return status;
+}
+
+
+/**
+ * @brief Run the CPU
+ * 
+ * @param budget maximum number of instructions
+ * @return SimStatus SIM_OK, SIM_HALTED or SIM_ERROR
+ */
+SimStatus Simulator::run(unsigned long int budget)
+{
+    if(!cpu || failed)
+        return SIM_ERROR;
+
+    FatalGuard guard;
+    try
+    {
+        cpu->run(budget);
+    }
+    catch(const SimError::Fatal &e)
+    {
+        error = error_message(e);
+        failed = true;
+        return SIM_ERROR;
+    }
+    return cpu->isHalted() ? SIM_HALTED : SIM_OK;
+}
+
+
+/**
+ * @brief Get message of the last fatal error
+ */
+const std::string & Simulator::getError()
+{
+    return error;
+}
+
+
+/**
+ * @brief Get ELF file loaded last
+ */
+const std::string & Simulator::getElfFile()
+{
+    return elfFile;
+}
+
+
+/**
+ * @brief Get simulated components
+ */
+RVCPU * Simulator::getCPU()
+{
+    return cpu;
+}
+
+Memory * Simulator::getMemory()
+{
+    return mem;
+}
+
+Bus<REG> * Simulator::getBus()
+{
+    return bus;
+}
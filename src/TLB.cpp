@@ -0,0 +1,139 @@
+#include "TLB.h"
+#include "RVdefs.h"
+
+
+/**
+ * @brief Construct a new TLB object
+ * 
+ * @param sets number of sets (power of 2)
+ * @param ways associativity
+ * @param level_bits virtual page number bits per page table level
+ */
+TLB::TLB(unsigned int sets, unsigned int ways, unsigned int level_bits)
+{
+    nSets = sets;
+    nWays = ways;
+    levelBits = level_bits;
+    entries.resize(nSets * nWays);
+    reset();
+}
+
+
+/**
+ * @brief Find the translation of a page
+ * 
+ * @param vpn virtual page number
+ * @param asid address space (global entries match any)
+ * @return Entry* entry or NULL on a miss
+ */
+TLB::Entry * TLB::lookup(uint64_t vpn, uint16_t asid)
+{
+    Entry * set = &entries[(vpn & (nSets - 1)) * nWays];
+    for(unsigned int w = 0; w < nWays; w++)
+    {
+        Entry &e = set[w];
+        if(e.vpn == vpn && (e.asid == asid || (e.flags & PTE_G)))
+        {
+            e.stamp = ++clock;
+            hits++;
+            return &e;
+        }
+    }
+    misses++;
+    return NULL;
+}
+
+
+/**
+ * @brief Add the translation of a page
+ * An entry for the same page (a walk that updated the dirty bit) is reused,
+ * otherwise the least recently used entry of the set is replaced.
+ */
+TLB::Entry * TLB::insert(uint64_t vpn, uint64_t ppn, uint16_t asid, uint8_t flags, unsigned int level)
+{
+    Entry * set = &entries[(vpn & (nSets - 1)) * nWays];
+    Entry * victim = set;
+    for(unsigned int w = 0; w < nWays; w++)
+    {
+        if(set[w].vpn == vpn && (set[w].asid == asid || (set[w].flags & PTE_G)))
+        {
+            victim = &set[w];
+            break;
+        }
+        if(set[w].stamp < victim->stamp)
+            victim = &set[w];
+    }
+
+    invalidate(*victim);
+    victim->vpn = vpn;
+    victim->ppn = ppn;
+    victim->asid = asid;
+    victim->flags = flags;
+    victim->level = level;
+    victim->stamp = ++clock;
+    if(level)
+        superpages++;
+    return victim;
+}
+
+
+/**
+ * @brief Invalidate an entry
+ */
+void TLB::invalidate(Entry &e)
+{
+    if(e.vpn != INVALID_VPN && e.level)
+        superpages--;
+    e.vpn = INVALID_VPN;
+    e.stamp = 0;
+}
+
+
+/**
+ * @brief Invalidate entries (sfence.vma)
+ * Entries of a superpage are spread over all sets, so flushing an address
+ * checks every entry while superpage entries are cached.
+ * 
+ * @param match_vpn only entries translating vpn
+ * @param vpn virtual page number
+ * @param match_asid only non-global entries of asid
+ * @param asid address space
+ */
+void TLB::flush(bool match_vpn, uint64_t vpn, bool match_asid, uint16_t asid)
+{
+    unsigned int first = 0, last = nSets * nWays;
+    if(match_vpn && superpages == 0)
+    {
+        first = (vpn & (nSets - 1)) * nWays;
+        last = first + nWays;
+    }
+
+    for(unsigned int i = first; i < last; i++)
+    {
+        Entry &e = entries[i];
+        if(e.vpn == INVALID_VPN)
+            continue;
+        if(match_vpn && ((e.vpn ^ vpn) >> (e.level * levelBits)) != 0)
+            continue;
+        if(match_asid && (e.asid != asid || (e.flags & PTE_G)))
+            continue;
+        invalidate(e);
+    }
+}
+
+
+/**
+ * @brief Invalidate all entries & clear statistics
+ */
+void TLB::reset()
+{
+    for(unsigned int i = 0; i < entries.size(); i++)
+    {
+        entries[i].vpn = INVALID_VPN;
+        entries[i].stamp = 0;
+    }
+    clock = 0;
+    superpages = 0;
+    hits = 0;
+    misses = 0;
+}
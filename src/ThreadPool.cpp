@@ -0,0 +1,102 @@
+#include <thread>
+
+#include "ThreadPool.h"
+
+
+/**
+ * @brief Construct a new ThreadPool object
+ * 
+ * @param threads number of worker threads (0: number of CPUs)
+ */
+ThreadPool::ThreadPool(unsigned int threads)
+{
+    if(threads == 0)
+        threads = std::thread::hardware_concurrency();
+    if(threads == 0)
+        threads = 1;
+
+    for(unsigned int i=0; i<threads; i++)
+        queues.push_back(std::unique_ptr<Queue>(new Queue));
+    nextQueue = 0;
+}
+
+
+/**
+ * @brief Get number of worker threads
+ */
+unsigned int ThreadPool::getThreadCount()
+{
+    return queues.size();
+}
+
+
+/**
+ * @brief Queue a task
+ */
+void ThreadPool::add(std::function<void()> task)
+{
+    Queue &q = *queues[nextQueue];
+    nextQueue = (nextQueue + 1) % queues.size();
+
+    std::lock_guard<std::mutex> guard(q.lock);
+    q.tasks.push_back(task);
+}
+
+
+/**
+ * @brief Take a task, from the worker's own queue or stolen from another
+ * 
+ * @return false if all queues are empty
+ */
+bool ThreadPool::take(size_t idx, std::function<void()> &task)
+{
+    {
+        Queue &own = *queues[idx];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if(!own.tasks.empty())
+        {
+            task = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Tasks never add tasks, so once every queue is empty all work is taken
+    for(size_t i=1; i<queues.size(); i++)
+    {
+        Queue &victim = *queues[(idx + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.tasks.empty())
+        {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * @brief Worker thread body
+ */
+void ThreadPool::worker(size_t idx)
+{
+    std::function<void()> task;
+    while(take(idx, task))
+        task();
+}
+
+
+/**
+ * @brief Run all queued tasks, returns once all have finished
+ */
+void ThreadPool::run()
+{
+    std::vector<std::thread> threads;
+    for(size_t i=1; i<queues.size(); i++)
+        threads.push_back(std::thread(&ThreadPool::worker, this, i));
+    worker(0);
+    for(size_t i=0; i<threads.size(); i++)
+        threads[i].join();
+}
@@ -1,4 +1,7 @@
 #include "Util.h"
+#include "RVDisasm.h"
+#include "RVCompressed.h"
+#include "elfio.hpp"
 
 #include <fstream>
 #include <sstream>
@@ -182,48 +185,185 @@ std::string Util::GetStdoutFromCommand(std::string cmd) {
 }
 
 /**
- * @brief Get the Disassembly of input file using riscv objdump
+ * @brief Add an executable segment
+ * 
+ * @param base start address
+ * @param size size in bytes
+ * @param data segment contents, may be NULL if instructions are
+ * supplied at lookup
+ */
+void Util::DisassemblyTable::addSegment(uint64_t base, uint64_t size, const uint8_t * data)
+{
+    Segment seg;
+    seg.base = base;
+    seg.entries.resize(size / 2);
+
+    // One entry per 16-bit parcel, as compressed & full instructions can mix
+    if(data)
+    {
+        for(uint64_t i=0; i<seg.entries.size(); i++)
+        {
+            const uint8_t * p = data + 2*i;
+            uint32_t instr = p[0] | (p[1] << 8);
+            if(!RVCompressed::isCompressed(instr) && 2*i + 4 <= size)
+                instr |= (p[2] << 16) | ((uint32_t)p[3] << 24);
+            seg.entries[i].instr = instr;
+            seg.entries[i].text = 0;
+        }
+    }
+    segments.push_back(seg);
+}
+
+
+/**
+ * @brief Get entry for an address
+ * 
+ * @param addr address
+ * @return Entry* entry, NULL if address is not in any segment
+ */
+Util::DisassemblyTable::Entry * Util::DisassemblyTable::find(uint64_t addr)
+{
+    if(addr & 0x1)
+        return NULL;
+
+    // Consecutive lookups almost always hit the same segment
+    for(unsigned int n=0; n<segments.size(); n++)
+    {
+        unsigned int i = (lastSegment + n) % segments.size();
+        uint64_t idx = (addr - segments[i].base) / 2;
+        if(addr >= segments[i].base && idx < segments[i].entries.size())
+        {
+            lastSegment = i;
+            return &segments[i].entries[idx];
+        }
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Get disassembly of the instruction stored in the table
+ * 
+ * @param addr address
+ * @return const std::string& disassembly
+ */
+const std::string & Util::DisassemblyTable::text(uint64_t addr)
+{
+    Entry * e = find(addr);
+    if(!e)
+    {
+        scratch = "";
+        return scratch;
+    }
+    if(e->text == 0)
+        e->text = intern(RVDisasm::disassemble(e->instr, addr));
+    return pool[e->text];
+}
+
+
+/**
+ * @brief Get disassembly of an instruction, re-formatting the entry
+ * if the instruction differs from the one stored
+ * 
+ * @param addr address
+ * @param instr raw instruction
+ * @return const std::string& disassembly
+ */
+const std::string & Util::DisassemblyTable::text(uint64_t addr, uint32_t instr)
+{
+    Entry * e = find(addr);
+    if(!e)
+    {
+        scratch = RVDisasm::disassemble(instr, addr);
+        return scratch;
+    }
+    if(e->text == 0 || e->instr != instr)
+    {
+        e->instr = instr;
+        e->text = intern(RVDisasm::disassemble(instr, addr));
+    }
+    return pool[e->text];
+}
+
+
+/**
+ * @brief Intern a string
+ */
+uint32_t Util::DisassemblyTable::intern(const std::string &s)
+{
+    std::unordered_map<std::string, uint32_t>::iterator it = poolIndex.find(s);
+    if(it != poolIndex.end())
+        return it->second;
+
+    uint32_t idx = pool.size();
+    pool.push_back(s);
+    poolIndex[s] = idx;
+    return idx;
+}
+
+
+/**
+ * @brief Look up a symbol in an ELF file
+ * 
+ * @param filename input filename
+ * @param name symbol name
+ * @param addr symbol value
+ * @return true if the symbol was found
+ */
+bool Util::getSymbolAddress(std::string filename, std::string name, uint64_t &addr)
+{
+    std::vector<uint64_t> addrs;
+    if(!getSymbolAddresses(filename, {name}, addrs))
+        return false;
+    addr = addrs[0];
+    return true;
+}
+
+
+/**
+ * @brief Look up several symbols in an ELF file, parsing it once
  * 
  * @param filename input filename
- * @return std::map<uint32_t, std::string> map of disassembly
+ * @param names symbol names
+ * @param addrs symbol values, in the order of names
+ * @return true if all symbols were found
  */
-std::map<uint32_t, Util::DisassembledLine> Util::getDisassembly(std::string filename)
+bool Util::getSymbolAddresses(std::string filename, const std::vector<std::string> &names, std::vector<uint64_t> &addrs)
 {
-	std::string command = "";
-	#ifdef RV32_COMPILER
-		command +="riscv32-unknown-elf-objdump -d ";
-	#else
-		command += "riscv64-unknown-elf-objdump -d ";
-	#endif
-	command+=filename;
-	
-	// Get command output
-	std::string output = GetStdoutFromCommand(command);
-	
-	std::stringstream s(output);
-
-	// Parse command output
-	std::map<uint32_t, DisassembledLine> dis;
-	
-	std::string line;
-	while(std::getline(s, line))
-	{        
-        if(strip(line).length() == 0)
+    ELFIO::elfio reader;
+    if(!reader.load(filename))
+        return false;
+
+    addrs.assign(names.size(), 0);
+    std::vector<bool> found(names.size(), false);
+    size_t nfound = 0;
+    for(unsigned int i=0; i<reader.sections.size(); i++)
+    {
+        ELFIO::section * sec = reader.sections[i];
+        if(sec->get_type() != SHT_SYMTAB)
             continue;
 
-        if(!(line.back() == ':' || line[0] != ' '))
+        ELFIO::symbol_section_accessor symbols(reader, sec);
+        for(ELFIO::Elf_Xword j=0; j<symbols.get_symbols_num() && nfound < names.size(); j++)
         {
-    
-            line = strip(line);
-            unsigned int colonAt = line.find(':');
+            std::string sym_name;
+            ELFIO::Elf64_Addr value;
+            ELFIO::Elf_Xword size;
+            unsigned char bind, type, other;
+            ELFIO::Elf_Half section_index;
+            if(!symbols.get_symbol(j, sym_name, value, size, bind, type, section_index, other))
+                continue;
 
-            uint32_t addr = std::stoi(strip(line.substr(0, colonAt)), 0, 16);
-            DisassembledLine d;
-            d.instr = (uint32_t)std::stol(strip(line.substr(colonAt+1, colonAt+15)), 0, 16);
-            d.disassembly = strip(line.substr(colonAt+16));
-
-            dis.insert({addr, d});
+            for(size_t k=0; k<names.size(); k++)
+            {
+                if(!found[k] && sym_name == names[k])
+                {
+                    addrs[k] = value;
+                    found[k] = true;
+                    nfound++;
+                }
+            }
         }
-	}
-	return dis;
+    }
+    return nfound == names.size();
 }
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <string>
+#include <string.h>
+
+#include "Simulator.h"
+#include "CheckpointFile.h"
+#include "SimError.h"
+
+// Header fields patched by the tests (see CheckpointFile::Header)
+static const size_t OFF_NSEGMENTS = 20;
+static const size_t OFF_NPAGES = 32;
+static const size_t OFF_INDEX = 40;
+static const size_t OFF_DATA = 48;
+
+static const char * CKP_FILE = "checkpoint_test.ckp";
+static const uint64_t MEM_SIZE = 16 << RVCPU::PAGE_SHIFT;
+static ISAdef isa;
+static unsigned int failures = 0;
+
+
+/**
+ * @brief Write a checkpoint image to the test file
+ */
+static void writeFile(const std::vector<char> &data)
+{
+    std::ofstream f(CKP_FILE, std::ios::binary | std::ios::trunc);
+    f.write(data.data(), data.size());
+}
+
+
+/**
+ * @brief Patch a 32 or 64-bit header field
+ */
+template <typename T>
+static std::vector<char> patched(std::vector<char> data, size_t offset, T value)
+{
+    memcpy(&data[offset], &value, sizeof(value));
+    return data;
+}
+
+
+/**
+ * @brief Check that opening or restoring a checkpoint image fails with message
+ */
+static void expectRejected(const char * name, const std::vector<char> &data, const std::string &message)
+{
+    writeFile(data);
+    try
+    {
+        Simulator target(isa, MEM_SIZE);
+        CheckpointFile ckp(CKP_FILE);
+        ckp.restore(target.getCPU(), target.getMemory());
+        std::cout << "FAIL " << name << ": accepted" << std::endl;
+        failures++;
+    }
+    catch(const SimError::Fatal &e)
+    {
+        if(e.message.compare(0, message.size(), message) != 0)
+        {
+            std::cout << "FAIL " << name << ": " << e.message << std::endl;
+            failures++;
+        }
+    }
+}
+
+
+int main()
+{
+    SimError::setThrowOnFatal(true);
+
+    memset(&isa, 0, sizeof(isa));
+    Simulator sim(isa, MEM_SIZE);
+    Memory * mem = sim.getMemory();
+    for(uint64_t i=0; i<MEM_SIZE; i++)
+        mem->mem[i] = (uint8_t)(i * 7 + 1);
+    CheckpointFile::save(CKP_FILE, sim.getCPU(), mem, false);
+
+    std::ifstream f(CKP_FILE, std::ios::binary);
+    const std::vector<char> good((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    // Intact file restores every page
+    {
+        Simulator other(isa, MEM_SIZE);
+        writeFile(good);
+        CheckpointFile ckp(CKP_FILE);
+        ckp.restore(other.getCPU(), other.getMemory());
+        if(memcmp(other.getMemory()->mem, mem->mem, MEM_SIZE) != 0)
+        {
+            std::cout << "FAIL intact: memory differs" << std::endl;
+            failures++;
+        }
+    }
+
+    const std::string truncated = "Truncated checkpoint file";
+    expectRejected("truncated to 8192 bytes", std::vector<char>(good.begin(), good.begin() + 8192), truncated);
+    expectRejected("last byte missing", std::vector<char>(good.begin(), good.end() - 1), truncated);
+    expectRejected("header only", std::vector<char>(good.begin(), good.begin() + OFF_DATA + 8), "Invalid checkpoint file");
+    expectRejected("npages past memory", patched<uint64_t>(good, OFF_NPAGES, 17), truncated);
+    expectRejected("npages huge", patched<uint64_t>(good, OFF_NPAGES, ~(uint64_t)0 >> 3), truncated);
+    expectRejected("nsegments huge", patched<uint32_t>(good, OFF_NSEGMENTS, 0xffffffff), truncated);
+    expectRejected("index offset moved", patched<uint64_t>(good, OFF_INDEX, 8), truncated);
+    expectRejected("data offset unaligned", patched<uint64_t>(good, OFF_DATA, 4096 + 8), truncated);
+    expectRejected("data offset past end", patched<uint64_t>(good, OFF_DATA, (uint64_t)good.size()), truncated);
+
+    // Page index out of memory & out of order
+    {
+        uint64_t index_offset;
+        memcpy(&index_offset, &good[OFF_INDEX], sizeof(index_offset));
+        expectRejected("page past memory", patched<uint64_t>(good, index_offset + 15 * 8, 16), "Invalid checkpoint page index");
+        expectRejected("pages out of order", patched<uint64_t>(good, index_offset + 3 * 8, 1), "Invalid checkpoint page index");
+    }
+
+    remove(CKP_FILE);
+    std::cout << (failures ? "checkpoint tests failed" : "checkpoint tests passed") << std::endl;
+    return failures ? 1 : 0;
+}
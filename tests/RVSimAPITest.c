@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "RVSimAPI.h"
+
+static unsigned int failures = 0;
+
+#define CHECK(cond) \
+    do { if(!(cond)) { printf("FAIL line %d: %s\n", __LINE__, #cond); failures++; } } while(0)
+
+
+/**
+ * @brief Fatal errors leave the CPU at the faulting instruction & keep
+ * failing until a program is loaded again
+ */
+static void testFatalError(void)
+{
+    static const uint32_t prog[] =
+    {
+        0x00100513,     // li a0, 1
+        0x00200593,     // li a1, 2
+        0xffffffff,     // illegal, no trap handler
+        0x00300613,     // li a2, 3
+        0x00400693,     // li a3, 4
+        0x00000073,     // ecall
+    };
+
+    rvsim_t * sim = rvsim_create(0, 1 << 16);
+    CHECK(sim != NULL);
+    memcpy(rvsim_memory(sim, 0, NULL), prog, sizeof(prog));
+    rvsim_set_pc(sim, 0);
+
+    CHECK(rvsim_run(sim, 100) == RVSIM_ERROR);
+    CHECK(strstr(rvsim_error(sim), "Illegal instruction") != NULL);
+    CHECK(rvsim_get_pc(sim) == 8);
+    CHECK(rvsim_instret(sim) == 2);
+    CHECK(rvsim_get_reg(sim, 11) == 2);
+    CHECK(rvsim_get_reg(sim, 12) == 0);
+
+    // Does not resume past the faulting instruction
+    CHECK(rvsim_run(sim, 100) == RVSIM_ERROR);
+    CHECK(rvsim_get_pc(sim) == 8);
+    CHECK(rvsim_get_reg(sim, 12) == 0);
+    rvsim_destroy(sim);
+}
+
+
+int main(void)
+{
+    testFatalError();
+    printf(failures ? "C API tests failed\n" : "C API tests passed\n");
+    return failures ? 1 : 0;
+}